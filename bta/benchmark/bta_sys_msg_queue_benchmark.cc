@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/bind.h>
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bta/sys/bta_sys_msg_queue.h"
+#include "common/message_loop_thread.h"
+#include "osi/include/allocator.h"
+
+using ::benchmark::State;
+using bluetooth::common::MessageLoopThread;
+
+namespace {
+
+constexpr int kNumMessages = 100000;
+
+std::atomic<int> g_handled;
+std::unique_ptr<std::promise<void>> g_handled_promise;
+
+// Does what bta_sys_event() does with a message of a subsystem handling it
+// right away
+void HandleMsg(BT_HDR* p_msg) {
+  osi_free(p_msg);
+  if (++g_handled == kNumMessages) g_handled_promise->set_value();
+}
+
+BT_HDR* NewMsg(int i) {
+  BT_HDR* p_msg = static_cast<BT_HDR*>(osi_malloc(sizeof(BT_HDR)));
+  p_msg->event = (uint16_t)(i % 8) << 8;
+  return p_msg;
+}
+
+class BM_BtaSysMsg : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    benchmark::Fixture::SetUp(st);
+    thread_ = std::make_unique<MessageLoopThread>("bta_sys_msg benchmark");
+    thread_->StartUp();
+  }
+
+  void TearDown(State& st) override {
+    thread_->ShutDown();
+    thread_.reset();
+    benchmark::Fixture::TearDown(st);
+  }
+
+  // Sends kNumMessages messages, split among the given number of threads,
+  // and waits for all of them to be handled
+  template <typename Send>
+  void Run(State& state, Send send) {
+    int num_senders = state.range(0);
+    for (auto _ : state) {
+      g_handled = 0;
+      g_handled_promise = std::make_unique<std::promise<void>>();
+      std::future<void> handled_future = g_handled_promise->get_future();
+
+      std::vector<std::thread> senders;
+      for (int s = 0; s < num_senders; s++) {
+        senders.emplace_back([&send, s, num_senders]() {
+          for (int i = s; i < kNumMessages; i += num_senders) send(NewMsg(i));
+        });
+      }
+      for (std::thread& sender : senders) sender.join();
+      handled_future.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kNumMessages);
+  }
+
+  std::unique_ptr<MessageLoopThread> thread_;
+};
+
+}  // namespace
+
+// One task per message, as bta_sys_sendmsg() used to post
+BENCHMARK_DEFINE_F(BM_BtaSysMsg, post_each)(State& state) {
+  Run(state, [this](BT_HDR* p_msg) {
+    thread_->DoInThread(FROM_HERE, base::Bind(&HandleMsg, p_msg));
+  });
+}
+BENCHMARK_REGISTER_F(BM_BtaSysMsg, post_each)
+    ->ArgName("senders")
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+
+// Messages sent together handled by one task
+BENCHMARK_DEFINE_F(BM_BtaSysMsg, batched)(State& state) {
+  BtaSysMsgQueue queue(thread_.get(), HandleMsg);
+  Run(state, [&queue](BT_HDR* p_msg) { queue.Enqueue(FROM_HERE, p_msg); });
+
+  // The last batch may still be running, let it return before the queue goes
+  std::promise<void> idle_promise;
+  thread_->DoInThread(FROM_HERE,
+                      base::BindOnce(&std::promise<void>::set_value,
+                                     base::Unretained(&idle_promise)));
+  idle_promise.get_future().wait();
+}
+BENCHMARK_REGISTER_F(BM_BtaSysMsg, batched)
+    ->ArgName("senders")
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -33,6 +33,8 @@
 #include "bta_gattc_int.h"
 #include "bta_sys.h"
 #include "btif/include/btif_debug_conn.h"
+#include "btm_int.h"
+#include "common/time_util.h"
 #include "l2c_api.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -115,7 +117,7 @@ static void bta_gattc_enable() {
 
   if (bta_gattc_cb.state == BTA_GATTC_STATE_DISABLED) {
     /* initialize control block */
-    bta_gattc_cb = tBTA_GATTC_CB();
+    bta_gattc_reset_cb();
     bta_gattc_cb.state = BTA_GATTC_STATE_ENABLED;
   } else {
     VLOG(1) << "GATTC is already enabled";
@@ -151,7 +153,7 @@ void bta_gattc_disable() {
 
   /* no registered apps, indicate disable completed */
   if (bta_gattc_cb.state != BTA_GATTC_STATE_DISABLING) {
-    bta_gattc_cb = tBTA_GATTC_CB();
+    bta_gattc_reset_cb();
     bta_gattc_cb.state = BTA_GATTC_STATE_DISABLED;
   }
 }
@@ -478,12 +480,15 @@ void bta_gattc_conn(tBTA_GATTC_CLCB* p_clcb, tBTA_GATTC_DATA* p_data) {
       p_clcb->p_srcb->state != BTA_GATTC_SERV_IDLE) {
     if (p_clcb->p_srcb->state == BTA_GATTC_SERV_IDLE) {
       p_clcb->p_srcb->state = BTA_GATTC_SERV_LOAD;
-      if (bta_gattc_cache_load(p_clcb->p_srcb)) {
+      /* the cache of an unbonded server is only reused once its Database
+       * Hash has been checked, which is done before discovery */
+      if (bta_gattc_cache_load(p_clcb->p_srcb) &&
+          btm_sec_is_a_bonded_dev(p_clcb->p_srcb->server_bda)) {
         p_clcb->p_srcb->state = BTA_GATTC_SERV_IDLE;
         bta_gattc_reset_discover_st(p_clcb->p_srcb, GATT_SUCCESS);
       } else {
         p_clcb->p_srcb->state = BTA_GATTC_SERV_DISC;
-        /* cache load failure, start discovery */
+        /* cache load failure or cache to validate, start discovery */
         bta_gattc_start_discover(p_clcb, NULL);
       }
     } else /* cache is building */
@@ -617,6 +622,17 @@ void bta_gattc_restart_discover(tBTA_GATTC_CLCB* p_clcb,
 void bta_gattc_cfg_mtu(tBTA_GATTC_CLCB* p_clcb, tBTA_GATTC_DATA* p_data) {
   if (!bta_gattc_enqueue(p_clcb, p_data)) return;
 
+  /* the MTU is exchanged once per connection, it might have been exchanged
+   * before the discovery already; report the negotiated one */
+  if (p_clcb->p_srcb->mtu_exchanged) {
+    tGATT_CL_COMPLETE cmpl;
+    memset(&cmpl, 0, sizeof(cmpl));
+    cmpl.mtu = p_clcb->p_srcb->mtu;
+    bta_gattc_cmpl_sendmsg(p_clcb->bta_conn_id, GATTC_OPTYPE_CONFIG,
+                           GATT_SUCCESS, &cmpl);
+    return;
+  }
+
   tGATT_STATUS status =
       GATTC_ConfigureMTU(p_clcb->bta_conn_id, p_data->api_mtu.mtu);
 
@@ -630,6 +646,87 @@ void bta_gattc_cfg_mtu(tBTA_GATTC_CLCB* p_clcb, tBTA_GATTC_DATA* p_data) {
   }
 }
 
+/** Discover the services of the server, dropping the cached database */
+static void bta_gattc_discover_services(tBTA_GATTC_CLCB* p_clcb) {
+  p_clcb->p_srcb->state = BTA_GATTC_SERV_DISC_ACT;
+
+  bta_gattc_init_cache(p_clcb->p_srcb);
+  p_clcb->status = bta_gattc_discover_pri_service(
+      p_clcb->bta_conn_id, p_clcb->p_srcb, GATT_DISC_SRVC_ALL);
+  if (p_clcb->status != GATT_SUCCESS) {
+    LOG(ERROR) << "discovery on server failed";
+    bta_gattc_reset_discover_st(p_clcb->p_srcb, p_clcb->status);
+  } else
+    p_clcb->disc_active = true;
+}
+
+/** Whether |handle| is the value of the Database Hash characteristic in the
+ * cached database of |p_srcb| */
+static bool bta_gattc_is_cached_db_hash(tBTA_GATTC_SERV* p_srcb,
+                                        uint16_t handle) {
+  const gatt::Characteristic* p_char =
+      bta_gattc_get_characteristic_srcb(p_srcb, handle);
+  return p_char != NULL &&
+         p_char->uuid == Uuid::From16Bit(GATT_UUID_DATABASE_HASH);
+}
+
+/** Database Hash read before discovery, keep the cached database if the hash
+ * is unchanged, otherwise discover the services */
+static void bta_gattc_db_hash_read_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                        tBTA_GATTC_OP_CMPL* p_data) {
+  tBTA_GATTC_SERV* p_srcb = p_clcb->p_srcb;
+  Octet16 hash{};
+  bool same_handle = false;
+
+  if (p_data->status == GATT_SUCCESS && p_data->p_cmpl != NULL &&
+      p_data->p_cmpl->att_value.len == OCTET16_LEN) {
+    memcpy(hash.data(), p_data->p_cmpl->att_value.value, OCTET16_LEN);
+    /* the read by type reports the handle the value was read from */
+    same_handle =
+        bta_gattc_is_cached_db_hash(p_srcb, p_data->p_cmpl->att_value.handle);
+  } else {
+    VLOG(1) << __func__ << ": no Database Hash, status=" << +p_data->status;
+  }
+
+  if (hash != Octet16{} && hash == p_srcb->database_hash && same_handle) {
+    LOG(INFO) << __func__ << ": Database Hash unchanged, skip discovery";
+    bta_gattc_reset_discover_st(p_srcb, GATT_SUCCESS);
+    return;
+  }
+
+  p_srcb->database_hash = hash;
+  bta_gattc_discover_services(p_clcb);
+}
+
+/** Validate the cached database with the Database Hash, or discover the
+ * services of the server right away */
+static void bta_gattc_validate_or_discover(tBTA_GATTC_CLCB* p_clcb) {
+  /* an unchanged Database Hash makes discovery unnecessary */
+  if (p_clcb->transport == BTA_TRANSPORT_LE &&
+      bta_gattc_read_db_hash(p_clcb->bta_conn_id) == GATT_SUCCESS) {
+    p_clcb->p_srcb->state = BTA_GATTC_SERV_READ_HASH;
+    p_clcb->disc_active = true;
+  } else {
+    bta_gattc_discover_services(p_clcb);
+  }
+}
+
+/** MTU exchanged before discovery, continue with the discovery using the
+ * larger responses */
+static void bta_gattc_disc_mtu_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                    tBTA_GATTC_OP_CMPL* p_data) {
+  tBTA_GATTC_SERV* p_srcb = p_clcb->p_srcb;
+
+  if (p_data->status == GATT_SUCCESS) {
+    p_srcb->mtu_exchanged = true;
+    if (p_data->p_cmpl) p_srcb->mtu = p_data->p_cmpl->mtu;
+  }
+  VLOG(1) << __func__ << ": status=" << +p_data->status
+          << " mtu=" << +p_srcb->mtu;
+
+  bta_gattc_validate_or_discover(p_clcb);
+}
+
 /** Start a discovery on server */
 void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
                               UNUSED_ATTR tBTA_GATTC_DATA* p_data) {
@@ -648,7 +745,6 @@ void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
       /* clear the service change mask */
       p_clcb->p_srcb->srvc_hdl_chg = false;
       p_clcb->p_srcb->update_count = 0;
-      p_clcb->p_srcb->state = BTA_GATTC_SERV_DISC_ACT;
 
       if (p_clcb->transport == BTA_TRANSPORT_LE)
         L2CA_EnableUpdateBleConnParams(p_clcb->p_srcb->server_bda, false);
@@ -656,14 +752,29 @@ void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
       /* set all srcb related clcb into discovery ST */
       bta_gattc_set_discover_st(p_clcb->p_srcb);
 
-      bta_gattc_init_cache(p_clcb->p_srcb);
-      p_clcb->status = bta_gattc_discover_pri_service(
-          p_clcb->bta_conn_id, p_clcb->p_srcb, GATT_DISC_SRVC_ALL);
-      if (p_clcb->status != GATT_SUCCESS) {
-        LOG(ERROR) << "discovery on server failed";
-        bta_gattc_reset_discover_st(p_clcb->p_srcb, p_clcb->status);
-      } else
+      p_clcb->p_srcb->disc_start_ms =
+          bluetooth::common::time_get_os_boottime_ms();
+      p_clcb->p_srcb->disc_procedures = 0;
+
+      /* a larger MTU lets each discovery response carry more attributes.
+       * An MTU request of the app waiting for the discovery is sent as it is
+       * afterwards instead, the MTU is exchanged only once per connection */
+      tGATT_STATUS mtu_status = GATT_ERROR;
+      if (p_clcb->transport == BTA_TRANSPORT_LE &&
+          !p_clcb->p_srcb->mtu_exchanged && p_clcb->p_q_cmd == NULL) {
+        mtu_status = GATTC_ConfigureMTU(p_clcb->bta_conn_id, GATT_MAX_MTU_SIZE);
+      }
+
+      if (mtu_status == GATT_SUCCESS || mtu_status == GATT_CMD_STARTED) {
+        p_clcb->p_srcb->state = BTA_GATTC_SERV_DISC_MTU;
         p_clcb->disc_active = true;
+      } else if (p_clcb->p_q_cmd == NULL) {
+        bta_gattc_validate_or_discover(p_clcb);
+      } else {
+        /* the request of the app still in flight would complete as the
+         * Database Hash read */
+        bta_gattc_discover_services(p_clcb);
+      }
     } else {
       LOG(ERROR) << "unknown device, can not start discovery";
     }
@@ -900,8 +1011,10 @@ void bta_gattc_cfg_mtu_cmpl(tBTA_GATTC_CLCB* p_clcb,
 
   osi_free_and_reset((void**)&p_clcb->p_q_cmd);
 
-  if (p_data->p_cmpl && p_data->status == GATT_SUCCESS)
+  if (p_data->p_cmpl && p_data->status == GATT_SUCCESS) {
     p_clcb->p_srcb->mtu = p_data->p_cmpl->mtu;
+    p_clcb->p_srcb->mtu_exchanged = true;
+  }
 
   /* configure MTU complete, callback */
   p_clcb->status = p_data->status;
@@ -974,8 +1087,20 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, tBTA_GATTC_DATA* p_data) {
 }
 
 /** operation completed */
-void bta_gattc_ignore_op_cmpl(UNUSED_ATTR tBTA_GATTC_CLCB* p_clcb,
+void bta_gattc_ignore_op_cmpl(tBTA_GATTC_CLCB* p_clcb,
                               tBTA_GATTC_DATA* p_data) {
+  if (p_clcb->p_srcb->state == BTA_GATTC_SERV_READ_HASH &&
+      p_clcb->disc_active && p_data->op_cmpl.op_code == GATTC_OPTYPE_READ) {
+    bta_gattc_db_hash_read_cmpl(p_clcb, &p_data->op_cmpl);
+    return;
+  }
+
+  if (p_clcb->p_srcb->state == BTA_GATTC_SERV_DISC_MTU &&
+      p_clcb->disc_active && p_data->op_cmpl.op_code == GATTC_OPTYPE_CONFIG) {
+    bta_gattc_disc_mtu_cmpl(p_clcb, &p_data->op_cmpl);
+    return;
+  }
+
   /* receive op complete when discovery is started, ignore the response,
       and wait for discovery finish and resent */
   VLOG(1) << __func__ << ": op = " << +p_data->hdr.layer_specific;
@@ -1021,6 +1146,7 @@ static void bta_gattc_deregister_cmpl(tBTA_GATTC_RCB* p_clreg) {
   memset(&cb_data, 0, sizeof(tBTA_GATTC));
 
   GATT_Deregister(p_clreg->client_if);
+  bta_gattc_remove_app_notif_registrations(client_if);
   memset(p_clreg, 0, sizeof(tBTA_GATTC_RCB));
 
   cb_data.reg_oper.client_if = client_if;
@@ -1156,7 +1282,7 @@ bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id, tBTA_GATTC_RCB* p_clrcb,
   /* mark service handle change pending */
   p_srcb->srvc_hdl_chg = true;
   /* clear up all notification/indication registration */
-  bta_gattc_clear_notif_registration(p_srcb, conn_id, s_handle, e_handle);
+  bta_gattc_clear_notif_registration(conn_id, s_handle, e_handle);
   /* service change indication all received, do discovery update */
   if (++p_srcb->update_count == bta_gattc_num_reg_app()) {
     /* not an opened connection; or connection busy */
@@ -1253,7 +1379,7 @@ void bta_gattc_process_indicate(uint16_t conn_id, tGATTC_OPTYPE op,
     return;
 
   /* if app registered for the notification */
-  if (bta_gattc_check_notif_registry(p_clrcb, p_srcb, &notify)) {
+  if (bta_gattc_check_notif_registry(gatt_if, remote_bda, handle)) {
     /* connection not open yet */
     if (p_clcb == NULL) {
       p_clcb = bta_gattc_clcb_alloc(gatt_if, remote_bda, transport);
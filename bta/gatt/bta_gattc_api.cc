@@ -231,7 +231,8 @@ void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu) {
  * Returns          None
  *
  ******************************************************************************/
-void BTA_GATTC_ServiceSearchRequest(uint16_t conn_id, Uuid* p_srvc_uuid) {
+void BTA_GATTC_ServiceSearchRequest(uint16_t conn_id,
+                                    const Uuid* p_srvc_uuid) {
   const size_t len = sizeof(tBTA_GATTC_API_SEARCH) + sizeof(Uuid);
   tBTA_GATTC_API_SEARCH* p_buf = (tBTA_GATTC_API_SEARCH*)osi_calloc(len);
 
@@ -634,50 +635,17 @@ void BTA_GATTC_SendIndConfirm(uint16_t conn_id, uint16_t handle) {
 tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if,
                                                 const RawAddress& bda,
                                                 uint16_t handle) {
-  tBTA_GATTC_RCB* p_clreg;
-  tGATT_STATUS status = GATT_ILLEGAL_PARAMETER;
-  uint8_t i;
-
   if (!handle) {
     LOG(ERROR) << __func__ << ": registration failed, handle is 0";
-    return status;
+    return GATT_ILLEGAL_PARAMETER;
   }
 
-  p_clreg = bta_gattc_cl_get_regcb(client_if);
-  if (p_clreg != NULL) {
-    for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-      if (p_clreg->notif_reg[i].in_use &&
-          p_clreg->notif_reg[i].remote_bda == bda &&
-          p_clreg->notif_reg[i].handle == handle) {
-        LOG(WARNING) << "notification already registered";
-        status = GATT_SUCCESS;
-        break;
-      }
-    }
-    if (status != GATT_SUCCESS) {
-      for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-        if (!p_clreg->notif_reg[i].in_use) {
-          memset((void*)&p_clreg->notif_reg[i], 0,
-                 sizeof(tBTA_GATTC_NOTIF_REG));
-
-          p_clreg->notif_reg[i].in_use = true;
-          p_clreg->notif_reg[i].remote_bda = bda;
-
-          p_clreg->notif_reg[i].handle = handle;
-          status = GATT_SUCCESS;
-          break;
-        }
-      }
-      if (i == BTA_GATTC_NOTIF_REG_MAX) {
-        status = GATT_NO_RESOURCES;
-        LOG(ERROR) << "Max Notification Reached, registration failed.";
-      }
-    }
-  } else {
+  if (bta_gattc_cl_get_regcb(client_if) == NULL) {
     LOG(ERROR) << "client_if=" << +client_if << " Not Registered";
+    return GATT_ILLEGAL_PARAMETER;
   }
 
-  return status;
+  return bta_gattc_add_notif_registration(client_if, bda, handle);
 }
 
 /*******************************************************************************
@@ -709,14 +677,10 @@ tGATT_STATUS BTA_GATTC_DeregisterForNotifications(tGATT_IF client_if,
     return GATT_ILLEGAL_PARAMETER;
   }
 
-  for (int i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-    if (p_clreg->notif_reg[i].in_use &&
-        p_clreg->notif_reg[i].remote_bda == bda &&
-        p_clreg->notif_reg[i].handle == handle) {
-      VLOG(1) << __func__ << " deregistered bd_addr=" << bda;
-      memset(&p_clreg->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
-      return GATT_SUCCESS;
-    }
+  if (bta_gattc_remove_notif_registration(client_if, bda, handle) ==
+      GATT_SUCCESS) {
+    VLOG(1) << __func__ << " deregistered bd_addr=" << bda;
+    return GATT_SUCCESS;
   }
 
   LOG(ERROR) << __func__ << " registration not found bd_addr=" << bda;
@@ -27,11 +27,18 @@
 
 #include "bt_target.h"
 
+#include <dirent.h>
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#include <utime.h>
+#include <algorithm>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "bt_common.h"
 #include "bta_gattc_int.h"
@@ -39,6 +46,8 @@
 #include "btm_api.h"
 #include "btm_ble_api.h"
 #include "btm_int.h"
+#include "common/metrics_registry.h"
+#include "common/time_util.h"
 #include "database.h"
 #include "database_builder.h"
 #include "osi/include/log.h"
@@ -58,6 +67,7 @@ using gatt::Service;
 using gatt::StoredAttribute;
 
 static void bta_gattc_cache_write(const RawAddress& server_bda,
+                                  const Octet16& database_hash,
                                   const std::vector<StoredAttribute>& attr);
 static tGATT_STATUS bta_gattc_sdp_service_disc(uint16_t conn_id,
                                                tBTA_GATTC_SERV* p_server_cb);
@@ -70,8 +80,14 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
 
 #define BTA_GATT_SDP_DB_SIZE 4096
 
-#define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
-#define GATT_CACHE_VERSION 5
+#define GATT_CACHE_DIR "/data/misc/bluetooth/"
+#define GATT_CACHE_FILE_PREFIX "gatt_cache_"
+#define GATT_CACHE_PREFIX GATT_CACHE_DIR GATT_CACHE_FILE_PREFIX
+#define GATT_CACHE_VERSION 6
+
+/* Caches of unbonded servers are kept for the most recently used ones only,
+ * their addresses may be private addresses that are never seen again */
+#define GATT_CACHE_MAX_UNBONDED 64
 
 static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
                                                const RawAddress& bda) {
@@ -80,6 +96,51 @@ static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
            bda.address[4], bda.address[5]);
 }
 
+/* Parses the server address out of a cache file |name|, without directory */
+static bool bta_gattc_parse_cache_file_name(const char* name, RawAddress* bda) {
+  const size_t prefix_len = strlen(GATT_CACHE_FILE_PREFIX);
+  if (strncmp(name, GATT_CACHE_FILE_PREFIX, prefix_len) != 0) return false;
+  name += prefix_len;
+  if (strlen(name) != 2 * RawAddress::kLength) return false;
+
+  for (size_t i = 0; i < RawAddress::kLength; i++) {
+    char byte[3] = {name[2 * i], name[2 * i + 1], 0};
+    char* end = NULL;
+    bda->address[i] = (uint8_t)strtoul(byte, &end, 16);
+    if (end != byte + 2) return false;
+  }
+  return true;
+}
+
+/* Removes the least recently used cache files of unbonded servers, past
+ * GATT_CACHE_MAX_UNBONDED of them */
+static void bta_gattc_cache_trim_unbonded(void) {
+  DIR* dir = opendir(GATT_CACHE_DIR);
+  if (!dir) return;
+
+  std::vector<std::pair<time_t, std::string>> unbonded;
+  for (struct dirent* entry = readdir(dir); entry; entry = readdir(dir)) {
+    RawAddress bda;
+    if (!bta_gattc_parse_cache_file_name(entry->d_name, &bda)) continue;
+    if (btm_sec_is_a_bonded_dev(bda)) continue;
+
+    std::string path = std::string(GATT_CACHE_DIR) + entry->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) continue;
+    unbonded.emplace_back(st.st_mtime, std::move(path));
+  }
+  closedir(dir);
+
+  if (unbonded.size() <= GATT_CACHE_MAX_UNBONDED) return;
+
+  std::sort(unbonded.begin(), unbonded.end());
+  size_t remove_n = unbonded.size() - GATT_CACHE_MAX_UNBONDED;
+  VLOG(1) << __func__ << ": removing " << remove_n << " GATT cache files";
+  for (size_t i = 0; i < remove_n; i++) {
+    unlink(unbonded[i].second.c_str());
+  }
+}
+
 /*****************************************************************************
  *  Constants and data types
  ****************************************************************************/
@@ -144,6 +205,19 @@ tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
   return bta_gattc_sdp_service_disc(conn_id, p_server_cb);
 }
 
+/** Read the Database Hash of the server, the result is reported as a read
+ * operation complete */
+tGATT_STATUS bta_gattc_read_db_hash(uint16_t conn_id) {
+  tGATT_READ_PARAM read_param;
+  memset(&read_param, 0, sizeof(tGATT_READ_PARAM));
+
+  read_param.char_type.s_handle = 0x0001;
+  read_param.char_type.e_handle = 0xFFFF;
+  read_param.char_type.uuid = Uuid::From16Bit(GATT_UUID_DATABASE_HASH);
+  read_param.char_type.auth_req = GATT_AUTH_REQ_NONE;
+  return GATTC_Read(conn_id, GATT_READ_BY_TYPE, &read_param);
+}
+
 /** start exploring next service, or finish discovery if no more services left
  */
 static void bta_gattc_explore_next_service(uint16_t conn_id,
@@ -175,7 +249,20 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
   }
 
   /* no service found at all, the end of server discovery*/
-  LOG(INFO) << __func__ << ": service discovery finished";
+  uint64_t duration_ms = bluetooth::common::time_get_os_boottime_ms() -
+                         p_srvc_cb->disc_start_ms;
+  LOG(INFO) << __func__ << ": service discovery finished in " << duration_ms
+            << " ms, " << +p_srvc_cb->disc_procedures << " procedures, mtu "
+            << +p_srvc_cb->mtu;
+
+  static bluetooth::common::MetricsHistogram* const duration_histogram =
+      bluetooth::common::MetricsRegistry::GetInstance()->GetHistogram(
+          "gatt_discovery_duration_ms");
+  static bluetooth::common::MetricsHistogram* const procedures_histogram =
+      bluetooth::common::MetricsRegistry::GetInstance()->GetHistogram(
+          "gatt_discovery_procedures");
+  duration_histogram->Record(duration_ms);
+  procedures_histogram->Record(p_srvc_cb->disc_procedures);
 
   p_srvc_cb->gatt_database = p_srvc_cb->pending_discovery.Build();
 
@@ -185,9 +272,17 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
   /* save cache to NV */
   p_clcb->p_srcb->state = BTA_GATTC_SERV_SAVE;
 
+  /* the cache of a bonded server is kept up to date by Service Changed
+   * indications, otherwise it is validated with the Database Hash */
   if (btm_sec_is_a_bonded_dev(p_srvc_cb->server_bda)) {
     bta_gattc_cache_write(p_clcb->p_srcb->server_bda,
+                          p_clcb->p_srcb->database_hash,
                           p_clcb->p_srcb->gatt_database.Serialize());
+  } else if (p_srvc_cb->database_hash != Octet16{}) {
+    bta_gattc_cache_write(p_clcb->p_srcb->server_bda,
+                          p_clcb->p_srcb->database_hash,
+                          p_clcb->p_srcb->gatt_database.Serialize());
+    bta_gattc_cache_trim_unbonded();
   }
 
   bta_gattc_reset_discover_st(p_clcb->p_srcb, GATT_SUCCESS);
@@ -218,6 +313,35 @@ descriptor_discovery_done:
   return;
 }
 
+/** Start discovery of the next merged descriptor range of all services, or
+ * finish discovery if none left */
+static void bta_gattc_start_disc_all_dscp(uint16_t conn_id,
+                                          tBTA_GATTC_SERV* p_srvc_cb) {
+  /* Find Information response entries with a 16 bit type, half a response
+   * of known attributes is cheaper than another request */
+  uint16_t max_gap = (p_srvc_cb->mtu - 2) / 8;
+
+  std::pair<uint16_t, uint16_t> range =
+      p_srvc_cb->pending_discovery.NextMergedDescriptorRangeToExplore(max_gap);
+  if (range == DatabaseBuilder::EXPLORE_END ||
+      GATTC_Discover(conn_id, GATT_DISC_CHAR_DSCPT, range.first,
+                     range.second) != GATT_SUCCESS) {
+    DVLOG(3) << "all characteristics explored";
+    bta_gattc_explore_srvc_finished(conn_id, p_srvc_cb);
+  }
+}
+
+/** Continue the discovery of all services with |disc_type| over the whole
+ * handle range */
+static void bta_gattc_discover_whole_range(uint16_t conn_id,
+                                           tBTA_GATTC_SERV* p_srvc_cb,
+                                           tGATT_DISC_TYPE disc_type) {
+  if (GATTC_Discover(conn_id, disc_type, 0x0001, 0xFFFF) != GATT_SUCCESS) {
+    LOG(ERROR) << __func__ << ": discovery type " << +disc_type << " failed";
+    bta_gattc_reset_discover_st(p_srvc_cb, GATT_ERROR);
+  }
+}
+
 /* Process the discovery result from sdp */
 void bta_gattc_sdp_callback(uint16_t sdp_status, void* user_data) {
   tBTA_GATTC_CB_DATA* cb_data = (tBTA_GATTC_CB_DATA*)user_data;
@@ -365,6 +489,36 @@ void bta_gattc_disc_cmpl_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
   tBTA_GATTC_SERV* p_srvc_cb = bta_gattc_find_scb_by_cid(conn_id);
   if (!p_srvc_cb) return;
 
+  p_srvc_cb->disc_procedures++;
+
+  /* on LE each procedure covers all the services, the BR/EDR services come
+   * from SDP and are explored one by one */
+  if (p_clcb && p_clcb->transport == BTA_TRANSPORT_LE) {
+    switch (disc_type) {
+      case GATT_DISC_SRVC_ALL:
+      case GATT_DISC_SRVC_BY_UUID:
+#if (BTA_GATT_DEBUG == TRUE)
+        bta_gattc_display_explore_record(p_srvc_cb->pending_discovery);
+#endif
+        if (!p_srvc_cb->pending_discovery.InProgress()) {
+          bta_gattc_explore_srvc_finished(conn_id, p_srvc_cb);
+          break;
+        }
+        bta_gattc_discover_whole_range(conn_id, p_srvc_cb, GATT_DISC_INC_SRVC);
+        break;
+
+      case GATT_DISC_INC_SRVC:
+        bta_gattc_discover_whole_range(conn_id, p_srvc_cb, GATT_DISC_CHAR);
+        break;
+
+      case GATT_DISC_CHAR:
+      case GATT_DISC_CHAR_DSCPT:
+        bta_gattc_start_disc_all_dscp(conn_id, p_srvc_cb);
+        break;
+    }
+    return;
+  }
+
   switch (disc_type) {
     case GATT_DISC_SRVC_ALL:
     case GATT_DISC_SRVC_BY_UUID:
@@ -733,6 +887,11 @@ bool bta_gattc_cache_load(tBTA_GATTC_SERV* p_srcb) {
     goto done;
   }
 
+  if (fread(p_srcb->database_hash.data(), OCTET16_LEN, 1, fd) != 1) {
+    LOG(ERROR) << __func__ << ": can't read GATT database hash: " << fname;
+    goto done;
+  }
+
   if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
     LOG(ERROR) << __func__
                << ": can't read number of GATT attributes: " << fname;
@@ -752,6 +911,8 @@ bool bta_gattc_cache_load(tBTA_GATTC_SERV* p_srcb) {
 
 done:
   fclose(fd);
+  /* the modification time orders the unbonded caches by last use */
+  if (success) utime(fname, NULL);
   return success;
 }
 
@@ -763,11 +924,14 @@ done:
  *                  cache is available to save.
  *
  * Parameter        server_bda: server bd address of this cache belongs to
+ *                  database_hash: Database Hash of the server, all zero if
+ *                                 unknown.
  *                  attr: attributes to save.
  * Returns
  *
  ******************************************************************************/
 static void bta_gattc_cache_write(const RawAddress& server_bda,
+                                  const Octet16& database_hash,
                                   const std::vector<StoredAttribute>& attr) {
   char fname[255] = {0};
   bta_gattc_generate_cache_file_name(fname, sizeof(fname), server_bda);
@@ -786,6 +950,12 @@ static void bta_gattc_cache_write(const RawAddress& server_bda,
     return;
   }
 
+  if (fwrite(database_hash.data(), OCTET16_LEN, 1, fd) != 1) {
+    LOG(ERROR) << __func__ << ": can't write GATT database hash: " << fname;
+    fclose(fd);
+    return;
+  }
+
   uint16_t num_attr = attr.size();
   if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
     LOG(ERROR) << __func__
@@ -36,6 +36,8 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <unordered_map>
+
 /*****************************************************************************
  *  Constants and data types
  ****************************************************************************/
@@ -204,6 +206,8 @@ typedef struct {
 #define BTA_GATTC_SERV_SAVE 2
 #define BTA_GATTC_SERV_DISC 3
 #define BTA_GATTC_SERV_DISC_ACT 4
+#define BTA_GATTC_SERV_READ_HASH 5 /* validating the cache before discovery */
+#define BTA_GATTC_SERV_DISC_MTU 6  /* exchanging the MTU before discovery */
 
   uint8_t state;
 
@@ -217,17 +221,14 @@ typedef struct {
   uint16_t attr_index;  /* cahce NV saving/loading attribute index */
 
   uint16_t mtu;
-} tBTA_GATTC_SERV;
+  bool mtu_exchanged; /* ATT_MTU already exchanged on this connection */
 
-#ifndef BTA_GATTC_NOTIF_REG_MAX
-#define BTA_GATTC_NOTIF_REG_MAX 15
-#endif
+  /* Database Hash of |gatt_database|, all zero if the server has none */
+  Octet16 database_hash;
 
-typedef struct {
-  bool in_use;
-  RawAddress remote_bda;
-  uint16_t handle;
-} tBTA_GATTC_NOTIF_REG;
+  uint64_t disc_start_ms;   /* start of the running discovery */
+  uint16_t disc_procedures; /* discovery procedures run so far */
+} tBTA_GATTC_SERV;
 
 typedef struct {
   tBTA_GATTC_CBACK* p_cback;
@@ -236,7 +237,6 @@ typedef struct {
   uint8_t num_clcb; /* number of associated CLCB */
   bool dereg_pending;
   bluetooth::Uuid app_uuid;
-  tBTA_GATTC_NOTIF_REG notif_reg[BTA_GATTC_NOTIF_REG_MAX];
 } tBTA_GATTC_RCB;
 
 /* client channel is a mapping between a BTA client(cl_id) and a remote BD
@@ -282,6 +282,11 @@ typedef struct {
   RawAddress remote_bda;
 } tBTA_GATTC_CONN;
 
+/* notification registrations of one server: attribute handle -> mask of the
+ * client applications registered for it */
+typedef std::unordered_map<uint16_t, tBTA_GATTC_CIF_MASK>
+    tBTA_GATTC_NOTIF_HANDLES;
+
 enum {
   BTA_GATTC_STATE_DISABLED,
   BTA_GATTC_STATE_ENABLING,
@@ -298,6 +303,11 @@ typedef struct {
 
   tBTA_GATTC_CLCB clcb[BTA_GATTC_CLCB_MAX];
   tBTA_GATTC_SERV known_server[BTA_GATTC_KNOWN_SR_MAX];
+
+  /* notification registrations, indexed by server address then handle. Only
+   * accessed through the bta_gattc_*_notif_* functions, which serialize the
+   * API callers against notification routing. */
+  std::unordered_map<RawAddress, tBTA_GATTC_NOTIF_HANDLES> notif_reg;
 } tBTA_GATTC_CB;
 
 /*****************************************************************************
@@ -400,18 +410,25 @@ extern tBTA_GATTC_CLCB* bta_gattc_find_int_disconn_clcb(tBTA_GATTC_DATA* p_msg);
 
 extern bool bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb, tBTA_GATTC_DATA* p_data);
 
-extern bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg,
-                                           tBTA_GATTC_SERV* p_srcb,
-                                           tBTA_GATTC_NOTIFY* p_notify);
+extern tGATT_STATUS bta_gattc_add_notif_registration(tGATT_IF client_if,
+                                                     const RawAddress& bda,
+                                                     uint16_t handle);
+extern tGATT_STATUS bta_gattc_remove_notif_registration(tGATT_IF client_if,
+                                                        const RawAddress& bda,
+                                                        uint16_t handle);
+extern void bta_gattc_remove_app_notif_registrations(tGATT_IF client_if);
+extern bool bta_gattc_check_notif_registry(tGATT_IF client_if,
+                                           const RawAddress& bda,
+                                           uint16_t handle);
 extern bool bta_gattc_mark_bg_conn(tGATT_IF client_if,
                                    const RawAddress& remote_bda, bool add);
 extern bool bta_gattc_check_bg_conn(tGATT_IF client_if,
                                     const RawAddress& remote_bda, uint8_t role);
 extern uint8_t bta_gattc_num_reg_app(void);
-extern void bta_gattc_clear_notif_registration(tBTA_GATTC_SERV* p_srcb,
-                                               uint16_t conn_id,
+extern void bta_gattc_clear_notif_registration(uint16_t conn_id,
                                                uint16_t start_handle,
                                                uint16_t end_handle);
+extern void bta_gattc_reset_cb(void);
 extern tBTA_GATTC_SERV* bta_gattc_find_srvr_cache(const RawAddress& bda);
 
 /* discovery functions */
@@ -424,6 +441,7 @@ extern void bta_gattc_disc_cmpl_cback(uint16_t conn_id,
 extern tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
                                                    tBTA_GATTC_SERV* p_server_cb,
                                                    uint8_t disc_type);
+extern tGATT_STATUS bta_gattc_read_db_hash(uint16_t conn_id);
 extern void bta_gattc_search_service(tBTA_GATTC_CLCB* p_clcb,
                                      bluetooth::Uuid* p_uuid);
 extern const std::list<gatt::Service>* bta_gattc_get_services(uint16_t conn_id);
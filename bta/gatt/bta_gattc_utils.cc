@@ -29,6 +29,8 @@
 #include <base/logging.h>
 #include <string.h>
 
+#include <mutex>
+
 #include "bt_common.h"
 #include "bta_gattc_int.h"
 #include "bta_sys.h"
@@ -202,6 +204,7 @@ void bta_gattc_clcb_dealloc(tBTA_GATTC_CLCB* p_clcb) {
     p_srcb->connected = false;
     p_srcb->state = BTA_GATTC_SERV_IDLE;
     p_srcb->mtu = 0;
+    p_srcb->mtu_exchanged = false;
 
     // clear reallocating
     p_srcb->gatt_database.Clear();
@@ -325,30 +328,130 @@ bool bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb, tBTA_GATTC_DATA* p_data) {
   return false;
 }
 
+/* Serializes notification (de)registration from the API callers against the
+ * lookups done for every received notification */
+static std::mutex notif_reg_lock;
+
+static tBTA_GATTC_CIF_MASK bta_gattc_cif_bit(tGATT_IF client_if) {
+  return (tBTA_GATTC_CIF_MASK)(1 << (client_if - 1));
+}
+
 /*******************************************************************************
  *
- * Function         bta_gattc_check_notif_registry
+ * Function         bta_gattc_add_notif_registration
  *
- * Description      check if the service notificaition has been registered.
+ * Description      register a client application for the notifications and
+ *                  indications of a server attribute.
  *
- * Returns
+ * Returns          GATT_SUCCESS, also when already registered.
  *
  ******************************************************************************/
-bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg,
-                                    tBTA_GATTC_SERV* p_srcb,
-                                    tBTA_GATTC_NOTIFY* p_notify) {
-  uint8_t i;
+tGATT_STATUS bta_gattc_add_notif_registration(tGATT_IF client_if,
+                                              const RawAddress& bda,
+                                              uint16_t handle) {
+  std::lock_guard<std::mutex> lock(notif_reg_lock);
+  tBTA_GATTC_CIF_MASK& cif_mask = bta_gattc_cb.notif_reg[bda][handle];
+  if (cif_mask & bta_gattc_cif_bit(client_if)) {
+    LOG(WARNING) << "notification already registered";
+  }
+  cif_mask |= bta_gattc_cif_bit(client_if);
+  return GATT_SUCCESS;
+}
 
-  for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-    if (p_clreg->notif_reg[i].in_use &&
-        p_clreg->notif_reg[i].remote_bda == p_srcb->server_bda &&
-        p_clreg->notif_reg[i].handle == p_notify->handle) {
-      VLOG(1) << "Notification registered!";
-      return true;
+/*******************************************************************************
+ *
+ * Function         bta_gattc_remove_notif_registration
+ *
+ * Description      remove the registration of a client application for the
+ *                  notifications and indications of a server attribute.
+ *
+ * Returns          GATT_SUCCESS, or GATT_ERROR if it was not registered.
+ *
+ ******************************************************************************/
+tGATT_STATUS bta_gattc_remove_notif_registration(tGATT_IF client_if,
+                                                 const RawAddress& bda,
+                                                 uint16_t handle) {
+  std::lock_guard<std::mutex> lock(notif_reg_lock);
+  auto server = bta_gattc_cb.notif_reg.find(bda);
+  if (server == bta_gattc_cb.notif_reg.end()) return GATT_ERROR;
+
+  auto attr = server->second.find(handle);
+  if (attr == server->second.end() ||
+      !(attr->second & bta_gattc_cif_bit(client_if)))
+    return GATT_ERROR;
+
+  attr->second &= ~bta_gattc_cif_bit(client_if);
+  if (attr->second == 0) server->second.erase(attr);
+  if (server->second.empty()) bta_gattc_cb.notif_reg.erase(server);
+  return GATT_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_remove_app_notif_registrations
+ *
+ * Description      remove every notification registration of a client
+ *                  application, when it deregisters.
+ *
+ * Returns          None.
+ *
+ ******************************************************************************/
+void bta_gattc_remove_app_notif_registrations(tGATT_IF client_if) {
+  std::lock_guard<std::mutex> lock(notif_reg_lock);
+  for (auto server = bta_gattc_cb.notif_reg.begin();
+       server != bta_gattc_cb.notif_reg.end();) {
+    for (auto attr = server->second.begin(); attr != server->second.end();) {
+      attr->second &= ~bta_gattc_cif_bit(client_if);
+      if (attr->second == 0)
+        attr = server->second.erase(attr);
+      else
+        ++attr;
     }
+    if (server->second.empty())
+      server = bta_gattc_cb.notif_reg.erase(server);
+    else
+      ++server;
   }
-  return false;
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_check_notif_registry
+ *
+ * Description      check if the client application registered for the
+ *                  notifications of a server attribute.
+ *
+ * Returns          true if registered.
+ *
+ ******************************************************************************/
+bool bta_gattc_check_notif_registry(tGATT_IF client_if, const RawAddress& bda,
+                                    uint16_t handle) {
+  std::lock_guard<std::mutex> lock(notif_reg_lock);
+  auto server = bta_gattc_cb.notif_reg.find(bda);
+  if (server == bta_gattc_cb.notif_reg.end()) return false;
+
+  auto attr = server->second.find(handle);
+  if (attr == server->second.end()) return false;
+
+  return (attr->second & bta_gattc_cif_bit(client_if)) != 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_reset_cb
+ *
+ * Description      Resets the GATTC control block. The notification
+ *                  registrations it holds are read from the API callers
+ *                  threads, so they are replaced under their lock.
+ *
+ * Returns          None.
+ *
+ ******************************************************************************/
+void bta_gattc_reset_cb(void) {
+  std::lock_guard<std::mutex> lock(notif_reg_lock);
+  bta_gattc_cb = tBTA_GATTC_CB();
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_clear_notif_registration
@@ -362,35 +465,33 @@ bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg,
  * Returns          None.
  *
  ******************************************************************************/
-void bta_gattc_clear_notif_registration(tBTA_GATTC_SERV* p_srcb,
-                                        uint16_t conn_id, uint16_t start_handle,
+void bta_gattc_clear_notif_registration(uint16_t conn_id, uint16_t start_handle,
                                         uint16_t end_handle) {
   RawAddress remote_bda;
   tGATT_IF gatt_if;
-  tBTA_GATTC_RCB* p_clrcb;
-  uint8_t i;
   tGATT_TRANSPORT transport;
-  uint16_t handle;
-
-  if (GATT_GetConnectionInfor(conn_id, &gatt_if, remote_bda, &transport)) {
-    p_clrcb = bta_gattc_cl_get_regcb(gatt_if);
-    if (p_clrcb != NULL) {
-      for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
-        if (p_clrcb->notif_reg[i].in_use &&
-            p_clrcb->notif_reg[i].remote_bda == remote_bda) {
-          /* It's enough to get service or characteristic handle, as
-           * clear boundaries are always around service.
-           */
-          handle = p_clrcb->notif_reg[i].handle;
-          if (handle >= start_handle && handle <= end_handle)
-            memset(&p_clrcb->notif_reg[i], 0, sizeof(tBTA_GATTC_NOTIF_REG));
-        }
-      }
-    }
-  } else {
+
+  if (!GATT_GetConnectionInfor(conn_id, &gatt_if, remote_bda, &transport)) {
     LOG(ERROR) << "can not clear indication/notif registration for unknown app";
+    return;
+  }
+  if (bta_gattc_cl_get_regcb(gatt_if) == NULL) return;
+
+  std::lock_guard<std::mutex> lock(notif_reg_lock);
+  auto server = bta_gattc_cb.notif_reg.find(remote_bda);
+  if (server == bta_gattc_cb.notif_reg.end()) return;
+
+  /* It's enough to get service or characteristic handle, as clear boundaries
+   * are always around service. */
+  for (auto attr = server->second.begin(); attr != server->second.end();) {
+    if (attr->first >= start_handle && attr->first <= end_handle)
+      attr->second &= ~bta_gattc_cif_bit(gatt_if);
+    if (attr->second == 0)
+      attr = server->second.erase(attr);
+    else
+      ++attr;
   }
-  return;
+  if (server->second.empty()) bta_gattc_cb.notif_reg.erase(server);
 }
 
 /*******************************************************************************
@@ -103,6 +103,24 @@ void DatabaseBuilder::AddCharacteristic(uint16_t handle, uint16_t value_handle,
   return;
 }
 
+/* Returns true if |handle| is a service, included service or characteristic
+ * declaration, or a characteristic value of |service| */
+static bool IsKnownAttribute(const Service& service, uint16_t handle) {
+  if (handle == service.handle) return true;
+
+  for (const IncludedService& included : service.included_services) {
+    if (included.handle == handle) return true;
+  }
+
+  for (const Characteristic& characteristic : service.characteristics) {
+    if (characteristic.declaration_handle == handle ||
+        characteristic.value_handle == handle)
+      return true;
+  }
+
+  return false;
+}
+
 void DatabaseBuilder::AddDescriptor(uint16_t handle, const Uuid& uuid) {
   Service* service = FindService(database.services, handle);
   if (!service) {
@@ -110,6 +128,9 @@ void DatabaseBuilder::AddDescriptor(uint16_t handle, const Uuid& uuid) {
     return;
   }
 
+  /* merged descriptor ranges report the attributes between descriptors too */
+  if (IsKnownAttribute(*service, handle)) return;
+
   if (service->characteristics.empty()) {
     LOG(ERROR) << __func__
                << ": Illegal action to add to non-existing characteristic!";
@@ -180,15 +201,64 @@ std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
   return {HANDLE_MAX, HANDLE_MAX};
 }
 
+std::pair<uint16_t, uint16_t>
+DatabaseBuilder::NextMergedDescriptorRangeToExplore(uint16_t max_gap) {
+  std::pair<uint16_t, uint16_t> range = EXPLORE_END;
+  /* true while all the characteristic values after range.second have a 16 bit
+   * UUID; a UUID size change ends a Find Information response early */
+  bool gap_16bit = true;
+
+  for (const Service& service : database.services) {
+    for (auto it = service.characteristics.cbegin();
+         it != service.characteristics.cend(); it++) {
+      auto next = std::next(it);
+
+      /* same bounds as NextDescriptorRangeToExplore */
+      uint16_t start = it->declaration_handle + 2;
+      uint16_t end;
+      if (next != service.characteristics.end())
+        end = next->declaration_handle - 1;
+      else
+        end = service.end_handle;
+
+      if (start <= descriptors_explored_until) continue;
+
+      if (range == EXPLORE_END) {
+        if (start <= end) range = {start, end};
+        continue;
+      }
+
+      gap_16bit = gap_16bit && it->uuid.Is16Bit();
+      // No place for descriptor, declaration and value are part of the gap
+      if (start > end) continue;
+
+      if (!gap_16bit || start - range.second - 1 > max_gap) {
+        descriptors_explored_until = range.second;
+        return range;
+      }
+      range.second = end;
+    }
+  }
+
+  if (range != EXPLORE_END) descriptors_explored_until = range.second;
+  return range;
+}
+
 bool DatabaseBuilder::InProgress() const { return !database.services.empty(); }
 
 Database DatabaseBuilder::Build() {
   Database tmp = database;
   database.Clear();
+  services_to_discover.clear();
+  descriptors_explored_until = 0;
   return tmp;
 }
 
-void DatabaseBuilder::Clear() { database.Clear(); }
+void DatabaseBuilder::Clear() {
+  database.Clear();
+  services_to_discover.clear();
+  descriptors_explored_until = 0;
+}
 
 std::string DatabaseBuilder::ToString() const { return database.ToString(); }
 
@@ -50,6 +50,16 @@ class DatabaseBuilder {
    */
   std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore();
 
+  /* Return pair with start and end handle of the next descriptor range to
+   * discover in any service, or DatabaseBuilder::EXPLORE_END if no more
+   * descriptors left. To be used once the characteristics of all services are
+   * known. Descriptor ranges separated by at most |max_gap| attributes with a
+   * 16 bit type are merged, AddDescriptor ignores the known attributes
+   * reported inside a merged range.
+   */
+  std::pair<uint16_t, uint16_t> NextMergedDescriptorRangeToExplore(
+      uint16_t max_gap);
+
   /* Returns true, if GATT discovery is in progress, false if discovery was not
    * started, or is already finished.
    */
@@ -74,6 +84,8 @@ class DatabaseBuilder {
   std::pair<uint16_t, uint16_t> pending_service;
   /* Characteristic inside pending_service that is currently being explored */
   uint16_t pending_characteristic;
+  /* End of the last range returned by NextMergedDescriptorRangeToExplore */
+  uint16_t descriptors_explored_until = 0;
 
   /* sorted, unique set of start_handle, end_handle pair of all services that
    * have not yet been discovered */
@@ -82,12 +82,12 @@ constexpr uint16_t ADD_RENDER_DELAY_INTERVALS = 4;
 namespace {
 
 // clang-format off
-Uuid HEARING_AID_UUID          = Uuid::FromString("FDF0");
-Uuid READ_ONLY_PROPERTIES_UUID = Uuid::FromString("6333651e-c481-4a3e-9169-7c902aad37bb");
-Uuid AUDIO_CONTROL_POINT_UUID  = Uuid::FromString("f0d4de7e-4a88-476c-9d9f-1937b0996cc0");
-Uuid AUDIO_STATUS_UUID         = Uuid::FromString("38663f1a-e711-4cac-b641-326b56404837");
-Uuid VOLUME_UUID               = Uuid::FromString("00e4ca9e-ab14-41e4-8823-f9e70c7e91df");
-Uuid LE_PSM_UUID               = Uuid::FromString("2d410339-82b6-42aa-b34e-e2e01df8cc1a");
+constexpr Uuid HEARING_AID_UUID          = Uuid::FromLiteral("FDF0");
+constexpr Uuid READ_ONLY_PROPERTIES_UUID = Uuid::FromLiteral("6333651e-c481-4a3e-9169-7c902aad37bb");
+constexpr Uuid AUDIO_CONTROL_POINT_UUID  = Uuid::FromLiteral("f0d4de7e-4a88-476c-9d9f-1937b0996cc0");
+constexpr Uuid AUDIO_STATUS_UUID         = Uuid::FromLiteral("38663f1a-e711-4cac-b641-326b56404837");
+constexpr Uuid VOLUME_UUID               = Uuid::FromLiteral("00e4ca9e-ab14-41e4-8823-f9e70c7e91df");
+constexpr Uuid LE_PSM_UUID               = Uuid::FromLiteral("2d410339-82b6-42aa-b34e-e2e01df8cc1a");
 // clang-format on
 
 void hearingaid_gattc_callback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data);
@@ -304,7 +304,7 @@ typedef struct {
 /*data associated with BTA_JV_L2CAP_DATA_IND_EVT if used for LE */
 typedef struct {
   uint32_t handle; /* The connection handle */
-  BT_HDR* p_buf;   /* The incoming data */
+  BT_HDR* p_buf;   /* The incoming data, owned by the receiver */
 } tBTA_JV_LE_DATA_IND;
 
 /* data associated with BTA_JV_RFCOMM_CONG_EVT */
@@ -642,6 +642,20 @@ tBTA_JV_STATUS BTA_JvL2capStopServer(uint16_t local_psm,
 tBTA_JV_STATUS BTA_JvL2capRead(uint32_t handle, uint32_t req_id,
                                uint8_t* p_data, uint16_t len);
 
+/*******************************************************************************
+ *
+ * Function         BTA_JvL2capReadBuf
+ *
+ * Description      This function takes the next SDU received on an L2CAP
+ *                  connection out of its receive queue, without copying it.
+ *                  The caller owns the buffer returned in *pp_buf.
+ *
+ * Returns          BTA_JV_SUCCESS, if an SDU was dequeued.
+ *                  BTA_JV_FAILURE, if there is none, or on error.
+ *
+ ******************************************************************************/
+tBTA_JV_STATUS BTA_JvL2capReadBuf(uint32_t handle, BT_HDR** pp_buf);
+
 /*******************************************************************************
  *
  * Function         BTA_JvL2capReady
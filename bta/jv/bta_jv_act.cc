@@ -2123,18 +2123,19 @@ static void fcchan_data_cbk(uint16_t chan, const RawAddress& bd_addr,
     // try to find an open socked for that addr and channel
     t = fcclient_find_by_addr(tc->clients, &bd_addr);
   }
-  if (!t) {
+  if (!t || !t->p_cback) {
     // no socket -> drop it
+    osi_free(p_buf);
     return;
   }
 
-
   sock_cback = t->p_cback;
   sock_id = t->l2cap_socket_id;
   evt_data.le_data_ind.handle = t->id;
   evt_data.le_data_ind.p_buf = p_buf;
 
-  if (sock_cback) sock_cback(BTA_JV_L2CAP_DATA_IND_EVT, &evt_data, sock_id);
+  // the socket takes ownership of p_buf
+  sock_cback(BTA_JV_L2CAP_DATA_IND_EVT, &evt_data, sock_id);
 }
 
 /** makes an le l2cap client connection */
@@ -441,6 +441,29 @@ tBTA_JV_STATUS BTA_JvL2capRead(uint32_t handle, uint32_t req_id,
   return BTA_JV_SUCCESS;
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_JvL2capReadBuf
+ *
+ * Description      This function takes the next SDU received on an L2CAP
+ *                  connection out of its receive queue, without copying it.
+ *                  The caller owns the buffer returned in *pp_buf.
+ *
+ * Returns          BTA_JV_SUCCESS, if an SDU was dequeued.
+ *                  BTA_JV_FAILURE, if there is none, or on error.
+ *
+ ******************************************************************************/
+tBTA_JV_STATUS BTA_JvL2capReadBuf(uint32_t handle, BT_HDR** pp_buf) {
+  VLOG(2) << __func__;
+
+  if (handle >= BTA_JV_MAX_L2C_CONN || !bta_jv_cb.l2c_cb[handle].p_cback)
+    return BTA_JV_FAILURE;
+
+  if (GAP_ConnBTRead((uint16_t)handle, pp_buf) != BT_PASS)
+    return BTA_JV_FAILURE;
+  return BTA_JV_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         BTA_JvL2capReady
@@ -32,6 +32,7 @@
 #include "bta_api.h"
 #include "bta_sys.h"
 #include "bta_sys_int.h"
+#include "bta_sys_msg_queue.h"
 #include "btm_api.h"
 #include "btu.h"
 #include "osi/include/alarm.h"
@@ -187,7 +188,17 @@ void bta_sys_init(void) {
 #endif
 }
 
+/* messages sent together are handled by a single main thread task */
+static BtaSysMsgQueue* bta_sys_msg_queue(void) {
+  static BtaSysMsgQueue* const msg_queue =
+      new BtaSysMsgQueue(get_main_thread(), bta_sys_event);
+  return msg_queue;
+}
+
 void bta_sys_free(void) {
+  /* the main thread is shut down, the tasks posted for the messages still
+   * queued were dropped */
+  bta_sys_msg_queue()->Reset();
 }
 
 /*******************************************************************************
@@ -515,7 +526,9 @@ bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
  *
  * Description      Send a GKI message to BTA.  This function is designed to
  *                  optimize sending of messages to BTA.  It is called by BTA
- *                  API functions and call-in functions.
+ *                  API functions and call-in functions.  Messages sent in a
+ *                  burst are handled by the same main thread task, see
+ *                  BtaSysMsgQueue.
  *
  *                  TODO (apanicke): Add location object as parameter for easier
  *                  future debugging when doing alarm refactor
@@ -525,10 +538,8 @@ bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
  *
  ******************************************************************************/
 void bta_sys_sendmsg(void* p_msg) {
-  if (do_in_main_thread(
-          FROM_HERE, base::Bind(&bta_sys_event, static_cast<BT_HDR*>(p_msg))) !=
-      BT_STATUS_SUCCESS) {
-    LOG(ERROR) << __func__ << ": do_in_main_thread failed";
+  if (!bta_sys_msg_queue()->Enqueue(FROM_HERE, static_cast<BT_HDR*>(p_msg))) {
+    LOG(ERROR) << __func__ << ": failed to queue message";
   }
 }
 
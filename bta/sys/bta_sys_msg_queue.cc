@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta_sys_msg_queue.h"
+
+#include <string>
+
+#include <base/bind.h>
+
+#include "common/time_util.h"
+#include "osi/include/allocator.h"
+
+using bluetooth::common::MessageLoopThread;
+using bluetooth::common::MetricsHistogram;
+using bluetooth::common::MetricsRegistry;
+using bluetooth::common::time_get_os_boottime_us;
+
+BtaSysMsgQueue::BtaSysMsgQueue(MessageLoopThread* thread, Handler handler)
+    : thread_(thread),
+      handler_(handler),
+      batch_open_(false),
+      batch_post_count_(0),
+      batch_size_histogram_(MetricsRegistry::GetInstance()->GetHistogram(
+          "bta_sys_msg_batch_size")) {
+  delay_histograms_.fill(nullptr);
+}
+
+BtaSysMsgQueue::~BtaSysMsgQueue() {
+  for (const Entry& entry : msgs_) osi_free(entry.p_msg);
+}
+
+void BtaSysMsgQueue::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Entry& entry : msgs_) osi_free(entry.p_msg);
+  msgs_.clear();
+  batch_sizes_.clear();
+  batch_open_ = false;
+}
+
+bool BtaSysMsgQueue::Enqueue(const base::Location& from_here, BT_HDR* p_msg) {
+  Entry entry = {p_msg, time_get_os_boottime_us()};
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Nothing was posted after the task of the newest batch, so handling the
+  // message in that task keeps it ordered with everything else
+  if (batch_open_ && thread_->GetPostCount() == batch_post_count_) {
+    msgs_.push_back(entry);
+    batch_sizes_.back()++;
+    return true;
+  }
+
+  if (!thread_->DoInThread(
+          from_here,
+          base::Bind(&BtaSysMsgQueue::RunBatch, base::Unretained(this)),
+          &batch_post_count_)) {
+    return false;
+  }
+  msgs_.push_back(entry);
+  batch_sizes_.push_back(1);
+  batch_open_ = true;
+  return true;
+}
+
+void BtaSysMsgQueue::RunBatch() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The batch was dropped by Reset()
+    if (batch_sizes_.empty()) return;
+    size_t size = batch_sizes_.front();
+    batch_sizes_.pop_front();
+    if (batch_sizes_.empty()) batch_open_ = false;
+    running_.assign(msgs_.begin(), msgs_.begin() + size);
+    msgs_.erase(msgs_.begin(), msgs_.begin() + size);
+  }
+
+  batch_size_histogram_->Record(running_.size());
+  for (const Entry& entry : running_) {
+    DelayHistogram(entry.p_msg->event >> 8)
+        ->Record(time_get_os_boottime_us() - entry.enqueue_us);
+    handler_(entry.p_msg);
+  }
+  running_.clear();
+}
+
+MetricsHistogram* BtaSysMsgQueue::DelayHistogram(uint8_t id) {
+  if (delay_histograms_[id] == nullptr) {
+    delay_histograms_[id] = MetricsRegistry::GetInstance()->GetHistogram(
+        "bta_sys_msg_delay_us_" + std::to_string(id));
+  }
+  return delay_histograms_[id];
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <base/location.h>
+#include <base/macros.h>
+
+#include "bt_types.h"
+#include "common/message_loop_thread.h"
+#include "common/metrics_registry.h"
+
+/**
+ * Queue of the messages sent to the BTA subsystems.
+ *
+ * Messages sent while the task posted for earlier ones has not started yet
+ * are handled by that same task, so a burst of messages, e.g. from GATT or
+ * AV, costs a single task post. A batch stops taking messages once another
+ * task is posted to the thread through MessageLoopThread::DoInThread(), so
+ * the messages and such tasks posted by a thread still run in the order it
+ * posted them. Tasks posted to the message loop directly, such as delayed
+ * tasks and alarms, are not ordered with the messages.
+ *
+ * The time each message waits in the queue is recorded in the histogram
+ * "bta_sys_msg_delay_us_<id>" of its subsystem, and the number of messages
+ * handled by each task in "bta_sys_msg_batch_size".
+ */
+class BtaSysMsgQueue {
+ public:
+  using Handler = void (*)(BT_HDR* p_msg);
+
+  /**
+   * @param thread thread the messages are handled on
+   * @param handler called on |thread| for each message, in the order they
+   * were sent, and owning the message from then on
+   */
+  BtaSysMsgQueue(bluetooth::common::MessageLoopThread* thread,
+                 Handler handler);
+
+  /**
+   * Frees the messages not handled yet. No task may be pending or running on
+   * the thread
+   */
+  ~BtaSysMsgQueue();
+
+  /**
+   * Queue a message for the handler, can be called from any thread
+   *
+   * @param from_here location where this message is sent from
+   * @param p_msg message to send, owned by the queue if this succeeds
+   * @return true if the message is queued, false if the thread is not running
+   */
+  bool Enqueue(const base::Location& from_here, BT_HDR* p_msg);
+
+  /**
+   * Frees the messages not handled yet and forgets their batches. To be
+   * called once the thread is shut down, as the tasks posted for these
+   * batches were dropped with it; one that still runs finds nothing to do
+   */
+  void Reset();
+
+ private:
+  struct Entry {
+    BT_HDR* p_msg;
+    uint64_t enqueue_us;
+  };
+
+  void RunBatch();
+  bluetooth::common::MetricsHistogram* DelayHistogram(uint8_t id);
+
+  bluetooth::common::MessageLoopThread* const thread_;
+  const Handler handler_;
+
+  std::mutex mutex_;
+  // Messages of the batches whose task has not started yet, oldest first
+  std::deque<Entry> msgs_;
+  std::deque<size_t> batch_sizes_;
+  // Whether the newest batch still takes messages, and the post count of the
+  // thread right after its task was posted
+  bool batch_open_;
+  uint64_t batch_post_count_;
+
+  // Only used on the thread
+  std::vector<Entry> running_;
+  bluetooth::common::MetricsHistogram* const batch_size_histogram_;
+  std::array<bluetooth::common::MetricsHistogram*, 256> delay_histograms_;
+
+  DISALLOW_COPY_AND_ASSIGN(BtaSysMsgQueue);
+};
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <base/bind.h>
+
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bta/sys/bta_sys_msg_queue.h"
+#include "osi/include/allocator.h"
+
+using bluetooth::common::MessageLoopThread;
+using bluetooth::common::MetricsRegistry;
+
+namespace {
+
+std::mutex g_handled_mutex;
+// Event of each message handled, or kTaskEvent for other tasks
+std::vector<uint16_t> g_handled;
+
+constexpr uint16_t kTaskEvent = 0xffff;
+
+void HandleMsg(BT_HDR* p_msg) {
+  {
+    std::lock_guard<std::mutex> lock(g_handled_mutex);
+    g_handled.push_back(p_msg->event);
+  }
+  osi_free(p_msg);
+}
+
+void HandleTask() {
+  std::lock_guard<std::mutex> lock(g_handled_mutex);
+  g_handled.push_back(kTaskEvent);
+}
+
+BT_HDR* NewMsg(uint16_t event) {
+  BT_HDR* p_msg = static_cast<BT_HDR*>(osi_calloc(sizeof(BT_HDR)));
+  p_msg->event = event;
+  return p_msg;
+}
+
+class BtaSysMsgQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_handled.clear();
+    thread_.StartUp();
+  }
+
+  void TearDown() override { thread_.ShutDown(); }
+
+  // Keeps the thread busy until the returned promise is set
+  std::promise<void> BlockThread() {
+    std::promise<void> unblock;
+    std::shared_future<void> unblocked = unblock.get_future().share();
+    thread_.DoInThread(FROM_HERE, base::Bind(
+                                      [](std::shared_future<void> unblocked) {
+                                        unblocked.wait();
+                                      },
+                                      unblocked));
+    return unblock;
+  }
+
+  // Waits for the tasks posted so far to run
+  void Sync() {
+    std::promise<void> done;
+    std::future<void> done_future = done.get_future();
+    thread_.DoInThread(FROM_HERE, base::Bind(
+                                      [](std::promise<void>* done) {
+                                        done->set_value();
+                                      },
+                                      &done));
+    done_future.wait();
+  }
+
+  MessageLoopThread thread_{"bta_sys_msg_queue_test"};
+};
+
+}  // namespace
+
+TEST_F(BtaSysMsgQueueTest, handles_messages_in_order) {
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+  for (uint16_t event = 0; event < 100; event++) {
+    ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(event)));
+  }
+  Sync();
+
+  ASSERT_EQ(g_handled.size(), 100u);
+  for (uint16_t event = 0; event < 100; event++) {
+    ASSERT_EQ(g_handled[event], event);
+  }
+}
+
+TEST_F(BtaSysMsgQueueTest, batches_messages_sent_together) {
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+  std::promise<void> unblock = BlockThread();
+  uint64_t post_count = thread_.GetPostCount();
+
+  for (uint16_t event = 0; event < 10; event++) {
+    ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(event)));
+  }
+  ASSERT_EQ(thread_.GetPostCount(), post_count + 1);
+
+  unblock.set_value();
+  Sync();
+  ASSERT_EQ(g_handled.size(), 10u);
+}
+
+TEST_F(BtaSysMsgQueueTest, keeps_order_with_other_tasks) {
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+  std::promise<void> unblock = BlockThread();
+
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(1)));
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(2)));
+  thread_.DoInThread(FROM_HERE, base::Bind(&HandleTask));
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(3)));
+  unblock.set_value();
+  Sync();
+
+  std::vector<uint16_t> expected = {1, 2, kTaskEvent, 3};
+  ASSERT_EQ(g_handled, expected);
+}
+
+TEST_F(BtaSysMsgQueueTest, reset_drops_pending_batches) {
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+  std::promise<void> unblock = BlockThread();
+
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(1)));
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(2)));
+  // As done once the thread is shut down, with the batch task dropped
+  queue.Reset();
+  unblock.set_value();
+  Sync();
+  ASSERT_TRUE(g_handled.empty());
+
+  // A new message starts a new batch instead of waiting for the dropped one
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(3)));
+  Sync();
+  std::vector<uint16_t> expected = {3};
+  ASSERT_EQ(g_handled, expected);
+}
+
+TEST_F(BtaSysMsgQueueTest, messages_sent_while_handling_wait_for_new_task) {
+  static BtaSysMsgQueue* queue = nullptr;
+  BtaSysMsgQueue resending_queue(&thread_, [](BT_HDR* p_msg) {
+    // The first message sends another one, which must not run before the
+    // task posted after the first message
+    if (p_msg->event == 1) queue->Enqueue(FROM_HERE, NewMsg(3));
+    HandleMsg(p_msg);
+  });
+  queue = &resending_queue;
+  std::promise<void> unblock = BlockThread();
+
+  ASSERT_TRUE(queue->Enqueue(FROM_HERE, NewMsg(1)));
+  ASSERT_TRUE(queue->Enqueue(FROM_HERE, NewMsg(2)));
+  thread_.DoInThread(FROM_HERE, base::Bind(&HandleTask));
+  unblock.set_value();
+  Sync();
+  Sync();
+
+  std::vector<uint16_t> expected = {1, 2, kTaskEvent, 3};
+  ASSERT_EQ(g_handled, expected);
+}
+
+TEST_F(BtaSysMsgQueueTest, keeps_order_of_each_sender) {
+  constexpr int kNumSenders = 4;
+  constexpr uint16_t kNumMessages = 2000;
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+
+  std::vector<std::thread> senders;
+  for (uint16_t sender = 0; sender < kNumSenders; sender++) {
+    senders.emplace_back([&queue, sender]() {
+      for (uint16_t i = 0; i < kNumMessages; i++) {
+        queue.Enqueue(FROM_HERE, NewMsg(sender * kNumMessages + i));
+      }
+    });
+  }
+  for (std::thread& sender : senders) sender.join();
+  Sync();
+
+  ASSERT_EQ(g_handled.size(), kNumSenders * kNumMessages);
+  std::vector<int> last(kNumSenders, -1);
+  for (uint16_t event : g_handled) {
+    int sender = event / kNumMessages;
+    ASSERT_GT(event % kNumMessages, last[sender]);
+    last[sender] = event % kNumMessages;
+  }
+}
+
+TEST_F(BtaSysMsgQueueTest, records_delay_per_subsystem) {
+  auto histogram =
+      MetricsRegistry::GetInstance()->GetHistogram("bta_sys_msg_delay_us_42");
+  int64_t count = histogram->Get().count;
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(42 << 8)));
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg((42 << 8) | 1)));
+  ASSERT_TRUE(queue.Enqueue(FROM_HERE, NewMsg(43 << 8)));
+  Sync();
+
+  ASSERT_EQ(histogram->Get().count, count + 2);
+}
+
+TEST_F(BtaSysMsgQueueTest, fails_when_thread_not_running) {
+  BtaSysMsgQueue queue(&thread_, HandleMsg);
+  thread_.ShutDown();
+
+  BT_HDR* p_msg = NewMsg(1);
+  ASSERT_FALSE(queue.Enqueue(FROM_HERE, p_msg));
+  osi_free(p_msg);
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "gatt/bta_gattc_int.h"
+
+namespace {
+const RawAddress bdaddr1({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress bdaddr2({0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+
+const tGATT_IF client_if1 = 1;
+const tGATT_IF client_if2 = 2;
+}  // namespace
+
+class BtaGattcNotifRegTest : public testing::Test {
+ protected:
+  void SetUp() override { bta_gattc_reset_cb(); }
+  void TearDown() override { bta_gattc_reset_cb(); }
+};
+
+/* Registrations used to live in a fixed array of 15 entries, make sure a
+ * client can now register for more attributes than that */
+TEST_F(BtaGattcNotifRegTest, more_than_fifteen_registrations) {
+  for (uint16_t handle = 1; handle <= 64; handle++) {
+    EXPECT_EQ(GATT_SUCCESS,
+              bta_gattc_add_notif_registration(client_if1, bdaddr1, handle));
+  }
+
+  for (uint16_t handle = 1; handle <= 64; handle++) {
+    EXPECT_TRUE(bta_gattc_check_notif_registry(client_if1, bdaddr1, handle));
+    EXPECT_FALSE(bta_gattc_check_notif_registry(client_if2, bdaddr1, handle));
+    EXPECT_FALSE(bta_gattc_check_notif_registry(client_if1, bdaddr2, handle));
+  }
+  EXPECT_FALSE(bta_gattc_check_notif_registry(client_if1, bdaddr1, 65));
+}
+
+TEST_F(BtaGattcNotifRegTest, register_twice) {
+  EXPECT_EQ(GATT_SUCCESS,
+            bta_gattc_add_notif_registration(client_if1, bdaddr1, 0x0010));
+  EXPECT_EQ(GATT_SUCCESS,
+            bta_gattc_add_notif_registration(client_if1, bdaddr1, 0x0010));
+
+  EXPECT_EQ(GATT_SUCCESS,
+            bta_gattc_remove_notif_registration(client_if1, bdaddr1, 0x0010));
+  EXPECT_FALSE(bta_gattc_check_notif_registry(client_if1, bdaddr1, 0x0010));
+}
+
+/* De-registering only drops the given client, server and handle */
+TEST_F(BtaGattcNotifRegTest, deregister_by_server_and_handle) {
+  for (const RawAddress& bda : {bdaddr1, bdaddr2}) {
+    bta_gattc_add_notif_registration(client_if1, bda, 0x0010);
+    bta_gattc_add_notif_registration(client_if1, bda, 0x0020);
+    bta_gattc_add_notif_registration(client_if2, bda, 0x0010);
+  }
+
+  EXPECT_EQ(GATT_SUCCESS,
+            bta_gattc_remove_notif_registration(client_if1, bdaddr1, 0x0010));
+  EXPECT_FALSE(bta_gattc_check_notif_registry(client_if1, bdaddr1, 0x0010));
+  EXPECT_TRUE(bta_gattc_check_notif_registry(client_if1, bdaddr1, 0x0020));
+  EXPECT_TRUE(bta_gattc_check_notif_registry(client_if2, bdaddr1, 0x0010));
+  EXPECT_TRUE(bta_gattc_check_notif_registry(client_if1, bdaddr2, 0x0010));
+
+  // Not registered any more, unknown handle, unknown server
+  EXPECT_EQ(GATT_ERROR,
+            bta_gattc_remove_notif_registration(client_if1, bdaddr1, 0x0010));
+  EXPECT_EQ(GATT_ERROR,
+            bta_gattc_remove_notif_registration(client_if2, bdaddr1, 0x0020));
+  EXPECT_EQ(GATT_ERROR,
+            bta_gattc_remove_notif_registration(client_if1, RawAddress::kAny,
+                                                0x0010));
+
+  EXPECT_EQ(GATT_SUCCESS,
+            bta_gattc_remove_notif_registration(client_if1, bdaddr1, 0x0020));
+  EXPECT_EQ(GATT_SUCCESS,
+            bta_gattc_remove_notif_registration(client_if2, bdaddr1, 0x0010));
+  // The server goes away with its last registration
+  EXPECT_EQ(1u, bta_gattc_cb.notif_reg.size());
+  EXPECT_EQ(0u, bta_gattc_cb.notif_reg.count(bdaddr1));
+}
+
+TEST_F(BtaGattcNotifRegTest, remove_app_registrations) {
+  for (uint16_t handle = 1; handle <= 20; handle++) {
+    bta_gattc_add_notif_registration(client_if1, bdaddr1, handle);
+    bta_gattc_add_notif_registration(client_if1, bdaddr2, handle);
+  }
+  bta_gattc_add_notif_registration(client_if2, bdaddr2, 0x0005);
+
+  bta_gattc_remove_app_notif_registrations(client_if1);
+
+  for (uint16_t handle = 1; handle <= 20; handle++) {
+    EXPECT_FALSE(bta_gattc_check_notif_registry(client_if1, bdaddr1, handle));
+    EXPECT_FALSE(bta_gattc_check_notif_registry(client_if1, bdaddr2, handle));
+  }
+  EXPECT_TRUE(bta_gattc_check_notif_registry(client_if2, bdaddr2, 0x0005));
+  EXPECT_EQ(1u, bta_gattc_cb.notif_reg.size());
+  EXPECT_EQ(1u, bta_gattc_cb.notif_reg[bdaddr2].size());
+}
+
+/* The control block is reset on the BTA thread while API callers keep
+ * registering, the reset must not race with them */
+TEST_F(BtaGattcNotifRegTest, reset_while_registering) {
+  std::atomic<bool> done(false);
+  std::thread caller([&done]() {
+    while (!done) {
+      for (uint16_t handle = 1; handle <= 32; handle++) {
+        bta_gattc_add_notif_registration(client_if1, bdaddr1, handle);
+        bta_gattc_check_notif_registry(client_if1, bdaddr1, handle);
+      }
+      bta_gattc_remove_app_notif_registrations(client_if1);
+    }
+  });
+
+  for (int i = 0; i < 1000; i++) bta_gattc_reset_cb();
+  done = true;
+  caller.join();
+
+  bta_gattc_reset_cb();
+  EXPECT_TRUE(bta_gattc_cb.notif_reg.empty());
+}
@@ -0,0 +1,388 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <base/logging.h>
+#include <map>
+#include <utility>
+
+#include "gatt/database_builder.h"
+
+using bluetooth::Uuid;
+
+namespace gatt {
+
+namespace {
+
+constexpr std::pair<uint16_t, uint16_t> EXPLORE_END =
+    DatabaseBuilder::EXPLORE_END;
+
+/* make_pair doesn't work well with EXPECT_EQ, have own helper instead */
+inline std::pair<uint16_t, uint16_t> make_pair_u16(uint16_t first,
+                                                   uint16_t second) {
+  return std::make_pair(first, second);
+}
+
+constexpr uint16_t DEFAULT_MTU = 23;
+constexpr uint16_t MAX_MTU = 517;
+
+Uuid PRIMARY_SERVICE = Uuid::From16Bit(0x2800);
+Uuid INCLUDE = Uuid::From16Bit(0x2802);
+Uuid CHARACTERISTIC = Uuid::From16Bit(0x2803);
+Uuid CCC = Uuid::From16Bit(0x2902);
+Uuid REPORT_REFERENCE = Uuid::From16Bit(0x2908);
+
+/* Attribute of the fake server, the value is the service, included service or
+ * characteristic definition depending on the type */
+struct ServerAttribute {
+  Uuid type;
+  const Service* service;
+  const IncludedService* included_service;
+  const Characteristic* characteristic;
+};
+
+size_t UuidSize(const Uuid& uuid) { return uuid.Is16Bit() ? 2 : 16; }
+
+/* ATT server answering the discovery procedures from a known database. Every
+ * response carries as many entries of the same size as fit in the MTU, a
+ * procedure ends with an error response or once the end of the range is
+ * reached, like in BT Spec 5.0 Vol 3, Part G 4.4 - 4.7 */
+class FakeAttServer {
+ public:
+  FakeAttServer(const Database& database, uint16_t mtu) : mtu_(mtu) {
+    for (const Service& service : database.Services()) {
+      attributes_[service.handle] = {PRIMARY_SERVICE, &service};
+      for (const IncludedService& included : service.included_services) {
+        attributes_[included.handle] = {INCLUDE, nullptr, &included};
+      }
+      for (const Characteristic& characteristic : service.characteristics) {
+        attributes_[characteristic.declaration_handle] = {
+            CHARACTERISTIC, nullptr, nullptr, &characteristic};
+        attributes_[characteristic.value_handle] = {characteristic.uuid};
+        for (const Descriptor& descriptor : characteristic.descriptors) {
+          attributes_[descriptor.handle] = {descriptor.uuid};
+        }
+      }
+    }
+  }
+
+  /* Read By Group Type requests for the primary services */
+  void DiscoverServices(DatabaseBuilder& builder) {
+    RunProcedure(
+        HANDLE_MIN, HANDLE_MAX, PRIMARY_SERVICE,
+        [](const ServerAttribute& attr) {
+          return 4 + UuidSize(attr.service->uuid);
+        },
+        [&builder](uint16_t handle, const ServerAttribute& attr) {
+          builder.AddService(handle, attr.service->end_handle,
+                             attr.service->uuid, true);
+          return attr.service->end_handle;
+        });
+  }
+
+  /* Read By Type requests for the includes, and a Read request for each 128
+   * bit service UUID left out of the response */
+  void DiscoverIncludedServices(DatabaseBuilder& builder,
+                                std::pair<uint16_t, uint16_t> range) {
+    RunProcedure(
+        range.first, range.second, INCLUDE,
+        [](const ServerAttribute& attr) {
+          return attr.included_service->uuid.Is16Bit() ? 8 : 6;
+        },
+        [this, &builder](uint16_t handle, const ServerAttribute& attr) {
+          const IncludedService* included = attr.included_service;
+          if (!included->uuid.Is16Bit()) requests_++;
+          builder.AddIncludedService(handle, included->uuid,
+                                     included->start_handle,
+                                     included->end_handle);
+          return handle;
+        });
+  }
+
+  /* Read By Type requests for the characteristic declarations */
+  void DiscoverCharacteristics(DatabaseBuilder& builder,
+                               std::pair<uint16_t, uint16_t> range) {
+    RunProcedure(
+        range.first, range.second, CHARACTERISTIC,
+        [](const ServerAttribute& attr) {
+          return 5 + UuidSize(attr.characteristic->uuid);
+        },
+        [&builder](uint16_t handle, const ServerAttribute& attr) {
+          const Characteristic* characteristic = attr.characteristic;
+          builder.AddCharacteristic(handle, characteristic->value_handle,
+                                    characteristic->uuid,
+                                    characteristic->properties);
+          return handle;
+        });
+  }
+
+  /* Find Information requests, reporting every attribute in the range */
+  void DiscoverDescriptors(DatabaseBuilder& builder,
+                           std::pair<uint16_t, uint16_t> range) {
+    RunProcedure(
+        range.first, range.second, Uuid::kEmpty,
+        [](const ServerAttribute& attr) { return 2 + UuidSize(attr.type); },
+        [&builder](uint16_t handle, const ServerAttribute& attr) {
+          builder.AddDescriptor(handle, attr.type);
+          return handle;
+        });
+  }
+
+  int requests() const { return requests_; }
+
+ private:
+  /* Runs one discovery procedure over |start|..|end| for the attributes of
+   * |type|, any type if empty. |size| returns the length of the response
+   * entry of an attribute, |report| passes it to the builder and returns the
+   * last handle it covers */
+  template <typename SizeFunction, typename ReportFunction>
+  void RunProcedure(uint16_t start, uint16_t end, const Uuid& type,
+                    SizeFunction size, ReportFunction report) {
+    while (true) {
+      requests_++;
+
+      auto it = attributes_.lower_bound(start);
+      auto matches = [&type](const ServerAttribute& attr) {
+        return type.IsEmpty() || attr.type == type;
+      };
+      while (it != attributes_.end() && it->first <= end &&
+             !matches(it->second))
+        it++;
+      /* Attribute Not Found error response */
+      if (it == attributes_.end() || it->first > end) return;
+
+      size_t entry_size = size(it->second);
+      size_t max_entries = (mtu_ - 2) / entry_size;
+      size_t entries = 0;
+      uint32_t last = start;
+      for (; it != attributes_.end() && it->first <= end; it++) {
+        if (!matches(it->second)) continue;
+        if (size(it->second) != entry_size || entries == max_entries) break;
+        last = report(it->first, it->second);
+        entries++;
+      }
+
+      if (last >= end) return;
+      start = last + 1;
+    }
+  }
+
+  uint16_t mtu_;
+  std::map<uint16_t, ServerAttribute> attributes_;
+  int requests_ = 0;
+};
+
+/* Discovery of each service on its own, as still done over BR/EDR */
+int DiscoverPerService(const Database& database, uint16_t mtu,
+                       Database* result) {
+  FakeAttServer server(database, mtu);
+  DatabaseBuilder builder;
+
+  server.DiscoverServices(builder);
+  while (builder.StartNextServiceExploration()) {
+    auto service = builder.CurrentlyExploredService();
+    server.DiscoverIncludedServices(builder, service);
+    server.DiscoverCharacteristics(builder, service);
+    for (auto range = builder.NextDescriptorRangeToExplore();
+         range != EXPLORE_END; range = builder.NextDescriptorRangeToExplore()) {
+      server.DiscoverDescriptors(builder, range);
+    }
+  }
+
+  *result = builder.Build();
+  return server.requests();
+}
+
+/* Discovery over the whole handle range with merged descriptor ranges, the
+ * way it is done over LE */
+int DiscoverWholeRange(const Database& database, uint16_t mtu,
+                       Database* result) {
+  FakeAttServer server(database, mtu);
+  DatabaseBuilder builder;
+  uint16_t max_gap = (mtu - 2) / 8;
+
+  server.DiscoverServices(builder);
+  if (builder.InProgress()) {
+    server.DiscoverIncludedServices(builder, {HANDLE_MIN, HANDLE_MAX});
+    server.DiscoverCharacteristics(builder, {HANDLE_MIN, HANDLE_MAX});
+    for (auto range = builder.NextMergedDescriptorRangeToExplore(max_gap);
+         range != EXPLORE_END;
+         range = builder.NextMergedDescriptorRangeToExplore(max_gap)) {
+      server.DiscoverDescriptors(builder, range);
+    }
+  }
+
+  *result = builder.Build();
+  return server.requests();
+}
+
+/* Daydream controller, same content as in the sample device test */
+Database SampleDevice() {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x0007, Uuid::From16Bit(0x1800), true);
+  builder.AddCharacteristic(0x0002, 0x0003, Uuid::From16Bit(0x2a00), 0x02);
+  builder.AddCharacteristic(0x0004, 0x0005, Uuid::From16Bit(0x2a01), 0x02);
+  builder.AddCharacteristic(0x0006, 0x0007, Uuid::From16Bit(0x2a04), 0x02);
+
+  builder.AddService(0x0008, 0x0008, Uuid::From16Bit(0x1801), true);
+
+  builder.AddService(0x0009, 0x000c, Uuid::From16Bit(0x180f), true);
+  builder.AddCharacteristic(0x000a, 0x000b, Uuid::From16Bit(0x2a19), 0x12);
+  builder.AddDescriptor(0x000c, CCC);
+
+  builder.AddService(0x000d, 0x001a, Uuid::From16Bit(0xfef5), true);
+  builder.AddCharacteristic(
+      0x000e, 0x000f,
+      Uuid::FromString("8082caa8-41a6-4021-91c6-56f9b954cc34"), 0x0a);
+  builder.AddCharacteristic(
+      0x0010, 0x0011,
+      Uuid::FromString("724249f0-5ec3-4b5f-8804-42345af08651"), 0x0a);
+  builder.AddCharacteristic(
+      0x0012, 0x0013,
+      Uuid::FromString("6c53db25-47a1-45fe-a022-7c92fb334fd4"), 0x02);
+  builder.AddCharacteristic(
+      0x0014, 0x0015,
+      Uuid::FromString("9d84b9a3-000c-49d8-9183-855b673fda31"), 0x0a);
+  builder.AddCharacteristic(
+      0x0016, 0x0017,
+      Uuid::FromString("457871e8-d516-4ca1-9116-57d0b17b9cb2"), 0x0e);
+  builder.AddCharacteristic(
+      0x0018, 0x0019,
+      Uuid::FromString("5f78df94-798c-46f5-990a-b3eb6a065c88"), 0x12);
+  builder.AddDescriptor(0x001a, CCC);
+
+  builder.AddService(0x001b, 0x0029, Uuid::From16Bit(0x180a), true);
+  builder.AddCharacteristic(0x001c, 0x001d, Uuid::From16Bit(0x2a29), 0x02);
+  builder.AddCharacteristic(0x001e, 0x001f, Uuid::From16Bit(0x2a24), 0x02);
+  builder.AddCharacteristic(0x0020, 0x0021, Uuid::From16Bit(0x2a25), 0x02);
+  builder.AddCharacteristic(0x0022, 0x0023, Uuid::From16Bit(0x2a27), 0x02);
+  builder.AddCharacteristic(0x0024, 0x0025, Uuid::From16Bit(0x2a26), 0x02);
+  builder.AddCharacteristic(0x0026, 0x0027, Uuid::From16Bit(0x2a28), 0x02);
+  builder.AddCharacteristic(0x0028, 0x0029, Uuid::From16Bit(0x2a50), 0x02);
+
+  builder.AddService(0x002a, 0x0031, Uuid::From16Bit(0xfe55), true);
+  builder.AddCharacteristic(
+      0x002b, 0x002c,
+      Uuid::FromString("00000001-1000-1000-8000-00805f9b34fb"), 0x10);
+  builder.AddDescriptor(0x002d, CCC);
+  builder.AddCharacteristic(
+      0x002e, 0x002f,
+      Uuid::FromString("00000002-1000-1000-8000-00805f9b34fb"), 0x08);
+  builder.AddCharacteristic(
+      0x0030, 0x0031,
+      Uuid::FromString("00000003-1000-1000-8000-00805f9b34fb"), 0x02);
+  return builder.Build();
+}
+
+/* HID keyboard with many small descriptor ranges: a Battery Service included
+ * by the HID Service, input reports with a CCC and a Report Reference */
+Database HidDevice() {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x0005, Uuid::From16Bit(0x1800), true);
+  builder.AddCharacteristic(0x0002, 0x0003, Uuid::From16Bit(0x2a00), 0x02);
+  builder.AddCharacteristic(0x0004, 0x0005, Uuid::From16Bit(0x2a01), 0x02);
+
+  builder.AddService(0x0006, 0x0009, Uuid::From16Bit(0x180f), true);
+  builder.AddCharacteristic(0x0007, 0x0008, Uuid::From16Bit(0x2a19), 0x12);
+  builder.AddDescriptor(0x0009, CCC);
+
+  builder.AddService(0x000a, 0x0032, Uuid::From16Bit(0x1812), true);
+  builder.AddIncludedService(0x000b, Uuid::From16Bit(0x180f), 0x0006, 0x0009);
+  builder.AddCharacteristic(0x000c, 0x000d, Uuid::From16Bit(0x2a4a), 0x02);
+  builder.AddCharacteristic(0x000e, 0x000f, Uuid::From16Bit(0x2a4b), 0x02);
+  builder.AddCharacteristic(0x0010, 0x0011, Uuid::From16Bit(0x2a4c), 0x04);
+  builder.AddCharacteristic(0x0012, 0x0013, Uuid::From16Bit(0x2a4e), 0x06);
+  uint16_t handle = 0x0014;
+  for (int report = 0; report < 7; report++, handle += 4) {
+    builder.AddCharacteristic(handle, handle + 1, Uuid::From16Bit(0x2a4d),
+                              0x1a);
+    builder.AddDescriptor(handle + 2, CCC);
+    builder.AddDescriptor(handle + 3, REPORT_REFERENCE);
+  }
+  builder.AddCharacteristic(handle, handle + 1, Uuid::From16Bit(0x2a4d), 0x0e);
+  builder.AddDescriptor(handle + 2, REPORT_REFERENCE);
+  return builder.Build();
+}
+
+void ExpectSameDatabaseInFewerRequests(const Database& database,
+                                       uint16_t mtu) {
+  Database per_service, whole_range;
+  int per_service_requests = DiscoverPerService(database, mtu, &per_service);
+  int whole_range_requests = DiscoverWholeRange(database, mtu, &whole_range);
+
+  EXPECT_EQ(per_service.ToString(), database.ToString());
+  EXPECT_EQ(whole_range.ToString(), database.ToString());
+  EXPECT_LT(whole_range_requests, per_service_requests);
+  LOG(INFO) << "mtu " << mtu << ": " << per_service_requests
+            << " requests per service, " << whole_range_requests
+            << " requests over the whole range";
+}
+
+}  // namespace
+
+TEST(DatabaseBuilderDiscoveryTest, SampleDeviceDefaultMtu) {
+  ExpectSameDatabaseInFewerRequests(SampleDevice(), DEFAULT_MTU);
+}
+
+TEST(DatabaseBuilderDiscoveryTest, SampleDeviceMaxMtu) {
+  ExpectSameDatabaseInFewerRequests(SampleDevice(), MAX_MTU);
+}
+
+TEST(DatabaseBuilderDiscoveryTest, HidDeviceDefaultMtu) {
+  ExpectSameDatabaseInFewerRequests(HidDevice(), DEFAULT_MTU);
+}
+
+TEST(DatabaseBuilderDiscoveryTest, HidDeviceMaxMtu) {
+  ExpectSameDatabaseInFewerRequests(HidDevice(), MAX_MTU);
+}
+
+/* Ranges are merged over a gap of known 16 bit attributes only */
+TEST(DatabaseBuilderDiscoveryTest, MergedDescriptorRanges) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x0020, Uuid::From16Bit(0x1812), true);
+  builder.AddCharacteristic(0x0002, 0x0003, Uuid::From16Bit(0x2a4d), 0x1a);
+  builder.AddCharacteristic(0x0005, 0x0006, Uuid::From16Bit(0x2a4d), 0x1a);
+  builder.AddCharacteristic(
+      0x0008, 0x0009, Uuid::FromString("00000001-1000-1000-8000-00805f9b34fb"),
+      0x1a);
+  builder.AddCharacteristic(0x0010, 0x0011, Uuid::From16Bit(0x2a4d), 0x1a);
+
+  EXPECT_EQ(builder.NextMergedDescriptorRangeToExplore(2),
+            make_pair_u16(0x0004, 0x0007));
+  /* the declaration and value of 0x0010 are a gap of 2 attributes */
+  EXPECT_EQ(builder.NextMergedDescriptorRangeToExplore(1),
+            make_pair_u16(0x000a, 0x000f));
+  EXPECT_EQ(builder.NextMergedDescriptorRangeToExplore(1),
+            make_pair_u16(0x0012, 0x0020));
+  EXPECT_EQ(builder.NextMergedDescriptorRangeToExplore(1), EXPLORE_END);
+
+  /* declarations and values reported inside a merged range are skipped */
+  builder.AddDescriptor(0x0004, CCC);
+  builder.AddDescriptor(0x0005, CHARACTERISTIC);
+  builder.AddDescriptor(0x0006, Uuid::From16Bit(0x2a4d));
+  builder.AddDescriptor(0x0007, REPORT_REFERENCE);
+  Database result = builder.Build();
+  const Service& service = result.Services().front();
+  ASSERT_EQ(service.characteristics[0].descriptors.size(), 1u);
+  EXPECT_EQ(service.characteristics[0].descriptors[0].handle, 0x0004);
+  ASSERT_EQ(service.characteristics[1].descriptors.size(), 1u);
+  EXPECT_EQ(service.characteristics[1].descriptors[0].handle, 0x0007);
+}
+
+}  // namespace gatt
@@ -20,6 +20,8 @@
 
 #include <stdbool.h>
 
+#include <chrono>
+
 #include "common/message_loop_thread.h"
 #include "osi/include/future.h"
 #include "osi/include/thread.h"
@@ -58,6 +60,22 @@ void module_shut_down(const module_t* module);
 // If not initialized, does nothing.
 void module_clean_up(const module_t* module);
 
+// Starts up the provided module on a separate thread and returns a future
+// which is resolved with |FUTURE_SUCCESS| or |FUTURE_FAIL| once start up has
+// finished. Lets the caller do independent work while a slow module (e.g. the
+// HCI layer waiting for firmware download) is starting.
+future_t* module_start_up_async(const module_t* module);
+
+// Records a startup step which is not a module lifecycle function (e.g. BTU
+// start up, or a single HCI command) in the startup timeline. Module
+// lifecycle functions are recorded automatically.
+void module_timeline_record(const char* name, const char* phase,
+                            std::chrono::steady_clock::time_point begin,
+                            std::chrono::steady_clock::time_point end);
+
+// Dumps the most recent lifecycle and startup step timings to |fd|.
+void module_timeline_dump(int fd);
+
 // Temporary callbacked wrapper for module start up, so real modules can be
 // spliced into the current janky startup sequence. Runs on a separate thread,
 // which terminates when the module start up has finished. When module startup
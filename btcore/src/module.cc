@@ -22,7 +22,11 @@
 #include <dlfcn.h>
 #include <string.h>
 
+#include <chrono>
+#include <deque>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "btcore/include/module.h"
@@ -44,7 +48,21 @@ static std::unordered_map<const module_t*, module_state_t> metadata;
 // TODO(jamuraa): remove this lock after the startup sequence is clean
 static std::mutex metadata_mutex;
 
-static bool call_lifecycle_function(module_lifecycle_fn function);
+typedef struct {
+  std::string name;
+  const char* phase;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+  std::thread::id thread;
+} timeline_entry_t;
+
+// Only the most recent entries are kept, which covers a full enable sequence
+static const size_t MAX_TIMELINE_ENTRIES = 128;
+static std::deque<timeline_entry_t> timeline;
+static std::mutex timeline_mutex;
+
+static bool call_lifecycle_function(const module_t* module, const char* phase,
+                                    module_lifecycle_fn function);
 static module_state_t get_module_state(const module_t* module);
 static void set_module_state(const module_t* module, module_state_t state);
 
@@ -64,7 +82,7 @@ bool module_init(const module_t* module) {
   CHECK(module != NULL);
   CHECK(get_module_state(module) == MODULE_STATE_NONE);
 
-  if (!call_lifecycle_function(module->init)) {
+  if (!call_lifecycle_function(module, "init", module->init)) {
     LOG_ERROR(LOG_TAG, "%s Failed to initialize module \"%s\"", __func__,
               module->name);
     return false;
@@ -85,7 +103,7 @@ bool module_start_up(const module_t* module) {
         module->init == NULL);
 
   LOG_INFO(LOG_TAG, "%s Starting module \"%s\"", __func__, module->name);
-  if (!call_lifecycle_function(module->start_up)) {
+  if (!call_lifecycle_function(module, "start_up", module->start_up)) {
     LOG_ERROR(LOG_TAG, "%s Failed to start up module \"%s\"", __func__,
               module->name);
     return false;
@@ -105,7 +123,7 @@ void module_shut_down(const module_t* module) {
   if (state < MODULE_STATE_STARTED) return;
 
   LOG_INFO(LOG_TAG, "%s Shutting down module \"%s\"", __func__, module->name);
-  if (!call_lifecycle_function(module->shut_down)) {
+  if (!call_lifecycle_function(module, "shut_down", module->shut_down)) {
     LOG_ERROR(LOG_TAG,
               "%s Failed to shutdown module \"%s\". Continuing anyway.",
               __func__, module->name);
@@ -125,7 +143,7 @@ void module_clean_up(const module_t* module) {
   if (state < MODULE_STATE_INITIALIZED) return;
 
   LOG_INFO(LOG_TAG, "%s Cleaning up module \"%s\"", __func__, module->name);
-  if (!call_lifecycle_function(module->clean_up)) {
+  if (!call_lifecycle_function(module, "clean_up", module->clean_up)) {
     LOG_ERROR(LOG_TAG, "%s Failed to cleanup module \"%s\". Continuing anyway.",
               __func__, module->name);
   }
@@ -135,17 +153,61 @@ void module_clean_up(const module_t* module) {
   set_module_state(module, MODULE_STATE_NONE);
 }
 
-static bool call_lifecycle_function(module_lifecycle_fn function) {
+static bool call_lifecycle_function(const module_t* module, const char* phase,
+                                    module_lifecycle_fn function) {
   // A NULL lifecycle function means it isn't needed, so assume success
   if (!function) return true;
 
+  auto begin = std::chrono::steady_clock::now();
   future_t* future = function();
 
-  // A NULL future means synchronous success
-  if (!future) return true;
+  // A NULL future means synchronous success, otherwise fall back to the future
+  bool success = !future || future_await(future);
+  module_timeline_record(module->name, phase, begin,
+                         std::chrono::steady_clock::now());
+  return success;
+}
 
-  // Otherwise fall back to the future
-  return future_await(future);
+future_t* module_start_up_async(const module_t* module) {
+  CHECK(module != NULL);
+  future_t* future = future_new();
+  std::thread([module, future]() {
+    bool success = module_start_up(module);
+    future_ready(future, success ? FUTURE_SUCCESS : FUTURE_FAIL);
+  }).detach();
+  return future;
+}
+
+void module_timeline_record(const char* name, const char* phase,
+                            std::chrono::steady_clock::time_point begin,
+                            std::chrono::steady_clock::time_point end) {
+  std::lock_guard<std::mutex> lock(timeline_mutex);
+  if (timeline.size() == MAX_TIMELINE_ENTRIES) timeline.pop_front();
+  timeline.push_back({name, phase, begin, end, std::this_thread::get_id()});
+}
+
+void module_timeline_dump(int fd) {
+  std::lock_guard<std::mutex> lock(timeline_mutex);
+  dprintf(fd, "\nStartup timeline (%zu entries):\n", timeline.size());
+  if (timeline.empty()) return;
+
+  auto origin = timeline.front().begin;
+  for (const auto& entry : timeline) {
+    if (entry.begin < origin) origin = entry.begin;
+  }
+  std::unordered_map<std::thread::id, size_t> thread_index;
+  for (const auto& entry : timeline) {
+    auto offset_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                         entry.begin - origin)
+                         .count();
+    auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           entry.end - entry.begin)
+                           .count();
+    size_t thread = thread_index.emplace(entry.thread, thread_index.size())
+                        .first->second;
+    dprintf(fd, "  +%10.3f ms %10.3f ms  T%zu  %-10s %s\n", offset_us / 1000.0,
+            duration_us / 1000.0, thread, entry.phase, entry.name.c_str());
+  }
 }
 
 static module_state_t get_module_state(const module_t* module) {
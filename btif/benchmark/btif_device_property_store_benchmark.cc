@@ -0,0 +1,247 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "btif/include/btif_config_cache.h"
+#include "btif/include/btif_device_property_store.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kCapacity = 10000;
+constexpr uint8_t kNumDevices = 100;
+constexpr size_t kKeySize = 16;
+constexpr size_t kLeKeySize = 28;
+constexpr int kDevTypeBredr = 1;
+constexpr int kDevTypeBle = 2;
+
+const char* kLeKeys[] = {"LE_KEY_PENC", "LE_KEY_PID",  "LE_KEY_LID",
+                         "LE_KEY_PCSRK", "LE_KEY_LENC", "LE_KEY_LCSRK"};
+const DeviceProperty kLeKeyProperties[] = {
+    DeviceProperty::LE_KEY_PENC,  DeviceProperty::LE_KEY_PID,
+    DeviceProperty::LE_KEY_LID,   DeviceProperty::LE_KEY_PCSRK,
+    DeviceProperty::LE_KEY_LENC,  DeviceProperty::LE_KEY_LCSRK};
+
+RawAddress device_address(uint8_t index) {
+  return RawAddress({0x00, 0x1b, 0xdc, 0x40, 0x00, index});
+}
+
+std::string hex_string(size_t length, uint8_t seed) {
+  static const char* lookup = "0123456789abcdef";
+  std::string str;
+  for (size_t i = 0; i < length; i++) {
+    uint8_t byte = seed + i;
+    str.push_back(lookup[byte >> 4]);
+    str.push_back(lookup[byte & 0x0F]);
+  }
+  return str;
+}
+
+// A config file of kNumDevices bonded devices, half of them LE only
+config_t make_config() {
+  config_t config;
+  config.sections.push_back({"Info", {{"TimeCreated", "2020-06-05 12:12:12"}}});
+  config.sections.push_back({"Metrics", {{"Salt256Bit", hex_string(32, 0)}}});
+  config.sections.push_back({"Adapter",
+                             {{"Address", "00:11:22:33:44:55"},
+                              {"LE_LOCAL_KEY_IRK", hex_string(kKeySize, 1)},
+                              {"ScanMode", "1"}}});
+  for (uint8_t i = 0; i < kNumDevices; i++) {
+    section_t section;
+    section.name = device_address(i).ToString();
+    section.entries = {{"Name", "Device " + std::to_string(i)},
+                       {"DevClass", "2360344"},
+                       {"Timestamp", "1591358532"},
+                       {"Manufacturer", "15"},
+                       {"LmpVer", "8"},
+                       {"LmpSubVer", "8716"},
+                       {"MetricsId", std::to_string(i + 1)},
+                       {"Service", "0000110b-0000-1000-8000-00805f9b34fb "
+                                   "0000110e-0000-1000-8000-00805f9b34fb"}};
+    if (i % 2 == 0) {
+      section.entries.push_back({"DevType", std::to_string(kDevTypeBredr)});
+      section.entries.push_back({"LinkKey", hex_string(kKeySize, i)});
+      section.entries.push_back({"LinkKeyType", "5"});
+      section.entries.push_back({"PinLength", "0"});
+    } else {
+      section.entries.push_back({"DevType", std::to_string(kDevTypeBle)});
+      section.entries.push_back({"AddrType", "1"});
+      for (const char* key : kLeKeys) {
+        section.entries.push_back({key, hex_string(kLeKeySize, i)});
+      }
+    }
+    config.sections.push_back(std::move(section));
+  }
+  return config;
+}
+
+// The value decoding done by btif_config_get_bin
+bool decode_hex(const std::string& value_str, uint8_t* value, size_t* length) {
+  size_t value_len = value_str.length();
+  if ((value_len % 2) != 0 || *length < (value_len / 2)) return false;
+  for (size_t i = 0; i < value_len; ++i) {
+    if (!isxdigit(value_str[i])) return false;
+  }
+  const char* ptr = value_str.c_str();
+  for (*length = 0; *ptr; ptr += 2, *length += 1) {
+    sscanf(ptr, "%02hhx", &value[*length]);
+  }
+  return true;
+}
+
+bool string_get_bin(BtifConfigCache& cache, const std::string& section,
+                    const std::string& key, uint8_t* value, size_t* length) {
+  auto value_str = cache.GetString(section, key);
+  return value_str && decode_hex(*value_str, value, length);
+}
+
+// What btif_in_fetch_bonded_devices did per device, with a section name
+void string_load_device(BtifConfigCache& cache, const std::string& name) {
+  uint8_t key[kLeKeySize];
+  size_t length = kKeySize;
+  if (string_get_bin(cache, name, "LinkKey", key, &length)) {
+    benchmark::DoNotOptimize(cache.GetInt(name, "LinkKeyType"));
+    benchmark::DoNotOptimize(cache.GetInt(name, "DevClass"));
+    benchmark::DoNotOptimize(cache.GetInt(name, "PinLength"));
+    benchmark::DoNotOptimize(cache.GetInt(name, "DevType"));
+  }
+
+  auto device_type = cache.GetInt(name, "DevType");
+  if (!device_type) return;
+  if ((*device_type & kDevTypeBle) || cache.HasKey(name, "LE_KEY_PENC")) {
+    RawAddress bd_addr;
+    RawAddress::FromString(name, bd_addr);
+    // the LE keys are read through btif_storage with the address
+    benchmark::DoNotOptimize(cache.GetInt(bd_addr.ToString(), "AddrType"));
+    for (const char* le_key : kLeKeys) {
+      length = sizeof(key);
+      string_get_bin(cache, bd_addr.ToString(), le_key, key, &length);
+      benchmark::DoNotOptimize(key);
+    }
+  }
+}
+
+void typed_load_device(BtifDevicePropertyStore& store,
+                       const RawAddress& bd_addr) {
+  uint8_t key[kLeKeySize];
+  size_t length = kKeySize;
+  if (store.GetBin(bd_addr, DeviceProperty::LINK_KEY, key, &length)) {
+    benchmark::DoNotOptimize(
+        store.GetInt(bd_addr, DeviceProperty::LINK_KEY_TYPE));
+    benchmark::DoNotOptimize(store.GetInt(bd_addr, DeviceProperty::DEV_CLASS));
+    benchmark::DoNotOptimize(
+        store.GetInt(bd_addr, DeviceProperty::PIN_LENGTH));
+    benchmark::DoNotOptimize(store.GetInt(bd_addr, DeviceProperty::DEV_TYPE));
+  }
+
+  auto device_type = store.GetInt(bd_addr, DeviceProperty::DEV_TYPE);
+  if (!device_type) return;
+  if ((*device_type & kDevTypeBle) ||
+      store.HasProperty(bd_addr, DeviceProperty::LE_KEY_PENC)) {
+    benchmark::DoNotOptimize(store.GetInt(bd_addr, DeviceProperty::ADDR_TYPE));
+    for (DeviceProperty property : kLeKeyProperties) {
+      length = sizeof(key);
+      store.GetBin(bd_addr, property, key, &length);
+      benchmark::DoNotOptimize(key);
+    }
+  }
+}
+
+}  // namespace
+
+// Bonded device load at start up: config file sections to the cache, then the
+// link keys and LE keys of every device
+static void BM_BondedDeviceLoad_StringSections(State& state) {
+  config_t config = make_config();
+  for (auto _ : state) {
+    BtifConfigCache cache(kCapacity);
+    cache.Init(std::make_unique<config_t>(config));
+    for (const section_t& section : cache.GetPersistentSections()) {
+      if (!RawAddress::IsValidAddress(section.name)) continue;
+      string_load_device(cache, section.name);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumDevices);
+}
+BENCHMARK(BM_BondedDeviceLoad_StringSections);
+
+static void BM_BondedDeviceLoad_PropertyStore(State& state) {
+  config_t config = make_config();
+  for (auto _ : state) {
+    BtifDevicePropertyStore store(kCapacity);
+    BtifConfigCache cache(kCapacity);
+    auto local_config = std::make_unique<config_t>(config);
+    store.Load(local_config.get());
+    cache.Init(std::move(local_config));
+    for (const RawAddress& bd_addr : store.GetPersistentDevices()) {
+      typed_load_device(store, bd_addr);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumDevices);
+}
+BENCHMARK(BM_BondedDeviceLoad_PropertyStore);
+
+// Lookups on reconnection of a bonded LE device: device and address type,
+// encryption key, name, then the timestamp update
+static void BM_Reconnect_StringSections(State& state) {
+  BtifConfigCache cache(kCapacity);
+  cache.Init(std::make_unique<config_t>(make_config()));
+  uint8_t index = 1;
+  for (auto _ : state) {
+    RawAddress bd_addr = device_address(index);
+    benchmark::DoNotOptimize(cache.GetInt(bd_addr.ToString(), "DevType"));
+    benchmark::DoNotOptimize(cache.GetInt(bd_addr.ToString(), "AddrType"));
+    uint8_t key[kLeKeySize];
+    size_t length = sizeof(key);
+    string_get_bin(cache, bd_addr.ToString(), "LE_KEY_PENC", key, &length);
+    benchmark::DoNotOptimize(key);
+    benchmark::DoNotOptimize(cache.GetString(bd_addr.ToString(), "Name"));
+    cache.SetInt(bd_addr.ToString(), "Timestamp", 1591358532);
+    index = (index + 2) % kNumDevices;
+  }
+}
+BENCHMARK(BM_Reconnect_StringSections);
+
+static void BM_Reconnect_PropertyStore(State& state) {
+  BtifDevicePropertyStore store(kCapacity);
+  config_t config = make_config();
+  store.Load(&config);
+  uint8_t index = 1;
+  for (auto _ : state) {
+    RawAddress bd_addr = device_address(index);
+    benchmark::DoNotOptimize(store.GetInt(bd_addr, DeviceProperty::DEV_TYPE));
+    benchmark::DoNotOptimize(store.GetInt(bd_addr, DeviceProperty::ADDR_TYPE));
+    uint8_t key[kLeKeySize];
+    size_t length = sizeof(key);
+    store.GetBin(bd_addr, DeviceProperty::LE_KEY_PENC, key, &length);
+    benchmark::DoNotOptimize(key);
+    benchmark::DoNotOptimize(store.GetString(bd_addr, DeviceProperty::NAME));
+    store.SetInt(bd_addr, DeviceProperty::TIMESTAMP, 1591358532);
+    index = (index + 2) % kNumDevices;
+  }
+}
+BENCHMARK(BM_Reconnect_PropertyStore);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <base/bind.h>
+#include <base/message_loop/message_loop.h>
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include "btif/include/btif_gatt_notify_batcher.h"
+#include "common/message_loop_thread.h"
+
+using ::benchmark::State;
+using bluetooth::common::MessageLoopThread;
+
+namespace {
+
+// Duration of the notification stream sent by the fake server per iteration
+constexpr std::chrono::milliseconds kStreamDuration(100);
+constexpr uint16_t kValueSize = 20;
+constexpr int kConnId = 3;
+constexpr uint64_t kBatchWindowMs = 5;
+constexpr size_t kMaxBatchSize = 32;
+const RawAddress kServer = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+
+// Work done by the app layer per notification, e.g. JNI array conversion
+volatile uint64_t g_app_checksum = 0;
+
+void app_handle_value(uint16_t handle, const uint8_t* value, uint16_t len) {
+  uint64_t sum = handle;
+  for (uint16_t i = 0; i < len; i++) sum += value[i];
+  g_app_checksum = g_app_checksum + sum;
+}
+
+}  // namespace
+
+class BM_GattNotifyDelivery : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    jni_thread_ = std::make_unique<MessageLoopThread>("bt_fake_jni_thread");
+    jni_thread_->StartUp();
+  }
+
+  void TearDown(State& st) override {
+    jni_thread_->ShutDown();
+    jni_thread_.reset();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void PostToJniThread(std::function<void()> task, uint64_t delay_ms) {
+    jni_thread_->message_loop()->task_runner()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(
+            [](std::atomic<uint64_t>* hops, const std::function<void()>& task) {
+              (*hops)++;
+              task();
+            },
+            &hops_, std::move(task)),
+        base::TimeDelta::FromMilliseconds(delay_ms));
+  }
+
+  // Fake GATT server: sends |rate| notifications per second for
+  // kStreamDuration, then waits until the app layer received all of them
+  template <typename SendFunction>
+  void RunStream(State& state, SendFunction send) {
+    uint64_t total_notifications = 0;
+    uint64_t total_hops = 0;
+    uint64_t rate = state.range(0);
+    size_t notifications = rate * kStreamDuration.count() / 1000;
+    auto interval = std::chrono::nanoseconds(1000000000 / rate);
+    uint8_t value[kValueSize];
+    for (auto _ : state) {
+      delivered_ = 0;
+      hops_ = 0;
+      all_delivered_ = std::promise<void>();
+      expected_ = notifications;
+      auto next = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < notifications; i++) {
+        std::this_thread::sleep_until(next);
+        next += interval;
+        memset(value, i, sizeof(value));
+        send(static_cast<uint16_t>(0x20 + i % 4), value, kValueSize);
+      }
+      all_delivered_.get_future().wait();
+      total_notifications += notifications;
+      total_hops += hops_;
+    }
+    state.SetItemsProcessed(total_notifications);
+    state.counters["hops_per_notification"] =
+        static_cast<double>(total_hops) / total_notifications;
+  }
+
+  // Waits until the tasks posted with up to |delay_ms| have run
+  void WaitForPostedTasks(uint64_t delay_ms) {
+    std::promise<void> done;
+    PostToJniThread([&done] { done.set_value(); }, delay_ms);
+    done.get_future().wait();
+  }
+
+  void OnDelivered(size_t count) {
+    delivered_ += count;
+    if (delivered_ == expected_) all_delivered_.set_value();
+  }
+
+  std::unique_ptr<MessageLoopThread> jni_thread_;
+  std::atomic<uint64_t> hops_{0};
+  // Only accessed on the JNI thread while a stream runs
+  size_t delivered_ = 0;
+  size_t expected_ = 0;
+  std::promise<void> all_delivered_;
+};
+
+// Previous path: one context switch and one notify_cb per notification
+BENCHMARK_DEFINE_F(BM_GattNotifyDelivery, per_notification)(State& state) {
+  RunStream(state, [this](uint16_t handle, const uint8_t* value,
+                          uint16_t len) {
+    btgatt_notify_params_t params;
+    params.bda = kServer;
+    params.handle = handle;
+    params.len = len;
+    params.is_notify = true;
+    memcpy(params.value, value, len);
+    PostToJniThread(
+        [this, params] {
+          app_handle_value(params.handle, params.value, params.len);
+          OnDelivered(1);
+        },
+        0);
+  });
+}
+BENCHMARK_REGISTER_F(BM_GattNotifyDelivery, per_notification)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_GattNotifyDelivery, batched)(State& state) {
+  BtifGattNotifyBatcher batcher(
+      kBatchWindowMs, kMaxBatchSize,
+      [this](std::function<void()> task, uint64_t delay_ms) {
+        PostToJniThread(std::move(task), delay_ms);
+      },
+      [this](int /* conn_id */, const btgatt_notify_batch_t& batch) {
+        for (const auto& entry : batch.entries) {
+          app_handle_value(entry.handle, batch.values.data() + entry.offset,
+                           entry.len);
+        }
+        OnDelivered(batch.entries.size());
+      });
+  RunStream(state,
+            [&batcher](uint16_t handle, const uint8_t* value, uint16_t len) {
+              batcher.Add(kConnId, kServer, handle, value, len);
+            });
+  // Window timeouts of batches delivered early still refer to the batcher
+  WaitForPostedTasks(kBatchWindowMs);
+}
+BENCHMARK_REGISTER_F(BM_GattNotifyDelivery, batched)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(10000)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,245 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "btif/include/btif_sock_l2cap_rx_queue.h"
+#include "osi/include/allocator.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kSocketCount = 256;
+// SDUs received per socket between two write ready signals, e.g. a file
+// transfer over CoC
+constexpr size_t kSdusPerRound = 8;
+constexpr uint16_t kSduSize = 512;
+constexpr size_t kMaxRxBuffer = 0x100000;
+
+// The copy of a received SDU made by the former socket layer
+struct packet {
+  struct packet *next, *prev;
+  uint32_t len;
+  uint8_t* data;
+};
+
+struct FakeSocket {
+  FakeSocket* next;  // list used for the lookups before
+  uint32_t id;
+  int our_fd;
+  int app_fd;
+  // former receive queue
+  packet* first_packet;
+  packet* last_packet;
+  // current receive queue
+  BtifSockL2capRxQueue rx_queue{kMaxRxBuffer};
+};
+
+// Reads everything delivered to |fd|
+size_t app_read(int fd) {
+  uint8_t record[kSduSize * kSdusPerRound];
+  size_t total = 0;
+  ssize_t len;
+  while ((len = recv(fd, record, sizeof(record), MSG_DONTWAIT)) > 0) {
+    total += len;
+  }
+  return total;
+}
+
+class SocketSet {
+ public:
+  SocketSet() : sockets_(kSocketCount) {
+    FakeSocket* head = nullptr;
+    for (size_t i = 0; i < kSocketCount; i++) {
+      FakeSocket* sock = &sockets_[i];
+      int fds[2];
+      socketpair(AF_LOCAL, SOCK_SEQPACKET, 0, fds);
+      sock->our_fd = fds[0];
+      sock->app_fd = fds[1];
+      // Ids of sockets opened and closed over time
+      sock->id = 1 + i * 7;
+      sock->first_packet = sock->last_packet = nullptr;
+      sock->next = head;
+      head = sock;
+      by_id_[sock->id] = sock;
+    }
+    list_ = head;
+
+    // Events spread over all the connections
+    std::mt19937 random(42);
+    for (size_t i = 0; i < kSocketCount; i++) {
+      event_ids_.push_back(sockets_[random() % kSocketCount].id);
+    }
+  }
+
+  ~SocketSet() {
+    for (auto& sock : sockets_) {
+      close(sock.our_fd);
+      close(sock.app_fd);
+    }
+  }
+
+  FakeSocket* FindInList(uint32_t id) {
+    FakeSocket* sock = list_;
+    while (sock && sock->id != id) sock = sock->next;
+    return sock;
+  }
+
+  FakeSocket* FindInMap(uint32_t id) {
+    auto it = by_id_.find(id);
+    return it != by_id_.end() ? it->second : nullptr;
+  }
+
+  // The apps read everything delivered to their socket
+  size_t AppRead() {
+    size_t total = 0;
+    for (auto& sock : sockets_) total += app_read(sock.app_fd);
+    return total;
+  }
+
+  const std::vector<uint32_t>& event_ids() const { return event_ids_; }
+
+ private:
+  std::vector<FakeSocket> sockets_;
+  FakeSocket* list_;
+  std::unordered_map<uint32_t, FakeSocket*> by_id_;
+  std::vector<uint32_t> event_ids_;
+};
+
+// An SDU as queued by GAP, with the L2CAP headroom
+BT_HDR* make_sdu() {
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_HDR_SIZE + 13 + kSduSize);
+  p_buf->offset = 13;
+  p_buf->len = kSduSize;
+  memset((uint8_t*)(p_buf + 1) + p_buf->offset, 0x5a, kSduSize);
+  return p_buf;
+}
+
+// The former data path: GAP_ConnReadData() copies the SDU to a temporary
+// buffer, which is copied again into a packet
+void on_data_ind_copy(FakeSocket* sock, BT_HDR* p_gap_buf, size_t* copied) {
+  std::vector<uint8_t> buffer(p_gap_buf->len);
+  memcpy(buffer.data(), (uint8_t*)(p_gap_buf + 1) + p_gap_buf->offset,
+         p_gap_buf->len);
+  osi_free(p_gap_buf);
+
+  packet* p = (packet*)osi_calloc(sizeof(*p));
+  p->data = (uint8_t*)osi_malloc(buffer.size());
+  p->len = buffer.size();
+  memcpy(p->data, buffer.data(), buffer.size());
+  p->prev = sock->last_packet;
+  sock->last_packet = p;
+  if (p->prev)
+    p->prev->next = p;
+  else
+    sock->first_packet = p;
+  *copied += 2 * buffer.size();
+}
+
+// One send() per packet
+void flush_copy(FakeSocket* sock) {
+  while (packet* p = sock->first_packet) {
+    send(sock->our_fd, p->data, p->len, MSG_DONTWAIT);
+    sock->first_packet = p->next;
+    if (!sock->first_packet) sock->last_packet = nullptr;
+    osi_free(p->data);
+    osi_free(p);
+  }
+}
+
+}  // namespace
+
+static void BM_SocketLookup_List(State& state) {
+  SocketSet sockets;
+  for (auto _ : state) {
+    for (uint32_t id : sockets.event_ids()) {
+      benchmark::DoNotOptimize(sockets.FindInList(id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * sockets.event_ids().size());
+}
+BENCHMARK(BM_SocketLookup_List);
+
+static void BM_SocketLookup_Map(State& state) {
+  SocketSet sockets;
+  for (auto _ : state) {
+    for (uint32_t id : sockets.event_ids()) {
+      benchmark::DoNotOptimize(sockets.FindInMap(id));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * sockets.event_ids().size());
+}
+BENCHMARK(BM_SocketLookup_Map);
+
+// Each iteration, the sockets receive kSdusPerRound SDUs, one data indication
+// each, then are signaled that the app is ready to read. Every event looks the
+// socket up by id. The time spent by the apps reading is not counted.
+static void BM_CocTraffic_Copy(State& state) {
+  SocketSet sockets;
+  size_t copied = 0;
+  size_t delivered = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kSdusPerRound; i++) {
+      for (uint32_t id : sockets.event_ids()) {
+        on_data_ind_copy(sockets.FindInList(id), make_sdu(), &copied);
+      }
+    }
+    for (uint32_t id : sockets.event_ids()) {
+      FakeSocket* sock = sockets.FindInList(id);
+      flush_copy(sock);
+    }
+    state.PauseTiming();
+    delivered += sockets.AppRead();
+    state.ResumeTiming();
+  }
+  state.SetBytesProcessed(delivered);
+  state.counters["copies_per_byte"] = (double)copied / delivered;
+}
+BENCHMARK(BM_CocTraffic_Copy);
+
+static void BM_CocTraffic_Buffers(State& state) {
+  SocketSet sockets;
+  size_t delivered = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < kSdusPerRound; i++) {
+      for (uint32_t id : sockets.event_ids()) {
+        // The GAP buffer is queued as is
+        sockets.FindInMap(id)->rx_queue.Enqueue(make_sdu());
+      }
+    }
+    for (uint32_t id : sockets.event_ids()) {
+      FakeSocket* sock = sockets.FindInMap(id);
+      sock->rx_queue.Flush(sock->our_fd);
+    }
+    state.PauseTiming();
+    delivered += sockets.AppRead();
+    state.ResumeTiming();
+  }
+  state.SetBytesProcessed(delivered);
+  // The payload is only copied by the kernel, into the socket
+  state.counters["copies_per_byte"] = 0;
+}
+BENCHMARK(BM_CocTraffic_Buffers);
+
+BENCHMARK_MAIN();
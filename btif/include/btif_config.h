@@ -25,6 +25,8 @@
 
 #include <list>
 #include <string>
+#include <vector>
+#include "btif_device_property_store.h"
 #include "osi/include/config.h"
 
 static const char BTIF_CONFIG_MODULE[] = "btif_config_module";
@@ -64,7 +66,30 @@ bool btif_config_remove(const std::string& section, const std::string& key);
 size_t btif_config_get_bin_length(const std::string& section,
                                   const std::string& key);
 
-const std::list<section_t>& btif_config_sections();
+// Typed access to the config section of a remote device, without formatting
+// the section name or the value
+bool btif_config_device_property_exist(const RawAddress& bd_addr,
+                                       DeviceProperty property);
+bool btif_config_get_device_int(const RawAddress& bd_addr,
+                                DeviceProperty property, int* value);
+bool btif_config_set_device_int(const RawAddress& bd_addr,
+                                DeviceProperty property, int value);
+bool btif_config_get_device_str(const RawAddress& bd_addr,
+                                DeviceProperty property, char* value,
+                                int* size_bytes);
+bool btif_config_set_device_str(const RawAddress& bd_addr,
+                                DeviceProperty property,
+                                const std::string& value);
+bool btif_config_get_device_bin(const RawAddress& bd_addr,
+                                DeviceProperty property, uint8_t* value,
+                                size_t* length);
+bool btif_config_set_device_bin(const RawAddress& bd_addr,
+                                DeviceProperty property, const uint8_t* value,
+                                size_t length);
+bool btif_config_remove_device_property(const RawAddress& bd_addr,
+                                        DeviceProperty property);
+// Devices loaded from the config file or bonded since
+std::vector<RawAddress> btif_config_get_persistent_devices();
 
 void btif_config_save(void);
 void btif_config_flush(void);
@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/lru.h"
+#include "osi/include/config.h"
+#include "raw_address.h"
+
+// Remote device properties with a typed in-memory representation. The name of
+// each one is the key it is persisted under in the device config section.
+enum class DeviceProperty : uint8_t {
+  NAME,           // "Name"
+  ALIAS,          // "Aliase"
+  DEV_CLASS,      // "DevClass"
+  DEV_TYPE,       // "DevType"
+  ADDR_TYPE,      // "AddrType"
+  TIMESTAMP,      // "Timestamp"
+  SERVICE,        // "Service"
+  MANUFACTURER,   // "Manufacturer"
+  LMP_VER,        // "LmpVer"
+  LMP_SUB_VER,    // "LmpSubVer"
+  LINK_KEY,       // "LinkKey"
+  LINK_KEY_TYPE,  // "LinkKeyType"
+  PIN_LENGTH,     // "PinLength"
+  LE_KEY_PENC,    // "LE_KEY_PENC"
+  LE_KEY_PID,     // "LE_KEY_PID"
+  LE_KEY_PCSRK,   // "LE_KEY_PCSRK"
+  LE_KEY_LENC,    // "LE_KEY_LENC"
+  LE_KEY_LCSRK,   // "LE_KEY_LCSRK"
+  LE_KEY_LID,     // "LE_KEY_LID"
+  METRICS_ID,     // "MetricsId"
+};
+
+// Config sections of remote devices, keyed by address instead of by section
+// name. Integer and binary properties are kept decoded and only formatted to
+// the INI representation when the config is persisted. Keys without a
+// DeviceProperty are kept as strings, so any device section round-trips.
+//
+// Like BtifConfigCache, devices loaded from the config file or holding a link
+// key are persistent, the others are kept in a size limited LRU cache.
+class BtifDevicePropertyStore {
+ public:
+  explicit BtifDevicePropertyStore(size_t capacity);
+
+  void Clear();
+
+  // Moves the device sections of |config| into the store
+  void Load(config_t* config);
+  // Appends the sections of the persistent devices to |config|
+  void AppendPersistentSections(config_t* config) const;
+  std::vector<RawAddress> GetPersistentDevices() const;
+  size_t GetPersistentDeviceCount() const;
+
+  bool HasDevice(const RawAddress& address);
+  bool HasProperty(const RawAddress& address, DeviceProperty property);
+  bool RemoveProperty(const RawAddress& address, DeviceProperty property);
+  void RemovePersistentDevicesWithKey(const std::string& key);
+
+  // Typed accessors
+  std::optional<int> GetInt(const RawAddress& address,
+                            DeviceProperty property);
+  void SetInt(const RawAddress& address, DeviceProperty property, int value);
+  // Fails when the value is not stored as binary, e.g. when it is a
+  // placeholder for a key held by the keystore
+  bool GetBin(const RawAddress& address, DeviceProperty property,
+              uint8_t* value, size_t* length);
+  void SetBin(const RawAddress& address, DeviceProperty property,
+              const uint8_t* value, size_t length);
+  std::optional<std::string> GetString(const RawAddress& address,
+                                       DeviceProperty property);
+  void SetString(const RawAddress& address, DeviceProperty property,
+                 std::string value);
+
+  // String keyed accessors backing the btif_config API
+  bool HasKey(const RawAddress& address, const std::string& key);
+  bool RemoveKey(const RawAddress& address, const std::string& key);
+  std::optional<std::string> GetString(const RawAddress& address,
+                                       const std::string& key);
+  void SetString(const RawAddress& address, const std::string& key,
+                 std::string value);
+  std::optional<int> GetInt(const RawAddress& address, const std::string& key);
+  std::optional<uint64_t> GetUint64(const RawAddress& address,
+                                    const std::string& key);
+
+  // Parses a device section name, in either case
+  static bool ParseSectionName(const std::string& section,
+                               RawAddress* address);
+  static std::optional<DeviceProperty> PropertyFromKey(const std::string& key);
+  static const std::string& KeyName(DeviceProperty property);
+
+ private:
+  enum class ValueType : uint8_t { INT, BIN, STRING };
+
+  struct PropertyValue {
+    DeviceProperty property;
+    ValueType type;
+    int64_t int_value;
+    // Raw bytes for BIN, text for STRING
+    std::string data;
+  };
+
+  struct DeviceRecord {
+    std::vector<PropertyValue> properties;
+    // Entries of keys without a DeviceProperty
+    std::list<entry_t> other_entries;
+
+    PropertyValue* Find(DeviceProperty property);
+    bool Empty() const;
+    bool HasLinkKey() const;
+  };
+
+  DeviceRecord* FindRecord(const RawAddress& address);
+  PropertyValue* FindProperty(const RawAddress& address,
+                              DeviceProperty property);
+  // Returns the record to update, which is created if needed
+  DeviceRecord* FindOrAddRecord(const RawAddress& address);
+  // Moves an unpaired device to the persistent devices once it has a link key
+  void OnPropertySet(const RawAddress& address, DeviceProperty property);
+  void OnEntryRemoved(const RawAddress& address);
+
+  static void ParseValue(PropertyValue* value, std::string text);
+  static std::string FormatValue(const PropertyValue& value);
+
+  std::unordered_map<RawAddress, DeviceRecord> persistent_devices_;
+  bluetooth::common::LruCache<RawAddress, DeviceRecord> unpaired_devices_;
+};
@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <hardware/bt_gatt_client.h>
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "raw_address.h"
+
+// Accumulates the GATT notifications of each connection, so that they reach
+// the app layer as one batch instead of one thread hop and one callback each.
+// Notifications are added from the BTA thread, batches are delivered from the
+// tasks handed to the scheduler.
+class BtifGattNotifyBatcher {
+ public:
+  // Runs |task| on the delivery thread once |delay_ms| have elapsed
+  using Scheduler =
+      std::function<void(std::function<void()> task, uint64_t delay_ms)>;
+  using BatchCallback =
+      std::function<void(int conn_id, const btgatt_notify_batch_t& batch)>;
+
+  BtifGattNotifyBatcher(uint64_t window_ms, size_t max_batch_size,
+                        Scheduler scheduler, BatchCallback callback);
+
+  // Adds a notification to the batch of |conn_id|. A batch is delivered
+  // |window_ms| after its first notification was added, or as soon as it
+  // holds |max_batch_size| notifications.
+  void Add(int conn_id, const RawAddress& bda, uint16_t handle,
+           const uint8_t* value, uint16_t len);
+
+  // Schedules the pending batch of |conn_id| for delivery right away, so it
+  // is delivered before any task scheduled on the delivery thread after this
+  void Flush(int conn_id);
+
+ private:
+  struct PendingBatch {
+    // Identifies the batch for its window timeout
+    uint64_t generation;
+    btgatt_notify_batch_t batch;
+  };
+
+  // Schedules immediate delivery of a batch taken out of |pending_|
+  void ScheduleDelivery(int conn_id, btgatt_notify_batch_t batch);
+  // Window timeout of the batch |generation| of |conn_id|
+  void OnWindowExpired(int conn_id, uint64_t generation);
+
+  const uint64_t window_ms_;
+  const size_t max_batch_size_;
+  Scheduler scheduler_;
+  BatchCallback callback_;
+
+  std::mutex lock_;
+  uint64_t next_generation_ = 0;
+  std::unordered_map<int, PendingBatch> pending_;
+};
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <deque>
+
+#include "bt_types.h"
+
+// The SDUs received on an L2CAP socket, waiting for the app to read them.
+// They are kept in the BT_HDR buffers handed over by the stack, and sent to
+// the socket straight from there, one SEQPACKET record per SDU.
+class BtifSockL2capRxQueue {
+ public:
+  explicit BtifSockL2capRxQueue(size_t max_bytes);
+  ~BtifSockL2capRxQueue();
+
+  // Takes ownership of |p_buf| and adds it to the queue.
+  // Returns false if the queue already holds |max_bytes|, in which case the
+  // caller keeps the ownership of |p_buf|.
+  bool Enqueue(BT_HDR* p_buf);
+
+  // Sends the queued SDUs to |fd| without blocking, as many at a time as the
+  // socket accepts.
+  // Returns true if data is left because the app is not keeping up, and the
+  // caller should wait for |fd| to be writable. Returns false once the queue
+  // is empty, or on an unrecoverable error.
+  bool Flush(int fd);
+
+  size_t bytesBuffered() const { return bytes_buffered_; }
+  bool empty() const { return buffers_.empty(); }
+
+ private:
+  const size_t max_bytes_;
+  size_t bytes_buffered_;
+  std::deque<BT_HDR*> buffers_;
+};
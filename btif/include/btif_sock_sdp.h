@@ -24,12 +24,14 @@
 #include <stdint.h>
 #include <string.h>
 
-static const bluetooth::Uuid UUID_OBEX_OBJECT_PUSH =
+static constexpr bluetooth::Uuid UUID_OBEX_OBJECT_PUSH =
     bluetooth::Uuid::From16Bit(0x1105);
-static const bluetooth::Uuid UUID_PBAP_PSE = bluetooth::Uuid::From16Bit(0x112F);
-static const bluetooth::Uuid UUID_MAP_MAS = bluetooth::Uuid::From16Bit(0x1132);
-static const bluetooth::Uuid UUID_SAP = bluetooth::Uuid::From16Bit(0x112D);
-static const bluetooth::Uuid UUID_SPP = bluetooth::Uuid::From16Bit(0x1101);
+static constexpr bluetooth::Uuid UUID_PBAP_PSE =
+    bluetooth::Uuid::From16Bit(0x112F);
+static constexpr bluetooth::Uuid UUID_MAP_MAS =
+    bluetooth::Uuid::From16Bit(0x1132);
+static constexpr bluetooth::Uuid UUID_SAP = bluetooth::Uuid::From16Bit(0x112D);
+static constexpr bluetooth::Uuid UUID_SPP = bluetooth::Uuid::From16Bit(0x1101);
 
 int add_rfc_sdp_rec(const char* name, bluetooth::Uuid uuid, int scn);
 void del_rfc_sdp_rec(int handle);
@@ -49,6 +49,7 @@
 #include "bt_utils.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
+#include "btcore/include/module.h"
 #include "btif/avrcp/avrcp_service.h"
 #include "btif_a2dp.h"
 #include "btif_api.h"
@@ -64,6 +65,7 @@
 #include "btsnoop.h"
 #include "btsnoop_mem.h"
 #include "common/address_obfuscator.h"
+#include "common/latency_tracer.h"
 #include "common/metric_id_allocator.h"
 #include "common/metrics.h"
 #include "device/include/interop.h"
@@ -79,6 +81,9 @@
 
 using bluetooth::hearing_aid::HearingAidInterface;
 
+// Set to true to trace received packet latency across the stack layers
+#define LATENCY_TRACE_PROPERTY "persist.bluetooth.latency_trace"
+
 /*******************************************************************************
  *  Static variables
  ******************************************************************************/
@@ -164,6 +169,9 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
   niap_config_compare_result = config_compare_result;
   is_local_device_atv = is_atv;
 
+  bluetooth::common::LatencyTracer::SetEnabled(
+      osi_property_get_bool(LATENCY_TRACE_PROPERTY, false));
+
   stack_manager_get_interface()->init_stack();
   btif_debug_init();
   return BT_STATUS_SUCCESS;
@@ -338,6 +346,8 @@ static void dump(int fd, const char** arguments) {
   stack_debug_avdtp_api_dump(fd);
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   btif_debug_config_dump(fd);
+  module_timeline_dump(fd);
+  bluetooth::common::LatencyTracer::Dump(fd);
   BTA_HfClientDumpStatistics(fd);
   wakelock_debug_dump(fd);
   osi_allocator_debug_dump(fd);
@@ -28,6 +28,8 @@
 #include <limits.h>
 #include <string.h>
 #include <algorithm>
+#include <deque>
+#include <mutex>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "audio_hal_interface/a2dp_encoding.h"
@@ -47,6 +49,7 @@
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 #include "uipc.h"
 
@@ -63,6 +66,14 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * In encode-ahead mode the media packets are encoded on a worker thread one
+ * media tick ahead, and kept in a bounded queue until the next tick sends
+ * them. The queue only grows past one tick worth of packets if the media
+ * tick falls behind.
+ */
+#define MAX_ENCODE_AHEAD_QUEUE_SZ MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -133,6 +144,14 @@ class BtifMediaStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    encode_total_calls = 0;
+    encode_total_time_us = 0;
+    encode_max_time_us = 0;
+    encode_ahead_queue_samples = 0;
+    encode_ahead_total_queue_depth = 0;
+    encode_ahead_max_queue_depth = 0;
+    encode_ahead_empty_count = 0;
+    encode_ahead_total_dropped_messages = 0;
     codec_index = -1;
   }
 
@@ -163,9 +182,53 @@ class BtifMediaStats {
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  // Time spent in the encoder send_frames() per media tick
+  size_t encode_total_calls;
+  uint64_t encode_total_time_us;
+  uint64_t encode_max_time_us;
+
+  // Packets encoded ahead, sampled at each media tick
+  size_t encode_ahead_queue_samples;
+  size_t encode_ahead_total_queue_depth;
+  size_t encode_ahead_max_queue_depth;
+  // Media ticks with nothing encoded ahead to send
+  size_t encode_ahead_empty_count;
+  size_t encode_ahead_total_dropped_messages;
+
   int codec_index = -1;
 };
 
+// Counters updated by the encoder and its callbacks, which run on the encoder
+// thread in encode-ahead mode. They are published under a lock after each
+// encoding and merged into BtifMediaStats on the source thread.
+class BtifMediaEncoderStats {
+ public:
+  BtifMediaEncoderStats() { Reset(); }
+  void Reset() {
+    media_read_total_underflow_bytes = 0;
+    media_read_total_underflow_count = 0;
+    media_read_last_underflow_us = 0;
+    encode_total_calls = 0;
+    encode_total_time_us = 0;
+    encode_max_time_us = 0;
+    encode_ahead_total_dropped_messages = 0;
+  }
+
+  size_t media_read_total_underflow_bytes;
+  size_t media_read_total_underflow_count;
+  uint64_t media_read_last_underflow_us;
+
+  size_t encode_total_calls;
+  uint64_t encode_total_time_us;
+  uint64_t encode_max_time_us;
+
+  size_t encode_ahead_total_dropped_messages;
+};
+
+template <class Stats>
+static void btif_a2dp_source_merge_encoder_stats(BtifMediaEncoderStats* src,
+                                                 Stats* dst);
+
 class BtifA2dpSource {
  public:
   enum RunState {
@@ -175,9 +238,16 @@ class BtifA2dpSource {
     kStateShuttingDown
   };
 
+  // A media packet encoded ahead of the media tick
+  struct EncodedPacket {
+    BT_HDR* p_buf;
+    size_t frames_n;
+  };
+
   BtifA2dpSource()
       : tx_audio_queue(nullptr),
         tx_flush(false),
+        encode_ahead(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
         state_(kStateOff) {}
@@ -186,12 +256,19 @@ class BtifA2dpSource {
     fixed_queue_free(tx_audio_queue, nullptr);
     tx_audio_queue = nullptr;
     tx_flush = false;
+    encode_ahead = false;
+    FlushEncodedPackets();
     media_alarm.CancelAndWait();
     wakelock_release();
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
     stats.Reset();
     accumulated_stats.Reset();
+    encoder_stats.Reset();
+    {
+      std::lock_guard<std::mutex> lock(encoded_packets_mutex_);
+      published_encoder_stats_.Reset();
+    }
     state_ = kStateOff;
   }
 
@@ -211,20 +288,75 @@ class BtifA2dpSource {
 
   void SetState(BtifA2dpSource::RunState state) { state_ = state; }
 
+  // Called on the encoder thread. Returns the number of dropped packets.
+  size_t PushEncodedPacket(BT_HDR* p_buf, size_t frames_n) {
+    std::lock_guard<std::mutex> lock(encoded_packets_mutex_);
+    size_t drop_n = 0;
+    while (encoded_packets_.size() >= MAX_ENCODE_AHEAD_QUEUE_SZ) {
+      osi_free(encoded_packets_.front().p_buf);
+      encoded_packets_.pop_front();
+      drop_n++;
+    }
+    encoded_packets_.push_back({p_buf, frames_n});
+    return drop_n;
+  }
+
+  // Called on the source thread by the media tick
+  std::deque<EncodedPacket> TakeEncodedPackets() {
+    std::lock_guard<std::mutex> lock(encoded_packets_mutex_);
+    std::deque<EncodedPacket> packets;
+    packets.swap(encoded_packets_);
+    return packets;
+  }
+
+  // Called by the thread running the encoder, once done encoding
+  void PublishEncoderStats() {
+    std::lock_guard<std::mutex> lock(encoded_packets_mutex_);
+    btif_a2dp_source_merge_encoder_stats(&encoder_stats,
+                                         &published_encoder_stats_);
+  }
+
+  // Called on the source thread, folds the published encoder counters into
+  // |stats|
+  void MergeEncoderStats() {
+    std::lock_guard<std::mutex> lock(encoded_packets_mutex_);
+    btif_a2dp_source_merge_encoder_stats(&published_encoder_stats_, &stats);
+  }
+
+  // Returns the number of flushed packets
+  size_t FlushEncodedPackets() {
+    size_t flush_n = 0;
+    for (auto& packet : TakeEncodedPackets()) {
+      osi_free(packet.p_buf);
+      flush_n++;
+    }
+    return flush_n;
+  }
+
   fixed_queue_t* tx_audio_queue;
   bool tx_flush; /* Discards any outgoing data when true */
+  bool encode_ahead; /* Encodes on the encoder thread, ahead of the tick */
   RepeatingTimer media_alarm;
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
   BtifMediaStats stats;
   BtifMediaStats accumulated_stats;
+  /* Only touched by the thread running the encoder */
+  BtifMediaEncoderStats encoder_stats;
 
  private:
   BtifA2dpSource::RunState state_;
+  /* Guards the encoded packets and the published encoder stats */
+  std::mutex encoded_packets_mutex_;
+  std::deque<EncodedPacket> encoded_packets_;
+  BtifMediaEncoderStats published_encoder_stats_;
 };
 
 static bluetooth::common::MessageLoopThread btif_a2dp_source_thread(
     "bt_a2dp_source_worker_thread");
+// Runs the encoder in encode-ahead mode
+static bluetooth::common::MessageLoopThread btif_a2dp_source_encoder_thread(
+    "bt_a2dp_source_encoder_thread");
 static BtifA2dpSource btif_a2dp_source_cb;
 
 static void btif_a2dp_source_init_delayed(void);
@@ -252,9 +384,24 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+// Sets the transmit queue length and encodes the frames for the media tick
+// at |timestamp_us|.
+static void btif_a2dp_source_encode_frames(uint64_t timestamp_us,
+                                           size_t transmit_queue_length);
+static void btif_a2dp_source_encode_ahead_event(uint64_t timestamp_us,
+                                                size_t transmit_queue_length);
+static void btif_a2dp_source_send_encoded_ahead(uint64_t now_us);
+// Waits until the encoder thread is idle. In encode-ahead mode this must be
+// called before using the encoder on the source thread.
+static void btif_a2dp_source_encoder_thread_sync(void);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
+static bool btif_a2dp_source_encode_ahead_enqueue_callback(BT_HDR* p_buf,
+                                                           size_t frames_n,
+                                                           uint32_t bytes_read);
+static bool btif_a2dp_source_enqueue_packet(BT_HDR* p_buf, size_t frames_n,
+                                            uint64_t now_us);
 static void log_tstamps_us(const char* comment, uint64_t timestamp_us);
 static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
                                     uint64_t expected_delta);
@@ -286,6 +433,26 @@ void btif_a2dp_source_accumulate_scheduling_stats(SchedulingStats* src,
   dst->total_scheduling_time_us += src->total_scheduling_time_us;
 }
 
+// Merges |src| into either BtifMediaEncoderStats or BtifMediaStats
+template <class Stats>
+static void btif_a2dp_source_merge_encoder_stats(BtifMediaEncoderStats* src,
+                                                 Stats* dst) {
+  dst->media_read_total_underflow_bytes +=
+      src->media_read_total_underflow_bytes;
+  dst->media_read_total_underflow_count +=
+      src->media_read_total_underflow_count;
+  if (src->media_read_last_underflow_us != 0) {
+    dst->media_read_last_underflow_us = src->media_read_last_underflow_us;
+  }
+  dst->encode_total_calls += src->encode_total_calls;
+  dst->encode_total_time_us += src->encode_total_time_us;
+  dst->encode_max_time_us =
+      std::max(dst->encode_max_time_us, src->encode_max_time_us);
+  dst->encode_ahead_total_dropped_messages +=
+      src->encode_ahead_total_dropped_messages;
+  src->Reset();
+}
+
 void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
                                        BtifMediaStats* dst) {
   dst->tx_queue_total_frames += src->tx_queue_total_frames;
@@ -308,6 +475,17 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
   dst->media_read_total_underflow_count +=
       src->media_read_total_underflow_count;
   dst->media_read_last_underflow_us = src->media_read_last_underflow_us;
+  dst->encode_total_calls += src->encode_total_calls;
+  dst->encode_total_time_us += src->encode_total_time_us;
+  dst->encode_max_time_us =
+      std::max(dst->encode_max_time_us, src->encode_max_time_us);
+  dst->encode_ahead_queue_samples += src->encode_ahead_queue_samples;
+  dst->encode_ahead_total_queue_depth += src->encode_ahead_total_queue_depth;
+  dst->encode_ahead_max_queue_depth = std::max(
+      dst->encode_ahead_max_queue_depth, src->encode_ahead_max_queue_depth);
+  dst->encode_ahead_empty_count += src->encode_ahead_empty_count;
+  dst->encode_ahead_total_dropped_messages +=
+      src->encode_ahead_total_dropped_messages;
   if (dst->codec_index < 0) dst->codec_index = src->codec_index;
   btif_a2dp_source_accumulate_scheduling_stats(&src->tx_queue_enqueue_stats,
                                                &dst->tx_queue_enqueue_stats);
@@ -343,6 +521,8 @@ bool btif_a2dp_source_startup(void) {
   btif_a2dp_source_cb.Reset();
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateStartingUp);
   btif_a2dp_source_cb.tx_audio_queue = fixed_queue_new(SIZE_MAX);
+  btif_a2dp_source_cb.encode_ahead = osi_property_get_bool(
+      "persist.bluetooth.a2dp_source.encode_ahead", false);
 
   // Schedule the rest of the operations
   btif_a2dp_source_thread.DoInThread(
@@ -357,6 +537,14 @@ static void btif_a2dp_source_startup_delayed() {
   if (!btif_a2dp_source_thread.EnableRealTimeScheduling()) {
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
   }
+  if (btif_a2dp_source_cb.encode_ahead &&
+      !btif_a2dp_source_encoder_thread.IsRunning()) {
+    btif_a2dp_source_encoder_thread.StartUp();
+    if (!btif_a2dp_source_encoder_thread.EnableRealTimeScheduling()) {
+      LOG(WARNING) << __func__
+                   << ": unable to enable real time scheduling for encoder";
+    }
+  }
   if (!bluetooth::audio::a2dp::init(&btif_a2dp_source_thread)) {
     if (btif_av_is_a2dp_offload_enabled()) {
       // TODO: BluetoothA2dp@1.0 is deprecated
@@ -512,6 +700,8 @@ static void btif_a2dp_source_shutdown_delayed(void) {
   }
   fixed_queue_free(btif_a2dp_source_cb.tx_audio_queue, nullptr);
   btif_a2dp_source_cb.tx_audio_queue = nullptr;
+  btif_a2dp_source_encoder_thread_sync();
+  btif_a2dp_source_cb.FlushEncodedPackets();
 
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateOff);
 }
@@ -526,8 +716,9 @@ void btif_a2dp_source_cleanup(void) {
   btif_a2dp_source_thread.DoInThread(
       FROM_HERE, base::Bind(&btif_a2dp_source_cleanup_delayed));
 
-  // Exit the thread
+  // Exit the threads
   btif_a2dp_source_thread.ShutDown();
+  btif_a2dp_source_encoder_thread.ShutDown();
 }
 
 static void btif_a2dp_source_cleanup_delayed(void) {
@@ -591,9 +782,12 @@ static void btif_a2dp_source_setup_codec_delayed(
     return;
   }
 
+  btif_a2dp_source_encoder_thread_sync();
   btif_a2dp_source_cb.encoder_interface->encoder_init(
       &peer_params, a2dp_codec_config, btif_a2dp_source_read_callback,
-      btif_a2dp_source_enqueue_callback);
+      btif_a2dp_source_cb.encode_ahead
+          ? btif_a2dp_source_encode_ahead_enqueue_callback
+          : btif_a2dp_source_enqueue_callback);
 
   // Save a local copy of the encoder_interval_ms
   btif_a2dp_source_cb.encoder_interval_ms =
@@ -645,6 +839,7 @@ static void btif_a2dp_source_encoder_user_config_update_event(
     std::promise<void> peer_ready_promise) {
   bool restart_output = false;
   bool success = false;
+  btif_a2dp_source_encoder_thread_sync();
   for (auto codec_user_config : codec_user_preferences) {
     success = bta_av_co_set_codec_user_config(peer_address, codec_user_config,
                                               &restart_output);
@@ -689,6 +884,7 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config) {
   LOG_INFO(LOG_TAG, "%s: state=%s", __func__,
            btif_a2dp_source_cb.StateStr().c_str());
+  btif_a2dp_source_encoder_thread_sync();
   if (!bta_av_co_set_codec_audio_config(codec_audio_config)) {
     LOG_ERROR(LOG_TAG, "%s: cannot update codec audio feeding parameters",
               __func__);
@@ -832,6 +1028,9 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
   if (btif_av_is_a2dp_offload_running()) return;
 
+  // Let the encoder thread finish the media tick it was encoding for
+  btif_a2dp_source_encoder_thread_sync();
+
   btif_a2dp_source_cb.stats.session_end_us =
       bluetooth::common::time_get_os_boottime_us();
   btif_a2dp_source_update_metrics();
@@ -853,6 +1052,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
   /* Stop the timer first */
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
   wakelock_release();
+  btif_a2dp_source_cb.FlushEncodedPackets();
 
   if (bluetooth::audio::a2dp::is_hal_2_0_enabled()) {
     bluetooth::audio::a2dp::ack_stream_suspended(A2DP_CTRL_ACK_SUCCESS);
@@ -900,16 +1100,85 @@ static void btif_a2dp_source_audio_handle_timer(void) {
 #ifndef OS_GENERIC
   ATRACE_INT("btif TX queue", transmit_queue_length);
 #endif
+  if (btif_a2dp_source_cb.encode_ahead) {
+    // Send what was encoded after the previous tick, and encode the frames of
+    // this tick on the encoder thread so they are ready for the next one.
+    btif_a2dp_source_send_encoded_ahead(timestamp_us);
+    btif_a2dp_source_encoder_thread.DoInThread(
+        FROM_HERE, base::Bind(&btif_a2dp_source_encode_ahead_event,
+                              timestamp_us, transmit_queue_length));
+  } else {
+    btif_a2dp_source_encode_frames(timestamp_us, transmit_queue_length);
+  }
+  btif_a2dp_source_cb.MergeEncoderStats();
+  bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
+  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
+                          timestamp_us,
+                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+}
+
+static void btif_a2dp_source_encode_frames(uint64_t timestamp_us,
+                                           size_t transmit_queue_length) {
   if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
       nullptr) {
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
         transmit_queue_length);
   }
+  uint64_t encode_start_us = bluetooth::common::time_get_os_boottime_us();
   btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
-  bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
-  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
-                          timestamp_us,
-                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+  uint64_t encode_time_us =
+      bluetooth::common::time_get_os_boottime_us() - encode_start_us;
+
+  BtifMediaEncoderStats& encoder_stats = btif_a2dp_source_cb.encoder_stats;
+  encoder_stats.encode_total_calls++;
+  encoder_stats.encode_total_time_us += encode_time_us;
+  encoder_stats.encode_max_time_us =
+      std::max(encode_time_us, encoder_stats.encode_max_time_us);
+  btif_a2dp_source_cb.PublishEncoderStats();
+}
+
+static void btif_a2dp_source_encode_ahead_event(uint64_t timestamp_us,
+                                                size_t transmit_queue_length) {
+  // The media task may have been stopped since the tick
+  if (!btif_a2dp_source_cb.media_alarm.IsScheduled()) return;
+  btif_a2dp_source_encode_frames(timestamp_us, transmit_queue_length);
+}
+
+static void btif_a2dp_source_send_encoded_ahead(uint64_t now_us) {
+  std::deque<BtifA2dpSource::EncodedPacket> packets =
+      btif_a2dp_source_cb.TakeEncodedPackets();
+  BtifMediaStats& stats = btif_a2dp_source_cb.stats;
+
+  stats.encode_ahead_queue_samples++;
+  stats.encode_ahead_total_queue_depth += packets.size();
+  stats.encode_ahead_max_queue_depth =
+      std::max(packets.size(), stats.encode_ahead_max_queue_depth);
+  // Nothing is encoded yet for the first tick of the stream
+  if (packets.empty() && stats.tx_queue_enqueue_stats.total_updates > 0) {
+    stats.encode_ahead_empty_count++;
+  }
+
+  for (auto& packet : packets) {
+    btif_a2dp_source_enqueue_packet(packet.p_buf, packet.frames_n, now_us);
+  }
+}
+
+static void btif_a2dp_source_encoder_thread_synced(
+    std::promise<void> promise) {
+  promise.set_value();
+}
+
+static void btif_a2dp_source_encoder_thread_sync(void) {
+  if (btif_a2dp_source_encoder_thread.IsRunning()) {
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    if (btif_a2dp_source_encoder_thread.DoInThread(
+            FROM_HERE, base::BindOnce(&btif_a2dp_source_encoder_thread_synced,
+                                      std::move(promise)))) {
+      future.wait();
+    }
+  }
+  btif_a2dp_source_cb.MergeEncoderStats();
 }
 
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
@@ -925,10 +1194,10 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
   if (bytes_read < len) {
     LOG_WARN(LOG_TAG, "%s: UNDERFLOW: ONLY READ %d BYTES OUT OF %d", __func__,
              bytes_read, len);
-    btif_a2dp_source_cb.stats.media_read_total_underflow_bytes +=
+    btif_a2dp_source_cb.encoder_stats.media_read_total_underflow_bytes +=
         (len - bytes_read);
-    btif_a2dp_source_cb.stats.media_read_total_underflow_count++;
-    btif_a2dp_source_cb.stats.media_read_last_underflow_us =
+    btif_a2dp_source_cb.encoder_stats.media_read_total_underflow_count++;
+    btif_a2dp_source_cb.encoder_stats.media_read_last_underflow_us =
         bluetooth::common::time_get_os_boottime_us();
     bluetooth::common::LogA2dpAudioUnderrunEvent(
         btif_av_source_active_peer(), btif_a2dp_source_cb.encoder_interval_ms,
@@ -943,6 +1212,32 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
   btif_a2dp_control_log_bytes_read(bytes_read);
 
+  return btif_a2dp_source_enqueue_packet(p_buf, frames_n, now_us);
+}
+
+static bool btif_a2dp_source_encode_ahead_enqueue_callback(
+    BT_HDR* p_buf, size_t frames_n, uint32_t bytes_read) {
+  btif_a2dp_control_log_bytes_read(bytes_read);
+
+  /* Check if media task was stopped or the transmission queue flushed */
+  if (!btif_a2dp_source_cb.media_alarm.IsScheduled() ||
+      btif_a2dp_source_cb.tx_flush) {
+    osi_free(p_buf);
+    return false;
+  }
+
+  size_t drop_n = btif_a2dp_source_cb.PushEncodedPacket(p_buf, frames_n);
+  if (drop_n > 0) {
+    LOG_WARN(LOG_TAG, "%s: encode-ahead queue full, dropped %zu packet(s)",
+             __func__, drop_n);
+    btif_a2dp_source_cb.encoder_stats.encode_ahead_total_dropped_messages +=
+        drop_n;
+  }
+  return true;
+}
+
+static bool btif_a2dp_source_enqueue_packet(BT_HDR* p_buf, size_t frames_n,
+                                            uint64_t now_us) {
   /* Check if timer was stopped (media task stopped) */
   if (!btif_a2dp_source_cb.media_alarm.IsScheduled()) {
     osi_free(p_buf);
@@ -1039,11 +1334,13 @@ static void btif_a2dp_source_audio_tx_flush_event(void) {
            btif_a2dp_source_cb.StateStr().c_str());
   if (btif_av_is_a2dp_offload_running()) return;
 
+  btif_a2dp_source_encoder_thread_sync();
   if (btif_a2dp_source_cb.encoder_interface != nullptr)
     btif_a2dp_source_cb.encoder_interface->feeding_flush();
 
   btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue) +
+      btif_a2dp_source_cb.FlushEncodedPackets();
   btif_a2dp_source_cb.stats.tx_queue_last_flushed_us =
       bluetooth::common::time_get_os_boottime_us();
   fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
@@ -1128,6 +1425,7 @@ static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
 }
 
 void btif_a2dp_source_debug_dump(int fd) {
+  btif_a2dp_source_cb.MergeEncoderStats();
   btif_a2dp_source_accumulate_stats(&btif_a2dp_source_cb.stats,
                                     &btif_a2dp_source_cb.accumulated_stats);
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
@@ -1215,6 +1513,39 @@ void btif_a2dp_source_debug_dump(int fd) {
                     1000
               : 0);
 
+  ave_time_us = 0;
+  if (accumulated_stats->encode_total_calls != 0) {
+    ave_time_us = accumulated_stats->encode_total_time_us /
+                  accumulated_stats->encode_total_calls;
+  }
+  dprintf(fd,
+          "  Encode time in us (count/total/max/ave)                 : %zu / "
+          "%llu / %llu / %llu\n",
+          accumulated_stats->encode_total_calls,
+          (unsigned long long)accumulated_stats->encode_total_time_us,
+          (unsigned long long)accumulated_stats->encode_max_time_us,
+          (unsigned long long)ave_time_us);
+
+  dprintf(fd,
+          "  Encode ahead                                            : %s\n",
+          btif_a2dp_source_cb.encode_ahead ? "true" : "false");
+  if (btif_a2dp_source_cb.encode_ahead) {
+    double ave_depth = 0;
+    if (accumulated_stats->encode_ahead_queue_samples != 0) {
+      ave_depth = (double)accumulated_stats->encode_ahead_total_queue_depth /
+                  accumulated_stats->encode_ahead_queue_samples;
+    }
+    dprintf(fd,
+            "  Encode-ahead queue depth (max/ave)                      : %zu / "
+            "%.2f\n",
+            accumulated_stats->encode_ahead_max_queue_depth, ave_depth);
+    dprintf(fd,
+            "  Encode-ahead counts (empty/dropped)                     : %zu / "
+            "%zu\n",
+            accumulated_stats->encode_ahead_empty_count,
+            accumulated_stats->encode_ahead_total_dropped_messages);
+  }
+
   //
   // TxQueue enqueue stats
   //
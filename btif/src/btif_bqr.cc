@@ -23,19 +23,19 @@
 
 #include "btif_bqr.h"
 #include "btif_dm.h"
-#include "common/leaky_bonded_queue.h"
+#include "common/lock_free_leaky_bonded_queue.h"
 #include "osi/include/properties.h"
 #include "stack/btm/btm_int.h"
 
 namespace bluetooth {
 namespace bqr {
 
-using bluetooth::common::LeakyBondedQueue;
+using bluetooth::common::LockFreeLeakyBondedQueue;
 using std::chrono::system_clock;
 
 // The instance of BQR event queue
-static std::unique_ptr<LeakyBondedQueue<BqrVseSubEvt>> kpBqrEventQueue(
-    new LeakyBondedQueue<BqrVseSubEvt>(kBqrEventQueueSize));
+static std::unique_ptr<LockFreeLeakyBondedQueue<BqrVseSubEvt>> kpBqrEventQueue(
+    new LockFreeLeakyBondedQueue<BqrVseSubEvt>(kBqrEventQueueSize));
 
 void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length,
                                           uint8_t* p_param_buf) {
@@ -491,6 +491,7 @@ void DebugDump(int fd) {
 
   while (!kpBqrEventQueue->Empty()) {
     std::unique_ptr<BqrVseSubEvt> p_event(kpBqrEventQueue->Dequeue());
+    if (p_event == nullptr) break;
 
     bool warning = (p_event->bqr_link_quality_event_.rssi < kCriWarnRssi ||
                     p_event->bqr_link_quality_event_.unused_afh_channel_count >
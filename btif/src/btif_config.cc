@@ -42,6 +42,7 @@
 #include "btif_common.h"
 #include "btif_config_cache.h"
 #include "btif_config_transcode.h"
+#include "btif_device_property_store.h"
 #include "btif_util.h"
 #include "common/address_obfuscator.h"
 #include "common/metric_id_allocator.h"
@@ -150,26 +151,23 @@ static BluetoothKeystoreInterface* get_bluetooth_keystore_interface() {
 bool btif_get_device_type(const RawAddress& bda, int* p_device_type) {
   if (p_device_type == NULL) return false;
 
-  std::string addrstr = bda.ToString();
-  const char* bd_addr_str = addrstr.c_str();
-
-  if (!btif_config_get_int(bd_addr_str, "DevType", p_device_type)) return false;
+  if (!btif_config_get_device_int(bda, DeviceProperty::DEV_TYPE,
+                                  p_device_type))
+    return false;
 
-  LOG_DEBUG(LOG_TAG, "%s: Device [%s] type %d", __func__, bd_addr_str,
-            *p_device_type);
+  LOG_DEBUG(LOG_TAG, "%s: Device [%s] type %d", __func__,
+            bda.ToString().c_str(), *p_device_type);
   return true;
 }
 
 bool btif_get_address_type(const RawAddress& bda, int* p_addr_type) {
   if (p_addr_type == NULL) return false;
 
-  std::string addrstr = bda.ToString();
-  const char* bd_addr_str = addrstr.c_str();
-
-  if (!btif_config_get_int(bd_addr_str, "AddrType", p_addr_type)) return false;
+  if (!btif_config_get_device_int(bda, DeviceProperty::ADDR_TYPE, p_addr_type))
+    return false;
 
-  LOG_DEBUG(LOG_TAG, "%s: Device [%s] address type %d", __func__, bd_addr_str,
-            *p_addr_type);
+  LOG_DEBUG(LOG_TAG, "%s: Device [%s] address type %d", __func__,
+            bda.ToString().c_str(), *p_addr_type);
   return true;
 }
 
@@ -219,18 +217,12 @@ static void init_metric_id_allocator() {
   // version of android without a metric id.
   std::vector<RawAddress> addresses_without_id;
 
-  for (auto& section : btif_config_sections()) {
-    auto& section_name = section.name;
-    RawAddress mac_address;
-    if (!RawAddress::FromString(section_name, mac_address)) {
-      continue;
-    }
-    // if the section name is a mac address
+  for (const RawAddress& mac_address : btif_config_get_persistent_devices()) {
     bool is_valid_id_found = false;
-    if (btif_config_exist(section_name, BT_CONFIG_METRICS_ID_KEY)) {
+    int id = 0;
+    if (btif_config_get_device_int(mac_address, DeviceProperty::METRICS_ID,
+                                   &id)) {
       // there is one metric id under this mac_address
-      int id = 0;
-      btif_config_get_int(section_name, BT_CONFIG_METRICS_ID_KEY, &id);
       if (MetricIdAllocator::IsValidId(id)) {
         paired_device_map[mac_address] = id;
         is_valid_id_found = true;
@@ -244,12 +236,13 @@ static void init_metric_id_allocator() {
   // Initialize MetricIdAllocator
   MetricIdAllocator::Callback save_device_callback =
       [](const RawAddress& address, const int id) {
-        return btif_config_set_int(address.ToString(), BT_CONFIG_METRICS_ID_KEY,
-                                   id);
+        return btif_config_set_device_int(address, DeviceProperty::METRICS_ID,
+                                          id);
       };
   MetricIdAllocator::Callback forget_device_callback =
       [](const RawAddress& address, const int id) {
-        return btif_config_remove(address.ToString(), BT_CONFIG_METRICS_ID_KEY);
+        return btif_config_remove_device_property(address,
+                                                  DeviceProperty::METRICS_ID);
       };
   if (!MetricIdAllocator::GetInstance().Init(
           paired_device_map, std::move(save_device_callback),
@@ -269,6 +262,9 @@ static alarm_t* config_timer;
 
 // limited btif config cache capacity
 static BtifConfigCache btif_config_cache(TEMPORARY_SECTION_CAPACITY);
+// remote device sections, keyed by address
+static BtifDevicePropertyStore btif_device_property_store(
+    TEMPORARY_SECTION_CAPACITY);
 
 // Module lifecycle functions
 
@@ -310,7 +306,9 @@ static future_t* init(void) {
     file_source = "Empty";
   }
 
-  // move persistent config data from btif_config file to btif config cache
+  // move persistent config data from btif_config file to btif config cache,
+  // device sections go to the device property store
+  btif_device_property_store.Load(config.get());
   btif_config_cache.Init(std::move(config));
 
   if (!file_source.empty()) {
@@ -320,6 +318,7 @@ static future_t* init(void) {
   // Cleanup temporary pairings if we have left guest mode
   if (!is_restricted_mode()) {
     btif_config_cache.RemovePersistentSectionsWithKey("Restricted");
+    btif_device_property_store.RemovePersistentDevicesWithKey("Restricted");
   }
 
   // Read or set config file creation timestamp
@@ -358,6 +357,7 @@ error:
   alarm_free(config_timer);
   config.reset();
   btif_config_cache.Clear();
+  btif_device_property_store.Clear();
   config_timer = NULL;
   btif_config_source = NOT_LOADED;
   return future_new_immediate(FUTURE_FAIL);
@@ -391,6 +391,7 @@ static future_t* clean_up(void) {
   get_bluetooth_keystore_interface()->clear_map();
   MetricIdAllocator::GetInstance().Close();
   btif_config_cache.Clear();
+  btif_device_property_store.Clear();
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
@@ -400,15 +401,51 @@ EXPORT_SYMBOL module_t btif_config_module = {.name = BTIF_CONFIG_MODULE,
                                              .shut_down = shut_down,
                                              .clean_up = clean_up};
 
+/* device sections are kept by btif_device_property_store, the helpers below
+ * route the string API to it. Must be called with config_lock held. */
+static std::optional<std::string> btif_config_get_string(
+    const std::string& section, const std::string& key) {
+  RawAddress bd_addr;
+  if (BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    return btif_device_property_store.GetString(bd_addr, key);
+  }
+  return btif_config_cache.GetString(section, key);
+}
+
+static void btif_config_set_string(const std::string& section,
+                                   const std::string& key, std::string value) {
+  RawAddress bd_addr;
+  if (BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    btif_device_property_store.SetString(bd_addr, key, std::move(value));
+    return;
+  }
+  btif_config_cache.SetString(section, key, std::move(value));
+}
+
+/* persistent sections, with the device sections in INI form */
+static config_t btif_config_persistent_copy() {
+  config_t config = btif_config_cache.PersistentSectionCopy();
+  btif_device_property_store.AppendPersistentSections(&config);
+  return config;
+}
+
 bool btif_config_has_section(const char* section) {
   CHECK(section != NULL);
 
   std::unique_lock<std::recursive_mutex> lock(config_lock);
+  RawAddress bd_addr;
+  if (BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    return btif_device_property_store.HasDevice(bd_addr);
+  }
   return btif_config_cache.HasSection(section);
 }
 
 bool btif_config_exist(const std::string& section, const std::string& key) {
   std::unique_lock<std::recursive_mutex> lock(config_lock);
+  RawAddress bd_addr;
+  if (BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    return btif_device_property_store.HasKey(bd_addr, key);
+  }
   return btif_config_cache.HasKey(section, key);
 }
 
@@ -416,7 +453,10 @@ bool btif_config_get_int(const std::string& section, const std::string& key,
                          int* value) {
   CHECK(value != NULL);
   std::unique_lock<std::recursive_mutex> lock(config_lock);
-  auto ret = btif_config_cache.GetInt(section, key);
+  RawAddress bd_addr;
+  auto ret = BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)
+                 ? btif_device_property_store.GetInt(bd_addr, key)
+                 : btif_config_cache.GetInt(section, key);
   if (!ret) {
     return false;
   }
@@ -427,6 +467,17 @@ bool btif_config_get_int(const std::string& section, const std::string& key,
 bool btif_config_set_int(const std::string& section, const std::string& key,
                          int value) {
   std::unique_lock<std::recursive_mutex> lock(config_lock);
+  RawAddress bd_addr;
+  if (BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    auto property = BtifDevicePropertyStore::PropertyFromKey(key);
+    if (property) {
+      btif_device_property_store.SetInt(bd_addr, *property, value);
+    } else {
+      btif_device_property_store.SetString(bd_addr, key,
+                                           std::to_string(value));
+    }
+    return true;
+  }
   btif_config_cache.SetInt(section, key, value);
   return true;
 }
@@ -435,7 +486,10 @@ bool btif_config_get_uint64(const std::string& section, const std::string& key,
                             uint64_t* value) {
   CHECK(value != NULL);
   std::unique_lock<std::recursive_mutex> lock(config_lock);
-  auto ret = btif_config_cache.GetUint64(section, key);
+  RawAddress bd_addr;
+  auto ret = BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)
+                 ? btif_device_property_store.GetUint64(bd_addr, key)
+                 : btif_config_cache.GetUint64(section, key);
   if (!ret) {
     return false;
   }
@@ -446,7 +500,7 @@ bool btif_config_get_uint64(const std::string& section, const std::string& key,
 bool btif_config_set_uint64(const std::string& section, const std::string& key,
                             uint64_t value) {
   std::unique_lock<std::recursive_mutex> lock(config_lock);
-  btif_config_cache.SetUint64(section, key, value);
+  btif_config_set_string(section, key, std::to_string(value));
   return true;
 }
 
@@ -457,7 +511,7 @@ bool btif_config_get_str(const std::string& section, const std::string& key,
 
   {
     std::unique_lock<std::recursive_mutex> lock(config_lock);
-    auto stored_value = btif_config_cache.GetString(section, key);
+    auto stored_value = btif_config_get_string(section, key);
     if (!stored_value) return false;
     strlcpy(value, stored_value->c_str(), *size_bytes);
   }
@@ -468,7 +522,7 @@ bool btif_config_get_str(const std::string& section, const std::string& key,
 bool btif_config_set_str(const std::string& section, const std::string& key,
                          const std::string& value) {
   std::unique_lock<std::recursive_mutex> lock(config_lock);
-  btif_config_cache.SetString(section, key, value);
+  btif_config_set_string(section, key, value);
   return true;
 }
 
@@ -484,8 +538,18 @@ bool btif_config_get_bin(const std::string& section, const std::string& key,
   CHECK(length != NULL);
 
   std::unique_lock<std::recursive_mutex> lock(config_lock);
+  RawAddress bd_addr;
+  if (!btif_is_niap_mode() &&
+      BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    auto property = BtifDevicePropertyStore::PropertyFromKey(key);
+    if (property && btif_device_property_store.GetBin(bd_addr, *property,
+                                                      value, length)) {
+      return true;
+    }
+  }
+
   const std::string* value_str;
-  auto value_str_from_config = btif_config_cache.GetString(section, key);
+  auto value_str_from_config = btif_config_get_string(section, key);
 
   if (!value_str_from_config) {
     VLOG(1) << __func__ << ": cannot find string for section " << section
@@ -527,11 +591,11 @@ bool btif_config_get_bin(const std::string& section, const std::string& key,
         !is_key_encrypted) {
       get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
           section + "-" + key, *value_str_from_config);
-      btif_config_cache.SetString(section, key, ENCRYPTED_STR);
+      btif_config_set_string(section, key, ENCRYPTED_STR);
     }
   } else {
     if (in_encrypt_key_name_list && is_key_encrypted) {
-      btif_config_cache.SetString(section, key, *value_str);
+      btif_config_set_string(section, key, *value_str);
     }
   }
 
@@ -541,7 +605,7 @@ bool btif_config_get_bin(const std::string& section, const std::string& key,
 size_t btif_config_get_bin_length(const std::string& section,
                                   const std::string& key) {
   std::unique_lock<std::recursive_mutex> lock(config_lock);
-  auto value_str = btif_config_cache.GetString(section, key);
+  auto value_str = btif_config_get_string(section, key);
   if (!value_str) return 0;
   size_t value_len = value_str->length();
   return ((value_len % 2) != 0) ? 0 : (value_len / 2);
@@ -558,6 +622,19 @@ bool btif_config_set_bin(const std::string& section, const std::string& key,
     return false;
   }
 
+  bool encrypt = (length > 0) && btif_is_niap_mode() &&
+                 btif_in_encrypt_key_name_list(key);
+  RawAddress bd_addr;
+  if (!encrypt &&
+      BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    auto property = BtifDevicePropertyStore::PropertyFromKey(key);
+    if (property) {
+      std::unique_lock<std::recursive_mutex> lock(config_lock);
+      btif_device_property_store.SetBin(bd_addr, *property, value, length);
+      return true;
+    }
+  }
+
   char* str = (char*)osi_calloc(length * 2 + 1);
 
   for (size_t i = 0; i < length; ++i) {
@@ -566,8 +643,7 @@ bool btif_config_set_bin(const std::string& section, const std::string& key,
   }
 
   std::string value_str;
-  if ((length > 0) && btif_is_niap_mode() &&
-      btif_in_encrypt_key_name_list(key)) {
+  if (encrypt) {
     get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
         section + "-" + key, str);
     value_str = ENCRYPTED_STR;
@@ -577,26 +653,129 @@ bool btif_config_set_bin(const std::string& section, const std::string& key,
 
   {
     std::unique_lock<std::recursive_mutex> lock(config_lock);
-    btif_config_cache.SetString(section, key, value_str);
+    btif_config_set_string(section, key, value_str);
   }
 
   osi_free(str);
   return true;
 }
 
-const std::list<section_t>& btif_config_sections() {
-  return btif_config_cache.GetPersistentSections();
-}
-
 bool btif_config_remove(const std::string& section, const std::string& key) {
   if (is_niap_mode() && btif_in_encrypt_key_name_list(key)) {
     get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
         section + "-" + key, "");
   }
   std::unique_lock<std::recursive_mutex> lock(config_lock);
+  RawAddress bd_addr;
+  if (BtifDevicePropertyStore::ParseSectionName(section, &bd_addr)) {
+    return btif_device_property_store.RemoveKey(bd_addr, key);
+  }
   return btif_config_cache.RemoveKey(section, key);
 }
 
+bool btif_config_device_property_exist(const RawAddress& bd_addr,
+                                       DeviceProperty property) {
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  return btif_device_property_store.HasProperty(bd_addr, property);
+}
+
+bool btif_config_get_device_int(const RawAddress& bd_addr,
+                                DeviceProperty property, int* value) {
+  CHECK(value != NULL);
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  auto ret = btif_device_property_store.GetInt(bd_addr, property);
+  if (!ret) {
+    return false;
+  }
+  *value = *ret;
+  return true;
+}
+
+bool btif_config_set_device_int(const RawAddress& bd_addr,
+                                DeviceProperty property, int value) {
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  btif_device_property_store.SetInt(bd_addr, property, value);
+  return true;
+}
+
+bool btif_config_get_device_str(const RawAddress& bd_addr,
+                                DeviceProperty property, char* value,
+                                int* size_bytes) {
+  CHECK(value != NULL);
+  CHECK(size_bytes != NULL);
+
+  {
+    std::unique_lock<std::recursive_mutex> lock(config_lock);
+    auto stored_value = btif_device_property_store.GetString(bd_addr, property);
+    if (!stored_value) return false;
+    strlcpy(value, stored_value->c_str(), *size_bytes);
+  }
+  *size_bytes = strlen(value) + 1;
+  return true;
+}
+
+bool btif_config_set_device_str(const RawAddress& bd_addr,
+                                DeviceProperty property,
+                                const std::string& value) {
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  btif_device_property_store.SetString(bd_addr, property, value);
+  return true;
+}
+
+bool btif_config_get_device_bin(const RawAddress& bd_addr,
+                                DeviceProperty property, uint8_t* value,
+                                size_t* length) {
+  CHECK(value != NULL);
+  CHECK(length != NULL);
+
+  {
+    std::unique_lock<std::recursive_mutex> lock(config_lock);
+    if (!btif_device_property_store.HasProperty(bd_addr, property)) {
+      return false;
+    }
+    if (!btif_is_niap_mode() &&
+        btif_device_property_store.GetBin(bd_addr, property, value, length)) {
+      return true;
+    }
+  }
+
+  // not stored decoded, e.g. held by the keystore
+  return btif_config_get_bin(bd_addr.ToString(),
+                             BtifDevicePropertyStore::KeyName(property), value,
+                             length);
+}
+
+bool btif_config_set_device_bin(const RawAddress& bd_addr,
+                                DeviceProperty property, const uint8_t* value,
+                                size_t length) {
+  const std::string& key = BtifDevicePropertyStore::KeyName(property);
+  if ((length > 0) && btif_is_niap_mode() &&
+      btif_in_encrypt_key_name_list(key)) {
+    return btif_config_set_bin(bd_addr.ToString(), key, value, length);
+  }
+  if (length > 0) CHECK(value != NULL);
+
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  btif_device_property_store.SetBin(bd_addr, property, value, length);
+  return true;
+}
+
+bool btif_config_remove_device_property(const RawAddress& bd_addr,
+                                        DeviceProperty property) {
+  const std::string& key = BtifDevicePropertyStore::KeyName(property);
+  if (is_niap_mode() && btif_in_encrypt_key_name_list(key)) {
+    get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
+        bd_addr.ToString() + "-" + key, "");
+  }
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  return btif_device_property_store.RemoveProperty(bd_addr, property);
+}
+
+std::vector<RawAddress> btif_config_get_persistent_devices() {
+  std::unique_lock<std::recursive_mutex> lock(config_lock);
+  return btif_device_property_store.GetPersistentDevices();
+}
+
 void btif_config_save(void) {
   CHECK(config_timer != NULL);
 
@@ -618,8 +797,9 @@ bool btif_config_clear(void) {
   std::unique_lock<std::recursive_mutex> lock(config_lock);
 
   btif_config_cache.Clear();
+  btif_device_property_store.Clear();
   bool ret = storage_config_get_interface()->config_save(
-      btif_config_cache.PersistentSectionCopy(), CONFIG_FILE_PATH);
+      btif_config_persistent_copy(), CONFIG_FILE_PATH);
   btif_config_source = RESET;
 
   return ret;
@@ -638,8 +818,8 @@ static void btif_config_write(UNUSED_ATTR uint16_t event,
 
   std::unique_lock<std::recursive_mutex> lock(config_lock);
   rename(CONFIG_FILE_PATH, CONFIG_BACKUP_PATH);
-  storage_config_get_interface()->config_save(
-      btif_config_cache.PersistentSectionCopy(), CONFIG_FILE_PATH);
+  storage_config_get_interface()->config_save(btif_config_persistent_copy(),
+                                              CONFIG_FILE_PATH);
   if (btif_is_niap_mode()) {
     get_bluetooth_keystore_interface()->set_encrypt_key_or_remove_key(
         CONFIG_FILE_PREFIX, CONFIG_FILE_HASH);
@@ -677,7 +857,8 @@ void btif_debug_config_dump(int fd) {
   }
 
   dprintf(fd, "  Devices loaded: %zu\n",
-          btif_config_cache.GetPersistentSections().size());
+          btif_config_cache.GetPersistentSections().size() +
+              btif_device_property_store.GetPersistentDeviceCount());
   dprintf(fd, "  File created/tagged: %s\n", btif_config_time_created);
   dprintf(fd, "  File source: %s\n", file_source->c_str());
 }
@@ -0,0 +1,571 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "btif_device_property_store.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "osi/include/log.h"
+
+namespace {
+
+enum PropertyFormat { FORMAT_INT, FORMAT_BIN, FORMAT_STRING };
+
+struct PropertyInfo {
+  std::string key;
+  PropertyFormat format;
+};
+
+// Indexed by DeviceProperty
+const PropertyInfo kPropertyInfo[] = {
+    {"Name", FORMAT_STRING},        {"Aliase", FORMAT_STRING},
+    {"DevClass", FORMAT_INT},       {"DevType", FORMAT_INT},
+    {"AddrType", FORMAT_INT},       {"Timestamp", FORMAT_INT},
+    {"Service", FORMAT_STRING},     {"Manufacturer", FORMAT_INT},
+    {"LmpVer", FORMAT_INT},         {"LmpSubVer", FORMAT_INT},
+    {"LinkKey", FORMAT_BIN},        {"LinkKeyType", FORMAT_INT},
+    {"PinLength", FORMAT_INT},      {"LE_KEY_PENC", FORMAT_BIN},
+    {"LE_KEY_PID", FORMAT_BIN},     {"LE_KEY_PCSRK", FORMAT_BIN},
+    {"LE_KEY_LENC", FORMAT_BIN},    {"LE_KEY_LCSRK", FORMAT_BIN},
+    {"LE_KEY_LID", FORMAT_BIN},     {"MetricsId", FORMAT_INT},
+};
+
+// Same as the link key types of BtifConfigCache
+const DeviceProperty kLinkKeyProperties[] = {
+    DeviceProperty::LINK_KEY,    DeviceProperty::LE_KEY_PENC,
+    DeviceProperty::LE_KEY_PID,  DeviceProperty::LE_KEY_PCSRK,
+    DeviceProperty::LE_KEY_LENC, DeviceProperty::LE_KEY_LCSRK};
+
+const PropertyInfo& property_info(DeviceProperty property) {
+  return kPropertyInfo[static_cast<size_t>(property)];
+}
+
+// only lower case digits are written by btif_config_set_bin
+int lower_hex_digit_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+int hex_digit_value(char c) {
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return lower_hex_digit_value(c);
+}
+
+// trim new line in place, return true if newline was found
+bool trim_new_line(std::string& value) {
+  size_t newline_position = value.find_first_of('\n');
+  if (newline_position != std::string::npos) {
+    value.erase(newline_position);
+    return true;
+  }
+  return false;
+}
+
+std::list<entry_t>::iterator find_entry(std::list<entry_t>& entries,
+                                        const std::string& key) {
+  return std::find_if(
+      entries.begin(), entries.end(),
+      [&key](const entry_t& entry) { return entry.key == key; });
+}
+
+// Same parsing as the BtifConfigCache getters
+std::optional<int> parse_int(const std::string& value) {
+  char* endptr;
+  long ret_long = strtol(value.c_str(), &endptr, 0);
+  if (*endptr != '\0') {
+    LOG(WARNING) << "Failed to parse value to long: " << value;
+    return std::nullopt;
+  }
+  if (ret_long >= std::numeric_limits<int>::max()) {
+    LOG(WARNING) << "Integer overflow when parsing value to int: " << value;
+    return std::nullopt;
+  }
+  return static_cast<int>(ret_long);
+}
+
+std::optional<uint64_t> parse_uint64(const std::string& value) {
+  char* endptr;
+  uint64_t ret = strtoull(value.c_str(), &endptr, 0);
+  if (*endptr != '\0') {
+    LOG(WARNING) << "Failed to parse value to uint64: " << value;
+    return std::nullopt;
+  }
+  return ret;
+}
+
+}  // namespace
+
+BtifDevicePropertyStore::PropertyValue* BtifDevicePropertyStore::DeviceRecord::
+    Find(DeviceProperty property) {
+  for (auto& value : properties) {
+    if (value.property == property) return &value;
+  }
+  return nullptr;
+}
+
+bool BtifDevicePropertyStore::DeviceRecord::Empty() const {
+  return properties.empty() && other_entries.empty();
+}
+
+bool BtifDevicePropertyStore::DeviceRecord::HasLinkKey() const {
+  for (const auto& value : properties) {
+    if (std::find(std::begin(kLinkKeyProperties), std::end(kLinkKeyProperties),
+                  value.property) != std::end(kLinkKeyProperties)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+BtifDevicePropertyStore::BtifDevicePropertyStore(size_t capacity)
+    : unpaired_devices_(capacity, "bt_device_property_store") {}
+
+void BtifDevicePropertyStore::Clear() {
+  persistent_devices_.clear();
+  unpaired_devices_.Clear();
+}
+
+void BtifDevicePropertyStore::Load(config_t* config) {
+  for (auto it = config->sections.begin(); it != config->sections.end();) {
+    RawAddress address;
+    if (!ParseSectionName(it->name, &address)) {
+      it++;
+      continue;
+    }
+
+    // sections differing in case only are merged, like duplicate sections
+    DeviceRecord& record = persistent_devices_[address];
+    for (auto& entry : it->entries) {
+      auto property = PropertyFromKey(entry.key);
+      if (!property) {
+        auto entry_iter = find_entry(record.other_entries, entry.key);
+        if (entry_iter != record.other_entries.end()) {
+          entry_iter->value = std::move(entry.value);
+        } else {
+          record.other_entries.push_back(std::move(entry));
+        }
+        continue;
+      }
+
+      PropertyValue* value = record.Find(*property);
+      if (value == nullptr) {
+        record.properties.push_back({*property, ValueType::STRING, 0, {}});
+        value = &record.properties.back();
+      }
+      ParseValue(value, std::move(entry.value));
+    }
+    it = config->sections.erase(it);
+  }
+}
+
+void BtifDevicePropertyStore::AppendPersistentSections(
+    config_t* config) const {
+  for (const RawAddress& address : GetPersistentDevices()) {
+    const DeviceRecord& record = persistent_devices_.at(address);
+    section_t section;
+    section.name = address.ToString();
+    for (const auto& value : record.properties) {
+      section.entries.push_back({KeyName(value.property), FormatValue(value)});
+    }
+    for (const auto& entry : record.other_entries) {
+      section.entries.push_back(entry);
+    }
+    config->sections.push_back(std::move(section));
+  }
+}
+
+std::vector<RawAddress> BtifDevicePropertyStore::GetPersistentDevices() const {
+  std::vector<RawAddress> devices;
+  devices.reserve(persistent_devices_.size());
+  for (const auto& device : persistent_devices_) {
+    devices.push_back(device.first);
+  }
+  // keep the config file stable between saves
+  std::sort(devices.begin(), devices.end());
+  return devices;
+}
+
+size_t BtifDevicePropertyStore::GetPersistentDeviceCount() const {
+  return persistent_devices_.size();
+}
+
+bool BtifDevicePropertyStore::HasDevice(const RawAddress& address) {
+  return FindRecord(address) != nullptr;
+}
+
+bool BtifDevicePropertyStore::HasProperty(const RawAddress& address,
+                                          DeviceProperty property) {
+  return FindProperty(address, property) != nullptr;
+}
+
+bool BtifDevicePropertyStore::RemoveProperty(const RawAddress& address,
+                                             DeviceProperty property) {
+  DeviceRecord* record = FindRecord(address);
+  if (record == nullptr) return false;
+
+  auto it = std::find_if(
+      record->properties.begin(), record->properties.end(),
+      [property](const PropertyValue& v) { return v.property == property; });
+  if (it == record->properties.end()) return false;
+
+  record->properties.erase(it);
+  OnEntryRemoved(address);
+  return true;
+}
+
+void BtifDevicePropertyStore::RemovePersistentDevicesWithKey(
+    const std::string& key) {
+  auto property = PropertyFromKey(key);
+  for (auto it = persistent_devices_.begin();
+       it != persistent_devices_.end();) {
+    DeviceRecord& record = it->second;
+    bool has_key =
+        property ? record.Find(*property) != nullptr
+                 : find_entry(record.other_entries, key) !=
+                       record.other_entries.end();
+    if (has_key) {
+      it = persistent_devices_.erase(it);
+      continue;
+    }
+    it++;
+  }
+}
+
+std::optional<int> BtifDevicePropertyStore::GetInt(const RawAddress& address,
+                                                   DeviceProperty property) {
+  PropertyValue* value = FindProperty(address, property);
+  if (value == nullptr) return std::nullopt;
+  if (value->type != ValueType::INT) return parse_int(FormatValue(*value));
+
+  if (value->int_value >= std::numeric_limits<int>::max()) {
+    LOG(WARNING) << "Integer overflow for " << KeyName(property) << ": "
+                 << value->int_value;
+    return std::nullopt;
+  }
+  return static_cast<int>(value->int_value);
+}
+
+void BtifDevicePropertyStore::SetInt(const RawAddress& address,
+                                     DeviceProperty property, int value) {
+  DeviceRecord* record = FindOrAddRecord(address);
+  PropertyValue* stored = record->Find(property);
+  if (stored == nullptr) {
+    record->properties.push_back({property, ValueType::INT, value, {}});
+  } else {
+    stored->type = ValueType::INT;
+    stored->int_value = value;
+    stored->data.clear();
+  }
+  OnPropertySet(address, property);
+}
+
+bool BtifDevicePropertyStore::GetBin(const RawAddress& address,
+                                     DeviceProperty property, uint8_t* value,
+                                     size_t* length) {
+  PropertyValue* stored = FindProperty(address, property);
+  if (stored == nullptr || stored->type != ValueType::BIN) return false;
+
+  if (*length < stored->data.size()) {
+    LOG(WARNING) << __func__ << ": buffer too small for " << KeyName(property)
+                 << ", size is " << stored->data.size();
+    return false;
+  }
+  std::copy(stored->data.begin(), stored->data.end(), value);
+  *length = stored->data.size();
+  return true;
+}
+
+void BtifDevicePropertyStore::SetBin(const RawAddress& address,
+                                     DeviceProperty property,
+                                     const uint8_t* value, size_t length) {
+  DeviceRecord* record = FindOrAddRecord(address);
+  PropertyValue* stored = record->Find(property);
+  if (stored == nullptr) {
+    record->properties.push_back({property, ValueType::BIN, 0, {}});
+    stored = &record->properties.back();
+  }
+  stored->type = ValueType::BIN;
+  stored->data.assign(reinterpret_cast<const char*>(value), length);
+  OnPropertySet(address, property);
+}
+
+std::optional<std::string> BtifDevicePropertyStore::GetString(
+    const RawAddress& address, DeviceProperty property) {
+  PropertyValue* value = FindProperty(address, property);
+  if (value == nullptr) return std::nullopt;
+  return FormatValue(*value);
+}
+
+void BtifDevicePropertyStore::SetString(const RawAddress& address,
+                                        DeviceProperty property,
+                                        std::string value) {
+  if (trim_new_line(value)) {
+    android_errorWriteLog(0x534e4554, "70808273");
+  }
+  DeviceRecord* record = FindOrAddRecord(address);
+  PropertyValue* stored = record->Find(property);
+  if (stored == nullptr) {
+    record->properties.push_back({property, ValueType::STRING, 0, {}});
+    stored = &record->properties.back();
+  }
+  ParseValue(stored, std::move(value));
+  OnPropertySet(address, property);
+}
+
+bool BtifDevicePropertyStore::HasKey(const RawAddress& address,
+                                     const std::string& key) {
+  auto property = PropertyFromKey(key);
+  if (property) return HasProperty(address, *property);
+
+  DeviceRecord* record = FindRecord(address);
+  return record != nullptr && find_entry(record->other_entries, key) !=
+                                  record->other_entries.end();
+}
+
+bool BtifDevicePropertyStore::RemoveKey(const RawAddress& address,
+                                        const std::string& key) {
+  auto property = PropertyFromKey(key);
+  if (property) return RemoveProperty(address, *property);
+
+  DeviceRecord* record = FindRecord(address);
+  if (record == nullptr) return false;
+  auto entry_iter = find_entry(record->other_entries, key);
+  if (entry_iter == record->other_entries.end()) return false;
+
+  record->other_entries.erase(entry_iter);
+  OnEntryRemoved(address);
+  return true;
+}
+
+std::optional<std::string> BtifDevicePropertyStore::GetString(
+    const RawAddress& address, const std::string& key) {
+  auto property = PropertyFromKey(key);
+  if (property) return GetString(address, *property);
+
+  DeviceRecord* record = FindRecord(address);
+  if (record == nullptr) return std::nullopt;
+  auto entry_iter = find_entry(record->other_entries, key);
+  if (entry_iter == record->other_entries.end()) return std::nullopt;
+  return entry_iter->value;
+}
+
+void BtifDevicePropertyStore::SetString(const RawAddress& address,
+                                        const std::string& key,
+                                        std::string value) {
+  auto property = PropertyFromKey(key);
+  if (property) {
+    SetString(address, *property, std::move(value));
+    return;
+  }
+
+  std::string trimmed_key = key;
+  if (trim_new_line(trimmed_key) || trim_new_line(value)) {
+    android_errorWriteLog(0x534e4554, "70808273");
+  }
+  if (trimmed_key.empty()) {
+    LOG(FATAL) << "Empty key not allowed";
+    return;
+  }
+
+  DeviceRecord* record = FindOrAddRecord(address);
+  auto entry_iter = find_entry(record->other_entries, trimmed_key);
+  if (entry_iter != record->other_entries.end()) {
+    entry_iter->value = std::move(value);
+  } else {
+    record->other_entries.push_back({std::move(trimmed_key), std::move(value)});
+  }
+}
+
+std::optional<int> BtifDevicePropertyStore::GetInt(const RawAddress& address,
+                                                   const std::string& key) {
+  auto property = PropertyFromKey(key);
+  if (property) return GetInt(address, *property);
+
+  auto value = GetString(address, key);
+  if (!value) return std::nullopt;
+  return parse_int(*value);
+}
+
+std::optional<uint64_t> BtifDevicePropertyStore::GetUint64(
+    const RawAddress& address, const std::string& key) {
+  auto property = PropertyFromKey(key);
+  if (property) {
+    PropertyValue* value = FindProperty(address, *property);
+    if (value != nullptr && value->type == ValueType::INT) {
+      return static_cast<uint64_t>(value->int_value);
+    }
+  }
+
+  auto value = GetString(address, key);
+  if (!value) return std::nullopt;
+  return parse_uint64(*value);
+}
+
+bool BtifDevicePropertyStore::ParseSectionName(const std::string& section,
+                                               RawAddress* address) {
+  if (section.length() != 17) return false;
+
+  for (size_t i = 0; i < RawAddress::kLength; i++) {
+    if (i > 0 && section[i * 3 - 1] != ':') return false;
+    int high = hex_digit_value(section[i * 3]);
+    int low = hex_digit_value(section[i * 3 + 1]);
+    if (high < 0 || low < 0) return false;
+    address->address[i] = (high << 4) | low;
+  }
+  return true;
+}
+
+std::optional<DeviceProperty> BtifDevicePropertyStore::PropertyFromKey(
+    const std::string& key) {
+  static const auto* properties = [] {
+    auto* map = new std::unordered_map<std::string, DeviceProperty>();
+    for (size_t i = 0; i < std::size(kPropertyInfo); i++) {
+      map->emplace(kPropertyInfo[i].key, static_cast<DeviceProperty>(i));
+    }
+    return map;
+  }();
+
+  auto it = properties->find(key);
+  if (it == properties->end()) return std::nullopt;
+  return it->second;
+}
+
+const std::string& BtifDevicePropertyStore::KeyName(DeviceProperty property) {
+  return property_info(property).key;
+}
+
+BtifDevicePropertyStore::DeviceRecord* BtifDevicePropertyStore::FindRecord(
+    const RawAddress& address) {
+  auto it = persistent_devices_.find(address);
+  if (it != persistent_devices_.end()) return &it->second;
+  return unpaired_devices_.Find(address);
+}
+
+BtifDevicePropertyStore::PropertyValue* BtifDevicePropertyStore::FindProperty(
+    const RawAddress& address, DeviceProperty property) {
+  DeviceRecord* record = FindRecord(address);
+  if (record == nullptr) return nullptr;
+  return record->Find(property);
+}
+
+BtifDevicePropertyStore::DeviceRecord* BtifDevicePropertyStore::FindOrAddRecord(
+    const RawAddress& address) {
+  DeviceRecord* record = FindRecord(address);
+  if (record != nullptr) return record;
+
+  unpaired_devices_.Put(address, DeviceRecord());
+  return unpaired_devices_.Find(address);
+}
+
+void BtifDevicePropertyStore::OnPropertySet(const RawAddress& address,
+                                            DeviceProperty property) {
+  if (std::find(std::begin(kLinkKeyProperties), std::end(kLinkKeyProperties),
+                property) == std::end(kLinkKeyProperties)) {
+    return;
+  }
+  if (persistent_devices_.count(address) != 0) return;
+
+  // when an unpaired device got a link key, move it to the persistent devices
+  DeviceRecord* record = unpaired_devices_.Find(address);
+  if (record == nullptr) return;
+  persistent_devices_.emplace(address, std::move(*record));
+  unpaired_devices_.Remove(address);
+}
+
+/* the device is removed when empty, a persistent device without link key is
+ * moved to the unpaired devices */
+void BtifDevicePropertyStore::OnEntryRemoved(const RawAddress& address) {
+  auto it = persistent_devices_.find(address);
+  if (it != persistent_devices_.end()) {
+    if (it->second.Empty()) {
+      persistent_devices_.erase(it);
+    } else if (!it->second.HasLinkKey()) {
+      unpaired_devices_.Put(address, std::move(it->second));
+      persistent_devices_.erase(it);
+    }
+    return;
+  }
+
+  DeviceRecord* record = unpaired_devices_.Find(address);
+  if (record != nullptr && record->Empty()) {
+    unpaired_devices_.Remove(address);
+  }
+}
+
+/* values are decoded only when they format back to the same text, so that
+ * any value round-trips through the store */
+void BtifDevicePropertyStore::ParseValue(PropertyValue* value,
+                                         std::string text) {
+  switch (property_info(value->property).format) {
+    case FORMAT_INT: {
+      if (text.empty()) break;
+      char* endptr;
+      long long parsed = strtoll(text.c_str(), &endptr, 10);
+      if (*endptr != '\0' || std::to_string(parsed) != text) break;
+      value->type = ValueType::INT;
+      value->int_value = parsed;
+      value->data.clear();
+      return;
+    }
+
+    case FORMAT_BIN: {
+      if (text.length() % 2 != 0) break;
+      std::string bytes;
+      bytes.reserve(text.length() / 2);
+      size_t i = 0;
+      for (; i < text.length(); i += 2) {
+        int high = lower_hex_digit_value(text[i]);
+        int low = lower_hex_digit_value(text[i + 1]);
+        if (high < 0 || low < 0) break;
+        bytes.push_back(static_cast<char>((high << 4) | low));
+      }
+      if (i < text.length()) break;
+      value->type = ValueType::BIN;
+      value->data = std::move(bytes);
+      return;
+    }
+
+    case FORMAT_STRING:
+      break;
+  }
+
+  value->type = ValueType::STRING;
+  value->data = std::move(text);
+}
+
+std::string BtifDevicePropertyStore::FormatValue(const PropertyValue& value) {
+  static const char* lookup = "0123456789abcdef";
+  switch (value.type) {
+    case ValueType::INT:
+      return std::to_string(value.int_value);
+    case ValueType::BIN: {
+      std::string text;
+      text.reserve(value.data.size() * 2);
+      for (char c : value.data) {
+        uint8_t byte = static_cast<uint8_t>(c);
+        text.push_back(lookup[byte >> 4]);
+        text.push_back(lookup[byte & 0x0F]);
+      }
+      return text;
+    }
+    case ValueType::STRING:
+      break;
+  }
+  return value.data;
+}
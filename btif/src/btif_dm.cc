@@ -78,7 +78,7 @@ using bluetooth::common::MetricIdAllocator;
  *  Constants & Macros
  *****************************************************************************/
 
-const Uuid UUID_HEARING_AID = Uuid::FromString("FDF0");
+constexpr Uuid UUID_HEARING_AID = Uuid::FromLiteral("FDF0");
 
 #define COD_MASK 0x07FF
 
@@ -33,6 +33,7 @@
 #include <hardware/bluetooth.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include "device/include/controller.h"
 
 #include "btif_common.h"
@@ -45,15 +46,19 @@
 #include "btif_config.h"
 #include "btif_dm.h"
 #include "btif_gatt.h"
+#include "btif_gatt_notify_batcher.h"
 #include "btif_gatt_util.h"
 #include "btif_storage.h"
+#include "common/latency_tracer.h"
 #include "osi/include/log.h"
+#include "osi/include/properties.h"
 #include "stack/include/btu.h"
 #include "vendor_api.h"
 
 using base::Bind;
 using base::Owned;
 using bluetooth::Uuid;
+using bluetooth::common::LatencyTracer;
 using std::vector;
 
 extern bt_status_t btif_gattc_test_command_impl(
@@ -84,6 +89,14 @@ extern const btgatt_callbacks_t* bt_gatt_callbacks;
     }                                                            \
   } while (0)
 
+/* Window in ms for batching GATT notifications, 0 disables batching */
+#define GATT_NOTIFY_BATCH_WINDOW_PROPERTY \
+  "persist.bluetooth.gatt_notify_batch_ms"
+/* Notifications after which a batch is delivered before its window ends */
+#define GATT_NOTIFY_BATCH_SIZE_PROPERTY \
+  "persist.bluetooth.gatt_notify_batch_size"
+#define GATT_NOTIFY_BATCH_SIZE_DEFAULT 32
+
 #define BLE_RESOLVE_ADDR_MSB                                                   \
   0x40                             /* bit7, bit6 is 01 to be resolvable random \
                                       */
@@ -125,8 +138,10 @@ void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
       data.is_notify = p_data->notify.is_notify;
       data.len = p_data->notify.len;
 
+      LatencyTracer::Resume(p_data, LatencyTracer::JNI_CALLBACK);
       HAL_CBACK(bt_gatt_callbacks, client->notify_cb, p_data->notify.conn_id,
                 data);
+      LatencyTracer::End();
 
       if (!p_data->notify.is_notify)
         BTA_GATTC_SendIndConfirm(p_data->notify.conn_id, p_data->notify.handle);
@@ -200,10 +215,74 @@ void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
   }
 }
 
+void post_to_jni_thread(std::function<void()> task, uint64_t delay_ms) {
+  base::MessageLoop* jni_message_loop = get_jni_message_loop();
+  if (jni_message_loop == nullptr) return;
+  jni_message_loop->task_runner()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind([](const std::function<void()>& task) { task(); },
+                 std::move(task)),
+      base::TimeDelta::FromMilliseconds(delay_ms));
+}
+
+void deliver_notify_batch(int conn_id, const btgatt_notify_batch_t& batch) {
+  HAL_CBACK(bt_gatt_callbacks, client->notify_batch_cb, conn_id, batch);
+}
+
+/* Returns the notification batcher if batching is enabled, nullptr if each
+ * notification is delivered on its own */
+BtifGattNotifyBatcher* notify_batcher() {
+  static BtifGattNotifyBatcher* batcher = []() -> BtifGattNotifyBatcher* {
+    int32_t window_ms =
+        osi_property_get_int32(GATT_NOTIFY_BATCH_WINDOW_PROPERTY, 0);
+    if (window_ms <= 0) return nullptr;
+    int32_t max_batch_size = osi_property_get_int32(
+        GATT_NOTIFY_BATCH_SIZE_PROPERTY, GATT_NOTIFY_BATCH_SIZE_DEFAULT);
+    LOG_INFO(LOG_TAG, "%s: batching notifications for %d ms, up to %d",
+             __func__, window_ms, max_batch_size);
+    return new BtifGattNotifyBatcher(window_ms, std::max(max_batch_size, 1),
+                                     post_to_jni_thread, deliver_notify_batch);
+  }();
+  if (batcher == nullptr || bt_gatt_callbacks == nullptr ||
+      bt_gatt_callbacks->client->notify_batch_cb == nullptr)
+    return nullptr;
+  return batcher;
+}
+
+/* Copies a notification for the JNI thread and parks the trace of the calling
+ * thread under the copy, btif_gattc_upstreams_evt() resumes it from there */
+static void btif_gattc_copy_notify(uint16_t event, char* p_dest,
+                                   char* p_src) {
+  memcpy(p_dest, p_src, sizeof(tBTA_GATTC));
+  LatencyTracer::Park(p_dest);
+}
+
 void bta_gattc_cback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
+  tBTIF_COPY_CBACK* p_copy_cback = NULL;
+  if (event == BTA_GATTC_NOTIF_EVT) {
+    LatencyTracer::Stamp(LatencyTracer::BTIF_DISPATCH);
+    BtifGattNotifyBatcher* batcher = notify_batcher();
+    if (batcher != nullptr) {
+      const tBTA_GATTC_NOTIFY& notify = p_data->notify;
+      if (notify.is_notify) {
+        /* the trace does not follow the notification into its batch */
+        LatencyTracer::End();
+        batcher->Add(notify.conn_id, notify.bda, notify.handle, notify.value,
+                     notify.len);
+        return;
+      }
+      /* indications need a confirmation, keep them in order behind the
+       * notifications received before */
+      batcher->Flush(notify.conn_id);
+    }
+    p_copy_cback = btif_gattc_copy_notify;
+  } else if (event == BTA_GATTC_CLOSE_EVT) {
+    BtifGattNotifyBatcher* batcher = notify_batcher();
+    if (batcher != nullptr) batcher->Flush(p_data->close.conn_id);
+  }
   bt_status_t status =
       btif_transfer_context(btif_gattc_upstreams_evt, (uint16_t)event,
-                            (char*)p_data, sizeof(tBTA_GATTC), NULL);
+                            (char*)p_data, sizeof(tBTA_GATTC), p_copy_cback);
   ASSERTC(status == BT_STATUS_SUCCESS, "Context transfer failed!", status);
 }
 
@@ -0,0 +1,108 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "btif_gatt_notify_batcher.h"
+
+#include <utility>
+
+namespace {
+
+// Typical notification value for the initial reservation of a batch buffer
+constexpr size_t kExpectedValueSize = 20;
+
+}  // namespace
+
+BtifGattNotifyBatcher::BtifGattNotifyBatcher(uint64_t window_ms,
+                                             size_t max_batch_size,
+                                             Scheduler scheduler,
+                                             BatchCallback callback)
+    : window_ms_(window_ms),
+      max_batch_size_(max_batch_size),
+      scheduler_(std::move(scheduler)),
+      callback_(std::move(callback)) {}
+
+void BtifGattNotifyBatcher::Add(int conn_id, const RawAddress& bda,
+                                uint16_t handle, const uint8_t* value,
+                                uint16_t len) {
+  bool started_batch = false;
+  uint64_t generation = 0;
+  bool batch_full = false;
+  btgatt_notify_batch_t full_batch;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = pending_.find(conn_id);
+    if (it == pending_.end()) {
+      started_batch = true;
+      generation = next_generation_++;
+      it = pending_.emplace(conn_id, PendingBatch{generation, {}}).first;
+      it->second.batch.bda = bda;
+      it->second.batch.entries.reserve(max_batch_size_);
+      it->second.batch.values.reserve(max_batch_size_ * kExpectedValueSize);
+    }
+
+    btgatt_notify_batch_t& batch = it->second.batch;
+    batch.entries.push_back(
+        {handle, len, static_cast<uint32_t>(batch.values.size())});
+    batch.values.insert(batch.values.end(), value, value + len);
+    if (batch.entries.size() >= max_batch_size_) {
+      batch_full = true;
+      full_batch = std::move(batch);
+      pending_.erase(it);
+    }
+  }
+
+  if (batch_full) {
+    ScheduleDelivery(conn_id, std::move(full_batch));
+  } else if (started_batch) {
+    scheduler_(
+        [this, conn_id, generation] { OnWindowExpired(conn_id, generation); },
+        window_ms_);
+  }
+}
+
+void BtifGattNotifyBatcher::Flush(int conn_id) {
+  btgatt_notify_batch_t batch;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = pending_.find(conn_id);
+    if (it == pending_.end()) return;
+    batch = std::move(it->second.batch);
+    pending_.erase(it);
+  }
+  ScheduleDelivery(conn_id, std::move(batch));
+}
+
+void BtifGattNotifyBatcher::ScheduleDelivery(int conn_id,
+                                             btgatt_notify_batch_t batch) {
+  scheduler_(
+      [this, conn_id, batch = std::move(batch)] { callback_(conn_id, batch); },
+      0);
+}
+
+void BtifGattNotifyBatcher::OnWindowExpired(int conn_id, uint64_t generation) {
+  btgatt_notify_batch_t batch;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = pending_.find(conn_id);
+    // The batch may have been delivered early because it filled up or was
+    // flushed; a newer batch has its own window
+    if (it == pending_.end() || it->second.generation != generation) return;
+    batch = std::move(it->second.batch);
+    pending_.erase(it);
+  }
+  // Already on the delivery thread
+  callback_(conn_id, batch);
+}
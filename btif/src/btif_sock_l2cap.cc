@@ -24,9 +24,9 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
-#include <vector>
 
 #include <mutex>
+#include <unordered_map>
 
 #include <frameworks/base/core/proto/android/bluetooth/enums.pb.h>
 #include <hardware/bt_sock.h>
@@ -39,6 +39,7 @@
 #include "bta_jv_api.h"
 #include "bta_jv_co.h"
 #include "btif_common.h"
+#include "btif_sock_l2cap_rx_queue.h"
 #include "btif_sock_sdp.h"
 #include "btif_sock_thread.h"
 #include "btif_sock_util.h"
@@ -55,15 +56,7 @@
 #include "port_api.h"
 #include "sdp_api.h"
 
-struct packet {
-  struct packet *next, *prev;
-  uint32_t len;
-  uint8_t* data;
-};
-
 typedef struct l2cap_socket {
-  struct l2cap_socket* prev;  // link to prev list item
-  struct l2cap_socket* next;  // link to next list item
   RawAddress addr;            // other side's address
   char name[256];             // user-friendly name of the service
   uint32_t id;                // just a tag to find this struct
@@ -74,9 +67,8 @@ typedef struct l2cap_socket {
   int our_fd;                 // fd from our side
   int app_fd;                 // fd from app's side
 
-  unsigned bytes_buffered;
-  struct packet* first_packet;  // fist packet to be delivered to app
-  struct packet* last_packet;   // last packet to be delivered to app
+  // SDUs received from the stack, to be delivered to app
+  BtifSockL2capRxQueue* rx_queue;
 
   unsigned fixed_chan : 1;        // fixed channel (or psm?)
   unsigned server : 1;            // is a server? (or connecting?)
@@ -96,7 +88,8 @@ static void btsock_l2cap_server_listen(l2cap_socket* sock);
 
 static std::mutex state_lock;
 
-l2cap_socket* socks = NULL;
+// All the sockets, by id
+static std::unordered_map<uint32_t, l2cap_socket*> socks;
 static uint32_t last_sock_id = 0;
 static uid_set_t* uid_set = NULL;
 static int pth = -1;
@@ -104,101 +97,6 @@ static int pth = -1;
 static void btsock_l2cap_cbk(tBTA_JV_EVT event, tBTA_JV* p_data,
                              uint32_t l2cap_socket_id);
 
-/* TODO: Consider to remove this buffer, as we have a buffer in l2cap as well,
- * and we risk
- *       a buffer overflow with this implementation if the socket data is not
- * read from
- *       JAVA for a while. In such a case we should use flow control to tell the
- * sender to
- *       back off.
- *       BUT remember we need to avoid blocking the BTA task execution - hence
- * we cannot
- *       directly write to the socket.
- *       we should be able to change to store the data pointer here, and just
- * wait
- *       confirming the l2cap_ind until we have more space in the buffer. */
-
-/* returns false if none - caller must free "data" memory when done with it */
-static char packet_get_head_l(l2cap_socket* sock, uint8_t** data,
-                              uint32_t* len) {
-  struct packet* p = sock->first_packet;
-
-  if (!p) return false;
-
-  if (data) *data = sock->first_packet->data;
-  if (len) *len = sock->first_packet->len;
-  sock->first_packet = p->next;
-  if (sock->first_packet)
-    sock->first_packet->prev = NULL;
-  else
-    sock->last_packet = NULL;
-
-  if (len) sock->bytes_buffered -= *len;
-
-  osi_free(p);
-
-  return true;
-}
-
-static struct packet* packet_alloc(const uint8_t* data, uint32_t len) {
-  struct packet* p = (struct packet*)osi_calloc(sizeof(*p));
-  uint8_t* buf = (uint8_t*)osi_malloc(len);
-
-  p->data = buf;
-  p->len = len;
-  memcpy(p->data, data, len);
-  return p;
-}
-
-/* makes a copy of the data, returns true on success */
-static char packet_put_head_l(l2cap_socket* sock, const void* data,
-                              uint32_t len) {
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
-
-  /*
-   * We do not check size limits here since this is used to undo "getting" a
-   * packet that the user read incompletely. That is to say the packet was
-   * already in the queue. We do check thos elimits in packet_put_tail_l() since
-   * that function is used to put new data into the queue.
-   */
-
-  if (!p) return false;
-
-  p->prev = NULL;
-  p->next = sock->first_packet;
-  sock->first_packet = p;
-  if (p->next)
-    p->next->prev = p;
-  else
-    sock->last_packet = p;
-
-  sock->bytes_buffered += len;
-
-  return true;
-}
-
-/* makes a copy of the data, returns true on success */
-static char packet_put_tail_l(l2cap_socket* sock, const void* data,
-                              uint32_t len) {
-  if (sock->bytes_buffered >= L2CAP_MAX_RX_BUFFER) {
-    LOG(ERROR) << __func__ << ": buffer overflow";
-    return false;
-  }
-
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
-  p->next = NULL;
-  p->prev = sock->last_packet;
-  sock->last_packet = p;
-  if (p->prev)
-    p->prev->next = p;
-  else
-    sock->first_packet = p;
-
-  sock->bytes_buffered += len;
-
-  return true;
-}
-
 static char is_inited(void) {
   std::unique_lock<std::mutex> lock(state_lock);
   return pth != -1;
@@ -206,20 +104,18 @@ static char is_inited(void) {
 
 /* only call with std::mutex taken */
 static l2cap_socket* btsock_l2cap_find_by_id_l(uint32_t id) {
-  l2cap_socket* sock = socks;
-
-  while (sock && sock->id != id) sock = sock->next;
+  auto it = socks.find(id);
+  return it != socks.end() ? it->second : NULL;
+}
 
-  return sock;
+/* only call with std::mutex taken, to hand over |id| to |sock| */
+static void btsock_l2cap_set_id_l(l2cap_socket* sock, uint32_t id) {
+  sock->id = id;
+  socks[id] = sock;
 }
 
 static void btsock_l2cap_free_l(l2cap_socket* sock) {
-  uint8_t* buf;
-  l2cap_socket* t = socks;
-
-  while (t && t != sock) t = t->next;
-
-  if (!t) /* prever double-frees */
+  if (btsock_l2cap_find_by_id_l(sock->id) != sock) /* prever double-frees */
     return;
 
   // Whenever a socket is freed, the connection must be dropped
@@ -230,12 +126,7 @@ static void btsock_l2cap_free_l(l2cap_socket* sock) {
       sock->server ? android::bluetooth::SOCKET_ROLE_LISTEN
                    : android::bluetooth::SOCKET_ROLE_CONNECTION);
 
-  if (sock->next) sock->next->prev = sock->prev;
-
-  if (sock->prev)
-    sock->prev->next = sock->next;
-  else
-    socks = sock->next;
+  socks.erase(sock->id);
 
   shutdown(sock->our_fd, SHUT_RDWR);
   close(sock->our_fd);
@@ -245,7 +136,7 @@ static void btsock_l2cap_free_l(l2cap_socket* sock) {
     LOG(ERROR) << "SOCK_LIST: free(id = " << sock->id << ") - NO app_fd!";
   }
 
-  while (packet_get_head_l(sock, &buf, NULL)) osi_free(buf);
+  delete sock->rx_queue;
 
   // lower-level close() should be idempotent... so let's call it and see...
   if (sock->is_le_coc) {
@@ -320,32 +211,21 @@ static l2cap_socket* btsock_l2cap_alloc_l(const char* name,
   if (name) strncpy(sock->name, name, sizeof(sock->name) - 1);
   if (addr) sock->addr = *addr;
 
-  sock->first_packet = NULL;
-  sock->last_packet = NULL;
+  sock->rx_queue = new BtifSockL2capRxQueue(L2CAP_MAX_RX_BUFFER);
 
   sock->tx_mtu = L2CAP_LE_MIN_MTU;
 
-  sock->next = socks;
-  sock->prev = NULL;
-  if (socks) socks->prev = sock;
   sock->id = last_sock_id + 1;
   sock->tx_bytes = 0;
   sock->rx_bytes = 0;
-  socks = sock;
   /* paranoia cap on: verify no ID duplicates due to overflow and fix as needed
    */
-  while (1) {
-    l2cap_socket* t;
-    t = socks->next;
-    while (t && t->id != sock->id) {
-      t = t->next;
-    }
-    if (!t && sock->id) /* non-zeor handle is unique -> we're done */
-      break;
+  while (!sock->id || socks.count(sock->id)) {
     /* if we're here, we found a duplicate */
     if (!++sock->id) /* no zero IDs allowed */
       sock->id++;
   }
+  socks[sock->id] = sock;
   last_sock_id = sock->id;
   DVLOG(2) << __func__ << " SOCK_LIST: alloc id:" << sock->id;
   return sock;
@@ -359,7 +239,7 @@ bt_status_t btsock_l2cap_init(int handle, uid_set_t* set) {
   DVLOG(2) << __func__ << ": handle: " << handle;
   std::unique_lock<std::mutex> lock(state_lock);
   pth = handle;
-  socks = NULL;
+  socks.clear();
   uid_set = set;
   return BT_STATUS_SUCCESS;
 }
@@ -367,7 +247,7 @@ bt_status_t btsock_l2cap_init(int handle, uid_set_t* set) {
 bt_status_t btsock_l2cap_cleanup() {
   std::unique_lock<std::mutex> lock(state_lock);
   pth = -1;
-  while (socks) btsock_l2cap_free_l(socks);
+  while (!socks.empty()) btsock_l2cap_free_l(socks.begin()->second);
   return BT_STATUS_SUCCESS;
 }
 
@@ -476,8 +356,8 @@ static void on_srv_l2cap_psm_connect_l(tBTA_JV_L2CAP_OPEN* p_open,
   /* Swap IDs to hand over the GAP connection to the accepted socket, and start
      a new server on the newly create socket ID. */
   uint32_t new_listen_id = accept_rs->id;
-  accept_rs->id = sock->id;
-  sock->id = new_listen_id;
+  btsock_l2cap_set_id_l(accept_rs, sock->id);
+  btsock_l2cap_set_id_l(sock, new_listen_id);
 
   bluetooth::common::LogSocketConnectionState(
       accept_rs->addr, accept_rs->id,
@@ -513,8 +393,8 @@ static void on_srv_l2cap_le_connect_l(tBTA_JV_L2CAP_LE_OPEN* p_open,
 
   // swap IDs
   uint32_t new_listen_id = accept_rs->id;
-  accept_rs->id = sock->id;
-  sock->id = new_listen_id;
+  btsock_l2cap_set_id_l(accept_rs, sock->id);
+  btsock_l2cap_set_id_l(sock, new_listen_id);
 
   accept_rs->handle = p_open->handle;
   accept_rs->connected = true;
@@ -713,42 +593,44 @@ static void on_l2cap_data_ind(tBTA_JV* evt, uint32_t id) {
 
   if (sock->fixed_chan) { /* we do these differently */
 
-    tBTA_JV_LE_DATA_IND* p_le_data_ind = &evt->le_data_ind;
-    BT_HDR* p_buf = p_le_data_ind->p_buf;
-    uint8_t* data = (uint8_t*)(p_buf + 1) + p_buf->offset;
+    // The buffer is handed over to us, and is queued as is
+    BT_HDR* p_buf = evt->le_data_ind.p_buf;
+    uint16_t len = p_buf->len;
 
-    if (packet_put_tail_l(sock, data, p_buf->len)) {
-      bytes_read = p_buf->len;
+    if (sock->rx_queue->Enqueue(p_buf)) {
+      bytes_read = len;
       btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR,
                            sock->id);
     } else {  // connection must be dropped
+      LOG(ERROR) << __func__ << ": buffer overflow";
       DVLOG(2) << __func__
                << ": unable to push data to socket - closing  fixed channel";
+      osi_free(p_buf);
       BTA_JvL2capCloseLE(sock->handle);
       btsock_l2cap_free_l(sock);
       return;
     }
 
   } else {
-    uint32_t count;
-
-    if (BTA_JvL2capReady(sock->handle, &count) == BTA_JV_SUCCESS) {
-      std::vector<uint8_t> buffer(count);
-      if (BTA_JvL2capRead(sock->handle, sock->id, buffer.data(), count) ==
-          BTA_JV_SUCCESS) {
-        if (packet_put_tail_l(sock, buffer.data(), count)) {
-          bytes_read = count;
-          btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP,
-                               SOCK_THREAD_FD_WR, sock->id);
-        } else {  // connection must be dropped
-          DVLOG(2) << __func__
-                   << ": unable to push data to socket - closing channel";
-          BTA_JvL2capClose(sock->handle);
-          btsock_l2cap_free_l(sock);
-          return;
-        }
+    // Moves the received SDUs from the GAP queue to ours, one buffer each
+    BT_HDR* p_buf;
+
+    while (BTA_JvL2capReadBuf(sock->handle, &p_buf) == BTA_JV_SUCCESS) {
+      uint16_t len = p_buf->len;
+      if (!sock->rx_queue->Enqueue(p_buf)) {  // connection must be dropped
+        LOG(ERROR) << __func__ << ": buffer overflow";
+        DVLOG(2) << __func__
+                 << ": unable to push data to socket - closing channel";
+        osi_free(p_buf);
+        BTA_JvL2capClose(sock->handle);
+        btsock_l2cap_free_l(sock);
+        return;
       }
+      bytes_read += len;
     }
+    if (bytes_read)
+      btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR,
+                           sock->id);
   }
 
   sock->rx_bytes += bytes_read;
@@ -964,36 +846,6 @@ bt_status_t btsock_l2cap_connect(const RawAddress* bd_addr, int channel,
                                         0, app_uid);
 }
 
-/* return true if we have more to send and should wait for user readiness, false
- * else
- * (for example: unrecoverable error or no data)
- */
-static bool flush_incoming_que_on_wr_signal_l(l2cap_socket* sock) {
-  uint8_t* buf;
-  uint32_t len;
-
-  while (packet_get_head_l(sock, &buf, &len)) {
-    ssize_t sent;
-    OSI_NO_INTR(sent = send(sock->our_fd, buf, len, MSG_DONTWAIT));
-    int saved_errno = errno;
-
-    if (sent == (signed)len)
-      osi_free(buf);
-    else if (sent >= 0) {
-      packet_put_head_l(sock, buf + sent, len - sent);
-      osi_free(buf);
-      if (!sent) /* special case if other end not keeping up */
-        return true;
-    } else {
-      packet_put_head_l(sock, buf, len);
-      osi_free(buf);
-      return saved_errno == EWOULDBLOCK || saved_errno == EAGAIN;
-    }
-  }
-
-  return false;
-}
-
 inline BT_HDR* malloc_l2cap_buf(uint16_t len) {
   // We need FCS only for L2CAP_FCR_ERTM_MODE, but it's just 2 bytes so it's ok
   BT_HDR* msg = (BT_HDR*)osi_malloc(BT_HDR_SIZE + L2CAP_MIN_OFFSET + len +
@@ -1064,7 +916,7 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
   }
   if (flags & SOCK_THREAD_FD_WR) {
     // app is ready to receive more data, tell stack to enable the data flow
-    if (flush_incoming_que_on_wr_signal_l(sock) && sock->connected)
+    if (sock->rx_queue->Flush(sock->our_fd) && sock->connected)
       btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR,
                            sock->id);
   }
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif_sock_l2cap_rx_queue.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+
+#include "osi/include/allocator.h"
+#include "osi/include/osi.h"
+
+namespace {
+
+// SDUs handed to the socket per sendmmsg() call
+constexpr size_t kMaxFlushBatch = 16;
+
+}  // namespace
+
+BtifSockL2capRxQueue::BtifSockL2capRxQueue(size_t max_bytes)
+    : max_bytes_(max_bytes), bytes_buffered_(0) {}
+
+BtifSockL2capRxQueue::~BtifSockL2capRxQueue() {
+  for (BT_HDR* p_buf : buffers_) osi_free(p_buf);
+}
+
+bool BtifSockL2capRxQueue::Enqueue(BT_HDR* p_buf) {
+  if (bytes_buffered_ >= max_bytes_) return false;
+
+  buffers_.push_back(p_buf);
+  bytes_buffered_ += p_buf->len;
+  return true;
+}
+
+bool BtifSockL2capRxQueue::Flush(int fd) {
+  while (!buffers_.empty()) {
+    // One message per SDU: the socket is a SOCK_SEQPACKET one, and the app
+    // reads one SDU per record.
+    struct mmsghdr msgs[kMaxFlushBatch];
+    struct iovec iovs[kMaxFlushBatch];
+    size_t count = std::min(buffers_.size(), kMaxFlushBatch);
+    memset(msgs, 0, count * sizeof(msgs[0]));
+    for (size_t i = 0; i < count; i++) {
+      BT_HDR* p_buf = buffers_[i];
+      iovs[i].iov_base = (uint8_t*)(p_buf + 1) + p_buf->offset;
+      iovs[i].iov_len = p_buf->len;
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent;
+    OSI_NO_INTR(sent =
+                    sendmmsg(fd, msgs, count, MSG_NOSIGNAL | MSG_DONTWAIT));
+    if (sent < 0) return errno == EWOULDBLOCK || errno == EAGAIN;
+
+    for (int i = 0; i < sent; i++) {
+      BT_HDR* p_buf = buffers_.front();
+      size_t len = msgs[i].msg_len;
+      bytes_buffered_ -= len;
+      if (len < p_buf->len) {
+        // The rest of the SDU is sent on the next round
+        p_buf->offset += len;
+        p_buf->len -= len;
+        if (!len) /* special case if other end not keeping up */
+          return true;
+        break;
+      }
+      buffers_.pop_front();
+      osi_free(p_buf);
+    }
+  }
+
+  return false;
+}
@@ -171,24 +171,48 @@ extern void btif_gatts_add_bonded_dev_from_nv(const RawAddress& bda);
  ******************************************************************************/
 
 static bt_status_t btif_in_fetch_bonded_ble_device(
-    const std::string& remote_bd_addr, int add,
+    const RawAddress& bd_addr, int add,
     btif_bonded_devices_t* p_bonded_devices);
-static bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr);
+static bt_status_t btif_in_fetch_bonded_device(const RawAddress& bd_addr);
 
-static bool btif_has_ble_keys(const std::string& bdstr);
+static bool btif_has_ble_keys(const RawAddress& bd_addr);
 
 /*******************************************************************************
  *  Static functions
  ******************************************************************************/
 
-static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
-  std::string bdstr;
-  if (remote_bd_addr) {
-    bdstr = remote_bd_addr->ToString();
+/* Gets the device property the LE key of |key_type| is stored as */
+static bool btif_storage_le_key_property(uint8_t key_type,
+                                         DeviceProperty* property) {
+  switch (key_type) {
+    case BTIF_DM_LE_KEY_PENC:
+      *property = DeviceProperty::LE_KEY_PENC;
+      return true;
+    case BTIF_DM_LE_KEY_PID:
+      *property = DeviceProperty::LE_KEY_PID;
+      return true;
+    case BTIF_DM_LE_KEY_PCSRK:
+      *property = DeviceProperty::LE_KEY_PCSRK;
+      return true;
+    case BTIF_DM_LE_KEY_LENC:
+      *property = DeviceProperty::LE_KEY_LENC;
+      return true;
+    case BTIF_DM_LE_KEY_LCSRK:
+      *property = DeviceProperty::LE_KEY_LCSRK;
+      return true;
+    case BTIF_DM_LE_KEY_LID:
+      *property = DeviceProperty::LE_KEY_LID;
+      return true;
+    default:
+      return false;
   }
+}
 
-  BTIF_TRACE_DEBUG("in, bd addr:%s, prop type:%d, len:%d", bdstr.c_str(),
-                   prop->type, prop->len);
+static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
+  RawAddress bd_addr = remote_bd_addr ? *remote_bd_addr : RawAddress::kEmpty;
+
+  BTIF_TRACE_DEBUG("in, bd addr:%s, prop type:%d, len:%d",
+                   bd_addr.ToString().c_str(), prop->type, prop->len);
   char value[1024];
   if (prop->len <= 0 || prop->len > (int)sizeof(value) - 1) {
     BTIF_TRACE_ERROR("property type:%d, len:%d is invalid", prop->type,
@@ -197,8 +221,8 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   }
   switch (prop->type) {
     case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTIME,
-                          (int)time(NULL));
+      btif_config_set_device_int(bd_addr, DeviceProperty::TIMESTAMP,
+                                 (int)time(NULL));
       break;
     case BT_PROPERTY_BDNAME: {
       int name_length = prop->len > BTM_MAX_LOC_BD_NAME_LEN
@@ -207,7 +231,7 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       strncpy(value, (char*)prop->val, name_length);
       value[name_length] = '\0';
       if (remote_bd_addr) {
-        btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME, value);
+        btif_config_set_device_str(bd_addr, DeviceProperty::NAME, value);
       } else {
         btif_config_set_str("Adapter", BTIF_STORAGE_KEY_ADAPTER_NAME, value);
         btif_config_flush();
@@ -217,7 +241,7 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
     case BT_PROPERTY_REMOTE_FRIENDLY_NAME:
       strncpy(value, (char*)prop->val, prop->len);
       value[prop->len] = '\0';
-      btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_ALIASE, value);
+      btif_config_set_device_str(bd_addr, DeviceProperty::ALIAS, value);
       break;
     case BT_PROPERTY_ADAPTER_SCAN_MODE:
       btif_config_set_int("Adapter", BTIF_STORAGE_KEY_ADAPTER_SCANMODE,
@@ -236,12 +260,12 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
                           *(int*)prop->val);
       break;
     case BT_PROPERTY_CLASS_OF_DEVICE:
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVCLASS,
-                          *(int*)prop->val);
+      btif_config_set_device_int(bd_addr, DeviceProperty::DEV_CLASS,
+                                 *(int*)prop->val);
       break;
     case BT_PROPERTY_TYPE_OF_DEVICE:
-      btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
-                          *(int*)prop->val);
+      btif_config_set_device_int(bd_addr, DeviceProperty::DEV_TYPE,
+                                 *(int*)prop->val);
       break;
     case BT_PROPERTY_UUIDS: {
       std::string val;
@@ -249,7 +273,7 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       for (size_t i = 0; i < cnt; i++) {
         val += (reinterpret_cast<Uuid*>(prop->val) + i)->ToString() + " ";
       }
-      btif_config_set_str(bdstr, BTIF_STORAGE_PATH_REMOTE_SERVICE, val);
+      btif_config_set_device_str(bd_addr, DeviceProperty::SERVICE, val);
       break;
     }
     case BT_PROPERTY_REMOTE_VERSION_INFO: {
@@ -257,11 +281,12 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
 
       if (!info) return false;
 
-      btif_config_set_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_MFCT,
-                          info->manufacturer);
-      btif_config_set_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_VER, info->version);
-      btif_config_set_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_SUBVER,
-                          info->sub_ver);
+      btif_config_set_device_int(bd_addr, DeviceProperty::MANUFACTURER,
+                                 info->manufacturer);
+      btif_config_set_device_int(bd_addr, DeviceProperty::LMP_VER,
+                                 info->version);
+      btif_config_set_device_int(bd_addr, DeviceProperty::LMP_SUB_VER,
+                                 info->sub_ver);
     } break;
 
     default:
@@ -271,7 +296,7 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
 
   /* No need to look for bonded device with address of NULL */
   if (remote_bd_addr &&
-      btif_in_fetch_bonded_device(bdstr) == BT_STATUS_SUCCESS) {
+      btif_in_fetch_bonded_device(bd_addr) == BT_STATUS_SUCCESS) {
     /* save changes if the device was bonded */
     btif_config_flush();
   }
@@ -280,12 +305,9 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
 }
 
 static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
-  std::string bdstr;
-  if (remote_bd_addr) {
-    bdstr = remote_bd_addr->ToString();
-  }
-  BTIF_TRACE_DEBUG("in, bd addr:%s, prop type:%d, len:%d", bdstr.c_str(),
-                   prop->type, prop->len);
+  RawAddress bd_addr = remote_bd_addr ? *remote_bd_addr : RawAddress::kEmpty;
+  BTIF_TRACE_DEBUG("in, bd addr:%s, prop type:%d, len:%d",
+                   bd_addr.ToString().c_str(), prop->type, prop->len);
   if (prop->len <= 0) {
     BTIF_TRACE_ERROR("property type:%d, len:%d is invalid", prop->type,
                      prop->len);
@@ -295,14 +317,14 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   switch (prop->type) {
     case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
       if (prop->len >= (int)sizeof(int))
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTIME,
-                                  (int*)prop->val);
+        ret = btif_config_get_device_int(bd_addr, DeviceProperty::TIMESTAMP,
+                                         (int*)prop->val);
       break;
     case BT_PROPERTY_BDNAME: {
       int len = prop->len;
       if (remote_bd_addr)
-        ret = btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME,
-                                  (char*)prop->val, &len);
+        ret = btif_config_get_device_str(bd_addr, DeviceProperty::NAME,
+                                         (char*)prop->val, &len);
       else
         ret = btif_config_get_str("Adapter", BTIF_STORAGE_KEY_ADAPTER_NAME,
                                   (char*)prop->val, &len);
@@ -316,8 +338,8 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
     }
     case BT_PROPERTY_REMOTE_FRIENDLY_NAME: {
       int len = prop->len;
-      ret = btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_ALIASE,
-                                (char*)prop->val, &len);
+      ret = btif_config_get_device_str(bd_addr, DeviceProperty::ALIAS,
+                                       (char*)prop->val, &len);
       if (ret && len && len <= prop->len)
         prop->len = len - 1;
       else {
@@ -350,19 +372,19 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       break;
     case BT_PROPERTY_CLASS_OF_DEVICE:
       if (prop->len >= (int)sizeof(int))
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVCLASS,
-                                  (int*)prop->val);
+        ret = btif_config_get_device_int(bd_addr, DeviceProperty::DEV_CLASS,
+                                         (int*)prop->val);
       break;
     case BT_PROPERTY_TYPE_OF_DEVICE:
       if (prop->len >= (int)sizeof(int))
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
-                                  (int*)prop->val);
+        ret = btif_config_get_device_int(bd_addr, DeviceProperty::DEV_TYPE,
+                                         (int*)prop->val);
       break;
     case BT_PROPERTY_UUIDS: {
       char value[1280];
       int size = sizeof(value);
-      if (btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_SERVICE, value,
-                              &size)) {
+      if (btif_config_get_device_str(bd_addr, DeviceProperty::SERVICE, value,
+                                     &size)) {
         Uuid* p_uuid = reinterpret_cast<Uuid*>(prop->val);
         size_t num_uuids =
             btif_split_uuids_string(value, p_uuid, BT_MAX_NUM_UUIDS);
@@ -378,16 +400,16 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       bt_remote_version_t* info = (bt_remote_version_t*)prop->val;
 
       if (prop->len >= (int)sizeof(bt_remote_version_t)) {
-        ret = btif_config_get_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_MFCT,
-                                  &info->manufacturer);
+        ret = btif_config_get_device_int(
+            bd_addr, DeviceProperty::MANUFACTURER, &info->manufacturer);
 
         if (ret)
-          ret = btif_config_get_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_VER,
-                                    &info->version);
+          ret = btif_config_get_device_int(bd_addr, DeviceProperty::LMP_VER,
+                                           &info->version);
 
         if (ret)
-          ret = btif_config_get_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_SUBVER,
-                                    &info->sub_ver);
+          ret = btif_config_get_device_int(
+              bd_addr, DeviceProperty::LMP_SUB_VER, &info->sub_ver);
       }
     } break;
 
@@ -408,24 +430,26 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
  * Returns          BT_STATUS_SUCCESS if successful, BT_STATUS_FAIL otherwise
  *
  ******************************************************************************/
-static bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr) {
+static bt_status_t btif_in_fetch_bonded_device(const RawAddress& bd_addr) {
   bool bt_linkkey_file_found = false;
 
   LinkKey link_key;
   size_t size = link_key.size();
-  if (btif_config_get_bin(bdstr, "LinkKey", link_key.data(), &size)) {
+  if (btif_config_get_device_bin(bd_addr, DeviceProperty::LINK_KEY,
+                                 link_key.data(), &size)) {
     int linkkey_type;
-    if (btif_config_get_int(bdstr, "LinkKeyType", &linkkey_type)) {
+    if (btif_config_get_device_int(bd_addr, DeviceProperty::LINK_KEY_TYPE,
+                                   &linkkey_type)) {
       bt_linkkey_file_found = true;
     } else {
       bt_linkkey_file_found = false;
     }
   }
-  if ((btif_in_fetch_bonded_ble_device(bdstr, false, NULL) !=
+  if ((btif_in_fetch_bonded_ble_device(bd_addr, false, NULL) !=
        BT_STATUS_SUCCESS) &&
       (!bt_linkkey_file_found)) {
     BTIF_TRACE_DEBUG("Remote device:%s, no link key or ble key found",
-                     bdstr.c_str());
+                     bd_addr.ToString().c_str());
     return BT_STATUS_FAIL;
   }
   return BT_STATUS_SUCCESS;
@@ -450,29 +474,29 @@ static bt_status_t btif_in_fetch_bonded_devices(
 
   // TODO: this code is not thread safe, it can corrupt config content.
   // b/67595284
-  for (const section_t& section : btif_config_sections()) {
-    const std::string& name = section.name;
-    if (!RawAddress::IsValidAddress(name)) continue;
-
-    BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
+  for (const RawAddress& bd_addr : btif_config_get_persistent_devices()) {
+    BTIF_TRACE_DEBUG("Remote device:%s", bd_addr.ToString().c_str());
     LinkKey link_key;
     size_t size = sizeof(link_key);
-    if (btif_config_get_bin(name, "LinkKey", link_key.data(), &size)) {
+    if (btif_config_get_device_bin(bd_addr, DeviceProperty::LINK_KEY,
+                                   link_key.data(), &size)) {
       int linkkey_type;
-      if (btif_config_get_int(name, "LinkKeyType", &linkkey_type)) {
-        RawAddress bd_addr;
-        RawAddress::FromString(name, bd_addr);
+      if (btif_config_get_device_int(bd_addr, DeviceProperty::LINK_KEY_TYPE,
+                                     &linkkey_type)) {
         if (add) {
           DEV_CLASS dev_class = {0, 0, 0};
           int cod;
           int pin_length = 0;
-          if (btif_config_get_int(name, "DevClass", &cod))
+          if (btif_config_get_device_int(bd_addr, DeviceProperty::DEV_CLASS,
+                                         &cod))
             uint2devclass((uint32_t)cod, dev_class);
-          btif_config_get_int(name, "PinLength", &pin_length);
+          btif_config_get_device_int(bd_addr, DeviceProperty::PIN_LENGTH,
+                                     &pin_length);
           BTA_DmAddDevice(bd_addr, dev_class, link_key, 0, 0,
                           (uint8_t)linkkey_type, 0, pin_length);
 
-          if (btif_config_get_int(name, "DevType", &device_type) &&
+          if (btif_config_get_device_int(bd_addr, DeviceProperty::DEV_TYPE,
+                                         &device_type) &&
               (device_type == BT_DEVICE_TYPE_DUMO)) {
             btif_gatts_add_bonded_dev_from_nv(bd_addr);
           }
@@ -483,9 +507,10 @@ static bt_status_t btif_in_fetch_bonded_devices(
         bt_linkkey_file_found = false;
       }
     }
-    if (!btif_in_fetch_bonded_ble_device(name, add, p_bonded_devices) && !bt_linkkey_file_found) {
+    if (!btif_in_fetch_bonded_ble_device(bd_addr, add, p_bonded_devices) &&
+        !bt_linkkey_file_found) {
       BTIF_TRACE_DEBUG("Remote device:%s, no link key or ble key found",
-                       name.c_str());
+                       bd_addr.ToString().c_str());
     }
   }
   return BT_STATUS_SUCCESS;
@@ -815,13 +840,15 @@ bt_status_t btif_storage_add_remote_device(const RawAddress* remote_bd_addr,
 bt_status_t btif_storage_add_bonded_device(RawAddress* remote_bd_addr,
                                            LinkKey link_key, uint8_t key_type,
                                            uint8_t pin_length) {
-  std::string bdstr = remote_bd_addr->ToString();
-  int ret = btif_config_set_int(bdstr, "LinkKeyType", (int)key_type);
-  ret &= btif_config_set_int(bdstr, "PinLength", (int)pin_length);
-  ret &=
-      btif_config_set_bin(bdstr, "LinkKey", link_key.data(), link_key.size());
+  int ret = btif_config_set_device_int(
+      *remote_bd_addr, DeviceProperty::LINK_KEY_TYPE, (int)key_type);
+  ret &= btif_config_set_device_int(*remote_bd_addr, DeviceProperty::PIN_LENGTH,
+                                    (int)pin_length);
+  ret &= btif_config_set_device_bin(*remote_bd_addr, DeviceProperty::LINK_KEY,
+                                    link_key.data(), link_key.size());
 
   if (is_restricted_mode()) {
+    std::string bdstr = remote_bd_addr->ToString();
     BTIF_TRACE_WARNING("%s: '%s' pairing will be removed if unrestricted",
                        __func__, bdstr.c_str());
     btif_config_set_int(bdstr, "Restricted", 1);
@@ -844,20 +871,17 @@ bt_status_t btif_storage_add_bonded_device(RawAddress* remote_bd_addr,
  ******************************************************************************/
 bt_status_t btif_storage_remove_bonded_device(
     const RawAddress* remote_bd_addr) {
-  std::string bdstr = remote_bd_addr->ToString();
-  BTIF_TRACE_DEBUG("in bd addr:%s", bdstr.c_str());
+  const RawAddress& bd_addr = *remote_bd_addr;
+  BTIF_TRACE_DEBUG("in bd addr:%s", bd_addr.ToString().c_str());
 
   btif_storage_remove_ble_bonding_keys(remote_bd_addr);
 
   int ret = 1;
-  if (btif_config_exist(bdstr, "LinkKeyType"))
-    ret &= btif_config_remove(bdstr, "LinkKeyType");
-  if (btif_config_exist(bdstr, "PinLength"))
-    ret &= btif_config_remove(bdstr, "PinLength");
-  if (btif_config_exist(bdstr, "LinkKey"))
-    ret &= btif_config_remove(bdstr, "LinkKey");
-  if (btif_config_exist(bdstr, BTIF_STORAGE_PATH_REMOTE_ALIASE)) {
-    ret &= btif_config_remove(bdstr, BTIF_STORAGE_PATH_REMOTE_ALIASE);
+  for (DeviceProperty property :
+       {DeviceProperty::LINK_KEY_TYPE, DeviceProperty::PIN_LENGTH,
+        DeviceProperty::LINK_KEY, DeviceProperty::ALIAS}) {
+    if (btif_config_device_property_exist(bd_addr, property))
+      ret &= btif_config_remove_device_property(bd_addr, property);
   }
   /* write bonded info immediately */
   btif_config_flush();
@@ -873,15 +897,7 @@ bt_status_t btif_storage_remove_bonded_device(
  */
 static void remove_devices_with_sample_ltk() {
   std::vector<RawAddress> bad_ltk;
-  for (const section_t& section : btif_config_sections()) {
-    const std::string& name = section.name;
-    if (!RawAddress::IsValidAddress(name)) {
-      continue;
-    }
-
-    RawAddress bd_addr;
-    RawAddress::FromString(name, bd_addr);
-
+  for (RawAddress bd_addr : btif_config_get_persistent_devices()) {
     tBTA_LE_KEY_VALUE key;
     memset(&key, 0, sizeof(key));
 
@@ -1055,31 +1071,11 @@ bt_status_t btif_storage_add_ble_bonding_key(RawAddress* remote_bd_addr,
                                              const uint8_t* key,
                                              uint8_t key_type,
                                              uint8_t key_length) {
-  const char* name;
-  switch (key_type) {
-    case BTIF_DM_LE_KEY_PENC:
-      name = "LE_KEY_PENC";
-      break;
-    case BTIF_DM_LE_KEY_PID:
-      name = "LE_KEY_PID";
-      break;
-    case BTIF_DM_LE_KEY_PCSRK:
-      name = "LE_KEY_PCSRK";
-      break;
-    case BTIF_DM_LE_KEY_LENC:
-      name = "LE_KEY_LENC";
-      break;
-    case BTIF_DM_LE_KEY_LCSRK:
-      name = "LE_KEY_LCSRK";
-      break;
-    case BTIF_DM_LE_KEY_LID:
-      name = "LE_KEY_LID";
-      break;
-    default:
-      return BT_STATUS_FAIL;
-  }
-  int ret =
-      btif_config_set_bin(remote_bd_addr->ToString(), name, key, key_length);
+  DeviceProperty property;
+  if (!btif_storage_le_key_property(key_type, &property)) return BT_STATUS_FAIL;
+
+  int ret = btif_config_set_device_bin(*remote_bd_addr, property, key,
+                                       key_length);
   btif_config_save();
   return ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
 }
@@ -1098,32 +1094,12 @@ bt_status_t btif_storage_get_ble_bonding_key(RawAddress* remote_bd_addr,
                                              uint8_t key_type,
                                              uint8_t* key_value,
                                              int key_length) {
-  const char* name;
-  switch (key_type) {
-    case BTIF_DM_LE_KEY_PENC:
-      name = "LE_KEY_PENC";
-      break;
-    case BTIF_DM_LE_KEY_PID:
-      name = "LE_KEY_PID";
-      break;
-    case BTIF_DM_LE_KEY_PCSRK:
-      name = "LE_KEY_PCSRK";
-      break;
-    case BTIF_DM_LE_KEY_LENC:
-      name = "LE_KEY_LENC";
-      break;
-    case BTIF_DM_LE_KEY_LCSRK:
-      name = "LE_KEY_LCSRK";
-      break;
-    case BTIF_DM_LE_KEY_LID:
-      name = "LE_KEY_LID";
-      break;
-    default:
-      return BT_STATUS_FAIL;
-  }
+  DeviceProperty property;
+  if (!btif_storage_le_key_property(key_type, &property)) return BT_STATUS_FAIL;
+
   size_t length = key_length;
-  int ret =
-      btif_config_get_bin(remote_bd_addr->ToString(), name, key_value, &length);
+  int ret = btif_config_get_device_bin(*remote_bd_addr, property, key_value,
+                                       &length);
   return ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
 }
 
@@ -1139,19 +1115,16 @@ bt_status_t btif_storage_get_ble_bonding_key(RawAddress* remote_bd_addr,
  ******************************************************************************/
 bt_status_t btif_storage_remove_ble_bonding_keys(
     const RawAddress* remote_bd_addr) {
-  std::string bdstr = remote_bd_addr->ToString();
-  BTIF_TRACE_DEBUG(" %s in bd addr:%s", __func__, bdstr.c_str());
+  const RawAddress& bd_addr = *remote_bd_addr;
+  BTIF_TRACE_DEBUG(" %s in bd addr:%s", __func__, bd_addr.ToString().c_str());
   int ret = 1;
-  if (btif_config_exist(bdstr, "LE_KEY_PENC"))
-    ret &= btif_config_remove(bdstr, "LE_KEY_PENC");
-  if (btif_config_exist(bdstr, "LE_KEY_PID"))
-    ret &= btif_config_remove(bdstr, "LE_KEY_PID");
-  if (btif_config_exist(bdstr, "LE_KEY_PCSRK"))
-    ret &= btif_config_remove(bdstr, "LE_KEY_PCSRK");
-  if (btif_config_exist(bdstr, "LE_KEY_LENC"))
-    ret &= btif_config_remove(bdstr, "LE_KEY_LENC");
-  if (btif_config_exist(bdstr, "LE_KEY_LCSRK"))
-    ret &= btif_config_remove(bdstr, "LE_KEY_LCSRK");
+  for (DeviceProperty property :
+       {DeviceProperty::LE_KEY_PENC, DeviceProperty::LE_KEY_PID,
+        DeviceProperty::LE_KEY_PCSRK, DeviceProperty::LE_KEY_LENC,
+        DeviceProperty::LE_KEY_LCSRK}) {
+    if (btif_config_device_property_exist(bd_addr, property))
+      ret &= btif_config_remove_device_property(bd_addr, property);
+  }
   btif_config_save();
   return ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
 }
@@ -1243,23 +1216,21 @@ bt_status_t btif_storage_remove_ble_local_keys(void) {
 }
 
 static bt_status_t btif_in_fetch_bonded_ble_device(
-    const std::string& remote_bd_addr, int add,
+    const RawAddress& bd_addr, int add,
     btif_bonded_devices_t* p_bonded_devices) {
   int device_type;
   int addr_type;
   bool device_added = false;
   bool key_found = false;
 
-  if (!btif_config_get_int(remote_bd_addr, "DevType", &device_type))
+  if (!btif_config_get_device_int(bd_addr, DeviceProperty::DEV_TYPE,
+                                  &device_type))
     return BT_STATUS_FAIL;
 
   if ((device_type & BT_DEVICE_TYPE_BLE) == BT_DEVICE_TYPE_BLE ||
-      btif_has_ble_keys(remote_bd_addr)) {
+      btif_has_ble_keys(bd_addr)) {
     BTIF_TRACE_DEBUG("%s Found a LE device: %s", __func__,
-                     remote_bd_addr.c_str());
-
-    RawAddress bd_addr;
-    RawAddress::FromString(remote_bd_addr, bd_addr);
+                     bd_addr.ToString().c_str());
 
     if (btif_storage_get_remote_addr_type(&bd_addr, &addr_type) !=
         BT_STATUS_SUCCESS) {
@@ -1298,13 +1269,15 @@ static bt_status_t btif_in_fetch_bonded_ble_device(
 
 bt_status_t btif_storage_set_remote_addr_type(const RawAddress* remote_bd_addr,
                                               uint8_t addr_type) {
-  int ret = btif_config_set_int(remote_bd_addr->ToString(), "AddrType",
-                                (int)addr_type);
+  int ret = btif_config_set_device_int(*remote_bd_addr,
+                                       DeviceProperty::ADDR_TYPE,
+                                       (int)addr_type);
   return ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
 }
 
-bool btif_has_ble_keys(const std::string& bdstr) {
-  return btif_config_exist(bdstr, "LE_KEY_PENC");
+bool btif_has_ble_keys(const RawAddress& bd_addr) {
+  return btif_config_device_property_exist(bd_addr,
+                                           DeviceProperty::LE_KEY_PENC);
 }
 
 /*******************************************************************************
@@ -1319,8 +1292,8 @@ bool btif_has_ble_keys(const std::string& bdstr) {
  ******************************************************************************/
 bt_status_t btif_storage_get_remote_addr_type(const RawAddress* remote_bd_addr,
                                               int* addr_type) {
-  int ret =
-      btif_config_get_int(remote_bd_addr->ToString(), "AddrType", addr_type);
+  int ret = btif_config_get_device_int(*remote_bd_addr,
+                                       DeviceProperty::ADDR_TYPE, addr_type);
   return ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
 }
 /*******************************************************************************
@@ -1369,19 +1342,15 @@ bt_status_t btif_storage_add_hid_device_info(
 bt_status_t btif_storage_load_bonded_hid_info(void) {
   // TODO: this code is not thread safe, it can corrupt config content.
   // b/67595284
-  for (const section_t& section : btif_config_sections()) {
-    const std::string& name = section.name;
-    if (!RawAddress::IsValidAddress(name)) continue;
-
+  for (RawAddress bd_addr : btif_config_get_persistent_devices()) {
+    const std::string name = bd_addr.ToString();
     BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
 
     int value;
     if (!btif_config_get_int(name, "HidAttrMask", &value)) continue;
     uint16_t attr_mask = (uint16_t)value;
 
-    if (btif_in_fetch_bonded_device(name) != BT_STATUS_SUCCESS) {
-      RawAddress bd_addr;
-      RawAddress::FromString(name, bd_addr);
+    if (btif_in_fetch_bonded_device(bd_addr) != BT_STATUS_SUCCESS) {
       btif_storage_remove_hid_info(&bd_addr);
       continue;
     }
@@ -1423,8 +1392,6 @@ bt_status_t btif_storage_load_bonded_hid_info(void) {
                           (uint8_t*)dscp_info.descriptor.dsc_list, &len);
     }
 
-    RawAddress bd_addr;
-    RawAddress::FromString(name, bd_addr);
     // add extracted information to BTA HH
     if (btif_hh_add_added_dev(bd_addr, attr_mask)) {
       BTA_HhAddDev(bd_addr, attr_mask, sub_class, app_id, dscp_info);
@@ -1478,6 +1445,7 @@ constexpr char HEARING_AID_SYNC_ID[] = "HearingAidSyncId";
 constexpr char HEARING_AID_RENDER_DELAY[] = "HearingAidRenderDelay";
 constexpr char HEARING_AID_PREPARATION_DELAY[] = "HearingAidPreparationDelay";
 constexpr char HEARING_AID_IS_WHITE_LISTED[] = "HearingAidIsWhiteListed";
+constexpr Uuid HEARING_AID_UUID = Uuid::FromLiteral("FDF0");
 
 void btif_storage_add_hearing_aid(const HearingDevice& dev_info) {
   do_in_jni_thread(
@@ -1517,20 +1485,17 @@ void btif_storage_add_hearing_aid(const HearingDevice& dev_info) {
 void btif_storage_load_bonded_hearing_aids() {
   // TODO: this code is not thread safe, it can corrupt config content.
   // b/67595284
-  for (const section_t& section : btif_config_sections()) {
-    const std::string& name = section.name;
-    if (!RawAddress::IsValidAddress(name)) continue;
-
+  for (const RawAddress& bd_addr : btif_config_get_persistent_devices()) {
     int size = STORAGE_UUID_STRING_SIZE * HEARINGAID_MAX_NUM_UUIDS;
     char uuid_str[size];
     bool isHearingaidDevice = false;
-    if (btif_config_get_str(name, BTIF_STORAGE_PATH_REMOTE_SERVICE, uuid_str,
-                            &size)) {
+    if (btif_config_get_device_str(bd_addr, DeviceProperty::SERVICE, uuid_str,
+                                   &size)) {
       Uuid p_uuid[HEARINGAID_MAX_NUM_UUIDS];
       size_t num_uuids =
           btif_split_uuids_string(uuid_str, p_uuid, HEARINGAID_MAX_NUM_UUIDS);
       for (size_t i = 0; i < num_uuids; i++) {
-        if (p_uuid[i] == Uuid::FromString("FDF0")) {
+        if (p_uuid[i] == HEARING_AID_UUID) {
           isHearingaidDevice = true;
           break;
         }
@@ -1540,11 +1505,10 @@ void btif_storage_load_bonded_hearing_aids() {
       continue;
     }
 
+    const std::string name = bd_addr.ToString();
     BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
 
-    if (btif_in_fetch_bonded_device(name) != BT_STATUS_SUCCESS) {
-      RawAddress bd_addr;
-      RawAddress::FromString(name, bd_addr);
+    if (btif_in_fetch_bonded_device(bd_addr) != BT_STATUS_SUCCESS) {
       btif_storage_remove_hearing_aid(bd_addr);
       continue;
     }
@@ -1599,9 +1563,6 @@ void btif_storage_load_bonded_hearing_aids() {
     if (btif_config_get_int(name, HEARING_AID_IS_WHITE_LISTED, &value))
       is_white_listed = value;
 
-    RawAddress bd_addr;
-    RawAddress::FromString(name, bd_addr);
-
     // add extracted information to BTA Hearing Aid
     do_in_main_thread(
         FROM_HERE,
@@ -1715,16 +1676,12 @@ int btif_storage_get_num_bonded_devices(void) {
 bt_status_t btif_storage_load_hidd(void) {
   // TODO: this code is not thread safe, it can corrupt config content.
   // b/67595284
-  for (const section_t& section : btif_config_sections()) {
-    const std::string& name = section.name;
-    if (!RawAddress::IsValidAddress(name)) continue;
-
+  for (const RawAddress& bd_addr : btif_config_get_persistent_devices()) {
+    const std::string name = bd_addr.ToString();
     BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
     int value;
-    if (btif_in_fetch_bonded_device(name) == BT_STATUS_SUCCESS) {
+    if (btif_in_fetch_bonded_device(bd_addr) == BT_STATUS_SUCCESS) {
       if (btif_config_get_int(name, "HidDeviceCabled", &value)) {
-        RawAddress bd_addr;
-        RawAddress::FromString(name, bd_addr);
         BTA_HdAddDevice(bd_addr);
         break;
       }
@@ -1745,16 +1702,14 @@ bt_status_t btif_storage_load_hidd(void) {
  *
  ******************************************************************************/
 bt_status_t btif_storage_set_hidd(RawAddress* remote_bd_addr) {
-  std::string remote_device_address_string = remote_bd_addr->ToString();
-  for (const section_t& section : btif_config_sections()) {
-    if (!RawAddress::IsValidAddress(section.name)) continue;
-    if (section.name == remote_device_address_string) continue;
-    if (btif_in_fetch_bonded_device(section.name) == BT_STATUS_SUCCESS) {
-      btif_config_remove(section.name, "HidDeviceCabled");
+  for (const RawAddress& bd_addr : btif_config_get_persistent_devices()) {
+    if (bd_addr == *remote_bd_addr) continue;
+    if (btif_in_fetch_bonded_device(bd_addr) == BT_STATUS_SUCCESS) {
+      btif_config_remove(bd_addr.ToString(), "HidDeviceCabled");
     }
   }
 
-  btif_config_set_int(remote_device_address_string, "HidDeviceCabled", 1);
+  btif_config_set_int(remote_bd_addr->ToString(), "HidDeviceCabled", 1);
   btif_config_save();
   return BT_STATUS_SUCCESS;
 }
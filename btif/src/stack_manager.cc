@@ -22,6 +22,8 @@
 
 #include <hardware/bluetooth.h>
 
+#include <chrono>
+
 #include "btcore/include/module.h"
 #include "btcore/include/osi_module.h"
 #include "btif_api.h"
@@ -144,6 +146,7 @@ static void event_start_up_stack(UNUSED_ATTR void* context) {
   ensure_stack_is_initialized();
 
   LOG_INFO(LOG_TAG, "%s is bringing up the stack", __func__);
+  auto begin = std::chrono::steady_clock::now();
   future_t* local_hack_future = future_new();
   hack_future = local_hack_future;
 
@@ -159,6 +162,8 @@ static void event_start_up_stack(UNUSED_ATTR void* context) {
   }
 
   stack_is_running = true;
+  module_timeline_record("stack_start_up", "step", begin,
+                         std::chrono::steady_clock::now());
   LOG_INFO(LOG_TAG, "%s finished", __func__);
   do_in_jni_thread(FROM_HERE, base::Bind(event_signal_stack_up, nullptr));
 }
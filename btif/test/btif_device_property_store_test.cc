@@ -0,0 +1,205 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "btif/include/btif_device_property_store.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+const int kCapacity = 3;
+const RawAddress kAddr1 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+const RawAddress kAddr2 = {{0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff}};
+const uint8_t kLinkKey[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                            0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+
+RawAddress make_address(uint8_t last_octet) {
+  return RawAddress({0x00, 0x11, 0x22, 0x33, 0x44, last_octet});
+}
+
+section_t* find_section(config_t& config, const std::string& name) {
+  for (auto& section : config.sections) {
+    if (section.name == name) return &section;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST(BtifDevicePropertyStoreTest, parse_section_name) {
+  RawAddress address;
+  EXPECT_TRUE(BtifDevicePropertyStore::ParseSectionName("aa:bb:cc:dd:ee:ff",
+                                                        &address));
+  EXPECT_EQ(address, kAddr2);
+  EXPECT_TRUE(BtifDevicePropertyStore::ParseSectionName("AA:BB:CC:DD:EE:FF",
+                                                        &address));
+  EXPECT_EQ(address, kAddr2);
+
+  EXPECT_FALSE(
+      BtifDevicePropertyStore::ParseSectionName("Adapter", &address));
+  EXPECT_FALSE(
+      BtifDevicePropertyStore::ParseSectionName("AB:CD:EF:12:34", &address));
+  EXPECT_FALSE(BtifDevicePropertyStore::ParseSectionName(
+      "AB:CD:EF:12:34:56:78", &address));
+  EXPECT_FALSE(
+      BtifDevicePropertyStore::ParseSectionName("AB-CD-EF-12-34-56", &address));
+  EXPECT_FALSE(
+      BtifDevicePropertyStore::ParseSectionName("AB:CD:EF:12:34:5G", &address));
+}
+
+TEST(BtifDevicePropertyStoreTest, typed_properties) {
+  BtifDevicePropertyStore store(kCapacity);
+  store.SetInt(kAddr1, DeviceProperty::DEV_TYPE, 3);
+  store.SetString(kAddr1, DeviceProperty::NAME, "Headset");
+  store.SetBin(kAddr1, DeviceProperty::LINK_KEY, kLinkKey, sizeof(kLinkKey));
+
+  EXPECT_EQ(store.GetInt(kAddr1, DeviceProperty::DEV_TYPE), 3);
+  EXPECT_EQ(store.GetString(kAddr1, DeviceProperty::NAME), "Headset");
+  uint8_t key[16];
+  size_t length = sizeof(key);
+  EXPECT_TRUE(store.GetBin(kAddr1, DeviceProperty::LINK_KEY, key, &length));
+  EXPECT_EQ(length, sizeof(kLinkKey));
+  EXPECT_EQ(memcmp(key, kLinkKey, length), 0);
+
+  // too small buffer
+  length = sizeof(key) - 1;
+  EXPECT_FALSE(store.GetBin(kAddr1, DeviceProperty::LINK_KEY, key, &length));
+
+  // same values through the string API
+  EXPECT_EQ(store.GetString(kAddr1, "DevType"), "3");
+  EXPECT_EQ(store.GetString(kAddr1, "LinkKey"),
+            "00112233445566778899aabbccddeeff");
+  EXPECT_FALSE(store.HasProperty(kAddr1, DeviceProperty::PIN_LENGTH));
+  EXPECT_FALSE(store.GetInt(kAddr2, DeviceProperty::DEV_TYPE));
+}
+
+TEST(BtifDevicePropertyStoreTest, string_api_round_trips) {
+  BtifDevicePropertyStore store(kCapacity);
+  store.SetString(kAddr1, "DevClass", "2360344");
+  store.SetString(kAddr1, "PinLength", "0x10");
+  store.SetString(kAddr1, "LE_KEY_PENC", "encrypted");
+  store.SetString(kAddr1, "LE_KEY_PID", "ABCD");
+  store.SetString(kAddr1, "HidAttrMask", "12");
+
+  EXPECT_EQ(store.GetInt(kAddr1, DeviceProperty::DEV_CLASS), 2360344);
+  EXPECT_EQ(store.GetString(kAddr1, "DevClass"), "2360344");
+  // values not in their canonical form are kept as written
+  EXPECT_EQ(store.GetString(kAddr1, "PinLength"), "0x10");
+  EXPECT_EQ(store.GetInt(kAddr1, DeviceProperty::PIN_LENGTH), 16);
+  EXPECT_EQ(store.GetString(kAddr1, "LE_KEY_PENC"), "encrypted");
+  EXPECT_EQ(store.GetString(kAddr1, "LE_KEY_PID"), "ABCD");
+  uint8_t key[16];
+  size_t length = sizeof(key);
+  EXPECT_FALSE(store.GetBin(kAddr1, DeviceProperty::LE_KEY_PENC, key, &length));
+  // keys without a property
+  EXPECT_EQ(store.GetInt(kAddr1, "HidAttrMask"), 12);
+  EXPECT_EQ(store.GetUint64(kAddr1, "HidAttrMask"), 12u);
+  EXPECT_TRUE(store.HasKey(kAddr1, "HidAttrMask"));
+  EXPECT_TRUE(store.RemoveKey(kAddr1, "HidAttrMask"));
+  EXPECT_FALSE(store.HasKey(kAddr1, "HidAttrMask"));
+}
+
+TEST(BtifDevicePropertyStoreTest, device_persistent_with_link_key) {
+  BtifDevicePropertyStore store(kCapacity);
+  store.SetString(kAddr1, DeviceProperty::NAME, "Headset");
+  EXPECT_TRUE(store.HasDevice(kAddr1));
+  EXPECT_EQ(store.GetPersistentDeviceCount(), 0u);
+
+  store.SetBin(kAddr1, DeviceProperty::LINK_KEY, kLinkKey, sizeof(kLinkKey));
+  EXPECT_EQ(store.GetPersistentDevices(), std::vector<RawAddress>{kAddr1});
+
+  // unpaired again without link key
+  EXPECT_TRUE(store.RemoveProperty(kAddr1, DeviceProperty::LINK_KEY));
+  EXPECT_EQ(store.GetPersistentDeviceCount(), 0u);
+  EXPECT_EQ(store.GetString(kAddr1, DeviceProperty::NAME), "Headset");
+
+  // removed with its last property
+  EXPECT_TRUE(store.RemoveKey(kAddr1, "Name"));
+  EXPECT_FALSE(store.HasDevice(kAddr1));
+  EXPECT_FALSE(store.RemoveKey(kAddr1, "Name"));
+}
+
+TEST(BtifDevicePropertyStoreTest, unpaired_devices_are_limited) {
+  BtifDevicePropertyStore store(kCapacity);
+  for (uint8_t i = 0; i <= kCapacity; i++) {
+    store.SetInt(make_address(i), DeviceProperty::DEV_TYPE, 1);
+  }
+  EXPECT_FALSE(store.HasDevice(make_address(0)));
+  for (uint8_t i = 1; i <= kCapacity; i++) {
+    EXPECT_TRUE(store.HasDevice(make_address(i)));
+  }
+
+  // paired devices are not evicted
+  store.SetBin(kAddr1, DeviceProperty::LINK_KEY, kLinkKey, sizeof(kLinkKey));
+  for (uint8_t i = 0x10; i < 0x10 + kCapacity; i++) {
+    store.SetInt(make_address(i), DeviceProperty::DEV_TYPE, 1);
+  }
+  EXPECT_TRUE(store.HasDevice(kAddr1));
+}
+
+TEST(BtifDevicePropertyStoreTest, load_and_save) {
+  config_t config;
+  config.sections.push_back({"Adapter", {{"Address", "01:02:03:04:05:06"}}});
+  config.sections.push_back({"11:22:33:44:55:66",
+                             {{"Name", "Headset"},
+                              {"DevClass", "2360344"},
+                              {"HidAttrMask", "12"},
+                              {"LinkKey", "00112233445566778899aabbccddeeff"},
+                              {"LinkKeyType", "4"},
+                              {"PinLength", "0x10"}}});
+  // no link key, still persistent as it was in the file
+  config.sections.push_back({"AA:BB:CC:DD:EE:FF", {{"DevType", "2"}}});
+  config_t original = config;
+
+  BtifDevicePropertyStore store(kCapacity);
+  store.Load(&config);
+  ASSERT_EQ(config.sections.size(), 1u);
+  EXPECT_EQ(config.sections.front().name, "Adapter");
+  EXPECT_EQ(store.GetPersistentDeviceCount(), 2u);
+
+  EXPECT_EQ(store.GetInt(kAddr1, DeviceProperty::LINK_KEY_TYPE), 4);
+  EXPECT_EQ(store.GetInt(kAddr2, DeviceProperty::DEV_TYPE), 2);
+
+  store.AppendPersistentSections(&config);
+  ASSERT_EQ(config.sections.size(), 3u);
+  for (const auto& section : original.sections) {
+    RawAddress address;
+    std::string name = section.name;
+    if (BtifDevicePropertyStore::ParseSectionName(name, &address)) {
+      name = address.ToString();
+    }
+    section_t* saved = find_section(config, name);
+    ASSERT_NE(saved, nullptr) << name;
+    ASSERT_EQ(saved->entries.size(), section.entries.size());
+    // typed properties are written first
+    for (const auto& entry : section.entries) {
+      auto saved_entry = saved->Find(entry.key);
+      ASSERT_NE(saved_entry, saved->entries.end()) << name << " " << entry.key;
+      EXPECT_EQ(saved_entry->value, entry.value) << name << " " << entry.key;
+    }
+  }
+}
+
+TEST(BtifDevicePropertyStoreTest, remove_persistent_devices_with_key) {
+  BtifDevicePropertyStore store(kCapacity);
+  store.SetBin(kAddr1, DeviceProperty::LINK_KEY, kLinkKey, sizeof(kLinkKey));
+  store.SetString(kAddr1, "Restricted", "1");
+  store.SetBin(kAddr2, DeviceProperty::LINK_KEY, kLinkKey, sizeof(kLinkKey));
+
+  store.RemovePersistentDevicesWithKey("Restricted");
+  EXPECT_FALSE(store.HasDevice(kAddr1));
+  EXPECT_TRUE(store.HasDevice(kAddr2));
+}
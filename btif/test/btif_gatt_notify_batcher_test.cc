@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "btif/include/btif_gatt_notify_batcher.h"
+
+namespace {
+
+const RawAddress kDevice1 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+const RawAddress kDevice2 = {{0x66, 0x55, 0x44, 0x33, 0x22, 0x11}};
+
+constexpr uint64_t kWindowMs = 10;
+constexpr size_t kMaxBatchSize = 4;
+
+struct ScheduledTask {
+  std::function<void()> task;
+  uint64_t delay_ms;
+};
+
+struct DeliveredBatch {
+  int conn_id;
+  btgatt_notify_batch_t batch;
+};
+
+class BtifGattNotifyBatcherTest : public ::testing::Test {
+ protected:
+  BtifGattNotifyBatcherTest()
+      : batcher_(
+            kWindowMs, kMaxBatchSize,
+            [this](std::function<void()> task, uint64_t delay_ms) {
+              scheduled_.push_back({std::move(task), delay_ms});
+            },
+            [this](int conn_id, const btgatt_notify_batch_t& batch) {
+              delivered_.push_back({conn_id, batch});
+            }) {}
+
+  void AddNotification(int conn_id, const RawAddress& bda, uint16_t handle,
+                       uint8_t fill, uint16_t len) {
+    std::vector<uint8_t> value(len, fill);
+    batcher_.Add(conn_id, bda, handle, value.data(), len);
+  }
+
+  // Runs the scheduled tasks in delay order, like the delivery thread would
+  void RunScheduledTasks() {
+    std::vector<ScheduledTask> tasks = std::move(scheduled_);
+    scheduled_.clear();
+    std::stable_sort(tasks.begin(), tasks.end(),
+                     [](const ScheduledTask& a, const ScheduledTask& b) {
+                       return a.delay_ms < b.delay_ms;
+                     });
+    for (auto& task : tasks) task.task();
+  }
+
+  BtifGattNotifyBatcher batcher_;
+  std::vector<ScheduledTask> scheduled_;
+  std::vector<DeliveredBatch> delivered_;
+};
+
+TEST_F(BtifGattNotifyBatcherTest, delivers_batch_when_window_expires) {
+  AddNotification(1, kDevice1, 0x10, 0xaa, 2);
+  AddNotification(1, kDevice1, 0x20, 0xbb, 3);
+  ASSERT_EQ(scheduled_.size(), 1u);
+  EXPECT_EQ(scheduled_[0].delay_ms, kWindowMs);
+  EXPECT_TRUE(delivered_.empty());
+
+  RunScheduledTasks();
+  ASSERT_EQ(delivered_.size(), 1u);
+  const btgatt_notify_batch_t& batch = delivered_[0].batch;
+  EXPECT_EQ(delivered_[0].conn_id, 1);
+  EXPECT_EQ(batch.bda, kDevice1);
+  ASSERT_EQ(batch.entries.size(), 2u);
+  EXPECT_EQ(batch.entries[0].handle, 0x10);
+  EXPECT_EQ(batch.entries[0].offset, 0u);
+  EXPECT_EQ(batch.entries[0].len, 2);
+  EXPECT_EQ(batch.entries[1].handle, 0x20);
+  EXPECT_EQ(batch.entries[1].offset, 2u);
+  EXPECT_EQ(batch.entries[1].len, 3);
+  EXPECT_EQ(batch.values,
+            std::vector<uint8_t>({0xaa, 0xaa, 0xbb, 0xbb, 0xbb}));
+}
+
+TEST_F(BtifGattNotifyBatcherTest, delivers_full_batch_right_away) {
+  for (size_t i = 0; i < kMaxBatchSize + 1; i++) {
+    AddNotification(1, kDevice1, 0x10, i, 1);
+  }
+  // Window of the first batch, delivery of the full batch, window of the
+  // second batch
+  ASSERT_EQ(scheduled_.size(), 3u);
+  EXPECT_EQ(scheduled_[1].delay_ms, 0u);
+
+  RunScheduledTasks();
+  ASSERT_EQ(delivered_.size(), 2u);
+  EXPECT_EQ(delivered_[0].batch.entries.size(), kMaxBatchSize);
+  EXPECT_EQ(delivered_[1].batch.entries.size(), 1u);
+  EXPECT_EQ(delivered_[1].batch.values, std::vector<uint8_t>({kMaxBatchSize}));
+}
+
+TEST_F(BtifGattNotifyBatcherTest, window_of_delivered_batch_is_ignored) {
+  AddNotification(1, kDevice1, 0x10, 0, 1);
+  std::function<void()> first_window = scheduled_[0].task;
+  batcher_.Flush(1);
+  AddNotification(1, kDevice1, 0x10, 1, 1);
+
+  // The first window must not cut the second batch short
+  first_window();
+  EXPECT_EQ(delivered_.size(), 0u);
+  RunScheduledTasks();
+  ASSERT_EQ(delivered_.size(), 2u);
+  EXPECT_EQ(delivered_[0].batch.values, std::vector<uint8_t>({0}));
+  EXPECT_EQ(delivered_[1].batch.values, std::vector<uint8_t>({1}));
+}
+
+TEST_F(BtifGattNotifyBatcherTest, connections_are_batched_separately) {
+  AddNotification(1, kDevice1, 0x10, 1, 1);
+  AddNotification(2, kDevice2, 0x10, 2, 1);
+  AddNotification(1, kDevice1, 0x11, 1, 1);
+
+  RunScheduledTasks();
+  ASSERT_EQ(delivered_.size(), 2u);
+  EXPECT_EQ(delivered_[0].conn_id, 1);
+  EXPECT_EQ(delivered_[0].batch.bda, kDevice1);
+  EXPECT_EQ(delivered_[0].batch.entries.size(), 2u);
+  EXPECT_EQ(delivered_[1].conn_id, 2);
+  EXPECT_EQ(delivered_[1].batch.bda, kDevice2);
+  EXPECT_EQ(delivered_[1].batch.entries.size(), 1u);
+}
+
+TEST_F(BtifGattNotifyBatcherTest, flush_without_pending_batch) {
+  batcher_.Flush(1);
+  EXPECT_TRUE(scheduled_.empty());
+}
+
+}  // namespace
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "btif/include/btif_sock_l2cap_rx_queue.h"
+#include "osi/include/allocator.h"
+
+namespace {
+
+constexpr size_t kMaxBytes = 4096;
+
+BT_HDR* make_sdu(uint8_t fill, uint16_t len) {
+  // Same layout as the buffers received from L2CAP, with some headroom
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_HDR_SIZE + 13 + len);
+  p_buf->offset = 13;
+  p_buf->len = len;
+  memset((uint8_t*)(p_buf + 1) + p_buf->offset, fill, len);
+  return p_buf;
+}
+
+class BtifSockL2capRxQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(socketpair(AF_LOCAL, SOCK_SEQPACKET, 0, fds_), 0);
+  }
+
+  void TearDown() override {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  // Reads one record from the app side of the socket
+  std::vector<uint8_t> Receive() {
+    std::vector<uint8_t> record(kMaxBytes);
+    ssize_t len = recv(fds_[1], record.data(), record.size(), MSG_DONTWAIT);
+    record.resize(len < 0 ? 0 : len);
+    return record;
+  }
+
+  BtifSockL2capRxQueue queue_{kMaxBytes};
+  int fds_[2];
+};
+
+}  // namespace
+
+TEST_F(BtifSockL2capRxQueueTest, flush_keeps_sdu_boundaries) {
+  ASSERT_TRUE(queue_.Enqueue(make_sdu(0x01, 10)));
+  ASSERT_TRUE(queue_.Enqueue(make_sdu(0x02, 20)));
+  ASSERT_TRUE(queue_.Enqueue(make_sdu(0x03, 30)));
+  EXPECT_EQ(queue_.bytesBuffered(), 60u);
+
+  EXPECT_FALSE(queue_.Flush(fds_[0]));
+  EXPECT_TRUE(queue_.empty());
+  EXPECT_EQ(queue_.bytesBuffered(), 0u);
+
+  EXPECT_EQ(Receive(), std::vector<uint8_t>(10, 0x01));
+  EXPECT_EQ(Receive(), std::vector<uint8_t>(20, 0x02));
+  EXPECT_EQ(Receive(), std::vector<uint8_t>(30, 0x03));
+  EXPECT_TRUE(Receive().empty());
+}
+
+TEST_F(BtifSockL2capRxQueueTest, flush_more_sdus_than_one_batch) {
+  for (int i = 0; i < 40; i++) {
+    ASSERT_TRUE(queue_.Enqueue(make_sdu(i, 8)));
+  }
+  EXPECT_FALSE(queue_.Flush(fds_[0]));
+  EXPECT_TRUE(queue_.empty());
+  for (int i = 0; i < 40; i++) {
+    EXPECT_EQ(Receive(), std::vector<uint8_t>(8, i));
+  }
+}
+
+TEST_F(BtifSockL2capRxQueueTest, flush_waits_for_slow_reader) {
+  int sndbuf = 4096;
+  ASSERT_EQ(
+      setsockopt(fds_[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)), 0);
+
+  BtifSockL2capRxQueue queue(1024 * 1024);
+  const int kCount = 256;
+  for (int i = 0; i < kCount; i++) {
+    ASSERT_TRUE(queue.Enqueue(make_sdu(i, 1000)));
+  }
+
+  // The socket can not hold all of them: the rest waits in the queue, in
+  // order
+  EXPECT_TRUE(queue.Flush(fds_[0]));
+  EXPECT_FALSE(queue.empty());
+  int received = 0;
+  while (true) {
+    std::vector<uint8_t> record = Receive();
+    if (record.empty()) {
+      if (!queue.Flush(fds_[0])) break;
+      continue;
+    }
+    EXPECT_EQ(record, std::vector<uint8_t>(1000, received & 0xff));
+    received++;
+  }
+  while (!Receive().empty()) received++;
+  EXPECT_EQ(received, kCount);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(BtifSockL2capRxQueueTest, enqueue_limited_to_max_bytes) {
+  ASSERT_TRUE(queue_.Enqueue(make_sdu(0x01, kMaxBytes)));
+  BT_HDR* p_buf = make_sdu(0x02, 1);
+  EXPECT_FALSE(queue_.Enqueue(p_buf));
+  osi_free(p_buf);
+
+  EXPECT_FALSE(queue_.Flush(fds_[0]));
+  ASSERT_TRUE(queue_.Enqueue(make_sdu(0x02, 1)));
+}
+
+TEST_F(BtifSockL2capRxQueueTest, flush_error) {
+  ASSERT_TRUE(queue_.Enqueue(make_sdu(0x01, 10)));
+  close(fds_[1]);
+  fds_[1] = -1;
+  // The app closed its side, there is no point in waiting
+  EXPECT_FALSE(queue_.Flush(fds_[0]));
+}
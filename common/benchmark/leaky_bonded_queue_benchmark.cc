@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/leaky_bonded_queue.h"
+#include "common/lock_free_leaky_bonded_queue.h"
+
+using ::benchmark::State;
+using bluetooth::common::LeakyBondedQueue;
+using bluetooth::common::LockFreeLeakyBondedQueue;
+
+namespace {
+
+constexpr int kNumProducers = 4;
+constexpr int kNumItemsPerProducer = 20000;
+// Same as the BQR event queue
+constexpr size_t kQueueCapacity = 80;
+
+struct Event {
+  int producer;
+  int index;
+};
+
+// Producers log events as fast as they can while one consumer dumps them, as
+// quality reports and metrics do
+template <class Queue>
+void ProduceAndConsume(State& state) {
+  for (auto _ : state) {
+    Queue queue(kQueueCapacity);
+    std::atomic<int> num_producing(kNumProducers);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kNumProducers; producer++) {
+      producers.emplace_back([&queue, &num_producing, producer]() {
+        for (int i = 0; i < kNumItemsPerProducer; i++) {
+          queue.Enqueue(new Event{producer, i});
+        }
+        num_producing--;
+      });
+    }
+    while (num_producing > 0) {
+      while (!queue.Empty()) {
+        Event* event = queue.Dequeue();
+        if (event == nullptr) break;
+        benchmark::DoNotOptimize(event->index);
+        delete event;
+      }
+      std::this_thread::yield();
+    }
+    for (std::thread& producer : producers) producer.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumProducers *
+                          kNumItemsPerProducer);
+}
+
+}  // namespace
+
+static void BM_LeakyBondedQueue(State& state) {
+  ProduceAndConsume<LeakyBondedQueue<Event>>(state);
+}
+BENCHMARK(BM_LeakyBondedQueue)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_LockFreeLeakyBondedQueue(State& state) {
+  ProduceAndConsume<LockFreeLeakyBondedQueue<Event>>(state);
+}
+BENCHMARK(BM_LockFreeLeakyBondedQueue)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
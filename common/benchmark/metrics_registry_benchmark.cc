@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+#include "common/metrics_registry.h"
+
+using ::benchmark::State;
+using bluetooth::common::MetricsCounter;
+using bluetooth::common::MetricsHistogram;
+using bluetooth::common::MetricsRegistry;
+
+namespace {
+
+// What the metrics logger did before: a shared value guarded by a lock
+struct LockedCounter {
+  std::mutex lock;
+  int64_t value = 0;
+  std::array<int64_t, MetricsHistogram::kNumBuckets> buckets{};
+};
+
+LockedCounter locked_counter;
+MetricsCounter* registry_counter =
+    MetricsRegistry::GetInstance()->GetCounter("benchmark_counter");
+MetricsHistogram* registry_histogram =
+    MetricsRegistry::GetInstance()->GetHistogram("benchmark_histogram");
+
+}  // namespace
+
+static void BM_LockedCounter(State& state) {
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> lock(locked_counter.lock);
+    locked_counter.value++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedCounter)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_LockedHistogram(State& state) {
+  int64_t value = 0;
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> lock(locked_counter.lock);
+    locked_counter.buckets[MetricsHistogram::BucketIndex(value++ & 0xfff)]++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedHistogram)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_RegistryCounter(State& state) {
+  for (auto _ : state) {
+    registry_counter->Increment();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RegistryCounter)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_RegistryHistogram(State& state) {
+  int64_t value = 0;
+  for (auto _ : state) {
+    registry_histogram->Record(value++ & 0xfff);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RegistryHistogram)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_RegistryLookup(State& state) {
+  MetricsRegistry* registry = MetricsRegistry::GetInstance();
+  for (auto _ : state) {
+    registry->GetCounter("benchmark_counter")->Increment();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RegistryLookup)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
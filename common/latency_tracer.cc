@@ -0,0 +1,306 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "latency_tracer.h"
+
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "metrics_registry.h"
+
+namespace bluetooth {
+
+namespace common {
+
+namespace {
+
+// A packet visits each layer at most once; extra stamps are ignored
+constexpr size_t kMaxStamps = 12;
+// Traces waiting for another thread. Packets dropped on the way never resume
+// their trace, so the parked traces are dropped all at once past this bound.
+constexpr size_t kMaxParkedTraces = 256;
+// Finished traces kept for the Chrome trace export
+constexpr size_t kMaxCompletedTraces = 512;
+
+struct TraceStamp {
+  LatencyTracer::Point point;
+  int64_t time_us;
+  int32_t tid;
+};
+
+struct Trace {
+  uint64_t id;
+  size_t num_stamps = 0;
+  std::array<TraceStamp, kMaxStamps> stamps;
+};
+
+int64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int32_t current_tid() {
+  thread_local int32_t tid = static_cast<int32_t>(syscall(SYS_gettid));
+  return tid;
+}
+
+void add_stamp(Trace* trace, LatencyTracer::Point point) {
+  if (trace->num_stamps == kMaxStamps) return;
+  trace->stamps[trace->num_stamps++] = {point, now_us(), current_tid()};
+}
+
+std::string segment_name(LatencyTracer::Point from, LatencyTracer::Point to) {
+  return std::string(LatencyTracer::PointName(from)) + "->" +
+         LatencyTracer::PointName(to);
+}
+
+std::string path_name(const Trace& trace) {
+  std::string name;
+  for (size_t i = 0; i < trace.num_stamps; i++) {
+    if (i > 0) name += ">";
+    name += LatencyTracer::PointName(trace.stamps[i].point);
+  }
+  return name;
+}
+
+using HistogramMap = std::map<std::string, std::unique_ptr<MetricsHistogram>>;
+
+// Trace owned by the calling thread
+thread_local std::unique_ptr<Trace> current_trace;
+
+struct TracerState {
+  std::mutex lock;
+  uint64_t next_trace_id = 1;
+  std::unordered_map<const void*, std::unique_ptr<Trace>> parked;
+  std::deque<std::unique_ptr<Trace>> completed;
+  HistogramMap segment_latency_us;
+  HistogramMap path_latency_us;
+};
+
+TracerState& state() {
+  static TracerState* tracer_state = new TracerState();
+  return *tracer_state;
+}
+
+void record(HistogramMap& histograms, const std::string& name, int64_t value) {
+  auto& histogram = histograms[name];
+  if (histogram == nullptr) {
+    histogram = std::make_unique<MetricsHistogram>(name);
+  }
+  histogram->Record(value);
+}
+
+uint64_t percentile(const MetricsHistogramSnapshot& snapshot, int percent) {
+  int64_t rank = (snapshot.count * percent + 99) / 100;
+  int64_t seen = 0;
+  for (const auto& bucket : snapshot.buckets) {
+    seen += bucket.second;
+    if (seen >= rank) return bucket.first;
+  }
+  return 0;
+}
+
+void dump_histograms(int fd, const char* title,
+                     const HistogramMap& histograms) {
+  dprintf(fd, "  %s:\n", title);
+  for (const auto& entry : histograms) {
+    MetricsHistogramSnapshot snapshot = entry.second->Get();
+    if (snapshot.count == 0) continue;
+    dprintf(fd,
+            "    %-48s count %8lld  mean %8lld us  p50 >= %8llu us  "
+            "p99 >= %8llu us\n",
+            entry.first.c_str(), static_cast<long long>(snapshot.count),
+            static_cast<long long>(snapshot.sum / snapshot.count),
+            static_cast<unsigned long long>(percentile(snapshot, 50)),
+            static_cast<unsigned long long>(percentile(snapshot, 99)));
+  }
+}
+
+}  // namespace
+
+std::atomic<bool> LatencyTracer::enabled_(false);
+
+const char* LatencyTracer::PointName(Point point) {
+  switch (point) {
+    case HCI_RX:
+      return "hci_rx";
+    case BTU_DISPATCH:
+      return "btu_dispatch";
+    case L2CAP_RX:
+      return "l2cap_rx";
+    case AVDTP_RX:
+      return "avdtp_rx";
+    case GATT_RX:
+      return "gatt_rx";
+    case RFCOMM_RX:
+      return "rfcomm_rx";
+    case BTIF_DISPATCH:
+      return "btif_dispatch";
+    case JNI_CALLBACK:
+      return "jni_callback";
+    case NUM_POINTS:
+      break;
+  }
+  return "unknown";
+}
+
+void LatencyTracer::SetEnabled(bool enabled) {
+  TracerState& tracer = state();
+  std::lock_guard<std::mutex> lock(tracer.lock);
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    tracer.parked.clear();
+    tracer.completed.clear();
+    tracer.segment_latency_us.clear();
+    tracer.path_latency_us.clear();
+  }
+}
+
+void LatencyTracer::BeginImpl(Point point) {
+  current_trace = std::make_unique<Trace>();
+  {
+    TracerState& tracer = state();
+    std::lock_guard<std::mutex> lock(tracer.lock);
+    current_trace->id = tracer.next_trace_id++;
+  }
+  add_stamp(current_trace.get(), point);
+}
+
+void LatencyTracer::StampImpl(Point point) {
+  if (current_trace == nullptr) return;
+  add_stamp(current_trace.get(), point);
+}
+
+void LatencyTracer::ParkImpl(const void* packet) {
+  TracerState& tracer = state();
+  std::lock_guard<std::mutex> lock(tracer.lock);
+  if (current_trace == nullptr) {
+    tracer.parked.erase(packet);
+    return;
+  }
+  if (tracer.parked.size() >= kMaxParkedTraces) {
+    tracer.parked.clear();
+  }
+  tracer.parked[packet] = std::move(current_trace);
+}
+
+void LatencyTracer::ResumeImpl(const void* packet, Point point) {
+  current_trace.reset();
+  {
+    TracerState& tracer = state();
+    std::lock_guard<std::mutex> lock(tracer.lock);
+    auto it = tracer.parked.find(packet);
+    if (it == tracer.parked.end()) return;
+    current_trace = std::move(it->second);
+    tracer.parked.erase(it);
+  }
+  add_stamp(current_trace.get(), point);
+}
+
+void LatencyTracer::EndImpl() {
+  if (current_trace == nullptr) return;
+  std::unique_ptr<Trace> trace = std::move(current_trace);
+  if (trace->num_stamps < 2) return;
+  TracerState& tracer = state();
+  std::lock_guard<std::mutex> lock(tracer.lock);
+  for (size_t i = 1; i < trace->num_stamps; i++) {
+    const TraceStamp& from = trace->stamps[i - 1];
+    const TraceStamp& to = trace->stamps[i];
+    record(tracer.segment_latency_us, segment_name(from.point, to.point),
+           to.time_us - from.time_us);
+  }
+  record(tracer.path_latency_us, path_name(*trace),
+         trace->stamps[trace->num_stamps - 1].time_us -
+             trace->stamps[0].time_us);
+  if (tracer.completed.size() >= kMaxCompletedTraces) {
+    tracer.completed.pop_front();
+  }
+  tracer.completed.push_back(std::move(trace));
+}
+
+std::string LatencyTracer::GetChromeTrace() {
+  TracerState& tracer = state();
+  std::lock_guard<std::mutex> lock(tracer.lock);
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  char event[256];
+  auto append = [&json, &first](const char* text) {
+    if (!first) json += ",";
+    json += text;
+    first = false;
+  };
+  for (const auto& trace : tracer.completed) {
+    const TraceStamp& start = trace->stamps[0];
+    const TraceStamp& end = trace->stamps[trace->num_stamps - 1];
+    // The whole path on the receiving thread, with one slice per segment on
+    // the thread the segment started on
+    snprintf(event, sizeof(event),
+             "{\"name\":\"%s\",\"cat\":\"bt_packet\",\"ph\":\"X\","
+             "\"ts\":%lld,\"dur\":%lld,\"pid\":%d,\"tid\":%d,"
+             "\"args\":{\"trace\":%llu}}",
+             path_name(*trace).c_str(), static_cast<long long>(start.time_us),
+             static_cast<long long>(end.time_us - start.time_us), getpid(),
+             start.tid, static_cast<unsigned long long>(trace->id));
+    append(event);
+    for (size_t i = 1; i < trace->num_stamps; i++) {
+      const TraceStamp& from = trace->stamps[i - 1];
+      const TraceStamp& to = trace->stamps[i];
+      snprintf(event, sizeof(event),
+               "{\"name\":\"%s\",\"cat\":\"bt_layer\",\"ph\":\"X\","
+               "\"ts\":%lld,\"dur\":%lld,\"pid\":%d,\"tid\":%d,"
+               "\"args\":{\"trace\":%llu}}",
+               segment_name(from.point, to.point).c_str(),
+               static_cast<long long>(from.time_us),
+               static_cast<long long>(to.time_us - from.time_us), getpid(),
+               from.tid, static_cast<unsigned long long>(trace->id));
+      append(event);
+    }
+  }
+  json += "]}";
+  return json;
+}
+
+void LatencyTracer::Dump(int fd) {
+  dprintf(fd, "\nPacket latency tracer:\n");
+  if (!IsEnabled()) {
+    dprintf(fd, "  disabled\n");
+    return;
+  }
+  {
+    TracerState& tracer = state();
+    std::lock_guard<std::mutex> lock(tracer.lock);
+    dump_histograms(fd, "Per layer latency", tracer.segment_latency_us);
+    dump_histograms(fd, "Per path latency", tracer.path_latency_us);
+  }
+  dprintf(fd, "  Chrome trace of recent packets:\n%s\n",
+          GetChromeTrace().c_str());
+}
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * Opt-in tracer following received packets from the HCI layer up to the
+ * profile callbacks.
+ *
+ * A trace is owned by the thread currently processing the packet and gets a
+ * timestamp at every layer boundary it crosses. When the packet moves to
+ * another thread, the trace is parked under the buffer carrying the packet
+ * (Park) and picked up from it on the other side (Resume). Finished traces
+ * feed per segment and per path latency histograms, and the most recent ones
+ * are kept for export in the Chrome trace event JSON format, which Perfetto
+ * also loads.
+ *
+ * All entry points are static and cost a single relaxed load while disabled.
+ */
+class LatencyTracer {
+ public:
+  enum Point : uint8_t {
+    HCI_RX,
+    BTU_DISPATCH,
+    L2CAP_RX,
+    AVDTP_RX,
+    GATT_RX,
+    RFCOMM_RX,
+    BTIF_DISPATCH,
+    JNI_CALLBACK,
+    NUM_POINTS,
+  };
+
+  static const char* PointName(Point point);
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Enable or disable tracing. Disabling also drops all collected data.
+   */
+  static void SetEnabled(bool enabled);
+
+  /**
+   * Start a new trace on the calling thread, stamped with |point|
+   */
+  static void Begin(Point point) {
+    if (IsEnabled()) BeginImpl(point);
+  }
+
+  /**
+   * Stamp the trace of the calling thread, if any, with |point|
+   */
+  static void Stamp(Point point) {
+    if (IsEnabled()) StampImpl(point);
+  }
+
+  /**
+   * Detach the trace of the calling thread and keep it under |packet|. Without
+   * a trace, a stale trace left under a previous buffer at the same address is
+   * dropped.
+   */
+  static void Park(const void* packet) {
+    if (IsEnabled()) ParkImpl(packet);
+  }
+
+  /**
+   * Make the trace parked under |packet|, if any, the trace of the calling
+   * thread and stamp it with |point|
+   */
+  static void Resume(const void* packet, Point point) {
+    if (IsEnabled()) ResumeImpl(packet, point);
+  }
+
+  /**
+   * Finish the trace of the calling thread, if any, and account it
+   */
+  static void End() {
+    if (IsEnabled()) EndImpl();
+  }
+
+  /**
+   * Returns the most recent traces in the Chrome trace event JSON format
+   */
+  static std::string GetChromeTrace();
+
+  /**
+   * Dump latency histograms and the Chrome trace of recent packets to |fd|
+   */
+  static void Dump(int fd);
+
+ private:
+  static void BeginImpl(Point point);
+  static void StampImpl(Point point);
+  static void ParkImpl(const void* packet);
+  static void ResumeImpl(const void* packet, Point point);
+  static void EndImpl();
+
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "common/latency_tracer.h"
+
+namespace testing {
+
+using bluetooth::common::LatencyTracer;
+
+class LatencyTracerTest : public Test {
+ protected:
+  void SetUp() override { LatencyTracer::SetEnabled(true); }
+  void TearDown() override { LatencyTracer::SetEnabled(false); }
+};
+
+static size_t count_occurrences(const std::string& text,
+                                const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + 1)) {
+    count++;
+  }
+  return count;
+}
+
+TEST_F(LatencyTracerTest, disabled_records_nothing) {
+  LatencyTracer::SetEnabled(false);
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
+  LatencyTracer::Stamp(LatencyTracer::L2CAP_RX);
+  LatencyTracer::End();
+  LatencyTracer::SetEnabled(true);
+  EXPECT_EQ(LatencyTracer::GetChromeTrace(),
+            "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+}
+
+TEST_F(LatencyTracerTest, single_thread_path) {
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
+  LatencyTracer::Stamp(LatencyTracer::L2CAP_RX);
+  LatencyTracer::Stamp(LatencyTracer::GATT_RX);
+  LatencyTracer::End();
+  std::string trace = LatencyTracer::GetChromeTrace();
+  EXPECT_EQ(count_occurrences(trace, "\"ph\":\"X\""), 3u);
+  EXPECT_NE(trace.find("\"name\":\"hci_rx>l2cap_rx>gatt_rx\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"hci_rx->l2cap_rx\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"l2cap_rx->gatt_rx\""), std::string::npos);
+}
+
+TEST_F(LatencyTracerTest, single_stamp_is_dropped) {
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
+  LatencyTracer::End();
+  EXPECT_EQ(count_occurrences(LatencyTracer::GetChromeTrace(), "\"ph\""), 0u);
+}
+
+TEST_F(LatencyTracerTest, park_and_resume_across_threads) {
+  int packet;
+  std::thread rx_thread([&packet] {
+    LatencyTracer::Begin(LatencyTracer::HCI_RX);
+    LatencyTracer::Park(&packet);
+  });
+  rx_thread.join();
+  // Unknown packets do not pick up the parked trace
+  int other_packet;
+  LatencyTracer::Resume(&other_packet, LatencyTracer::BTU_DISPATCH);
+  LatencyTracer::End();
+  EXPECT_EQ(count_occurrences(LatencyTracer::GetChromeTrace(), "\"ph\""), 0u);
+
+  LatencyTracer::Resume(&packet, LatencyTracer::BTU_DISPATCH);
+  LatencyTracer::Stamp(LatencyTracer::L2CAP_RX);
+  LatencyTracer::End();
+  std::string trace = LatencyTracer::GetChromeTrace();
+  EXPECT_NE(trace.find("\"name\":\"hci_rx>btu_dispatch>l2cap_rx\""),
+            std::string::npos);
+}
+
+TEST_F(LatencyTracerTest, traces_follow_their_own_packets) {
+  int gatt_packet;
+  int rfcomm_packet;
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
+  LatencyTracer::Stamp(LatencyTracer::GATT_RX);
+  LatencyTracer::Park(&gatt_packet);
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
+  LatencyTracer::Stamp(LatencyTracer::RFCOMM_RX);
+  LatencyTracer::Park(&rfcomm_packet);
+  // Nothing is left on this thread after parking
+  LatencyTracer::End();
+  EXPECT_EQ(count_occurrences(LatencyTracer::GetChromeTrace(), "\"ph\""), 0u);
+
+  // The packets are resumed in another order than they were parked in
+  std::thread jni_thread([&gatt_packet] {
+    LatencyTracer::Resume(&gatt_packet, LatencyTracer::JNI_CALLBACK);
+    LatencyTracer::End();
+  });
+  jni_thread.join();
+  std::string trace = LatencyTracer::GetChromeTrace();
+  EXPECT_NE(trace.find("\"name\":\"hci_rx>gatt_rx>jni_callback\""),
+            std::string::npos);
+  EXPECT_EQ(trace.find("rfcomm_rx"), std::string::npos);
+}
+
+TEST_F(LatencyTracerTest, park_without_trace_drops_stale_trace) {
+  int packet;
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
+  LatencyTracer::Park(&packet);
+  // A new untraced packet reuses the buffer of one never resumed
+  LatencyTracer::Park(&packet);
+  LatencyTracer::Resume(&packet, LatencyTracer::BTU_DISPATCH);
+  LatencyTracer::End();
+  EXPECT_EQ(count_occurrences(LatencyTracer::GetChromeTrace(), "\"ph\""), 0u);
+}
+
+}  // namespace testing
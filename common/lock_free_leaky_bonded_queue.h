@@ -0,0 +1,244 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <base/logging.h>
+
+namespace bluetooth {
+
+namespace common {
+
+/*
+ *   LockFreeLeakyBondedQueue<T>
+ *
+ * - Same fixed size queue leaking its oldest item as LeakyBondedQueue<T>,
+ *   for items logged from several threads on hot paths, without a mutex.
+ * - Items are kept in a ring of |capacity| cells. Each cell has a sequence
+ *   number telling whether it is ready to be written (2 * position) or read
+ *   (2 * position + 1) for a given position, so producers and consumers only
+ *   contend on the position they claim with a compare and swap.
+ * - A producer finding the ring full dequeues the oldest item itself and
+ *   tries again. Items of a given producer are dequeued in the order they
+ *   were enqueued.
+ * - Length() and Empty() are a snapshot that may be stale by the time they
+ *   return when other threads use the queue. Dequeue() may return nullptr
+ *   even after Empty() returned false, callers must check its result.
+ * - The queue owns the items it holds and deletes them when they leak or
+ *   when it is cleared or destructed.
+ *
+ */
+template <class T>
+class LockFreeLeakyBondedQueue {
+ public:
+  LockFreeLeakyBondedQueue(size_t capacity);
+  /* Default destructor
+   *
+   * Call Clear() and free the queue structure itself
+   */
+  ~LockFreeLeakyBondedQueue();
+  /*
+   * Add item NEW_ITEM to the underlining queue. If the queue is full, delete
+   * the oldest item
+   */
+  void Enqueue(T* new_item);
+  /*
+   * Add item NEW_ITEM to the underlining queue. If the queue is full, dequeue
+   * the oldest item and returns it to the caller. Return nullptr otherwise.
+   * When other producers fill the queue again at the same time, the older
+   * items dequeued to make room are deleted and the last one is returned.
+   */
+  T* EnqueueWithPop(T* new_item);
+  /*
+   * Dequeues the oldest item from the queue. Return nullptr if queue is empty
+   */
+  T* Dequeue();
+  /*
+   * Returns the length of queue
+   */
+  size_t Length();
+  /*
+   * Returns the defined capacity of the queue
+   */
+  size_t Capacity();
+  /*
+   * Returns whether the queue is empty
+   */
+  bool Empty();
+  /*
+   * Pops all items from the queue
+   */
+  void Clear();
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T* item;
+  };
+
+  bool TryEnqueue(T* new_item);
+  bool TryDequeue(T** item);
+
+  const size_t capacity_;
+  std::unique_ptr<Cell[]> cells_;
+  // Apart so that producers and consumers do not share a cache line
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) std::atomic<size_t> dequeue_pos_;
+};
+
+/*
+ * Definitions must be in the header for template classes
+ */
+
+template <class T>
+LockFreeLeakyBondedQueue<T>::LockFreeLeakyBondedQueue(size_t capacity)
+    : capacity_(capacity),
+      cells_(new Cell[capacity]),
+      enqueue_pos_(0),
+      dequeue_pos_(0) {
+  if (capacity_ == 0) {
+    // don't allow invalid capacity
+    LOG(FATAL) << __func__ << ": unable to have 0 queue capacity";
+  }
+  for (size_t i = 0; i < capacity_; i++) {
+    cells_[i].sequence.store(2 * i, std::memory_order_relaxed);
+    cells_[i].item = nullptr;
+  }
+}
+
+template <class T>
+LockFreeLeakyBondedQueue<T>::~LockFreeLeakyBondedQueue() {
+  Clear();
+}
+
+template <class T>
+bool LockFreeLeakyBondedQueue<T>::TryEnqueue(T* new_item) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    Cell& cell = cells_[pos % capacity_];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)(2 * pos);
+    if (diff == 0) {
+      // Free for this position, claim it
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        cell.item = new_item;
+        cell.sequence.store(2 * pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // Still holding the item of the previous round, queue is full
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <class T>
+bool LockFreeLeakyBondedQueue<T>::TryDequeue(T** item) {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    Cell& cell = cells_[pos % capacity_];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)(2 * pos + 1);
+    if (diff == 0) {
+      // Written for this position, claim it
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        *item = cell.item;
+        cell.sequence.store(2 * (pos + capacity_), std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // Not written yet, queue is empty
+      return false;
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <class T>
+void LockFreeLeakyBondedQueue<T>::Enqueue(T* new_item) {
+  while (!TryEnqueue(new_item)) {
+    T* old_item;
+    if (TryDequeue(&old_item)) {
+      delete old_item;
+    } else {
+      // Another thread is writing or reading the cells in the way
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <class T>
+T* LockFreeLeakyBondedQueue<T>::EnqueueWithPop(T* new_item) {
+  T* old_item = nullptr;
+  while (!TryEnqueue(new_item)) {
+    T* item;
+    if (TryDequeue(&item)) {
+      delete old_item;
+      old_item = item;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  return old_item;
+}
+
+template <class T>
+T* LockFreeLeakyBondedQueue<T>::Dequeue() {
+  T* item = nullptr;
+  TryDequeue(&item);
+  return item;
+}
+
+template <class T>
+void LockFreeLeakyBondedQueue<T>::Clear() {
+  T* item;
+  while (TryDequeue(&item)) {
+    delete item;
+  }
+}
+
+template <class T>
+size_t LockFreeLeakyBondedQueue<T>::Length() {
+  size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+  size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+  if (enqueue_pos <= dequeue_pos) return 0;
+  return std::min(enqueue_pos - dequeue_pos, capacity_);
+}
+
+template <class T>
+size_t LockFreeLeakyBondedQueue<T>::Capacity() {
+  return capacity_;
+}
+
+template <class T>
+bool LockFreeLeakyBondedQueue<T>::Empty() {
+  return Length() == 0;
+}
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/lock_free_leaky_bonded_queue.h"
+
+namespace testing {
+
+using bluetooth::common::LockFreeLeakyBondedQueue;
+
+static std::atomic<int> num_deleted;
+
+class Item {
+ public:
+  Item(int producer, int index) : producer(producer), index(index) {}
+  ~Item() { num_deleted++; }
+  int producer;
+  int index;
+};
+
+TEST(LockFreeLeakyBondedQueueTest, TestEnqueueDequeue) {
+  num_deleted = 0;
+  LockFreeLeakyBondedQueue<Item> queue(3);
+  EXPECT_EQ(queue.Capacity(), static_cast<size_t>(3));
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Dequeue(), nullptr);
+
+  for (int i = 1; i <= 3; i++) {
+    queue.Enqueue(new Item(0, i));
+    EXPECT_EQ(queue.Length(), static_cast<size_t>(i));
+  }
+  // Leaks item 1
+  queue.Enqueue(new Item(0, 4));
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(3));
+  EXPECT_EQ(num_deleted, 1);
+
+  for (int i = 2; i <= 4; i++) {
+    std::unique_ptr<Item> item(queue.Dequeue());
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(item->index, i);
+  }
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Dequeue(), nullptr);
+}
+
+TEST(LockFreeLeakyBondedQueueTest, TestEnqueueWithPop) {
+  num_deleted = 0;
+  LockFreeLeakyBondedQueue<Item> queue(2);
+  Item* item1 = new Item(0, 1);
+  EXPECT_EQ(queue.EnqueueWithPop(item1), nullptr);
+  EXPECT_EQ(queue.EnqueueWithPop(new Item(0, 2)), nullptr);
+  EXPECT_EQ(queue.EnqueueWithPop(new Item(0, 3)), item1);
+  EXPECT_EQ(num_deleted, 0);
+  delete item1;
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(2));
+}
+
+TEST(LockFreeLeakyBondedQueueTest, TestClearAndDestruct) {
+  num_deleted = 0;
+  auto queue = std::make_unique<LockFreeLeakyBondedQueue<Item>>(4);
+  queue->Enqueue(new Item(0, 1));
+  queue->Enqueue(new Item(0, 2));
+  queue->Clear();
+  EXPECT_EQ(num_deleted, 2);
+  EXPECT_TRUE(queue->Empty());
+  queue->Enqueue(new Item(0, 3));
+  queue.reset();
+  EXPECT_EQ(num_deleted, 3);
+}
+
+TEST(LockFreeLeakyBondedQueueTest, TestPushNull) {
+  LockFreeLeakyBondedQueue<Item> queue(1);
+  queue.Enqueue(nullptr);
+  queue.Enqueue(nullptr);
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(1));
+  EXPECT_EQ(queue.Dequeue(), nullptr);
+  EXPECT_TRUE(queue.Empty());
+}
+
+// Producers race to leak each other's items while a consumer dequeues. Every
+// item must be either dequeued or deleted exactly once, and the items of a
+// producer must be dequeued in order.
+TEST(LockFreeLeakyBondedQueueTest, TestConcurrentProducersAndConsumer) {
+  static const int num_producers = 4;
+  static const int num_items = 50000;
+  num_deleted = 0;
+  LockFreeLeakyBondedQueue<Item> queue(16);
+  std::atomic<int> num_producing(num_producers);
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < num_producers; producer++) {
+    producers.emplace_back([&queue, &num_producing, producer]() {
+      for (int i = 0; i < num_items; i++) {
+        if (i % 2 == 0) {
+          queue.Enqueue(new Item(producer, i));
+        } else {
+          delete queue.EnqueueWithPop(new Item(producer, i));
+        }
+      }
+      num_producing--;
+    });
+  }
+
+  int num_dequeued = 0;
+  std::vector<int> last_index(num_producers, -1);
+  bool in_order = true;
+  bool within_capacity = true;
+  auto dequeue_all = [&]() {
+    while (Item* item = queue.Dequeue()) {
+      in_order &= item->index > last_index[item->producer];
+      last_index[item->producer] = item->index;
+      num_dequeued++;
+      delete item;
+    }
+  };
+  while (num_producing > 0) {
+    within_capacity &= queue.Length() <= queue.Capacity();
+    dequeue_all();
+    std::this_thread::yield();
+  }
+  for (std::thread& producer : producers) producer.join();
+  dequeue_all();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(within_capacity);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_GT(num_dequeued, 0);
+  EXPECT_EQ(num_deleted, num_producers * num_items);
+}
+
+}  // namespace testing
@@ -36,7 +36,8 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name)
       thread_id_(-1),
       linux_tid_(-1),
       weak_ptr_factory_(this),
-      shutting_down_(false) {}
+      shutting_down_(false),
+      post_count_(0) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -58,9 +59,27 @@ void MessageLoopThread::StartUp() {
 
 bool MessageLoopThread::DoInThread(const base::Location& from_here,
                                    base::OnceClosure task) {
-  return DoInThreadDelayed(from_here, std::move(task), base::TimeDelta());
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  if (!DoInThreadDelayed(from_here, std::move(task), base::TimeDelta())) {
+    return false;
+  }
+  post_count_++;
+  return true;
+}
+
+bool MessageLoopThread::DoInThread(const base::Location& from_here,
+                                   base::OnceClosure task,
+                                   uint64_t* post_count) {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  if (!DoInThread(from_here, std::move(task))) {
+    return false;
+  }
+  *post_count = post_count_;
+  return true;
 }
 
+uint64_t MessageLoopThread::GetPostCount() const { return post_count_; }
+
 bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                                           base::OnceClosure task,
                                           const base::TimeDelta& delay) {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <unistd.h>
+#include <atomic>
 #include <future>
 #include <memory>
 #include <string>
@@ -69,6 +70,29 @@ class MessageLoopThread final {
    */
   bool DoInThread(const base::Location& from_here, base::OnceClosure task);
 
+  /**
+   * Post a task to run on this thread, and return the number of tasks posted
+   * through DoInThread() so far, this task included. A caller can compare it
+   * with GetPostCount() later to know whether other tasks were posted after
+   * this one
+   *
+   * @param from_here location where this task is originated
+   * @param task task created through base::Bind()
+   * @param post_count where to store the number of tasks posted so far
+   * @return true if task is successfully scheduled, false if task cannot be
+   * scheduled
+   */
+  bool DoInThread(const base::Location& from_here, base::OnceClosure task,
+                  uint64_t* post_count);
+
+  /**
+   * Get the number of tasks posted through DoInThread() since this object was
+   * created
+   *
+   * @return number of tasks posted through DoInThread()
+   */
+  uint64_t GetPostCount() const;
+
   /**
    * Shutdown the current thread as if it is never started. IsRunning() and
    * DoInThread() will return false after this call. Blocks until the thread is
@@ -197,6 +221,8 @@ class MessageLoopThread final {
   pid_t linux_tid_;
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
+  // Updated while holding api_mutex_, right after each post
+  std::atomic<uint64_t> post_count_;
 
   DISALLOW_COPY_AND_ASSIGN(MessageLoopThread);
 };
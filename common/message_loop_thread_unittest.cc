@@ -133,6 +133,23 @@ TEST_F(MessageLoopThreadTest, test_do_in_thread_after_shutdown) {
                             base::Unretained(this))));
 }
 
+TEST_F(MessageLoopThreadTest, test_post_count) {
+  std::string name = "test_thread";
+  MessageLoopThread message_loop_thread(name);
+  base::Closure nothing = base::Bind([]() {});
+  uint64_t post_count = 0;
+  ASSERT_FALSE(message_loop_thread.DoInThread(FROM_HERE, nothing, &post_count));
+  ASSERT_EQ(message_loop_thread.GetPostCount(), 0u);
+  message_loop_thread.StartUp();
+  ASSERT_TRUE(message_loop_thread.DoInThread(FROM_HERE, nothing));
+  ASSERT_TRUE(message_loop_thread.DoInThread(FROM_HERE, nothing, &post_count));
+  ASSERT_EQ(post_count, 2u);
+  ASSERT_EQ(message_loop_thread.GetPostCount(), 2u);
+  ASSERT_TRUE(message_loop_thread.DoInThread(FROM_HERE, nothing));
+  ASSERT_EQ(message_loop_thread.GetPostCount(), 3u);
+  message_loop_thread.ShutDown();
+}
+
 TEST_F(MessageLoopThreadTest, test_name) {
   std::string name = "test_thread";
   MessageLoopThread message_loop_thread(name);
@@ -19,6 +19,7 @@
 #include <unistd.h>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <cstdint>
@@ -36,9 +37,10 @@
 #include "stack/include/btm_api_types.h"
 
 #include "address_obfuscator.h"
-#include "leaky_bonded_queue.h"
+#include "lock_free_leaky_bonded_queue.h"
 #include "metric_id_allocator.h"
 #include "metrics.h"
+#include "metrics_registry.h"
 #include "time_util.h"
 
 namespace bluetooth {
@@ -65,6 +67,9 @@ using bluetooth::metrics::BluetoothMetricsProto::PairEvent;
 using bluetooth::metrics::BluetoothMetricsProto::ScanEvent;
 using bluetooth::metrics::BluetoothMetricsProto::ScanEvent_ScanEventType;
 using bluetooth::metrics::BluetoothMetricsProto::ScanEvent_ScanTechnologyType;
+using bluetooth::metrics::BluetoothMetricsProto::StackCounter;
+using bluetooth::metrics::BluetoothMetricsProto::StackHistogram;
+using bluetooth::metrics::BluetoothMetricsProto::StackHistogramBucket;
 using bluetooth::metrics::BluetoothMetricsProto::WakeEvent;
 using bluetooth::metrics::BluetoothMetricsProto::WakeEvent_WakeEventType;
 
@@ -254,16 +259,33 @@ static A2dpSourceCodec get_a2dp_source_codec(int64_t codec_index) {
   }
 }
 
+// Moves the queued items to |field|, stopping once it holds one more item
+// than the queue capacity
+template <class T>
+static void DrainQueue(LockFreeLeakyBondedQueue<T>* queue,
+                       google::protobuf::RepeatedPtrField<T>* field) {
+  while (static_cast<size_t>(field->size()) <= queue->Capacity()) {
+    T* item = queue->Dequeue();
+    if (item == nullptr) return;
+    field->AddAllocated(item);
+  }
+}
+
 struct BluetoothMetricsLogger::impl {
   impl(size_t max_bluetooth_session, size_t max_pair_event,
        size_t max_wake_event, size_t max_scan_event)
-      : bt_session_queue_(
-            new LeakyBondedQueue<BluetoothSession>(max_bluetooth_session)),
-        pair_event_queue_(new LeakyBondedQueue<PairEvent>(max_pair_event)),
-        wake_event_queue_(new LeakyBondedQueue<WakeEvent>(max_wake_event)),
-        scan_event_queue_(new LeakyBondedQueue<ScanEvent>(max_scan_event)) {
+      : bt_session_queue_(new LockFreeLeakyBondedQueue<BluetoothSession>(
+            max_bluetooth_session)),
+        pair_event_queue_(
+            new LockFreeLeakyBondedQueue<PairEvent>(max_pair_event)),
+        wake_event_queue_(
+            new LockFreeLeakyBondedQueue<WakeEvent>(max_wake_event)),
+        scan_event_queue_(
+            new LockFreeLeakyBondedQueue<ScanEvent>(max_scan_event)) {
     bluetooth_log_ = BluetoothLog::default_instance().New();
-    headset_profile_connection_counts_.fill(0);
+    for (auto& count : headset_profile_connection_counts_) {
+      count = 0;
+    }
     bluetooth_session_ = nullptr;
     bluetooth_session_start_time_ms_ = 0;
     a2dp_session_metrics_ = A2dpSessionMetrics();
@@ -271,20 +293,23 @@ struct BluetoothMetricsLogger::impl {
 
   /* Bluetooth log lock protected */
   BluetoothLog* bluetooth_log_;
-  std::array<int, HeadsetProfileType_ARRAYSIZE>
-      headset_profile_connection_counts_;
   std::recursive_mutex bluetooth_log_lock_;
   /* End Bluetooth log lock protected */
+  /* Updated without lock, drained in Build() */
+  std::array<std::atomic<int>, HeadsetProfileType_ARRAYSIZE>
+      headset_profile_connection_counts_;
+  /* End updated without lock */
   /* Bluetooth session lock protected */
   BluetoothSession* bluetooth_session_;
   uint64_t bluetooth_session_start_time_ms_;
   A2dpSessionMetrics a2dp_session_metrics_;
   std::recursive_mutex bluetooth_session_lock_;
   /* End bluetooth session lock protected */
-  std::unique_ptr<LeakyBondedQueue<BluetoothSession>> bt_session_queue_;
-  std::unique_ptr<LeakyBondedQueue<PairEvent>> pair_event_queue_;
-  std::unique_ptr<LeakyBondedQueue<WakeEvent>> wake_event_queue_;
-  std::unique_ptr<LeakyBondedQueue<ScanEvent>> scan_event_queue_;
+  std::unique_ptr<LockFreeLeakyBondedQueue<BluetoothSession>>
+      bt_session_queue_;
+  std::unique_ptr<LockFreeLeakyBondedQueue<PairEvent>> pair_event_queue_;
+  std::unique_ptr<LockFreeLeakyBondedQueue<WakeEvent>> wake_event_queue_;
+  std::unique_ptr<LockFreeLeakyBondedQueue<ScanEvent>> scan_event_queue_;
 };
 
 BluetoothMetricsLogger::BluetoothMetricsLogger()
@@ -437,7 +462,6 @@ void BluetoothMetricsLogger::LogA2dpSession(
 
 void BluetoothMetricsLogger::LogHeadsetProfileRfcConnection(
     tBTA_SERVICE_ID service_id) {
-  std::lock_guard<std::recursive_mutex> lock(pimpl_->bluetooth_log_lock_);
   switch (service_id) {
     case BTA_HSP_SERVICE_ID:
       pimpl_->headset_profile_connection_counts_[HeadsetProfileType::HSP]++;
@@ -501,38 +525,17 @@ void BluetoothMetricsLogger::Build() {
   std::lock_guard<std::recursive_mutex> lock(pimpl_->bluetooth_log_lock_);
   CutoffSession();
   BluetoothLog* bluetooth_log = pimpl_->bluetooth_log_;
-  while (!pimpl_->bt_session_queue_->Empty() &&
-         static_cast<size_t>(bluetooth_log->session_size()) <=
-             pimpl_->bt_session_queue_->Capacity()) {
-    bluetooth_log->mutable_session()->AddAllocated(
-        pimpl_->bt_session_queue_->Dequeue());
-  }
-  while (!pimpl_->pair_event_queue_->Empty() &&
-         static_cast<size_t>(bluetooth_log->pair_event_size()) <=
-             pimpl_->pair_event_queue_->Capacity()) {
-    bluetooth_log->mutable_pair_event()->AddAllocated(
-        pimpl_->pair_event_queue_->Dequeue());
-  }
-  while (!pimpl_->scan_event_queue_->Empty() &&
-         static_cast<size_t>(bluetooth_log->scan_event_size()) <=
-             pimpl_->scan_event_queue_->Capacity()) {
-    bluetooth_log->mutable_scan_event()->AddAllocated(
-        pimpl_->scan_event_queue_->Dequeue());
-  }
-  while (!pimpl_->wake_event_queue_->Empty() &&
-         static_cast<size_t>(bluetooth_log->wake_event_size()) <=
-             pimpl_->wake_event_queue_->Capacity()) {
-    bluetooth_log->mutable_wake_event()->AddAllocated(
-        pimpl_->wake_event_queue_->Dequeue());
-  }
-  while (!pimpl_->bt_session_queue_->Empty() &&
-         static_cast<size_t>(bluetooth_log->wake_event_size()) <=
-             pimpl_->wake_event_queue_->Capacity()) {
-    bluetooth_log->mutable_wake_event()->AddAllocated(
-        pimpl_->wake_event_queue_->Dequeue());
-  }
+  DrainQueue(pimpl_->bt_session_queue_.get(),
+             bluetooth_log->mutable_session());
+  DrainQueue(pimpl_->pair_event_queue_.get(),
+             bluetooth_log->mutable_pair_event());
+  DrainQueue(pimpl_->scan_event_queue_.get(),
+             bluetooth_log->mutable_scan_event());
+  DrainQueue(pimpl_->wake_event_queue_.get(),
+             bluetooth_log->mutable_wake_event());
   for (size_t i = 0; i < HeadsetProfileType_ARRAYSIZE; ++i) {
-    int num_times_connected = pimpl_->headset_profile_connection_counts_[i];
+    int num_times_connected =
+        pimpl_->headset_profile_connection_counts_[i].exchange(0);
     if (HeadsetProfileType_IsValid(i) && num_times_connected > 0) {
       HeadsetProfileConnectionStats* headset_profile_connection_stats =
           bluetooth_log->add_headset_profile_connection_stats();
@@ -543,7 +546,32 @@ void BluetoothMetricsLogger::Build() {
           num_times_connected);
     }
   }
-  pimpl_->headset_profile_connection_counts_.fill(0);
+  MetricsRegistry::GetInstance()->ForEachCounter(
+      [bluetooth_log](MetricsCounter* counter) {
+        int64_t count = counter->GetAndReset();
+        if (count == 0) {
+          return;
+        }
+        StackCounter* stack_counter = bluetooth_log->add_stack_counter();
+        stack_counter->set_name(counter->name());
+        stack_counter->set_count(count);
+      });
+  MetricsRegistry::GetInstance()->ForEachHistogram(
+      [bluetooth_log](MetricsHistogram* histogram) {
+        MetricsHistogramSnapshot snapshot = histogram->GetAndReset();
+        if (snapshot.count == 0) {
+          return;
+        }
+        StackHistogram* stack_histogram = bluetooth_log->add_stack_histogram();
+        stack_histogram->set_name(histogram->name());
+        stack_histogram->set_count(snapshot.count);
+        stack_histogram->set_sum(snapshot.sum);
+        for (const auto& bucket : snapshot.buckets) {
+          StackHistogramBucket* stack_bucket = stack_histogram->add_bucket();
+          stack_bucket->set_lower_bound(static_cast<int64_t>(bucket.first));
+          stack_bucket->set_count(bucket.second);
+        }
+      });
 }
 
 void BluetoothMetricsLogger::ResetSession() {
@@ -570,6 +598,52 @@ void BluetoothMetricsLogger::Reset() {
   pimpl_->scan_event_queue_->Clear();
 }
 
+namespace {
+
+// Registry metrics updated by the statsd logging functions below, which are
+// called from the HCI and BTU threads for every matching event
+struct StackEventMetrics {
+  MetricsCounter* link_layer_connection_events;
+  MetricsCounter* hci_timeouts;
+  MetricsCounter* remote_version_infos;
+  MetricsCounter* stats_write_failures;
+  MetricsHistogram* stats_write_latency_us;
+};
+
+const StackEventMetrics& GetStackEventMetrics() {
+  static const StackEventMetrics metrics = [] {
+    MetricsRegistry* registry = MetricsRegistry::GetInstance();
+    StackEventMetrics metrics;
+    metrics.link_layer_connection_events =
+        registry->GetCounter("link_layer_connection_event");
+    metrics.hci_timeouts = registry->GetCounter("hci_timeout");
+    metrics.remote_version_infos = registry->GetCounter("remote_version_info");
+    metrics.stats_write_failures = registry->GetCounter("stats_write_failure");
+    metrics.stats_write_latency_us =
+        registry->GetHistogram("stats_write_latency_us");
+    return metrics;
+  }();
+  return metrics;
+}
+
+// Runs |write|, a stats_write call, and accounts its latency and result
+template <typename StatsWrite>
+int TimedStatsWrite(StatsWrite write) {
+  const StackEventMetrics& metrics = GetStackEventMetrics();
+  auto start = std::chrono::steady_clock::now();
+  int ret = write();
+  metrics.stats_write_latency_us->Record(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  if (ret < 0) {
+    metrics.stats_write_failures->Increment();
+  }
+  return ret;
+}
+
+}  // namespace
+
 void LogLinkLayerConnectionEvent(const RawAddress* address,
                                  uint32_t connection_handle,
                                  android::bluetooth::DirectionEnum direction,
@@ -586,10 +660,13 @@ void LogLinkLayerConnectionEvent(const RawAddress* address,
   android::util::BytesField bytes_field(
       address != nullptr ? obfuscated_id.c_str() : nullptr,
       address != nullptr ? obfuscated_id.size() : 0);
-  int ret = android::util::stats_write(
-      android::util::BLUETOOTH_LINK_LAYER_CONNECTION_EVENT, bytes_field,
-      connection_handle, direction, link_type, hci_cmd, hci_event,
-      hci_ble_event, cmd_status, reason_code, metric_id);
+  GetStackEventMetrics().link_layer_connection_events->Increment();
+  int ret = TimedStatsWrite([&] {
+    return android::util::stats_write(
+        android::util::BLUETOOTH_LINK_LAYER_CONNECTION_EVENT, bytes_field,
+        connection_handle, direction, link_type, hci_cmd, hci_event,
+        hci_ble_event, cmd_status, reason_code, metric_id);
+  });
   if (ret < 0) {
     LOG(WARNING) << __func__ << ": failed to log status " << loghex(cmd_status)
                  << ", reason " << loghex(reason_code) << " from cmd "
@@ -601,9 +678,12 @@ void LogLinkLayerConnectionEvent(const RawAddress* address,
 }
 
 void LogHciTimeoutEvent(uint32_t hci_cmd) {
-  int ret =
-      android::util::stats_write(android::util::BLUETOOTH_HCI_TIMEOUT_REPORTED,
-                                 static_cast<int64_t>(hci_cmd));
+  GetStackEventMetrics().hci_timeouts->Increment();
+  int ret = TimedStatsWrite([&] {
+    return android::util::stats_write(
+        android::util::BLUETOOTH_HCI_TIMEOUT_REPORTED,
+        static_cast<int64_t>(hci_cmd));
+  });
   if (ret < 0) {
     LOG(WARNING) << __func__ << ": failed for opcode " << loghex(hci_cmd)
                  << ", error " << ret;
@@ -612,9 +692,12 @@ void LogHciTimeoutEvent(uint32_t hci_cmd) {
 
 void LogRemoteVersionInfo(uint16_t handle, uint8_t status, uint8_t version,
                           uint16_t manufacturer_name, uint16_t subversion) {
-  int ret = android::util::stats_write(
-      android::util::BLUETOOTH_REMOTE_VERSION_INFO_REPORTED, handle, status,
-      version, manufacturer_name, subversion);
+  GetStackEventMetrics().remote_version_infos->Increment();
+  int ret = TimedStatsWrite([&] {
+    return android::util::stats_write(
+        android::util::BLUETOOTH_REMOTE_VERSION_INFO_REPORTED, handle, status,
+        version, manufacturer_name, subversion);
+  });
   if (ret < 0) {
     LOG(WARNING) << __func__ << ": failed for handle " << handle << ", status "
                  << loghex(status) << ", version " << loghex(version)
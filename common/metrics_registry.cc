@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "metrics_registry.h"
+
+namespace bluetooth {
+
+namespace common {
+
+size_t MetricsShardIndex() {
+  static std::atomic<size_t> next_shard(0);
+  thread_local size_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricsShards;
+  return shard;
+}
+
+int64_t MetricsCounter::Get() const {
+  int64_t total = 0;
+  for (const Shard& shard : shards_) {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+int64_t MetricsCounter::GetAndReset() {
+  int64_t total = 0;
+  for (Shard& shard : shards_) {
+    total += shard.value.exchange(0, std::memory_order_relaxed);
+  }
+  return total;
+}
+
+MetricsHistogramSnapshot MetricsHistogram::Snapshot(bool reset) const {
+  auto take = [reset](std::atomic<int64_t>& value) {
+    return reset ? value.exchange(0, std::memory_order_relaxed)
+                 : value.load(std::memory_order_relaxed);
+  };
+  MetricsHistogramSnapshot snapshot;
+  std::array<int64_t, kNumBuckets> buckets{};
+  for (Shard& shard : shards_) {
+    snapshot.sum += take(shard.sum);
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      buckets[i] += take(shard.buckets[i]);
+    }
+  }
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    if (buckets[i] > 0) {
+      snapshot.count += buckets[i];
+      snapshot.buckets.emplace_back(BucketLowerBound(i), buckets[i]);
+    }
+  }
+  return snapshot;
+}
+
+MetricsRegistry* MetricsRegistry::GetInstance() {
+  static MetricsRegistry* instance = new MetricsRegistry();
+  return instance;
+}
+
+MetricsCounter* MetricsRegistry::GetCounter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto& counter = counters_[name];
+  if (counter == nullptr) {
+    counter = std::make_unique<MetricsCounter>(name);
+  }
+  return counter.get();
+}
+
+MetricsHistogram* MetricsRegistry::GetHistogram(const std::string& name) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto& histogram = histograms_[name];
+  if (histogram == nullptr) {
+    histogram = std::make_unique<MetricsHistogram>(name);
+  }
+  return histogram.get();
+}
+
+void MetricsRegistry::ForEachCounter(
+    const std::function<void(MetricsCounter*)>& visitor) {
+  std::lock_guard<std::mutex> lock(lock_);
+  for (auto& entry : counters_) {
+    visitor(entry.second.get());
+  }
+}
+
+void MetricsRegistry::ForEachHistogram(
+    const std::function<void(MetricsHistogram*)>& visitor) {
+  std::lock_guard<std::mutex> lock(lock_);
+  for (auto& entry : histograms_) {
+    visitor(entry.second.get());
+  }
+}
+
+}  // namespace common
+
+}  // namespace bluetooth
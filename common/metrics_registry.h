@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+
+namespace common {
+
+// Number of independent slots every metric is spread over. Each thread is
+// assigned one slot round robin on first use, so threads updating the same
+// metric concurrently rarely contend on the same cache line.
+constexpr size_t kMetricsShards = 8;
+
+/**
+ * Returns the shard slot of the calling thread, in [0, kMetricsShards)
+ */
+size_t MetricsShardIndex();
+
+/**
+ * A monotonically increasing event counter that can be updated from any thread
+ * without taking a lock. Reading sums all shards and is only meant for dumps.
+ */
+class MetricsCounter {
+ public:
+  explicit MetricsCounter(std::string name) : name_(std::move(name)) {}
+
+  void Increment(int64_t delta = 1) {
+    shards_[MetricsShardIndex()].value.fetch_add(delta,
+                                                 std::memory_order_relaxed);
+  }
+
+  /**
+   * Sum of all increments since creation or the last GetAndReset()
+   */
+  int64_t Get() const;
+
+  /**
+   * Same as Get(), but also clears the counter. Increments racing with this
+   * call are either reported now or by the next call, never lost.
+   */
+  int64_t GetAndReset();
+
+  const std::string& name() const { return name_; }
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value{0};
+  };
+  const std::string name_;
+  std::array<Shard, kMetricsShards> shards_;
+};
+
+/**
+ * Snapshot of a histogram: only non-empty buckets are reported, as pairs of
+ * (bucket lower bound, number of samples) in increasing order
+ */
+struct MetricsHistogramSnapshot {
+  int64_t count = 0;
+  int64_t sum = 0;
+  std::vector<std::pair<uint64_t, int64_t>> buckets;
+};
+
+/**
+ * Fixed-size log-linear histogram of non-negative values. Values below
+ * kSubBuckets get a bucket each; above that, every power of two range is split
+ * into kSubBuckets linear buckets, which bounds the relative error to 25%.
+ * Recording a value is two relaxed atomic adds.
+ */
+class MetricsHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 2;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  explicit MetricsHistogram(std::string name) : name_(std::move(name)) {}
+
+  /**
+   * Record one sample, negative values are counted as 0
+   */
+  void Record(int64_t value) {
+    uint64_t sample = value < 0 ? 0 : static_cast<uint64_t>(value);
+    Shard& shard = shards_[MetricsShardIndex()];
+    shard.buckets[BucketIndex(sample)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(static_cast<int64_t>(sample),
+                        std::memory_order_relaxed);
+  }
+
+  MetricsHistogramSnapshot Get() const { return Snapshot(false); }
+
+  MetricsHistogramSnapshot GetAndReset() { return Snapshot(true); }
+
+  const std::string& name() const { return name_; }
+
+  static constexpr size_t BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    size_t msb = 63 - static_cast<size_t>(__builtin_clzll(value));
+    size_t sub = (value >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+    return (msb - kSubBucketBits + 1) * kSubBuckets + sub;
+  }
+
+  static constexpr uint64_t BucketLowerBound(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    size_t msb = index / kSubBuckets - 1 + kSubBucketBits;
+    uint64_t sub = index % kSubBuckets;
+    return (uint64_t{1} << msb) | (sub << (msb - kSubBucketBits));
+  }
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> sum{0};
+    std::array<std::atomic<int64_t>, kNumBuckets> buckets{};
+  };
+
+  MetricsHistogramSnapshot Snapshot(bool reset) const;
+
+  const std::string name_;
+  mutable std::array<Shard, kMetricsShards> shards_;
+};
+
+/**
+ * Process wide set of named counters and histograms. Lookup takes a lock, so
+ * hot paths should look a metric up once and keep the returned pointer, which
+ * stays valid for the lifetime of the process.
+ */
+class MetricsRegistry {
+ public:
+  static MetricsRegistry* GetInstance();
+
+  /**
+   * Returns the counter called |name|, creating it on first use
+   */
+  MetricsCounter* GetCounter(const std::string& name);
+
+  /**
+   * Returns the histogram called |name|, creating it on first use
+   */
+  MetricsHistogram* GetHistogram(const std::string& name);
+
+  /**
+   * Visit every metric in name order, used to serialize them on dump
+   */
+  void ForEachCounter(const std::function<void(MetricsCounter*)>& visitor);
+  void ForEachHistogram(const std::function<void(MetricsHistogram*)>& visitor);
+
+ private:
+  MetricsRegistry() = default;
+
+  std::mutex lock_;
+  std::map<std::string, std::unique_ptr<MetricsCounter>> counters_;
+  std::map<std::string, std::unique_ptr<MetricsHistogram>> histograms_;
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,116 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 Google, Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/metrics_registry.h"
+
+namespace testing {
+
+using bluetooth::common::MetricsCounter;
+using bluetooth::common::MetricsHistogram;
+using bluetooth::common::MetricsHistogramSnapshot;
+using bluetooth::common::MetricsRegistry;
+
+TEST(MetricsRegistryTest, bucket_index_round_trip) {
+  for (size_t i = 0; i < MetricsHistogram::kNumBuckets; i++) {
+    uint64_t lower_bound = MetricsHistogram::BucketLowerBound(i);
+    EXPECT_EQ(MetricsHistogram::BucketIndex(lower_bound), i);
+    if (i > 0) {
+      EXPECT_EQ(MetricsHistogram::BucketIndex(lower_bound - 1), i - 1);
+    }
+  }
+  EXPECT_EQ(MetricsHistogram::BucketIndex(UINT64_MAX),
+            MetricsHistogram::kNumBuckets - 1);
+}
+
+TEST(MetricsRegistryTest, bucket_relative_error) {
+  for (uint64_t value : {7ull, 100ull, 1000ull, 123456ull, 1ull << 40}) {
+    uint64_t lower_bound = MetricsHistogram::BucketLowerBound(
+        MetricsHistogram::BucketIndex(value));
+    EXPECT_LE(lower_bound, value);
+    EXPECT_LE(value - lower_bound, value / MetricsHistogram::kSubBuckets);
+  }
+}
+
+TEST(MetricsRegistryTest, same_name_same_metric) {
+  MetricsRegistry* registry = MetricsRegistry::GetInstance();
+  EXPECT_EQ(registry->GetCounter("registry_test_counter"),
+            registry->GetCounter("registry_test_counter"));
+  EXPECT_NE(registry->GetCounter("registry_test_counter"),
+            registry->GetCounter("registry_test_other_counter"));
+  EXPECT_EQ(registry->GetHistogram("registry_test_histogram"),
+            registry->GetHistogram("registry_test_histogram"));
+}
+
+TEST(MetricsRegistryTest, counter_get_and_reset) {
+  MetricsCounter counter("counter");
+  counter.Increment();
+  counter.Increment(4);
+  EXPECT_EQ(counter.Get(), 5);
+  EXPECT_EQ(counter.GetAndReset(), 5);
+  EXPECT_EQ(counter.Get(), 0);
+}
+
+TEST(MetricsRegistryTest, histogram_snapshot) {
+  MetricsHistogram histogram("histogram");
+  histogram.Record(-3);
+  histogram.Record(0);
+  histogram.Record(8);
+  histogram.Record(9);
+  MetricsHistogramSnapshot snapshot = histogram.GetAndReset();
+  EXPECT_EQ(snapshot.count, 4);
+  EXPECT_EQ(snapshot.sum, 17);
+  ASSERT_EQ(snapshot.buckets.size(), 2u);
+  EXPECT_EQ(snapshot.buckets[0].first, 0u);
+  EXPECT_EQ(snapshot.buckets[0].second, 2);
+  EXPECT_EQ(snapshot.buckets[1].first, 8u);
+  EXPECT_EQ(snapshot.buckets[1].second, 2);
+  EXPECT_EQ(histogram.Get().count, 0);
+  EXPECT_TRUE(histogram.Get().buckets.empty());
+}
+
+TEST(MetricsRegistryTest, concurrent_updates) {
+  constexpr int kThreads = 16;
+  constexpr int kEventsPerThread = 10000;
+  MetricsCounter counter("counter");
+  MetricsHistogram histogram("histogram");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([&counter, &histogram, i] {
+      for (int j = 0; j < kEventsPerThread; j++) {
+        counter.Increment();
+        histogram.Record(i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter.Get(), kThreads * kEventsPerThread);
+  MetricsHistogramSnapshot snapshot = histogram.Get();
+  EXPECT_EQ(snapshot.count, kThreads * kEventsPerThread);
+  EXPECT_EQ(snapshot.sum, kEventsPerThread * kThreads * (kThreads - 1) / 2);
+}
+
+}  // namespace testing
@@ -29,6 +29,7 @@
 
 #include "bluetooth/metrics/bluetooth.pb.h"
 #include "common/metrics.h"
+#include "common/metrics_registry.h"
 #include "common/time_util.h"
 
 #define BTM_COD_MAJOR_AUDIO_TEST 0x04
@@ -54,6 +55,8 @@ using bluetooth::metrics::BluetoothMetricsProto::RFCommSession;
 using bluetooth::metrics::BluetoothMetricsProto::ScanEvent;
 using bluetooth::metrics::BluetoothMetricsProto::ScanEvent_ScanEventType;
 using bluetooth::metrics::BluetoothMetricsProto::ScanEvent_ScanTechnologyType;
+using bluetooth::metrics::BluetoothMetricsProto::StackCounter;
+using bluetooth::metrics::BluetoothMetricsProto::StackHistogram;
 using bluetooth::metrics::BluetoothMetricsProto::WakeEvent;
 using bluetooth::metrics::BluetoothMetricsProto::WakeEvent_WakeEventType;
 
@@ -1005,4 +1008,42 @@ TEST_F(BluetoothMetricsLoggerTest, LogHeadsetProfileRfcConnectionErrorTest) {
   EXPECT_EQ(metrics->headset_profile_connection_stats_size(), 0);
   delete metrics;
 }
+
+TEST_F(BluetoothMetricsLoggerTest, StackMetricsTest) {
+  bluetooth::common::MetricsRegistry* registry =
+      bluetooth::common::MetricsRegistry::GetInstance();
+  registry->GetCounter("test_counter")->Increment(3);
+  registry->GetHistogram("test_histogram")->Record(100);
+  registry->GetHistogram("test_histogram")->Record(5);
+  std::string msg_str;
+  BluetoothMetricsLogger::GetInstance()->WriteString(&msg_str);
+  BluetoothLog* metrics = BluetoothLog::default_instance().New();
+  metrics->ParseFromString(msg_str);
+  bool counter_found = false;
+  for (const StackCounter& counter : metrics->stack_counter()) {
+    if (counter.name() == "test_counter") {
+      EXPECT_EQ(counter.count(), 3);
+      counter_found = true;
+    }
+  }
+  EXPECT_TRUE(counter_found);
+  bool histogram_found = false;
+  for (const StackHistogram& histogram : metrics->stack_histogram()) {
+    if (histogram.name() == "test_histogram") {
+      EXPECT_EQ(histogram.count(), 2);
+      EXPECT_EQ(histogram.sum(), 105);
+      ASSERT_EQ(histogram.bucket_size(), 2);
+      EXPECT_EQ(histogram.bucket(0).lower_bound(), 5);
+      EXPECT_EQ(histogram.bucket(1).lower_bound(), 96);
+      histogram_found = true;
+    }
+  }
+  EXPECT_TRUE(histogram_found);
+  // Stack metrics are reset on dump and empty ones are not reported
+  BluetoothMetricsLogger::GetInstance()->WriteString(&msg_str);
+  metrics->ParseFromString(msg_str);
+  EXPECT_EQ(metrics->stack_counter_size(), 0);
+  EXPECT_EQ(metrics->stack_histogram_size(), 0);
+  delete metrics;
+}
 }  // namespace testing
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include "device/include/interop.h"
+#include "device/include/interop_database.h"
+
+using ::benchmark::State;
+
+// The linear scan over the built-in database that interop_match_addr() and
+// interop_match_name() used before the compiled index, kept as a baseline.
+static bool linear_match_addr(const interop_feature_t feature,
+                              const RawAddress* addr) {
+  for (const auto& entry : interop_addr_database) {
+    if (feature == entry.feature &&
+        memcmp(addr, &entry.addr, entry.length) == 0)
+      return true;
+  }
+  return false;
+}
+
+static bool linear_match_name(const interop_feature_t feature,
+                              const char* name) {
+  for (const auto& entry : interop_name_database) {
+    if (feature == entry.feature && strlen(name) >= entry.length &&
+        strncmp(name, entry.name, entry.length) == 0)
+      return true;
+  }
+  return false;
+}
+
+// Misses, which are the common case on connection paths. Hits are logged, so
+// they would mostly measure logging.
+static const RawAddress kAddresses[] = {
+    {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}},
+    {{0x9c, 0xdf, 0x04, 0x12, 0x34, 0x56}},
+    {{0xf0, 0x79, 0x5a, 0x00, 0x00, 0x01}},
+    {{0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff}},
+};
+static const char* kNames[] = {"Pixel Buds", "Bose QC35", "Galaxy Buds+",
+                               "Joy-Con (L)"};
+static const interop_feature_t kFeatures[] = {
+    INTEROP_DISABLE_LE_SECURE_CONNECTIONS, INTEROP_AUTO_RETRY_PAIRING,
+    INTEROP_2MBPS_LINK_ONLY, INTEROP_DISABLE_SNIFF};
+
+static void BM_MatchAddrLinear(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        linear_match_addr(kFeatures[i % 4], &kAddresses[(i / 4) % 4]));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchAddrLinear);
+
+static void BM_MatchAddrIndexed(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_addr(kFeatures[i % 4], &kAddresses[(i / 4) % 4]));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchAddrIndexed);
+
+static void BM_MatchNameLinear(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(linear_match_name(INTEROP_DISABLE_AUTO_PAIRING,
+                                               kNames[i % 4]));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchNameLinear);
+
+static void BM_MatchNameIndexed(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING,
+                                                kNames[i % 4]));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchNameIndexed);
+
+BENCHMARK_MAIN();
@@ -136,3 +136,10 @@ void interop_database_add(uint16_t feature, const RawAddress* addr,
 
 // Clear the dynamic portion of the interoperability workaround database.
 void interop_database_clear(void);
+
+// Rebuild the fixed portion of the database from the built-in entries plus
+// the updatable database file at |path|, which is memory-mapped for as long as
+// it is in use. The module loads its default file on init, this is only needed
+// to use a different one. Returns false if |path| cannot be read, in which
+// case the database is left unchanged.
+bool interop_database_load(const char* path);
@@ -19,7 +19,18 @@
 #define LOG_TAG "bt_device_interop"
 
 #include <base/logging.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <string.h>  // For memcmp
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "btcore/include/module.h"
 #include "device/include/interop.h"
@@ -32,11 +43,233 @@
   case const:                  \
     return #const;
 
+// Updatable interop database, loaded in addition to the built-in one
+#if defined(OS_GENERIC)
+#define INTEROP_DATABASE_FILE "interop_database.bin"
+#else  // !defined(OS_GENERIC)
+#define INTEROP_DATABASE_FILE "/data/misc/bluedroid/interop_database.bin"
+#endif  // defined(OS_GENERIC)
+
+static const size_t INTEROP_FEATURE_COUNT = INTEROP_DISABLE_SNIFF + 1;
+
+// On-disk layout of the updatable database. All integers are little endian.
+// The file is a header followed by |addr_count| address entries and
+// |name_count| name entries. Names are matched as prefixes, like the
+// built-in database.
+static const char INTEROP_FILE_MAGIC[4] = {'B', 'T', 'I', 'O'};
+static const uint16_t INTEROP_FILE_VERSION = 1;
+
+typedef struct {
+  char magic[4];
+  uint16_t version;
+  uint16_t addr_count;
+  uint16_t name_count;
+  uint16_t reserved;
+} __attribute__((packed)) interop_file_header_t;
+
+typedef struct {
+  uint8_t addr[6];
+  uint8_t length;
+  uint8_t reserved;
+  uint16_t feature;
+} __attribute__((packed)) interop_file_addr_entry_t;
+
+typedef struct {
+  uint16_t feature;
+  uint8_t length;
+  uint8_t reserved;
+  char name[28];
+} __attribute__((packed)) interop_file_name_entry_t;
+
+namespace {
+
+// Compiled form of the built-in and file databases. Address prefixes are kept
+// sorted per feature and found with a binary search for each prefix length in
+// use; names are kept sorted by (length, hash of the prefix) so a lookup
+// hashes the name once, incrementally, and does one binary search per length.
+class InteropIndex {
+ public:
+  ~InteropIndex() {
+    if (file_map_ != MAP_FAILED) munmap(file_map_, file_size_);
+  }
+
+  void AddAddr(interop_feature_t feature, const uint8_t* prefix,
+               size_t length) {
+    FeatureIndex& index = features_[feature];
+    index.addr_keys.push_back(AddrKey(prefix, length));
+    index.addr_lengths |= 1 << length;
+  }
+
+  void AddName(interop_feature_t feature, const char* name, size_t length) {
+    FeatureIndex& index = features_[feature];
+    uint32_t hash = kFnvOffset;
+    for (size_t i = 0; i < length; ++i) hash = FnvStep(hash, name[i]);
+    index.names.push_back({length, hash, name});
+  }
+
+  void Build() {
+    for (auto& index : features_) {
+      std::sort(index.addr_keys.begin(), index.addr_keys.end());
+      std::sort(index.names.begin(), index.names.end());
+      for (const auto& entry : index.names) {
+        if (index.name_lengths.empty() ||
+            index.name_lengths.back() != entry.length)
+          index.name_lengths.push_back(entry.length);
+      }
+    }
+  }
+
+  bool MatchAddr(interop_feature_t feature, const RawAddress* addr) const {
+    const FeatureIndex& index = features_[feature];
+    for (size_t length = 1; length < RawAddress::kLength; ++length) {
+      if (!(index.addr_lengths & (1 << length))) continue;
+      if (std::binary_search(index.addr_keys.begin(), index.addr_keys.end(),
+                             AddrKey(addr->address, length)))
+        return true;
+    }
+    return false;
+  }
+
+  bool MatchName(interop_feature_t feature, const char* name) const {
+    const FeatureIndex& index = features_[feature];
+    uint32_t hash = kFnvOffset;
+    size_t hashed = 0;
+    for (size_t length : index.name_lengths) {
+      for (; hashed < length; ++hashed) {
+        if (name[hashed] == '\0') return false;
+        hash = FnvStep(hash, name[hashed]);
+      }
+      auto range = std::equal_range(index.names.begin(), index.names.end(),
+                                    NameKey{length, hash, nullptr});
+      for (auto it = range.first; it != range.second; ++it) {
+        if (strncmp(name, it->name, length) == 0) return true;
+      }
+    }
+    return false;
+  }
+
+  // Maps |path| and adds its entries to the index. Names are referenced in
+  // place, so the mapping lives as long as the index.
+  bool LoadFile(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 ||
+        (size_t)st.st_size < sizeof(interop_file_header_t)) {
+      close(fd);
+      return false;
+    }
+    file_size_ = st.st_size;
+    file_map_ = mmap(NULL, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file_map_ == MAP_FAILED) {
+      LOG_ERROR(LOG_TAG, "%s unable to map %s: %s", __func__, path,
+                strerror(errno));
+      return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(file_map_);
+    const interop_file_header_t* header =
+        reinterpret_cast<const interop_file_header_t*>(data);
+    size_t expected_size =
+        sizeof(interop_file_header_t) +
+        header->addr_count * sizeof(interop_file_addr_entry_t) +
+        header->name_count * sizeof(interop_file_name_entry_t);
+    if (memcmp(header->magic, INTEROP_FILE_MAGIC, sizeof(header->magic)) ||
+        header->version != INTEROP_FILE_VERSION || file_size_ < expected_size) {
+      LOG_ERROR(LOG_TAG, "%s ignoring malformed interop database %s", __func__,
+                path);
+      return false;
+    }
+
+    const interop_file_addr_entry_t* addr_entries =
+        reinterpret_cast<const interop_file_addr_entry_t*>(header + 1);
+    for (size_t i = 0; i < header->addr_count; ++i) {
+      const interop_file_addr_entry_t& entry = addr_entries[i];
+      if (entry.feature >= INTEROP_FEATURE_COUNT || entry.length == 0 ||
+          entry.length >= RawAddress::kLength)
+        continue;
+      AddAddr(static_cast<interop_feature_t>(entry.feature), entry.addr,
+              entry.length);
+    }
+
+    const interop_file_name_entry_t* name_entries =
+        reinterpret_cast<const interop_file_name_entry_t*>(addr_entries +
+                                                           header->addr_count);
+    for (size_t i = 0; i < header->name_count; ++i) {
+      const interop_file_name_entry_t& entry = name_entries[i];
+      if (entry.feature >= INTEROP_FEATURE_COUNT || entry.length == 0 ||
+          entry.length > sizeof(entry.name))
+        continue;
+      AddName(static_cast<interop_feature_t>(entry.feature), entry.name,
+              entry.length);
+    }
+
+    LOG_INFO(LOG_TAG, "%s loaded %u address and %u name entries from %s",
+             __func__, header->addr_count, header->name_count, path);
+    return true;
+  }
+
+ private:
+  static constexpr uint32_t kFnvOffset = 2166136261u;
+  static constexpr uint32_t kFnvPrime = 16777619u;
+
+  static uint32_t FnvStep(uint32_t hash, char c) {
+    return (hash ^ static_cast<uint8_t>(c)) * kFnvPrime;
+  }
+
+  // The prefix length is part of the key so that prefixes of different
+  // lengths never compare equal.
+  static uint64_t AddrKey(const uint8_t* prefix, size_t length) {
+    uint64_t key = length;
+    for (size_t i = 0; i < RawAddress::kLength; ++i)
+      key = (key << 8) | (i < length ? prefix[i] : 0);
+    return key;
+  }
+
+  struct NameKey {
+    size_t length;
+    uint32_t hash;
+    const char* name;
+
+    bool operator<(const NameKey& other) const {
+      if (length != other.length) return length < other.length;
+      return hash < other.hash;
+    }
+  };
+
+  struct FeatureIndex {
+    std::vector<uint64_t> addr_keys;
+    uint32_t addr_lengths = 0;
+    std::vector<NameKey> names;
+    std::vector<size_t> name_lengths;
+  };
+
+  FeatureIndex features_[INTEROP_FEATURE_COUNT];
+  void* file_map_ = MAP_FAILED;
+  size_t file_size_ = 0;
+};
+
+}  // namespace
+
 static list_t* interop_list = NULL;
 
+// Lookups read the current index without locking. A replaced index is retired
+// instead of freed, since a lookup may still be using it; retired indexes are
+// only freed on module clean up, when there are no more lookups. Indexes are
+// only replaced on init and by interop_database_load().
+static std::atomic<InteropIndex*> interop_index;
+static std::mutex interop_retired_mutex;
+static std::vector<std::unique_ptr<InteropIndex>> interop_retired;
+
 static const char* interop_feature_string_(const interop_feature_t feature);
 static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
+static std::unique_ptr<InteropIndex> interop_make_index_(const char* path,
+                                                         bool* loaded);
+static void interop_set_index_(std::unique_ptr<InteropIndex> index);
+static const InteropIndex& interop_get_index_(void);
 static bool interop_match_fixed_(const interop_feature_t feature,
                                  const RawAddress* addr);
 static bool interop_match_dynamic_(const interop_feature_t feature,
@@ -62,22 +295,26 @@ bool interop_match_addr(const interop_feature_t feature,
 bool interop_match_name(const interop_feature_t feature, const char* name) {
   CHECK(name);
 
-  const size_t db_size =
-      sizeof(interop_name_database) / sizeof(interop_name_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_name_database[i].feature &&
-        strlen(name) >= interop_name_database[i].length &&
-        strncmp(name, interop_name_database[i].name,
-                interop_name_database[i].length) == 0) {
-      LOG_INFO(LOG_TAG, "%s() Device %s is a match for interop workaround %s.",
+  if (interop_get_index_().MatchName(feature, name)) {
+    LOG_INFO(LOG_TAG, "%s() Device %s is a match for interop workaround %s.",
              __func__, name, interop_feature_string_(feature));
-      return true;
-    }
+    return true;
   }
 
   return false;
 }
 
+bool interop_database_load(const char* path) {
+  CHECK(path);
+
+  bool loaded = false;
+  std::unique_ptr<InteropIndex> index = interop_make_index_(path, &loaded);
+  if (!loaded) return false;
+
+  interop_set_index_(std::move(index));
+  return true;
+}
+
 void interop_database_add(uint16_t feature, const RawAddress* addr,
                           size_t length) {
   CHECK(addr);
@@ -100,15 +337,24 @@ void interop_database_clear() {
 
 // Module life-cycle functions
 
+static future_t* interop_init(void) {
+  interop_set_index_(interop_make_index_(INTEROP_DATABASE_FILE, NULL));
+  return future_new_immediate(FUTURE_SUCCESS);
+}
+
 static future_t* interop_clean_up(void) {
   list_free(interop_list);
   interop_list = NULL;
+
+  delete interop_index.exchange(nullptr);
+  std::lock_guard<std::mutex> lock(interop_retired_mutex);
+  interop_retired.clear();
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
 EXPORT_SYMBOL module_t interop_module = {
     .name = INTEROP_MODULE,
-    .init = NULL,
+    .init = interop_init,
     .start_up = NULL,
     .shut_down = NULL,
     .clean_up = interop_clean_up,
@@ -173,15 +419,42 @@ static bool interop_match_fixed_(const interop_feature_t feature,
                                  const RawAddress* addr) {
   CHECK(addr);
 
-  const size_t db_size =
-      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_addr_database[i].feature &&
-        memcmp(addr, &interop_addr_database[i].addr,
-               interop_addr_database[i].length) == 0) {
-      return true;
-    }
+  return interop_get_index_().MatchAddr(feature, addr);
+}
+
+// Builds an index from the built-in database and, if |path| is not NULL, the
+// file at |path|. |loaded| is set to whether the file could be used.
+static std::unique_ptr<InteropIndex> interop_make_index_(const char* path,
+                                                         bool* loaded) {
+  std::unique_ptr<InteropIndex> index = std::make_unique<InteropIndex>();
+
+  for (const auto& entry : interop_addr_database)
+    index->AddAddr(entry.feature, entry.addr.address, entry.length);
+  for (const auto& entry : interop_name_database)
+    index->AddName(entry.feature, entry.name, entry.length);
+  bool file_loaded = path && index->LoadFile(path);
+  if (loaded) *loaded = file_loaded;
+  index->Build();
+  return index;
+}
+
+static void interop_set_index_(std::unique_ptr<InteropIndex> index) {
+  InteropIndex* old_index = interop_index.exchange(index.release());
+  if (old_index) {
+    std::lock_guard<std::mutex> lock(interop_retired_mutex);
+    interop_retired.emplace_back(old_index);
   }
+}
 
-  return false;
+// Returns the index, building it from the built-in database if the module has
+// not been initialized.
+static const InteropIndex& interop_get_index_(void) {
+  InteropIndex* index = interop_index.load(std::memory_order_acquire);
+  if (index) return *index;
+
+  std::unique_ptr<InteropIndex> new_index = interop_make_index_(NULL, NULL);
+  if (interop_index.compare_exchange_strong(index, new_index.get())) {
+    index = new_index.release();
+  }
+  return *index;
 }
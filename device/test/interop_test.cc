@@ -17,6 +17,11 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <vector>
 
 #include "device/include/interop.h"
 
@@ -80,3 +85,50 @@ TEST(InteropTest, test_name_miss) {
   EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "audi"));
   EXPECT_FALSE(interop_match_name(INTEROP_AUTO_RETRY_PAIRING, "BMW M3"));
 }
+
+// Writes |file| to a temporary file and loads it as the interop database file
+static bool load_database_file(const std::vector<uint8_t>& file) {
+  char path[] = "/tmp/interop_test_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd == -1) return false;
+  bool written = write(fd, file.data(), file.size()) == (ssize_t)file.size();
+  close(fd);
+  bool loaded = written && interop_database_load(path);
+  unlink(path);
+  return loaded;
+}
+
+TEST(InteropTest, test_database_file) {
+  RawAddress test_address;
+  RawAddress::FromString("de:ad:be:ef:00:01", test_address);
+  EXPECT_FALSE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_SNIFF, "Interop Headset"));
+
+  // Header, one address entry and one name entry, as documented in interop.cc
+  std::vector<uint8_t> file = {'B', 'T', 'I', 'O', 1, 0, 1, 0, 1, 0, 0, 0};
+  std::vector<uint8_t> addr_entry = {0xde, 0xad, 0xbe, 0, 0, 0, 3, 0,
+                                     INTEROP_DISABLE_SNIFF, 0};
+  file.insert(file.end(), addr_entry.begin(), addr_entry.end());
+  std::vector<uint8_t> name_entry(32, 0);
+  name_entry[0] = INTEROP_DISABLE_SNIFF;
+  name_entry[2] = 7;
+  memcpy(&name_entry[4], "Interop", 7);
+  file.insert(file.end(), name_entry.begin(), name_entry.end());
+
+  ASSERT_TRUE(load_database_file(file));
+
+  EXPECT_TRUE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+  EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_SNIFF, "Interop Headset"));
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_SNIFF, "Interpol"));
+  // Built-in entries are still there
+  EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "BMW M3"));
+
+  EXPECT_FALSE(interop_database_load("/does/not/exist"));
+  EXPECT_TRUE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+
+  // Go back to the built-in entries only, which the other tests expect
+  ASSERT_TRUE(load_database_file({'B', 'T', 'I', 'O', 1, 0, 0, 0, 0, 0, 0, 0}));
+  EXPECT_FALSE(interop_match_addr(INTEROP_DISABLE_SNIFF, &test_address));
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_SNIFF, "Interop Headset"));
+  EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "BMW M3"));
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/h4_framer.h"
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include "os/log.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+constexpr size_t kH4HeaderSize = 1;
+
+// Returns the size of the whole H4 packet starting at |data|, or 0 if |length| bytes are not enough to tell
+size_t h4_packet_size(const uint8_t* data, size_t length) {
+  if (length < kH4HeaderSize) {
+    return 0;
+  }
+  size_t header_size;
+  size_t payload_size;
+  switch (data[0]) {
+    case kH4Command:
+      // Opcode (2), parameter total length (1)
+      header_size = 3;
+      if (length < kH4HeaderSize + header_size) return 0;
+      payload_size = data[3];
+      break;
+    case kH4Acl:
+      // Handle and flags (2), data total length (2)
+      header_size = 4;
+      if (length < kH4HeaderSize + header_size) return 0;
+      payload_size = data[3] | (data[4] << 8);
+      break;
+    case kH4Sco:
+      // Handle and flags (2), data total length (1)
+      header_size = 3;
+      if (length < kH4HeaderSize + header_size) return 0;
+      payload_size = data[3];
+      break;
+    case kH4Event:
+      // Event code (1), parameter total length (1)
+      header_size = 2;
+      if (length < kH4HeaderSize + header_size) return 0;
+      payload_size = data[2];
+      break;
+    default:
+      ASSERT_LOG(false, "Unexpected H4 packet type 0x%02hhx", data[0]);
+      return 0;
+  }
+  return kH4HeaderSize + header_size + payload_size;
+}
+
+}  // namespace
+
+H4Framer::H4Framer() : buffer_(kBufferSize) {}
+
+void H4Framer::Compact() {
+  if (begin_ == 0 || buffer_.size() - begin_ >= kMaxPacketSize) {
+    return;
+  }
+  std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+  end_ -= begin_;
+  begin_ = 0;
+}
+
+ssize_t H4Framer::ReadAndDispatch(int fd, const PacketCallback& on_packet) {
+  Compact();
+  ssize_t received_size;
+  RUN_NO_INTR(received_size = recv(fd, buffer_.data() + end_, buffer_.size() - end_, 0));
+  if (received_size > 0) {
+    end_ += received_size;
+    Dispatch(on_packet);
+  }
+  return received_size;
+}
+
+void H4Framer::Append(const uint8_t* data, size_t length) {
+  Compact();
+  ASSERT_LOG(length <= buffer_.size() - end_, "%zu bytes do not fit in the H4 buffer", length);
+  std::memcpy(buffer_.data() + end_, data, length);
+  end_ += length;
+}
+
+size_t H4Framer::Dispatch(const PacketCallback& on_packet) {
+  size_t num_packets = 0;
+  while (true) {
+    const uint8_t* packet = buffer_.data() + begin_;
+    size_t packet_size = h4_packet_size(packet, end_ - begin_);
+    if (packet_size == 0 || packet_size > end_ - begin_) {
+      break;
+    }
+    // Advance first, |on_packet| may not return if the stack is shutting down
+    begin_ += packet_size;
+    on_packet(packet[0], HciPacket(packet + kH4HeaderSize, packet + packet_size));
+    num_packets++;
+  }
+  if (begin_ == end_) {
+    begin_ = 0;
+    end_ = 0;
+  }
+  return num_packets;
+}
+
+void H4Writer::Enqueue(uint8_t type, HciPacket packet) {
+  queue_.emplace_back(type, std::move(packet));
+}
+
+ssize_t H4Writer::WriteTo(int fd) {
+  std::array<iovec, 2 * kMaxPacketsPerWrite> iov;
+  size_t iov_count = 0;
+  size_t skip = front_offset_;
+  for (auto it = queue_.begin(); it != queue_.end() && iov_count + 2 <= iov.size(); ++it) {
+    uint8_t* type = &it->first;
+    HciPacket& packet = it->second;
+    if (skip == 0) {
+      iov[iov_count++] = {type, kH4HeaderSize};
+      iov[iov_count++] = {packet.data(), packet.size()};
+    } else {
+      // Only the front packet can be partially written
+      size_t written = skip - kH4HeaderSize;
+      iov[iov_count++] = {packet.data() + written, packet.size() - written};
+      skip = 0;
+    }
+  }
+  if (iov_count == 0) {
+    return 0;
+  }
+
+  ssize_t bytes_written;
+  RUN_NO_INTR(bytes_written = writev(fd, iov.data(), iov_count));
+  if (bytes_written <= 0) {
+    return bytes_written;
+  }
+
+  size_t remaining = bytes_written;
+  while (remaining > 0) {
+    size_t front_size = kH4HeaderSize + queue_.front().second.size();
+    size_t front_left = front_size - front_offset_;
+    if (remaining < front_left) {
+      front_offset_ += remaining;
+      break;
+    }
+    remaining -= front_left;
+    front_offset_ = 0;
+    queue_.pop_front();
+  }
+  return bytes_written;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
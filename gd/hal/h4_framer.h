@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "hal/hci_hal.h"
+
+namespace bluetooth {
+namespace hal {
+
+constexpr uint8_t kH4Command = 0x01;
+constexpr uint8_t kH4Acl = 0x02;
+constexpr uint8_t kH4Sco = 0x03;
+constexpr uint8_t kH4Event = 0x04;
+
+// Splits a byte stream of H4 framed HCI packets into packets. Data is read from the socket in large chunks, so every
+// packet already available is delivered on a single wakeup instead of costing three reads per packet.
+class H4Framer {
+ public:
+  // Receives the H4 packet type and the HCI packet without its H4 type byte
+  using PacketCallback = std::function<void(uint8_t type, HciPacket packet)>;
+
+  // Largest H4 packet: type byte, ACL header and the maximum ACL payload
+  static constexpr size_t kMaxPacketSize = 1 + 4 + 0xffff;
+  static constexpr size_t kBufferSize = 2 * kMaxPacketSize;
+
+  H4Framer();
+  H4Framer(const H4Framer&) = delete;
+  H4Framer& operator=(const H4Framer&) = delete;
+
+  // Reads what is available on |fd| with a single read into the free space of the buffer, then passes every complete
+  // packet to |on_packet| in order. Returns the read result: bytes read, 0 at end of stream or -1 with errno set.
+  ssize_t ReadAndDispatch(int fd, const PacketCallback& on_packet);
+
+  // Appends |length| bytes received by other means; at most the free space of the buffer
+  void Append(const uint8_t* data, size_t length);
+
+  // Passes every complete buffered packet to |on_packet| in order, returns the number of packets
+  size_t Dispatch(const PacketCallback& on_packet);
+
+  // Number of buffered bytes that are not part of a complete packet yet
+  size_t Pending() const {
+    return end_ - begin_;
+  }
+
+ private:
+  // Moves the partial packet at the front to the start of the buffer if a whole packet might not fit anymore
+  void Compact();
+
+  std::vector<uint8_t> buffer_;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+};
+
+// Queues H4 packets for a stream socket and writes as many of them as possible with a single writev. The H4 type byte
+// is kept apart from the packet, so nothing is copied to prepend it.
+class H4Writer {
+ public:
+  // Maximum number of packets passed to one writev
+  static constexpr size_t kMaxPacketsPerWrite = 64;
+
+  void Enqueue(uint8_t type, HciPacket packet);
+
+  bool Empty() const {
+    return queue_.empty();
+  }
+
+  size_t Size() const {
+    return queue_.size();
+  }
+
+  // Writes queued packets to |fd|; partially written packets are resumed on the next call. Returns the writev result.
+  ssize_t WriteTo(int fd);
+
+ private:
+  std::deque<std::pair<uint8_t, HciPacket>> queue_;
+  // Bytes of the front packet, including its type byte, that were already written
+  size_t front_offset_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include "hal/h4_framer.h"
+#include "os/log.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+constexpr size_t kPacketsPerIteration = 1000;
+
+std::vector<uint8_t> make_acl_stream(size_t payload_size, size_t num_packets) {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < num_packets; i++) {
+    stream.insert(stream.end(), {kH4Acl, 0x01, 0x20, static_cast<uint8_t>(payload_size & 0xff),
+                                 static_cast<uint8_t>(payload_size >> 8)});
+    stream.insert(stream.end(), payload_size, static_cast<uint8_t>(i));
+  }
+  return stream;
+}
+
+void write_all(int fd, const uint8_t* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    ASSERT(written > 0);
+    data += written;
+    size -= written;
+  }
+}
+
+void drain(int fd, size_t size) {
+  std::vector<uint8_t> buffer(64 * 1024);
+  while (size > 0) {
+    ssize_t received = read(fd, buffer.data(), std::min(size, buffer.size()));
+    ASSERT(received > 0);
+    size -= received;
+  }
+}
+
+}  // namespace
+
+class BM_H4Transport : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds_) == 0);
+    stream_ = make_acl_stream(st.range(0), kPacketsPerIteration);
+  }
+
+  void TearDown(State& st) override {
+    close(fds_[0]);
+    close(fds_[1]);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  int fds_[2];
+  std::vector<uint8_t> stream_;
+};
+
+// Previous receive path: H4 type, header and payload each read separately, then copied into a packet
+BENCHMARK_DEFINE_F(BM_H4Transport, receive_per_packet)(State& state) {
+  for (auto _ : state) {
+    std::thread peer([this] { write_all(fds_[1], stream_.data(), stream_.size()); });
+    uint8_t buf[4 + 1 + 0xffff];
+    size_t delivered = 0;
+    for (size_t i = 0; i < kPacketsPerIteration; i++) {
+      recv(fds_[0], buf, 1, MSG_WAITALL);
+      recv(fds_[0], buf + 1, 4, MSG_WAITALL);
+      uint16_t length = buf[3] | (buf[4] << 8);
+      recv(fds_[0], buf + 5, length, MSG_WAITALL);
+      HciPacket packet;
+      packet.assign(buf + 1, buf + 5 + length);
+      HciPacket delivered_packet = packet;
+      delivered += delivered_packet.size();
+    }
+    benchmark::DoNotOptimize(delivered);
+    peer.join();
+  }
+  state.SetBytesProcessed(state.iterations() * stream_.size());
+  state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+}
+BENCHMARK_REGISTER_F(BM_H4Transport, receive_per_packet)->Arg(27)->Arg(251)->Arg(1021)->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_H4Transport, receive_framed)(State& state) {
+  H4Framer framer;
+  for (auto _ : state) {
+    std::thread peer([this] { write_all(fds_[1], stream_.data(), stream_.size()); });
+    size_t delivered = 0;
+    size_t num_packets = 0;
+    H4Framer::PacketCallback on_packet = [&delivered, &num_packets](uint8_t, HciPacket packet) {
+      delivered += packet.size();
+      num_packets++;
+    };
+    while (num_packets < kPacketsPerIteration) {
+      framer.ReadAndDispatch(fds_[0], on_packet);
+    }
+    benchmark::DoNotOptimize(delivered);
+    peer.join();
+  }
+  state.SetBytesProcessed(state.iterations() * stream_.size());
+  state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+}
+BENCHMARK_REGISTER_F(BM_H4Transport, receive_framed)->Arg(27)->Arg(251)->Arg(1021)->UseRealTime();
+
+// Previous send path: H4 type inserted in front of the packet, one write per packet
+BENCHMARK_DEFINE_F(BM_H4Transport, send_per_packet)(State& state) {
+  HciPacket payload(stream_.begin() + 1, stream_.begin() + stream_.size() / kPacketsPerIteration);
+  for (auto _ : state) {
+    std::thread peer([this] { drain(fds_[1], stream_.size()); });
+    for (size_t i = 0; i < kPacketsPerIteration; i++) {
+      HciPacket packet = payload;
+      packet.insert(packet.cbegin(), kH4Acl);
+      write_all(fds_[0], packet.data(), packet.size());
+    }
+    peer.join();
+  }
+  state.SetBytesProcessed(state.iterations() * stream_.size());
+  state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+}
+BENCHMARK_REGISTER_F(BM_H4Transport, send_per_packet)->Arg(27)->Arg(251)->Arg(1021)->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_H4Transport, send_coalesced)(State& state) {
+  HciPacket payload(stream_.begin() + 1, stream_.begin() + stream_.size() / kPacketsPerIteration);
+  H4Writer writer;
+  for (auto _ : state) {
+    std::thread peer([this] { drain(fds_[1], stream_.size()); });
+    for (size_t i = 0; i < kPacketsPerIteration; i++) {
+      writer.Enqueue(kH4Acl, payload);
+      // The HAL writes whatever queued up until the socket became writable again
+      if (writer.Size() == H4Writer::kMaxPacketsPerWrite) {
+        writer.WriteTo(fds_[0]);
+      }
+    }
+    while (!writer.Empty()) {
+      writer.WriteTo(fds_[0]);
+    }
+    peer.join();
+  }
+  state.SetBytesProcessed(state.iterations() * stream_.size());
+  state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+}
+BENCHMARK_REGISTER_F(BM_H4Transport, send_coalesced)->Arg(27)->Arg(251)->Arg(1021)->UseRealTime();
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/h4_framer.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+using H4Packet = std::vector<uint8_t>;
+
+H4Packet make_acl(uint16_t payload_size, uint8_t fill) {
+  H4Packet packet = {kH4Acl, 0x01, 0x20, static_cast<uint8_t>(payload_size & 0xff),
+                     static_cast<uint8_t>(payload_size >> 8)};
+  packet.insert(packet.end(), payload_size, fill);
+  return packet;
+}
+
+H4Packet make_event(uint8_t payload_size, uint8_t fill) {
+  H4Packet packet = {kH4Event, 0x0e, payload_size};
+  packet.insert(packet.end(), payload_size, fill);
+  return packet;
+}
+
+H4Packet make_sco(uint8_t payload_size, uint8_t fill) {
+  H4Packet packet = {kH4Sco, 0x02, 0x00, payload_size};
+  packet.insert(packet.end(), payload_size, fill);
+  return packet;
+}
+
+class H4FramerTest : public ::testing::Test {
+ protected:
+  H4Framer::PacketCallback collector() {
+    return [this](uint8_t type, HciPacket packet) {
+      H4Packet h4_packet = {type};
+      h4_packet.insert(h4_packet.end(), packet.begin(), packet.end());
+      received_.push_back(std::move(h4_packet));
+    };
+  }
+
+  H4Framer framer_;
+  std::vector<H4Packet> received_;
+};
+
+TEST_F(H4FramerTest, several_packets_in_one_chunk) {
+  std::vector<H4Packet> packets = {make_event(3, 0xaa), make_acl(100, 0xbb), make_sco(0, 0), make_acl(0, 0),
+                                   make_event(255, 0xcc)};
+  H4Packet stream;
+  for (const auto& packet : packets) {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  framer_.Append(stream.data(), stream.size());
+  EXPECT_EQ(framer_.Dispatch(collector()), packets.size());
+  EXPECT_EQ(received_, packets);
+  EXPECT_EQ(framer_.Pending(), 0u);
+}
+
+TEST_F(H4FramerTest, packet_split_at_every_byte) {
+  H4Packet packet = make_acl(20, 0x5a);
+  for (size_t i = 0; i < packet.size() - 1; i++) {
+    framer_.Append(&packet[i], 1);
+    EXPECT_EQ(framer_.Dispatch(collector()), 0u);
+    EXPECT_EQ(framer_.Pending(), i + 1);
+  }
+  framer_.Append(&packet.back(), 1);
+  EXPECT_EQ(framer_.Dispatch(collector()), 1u);
+  ASSERT_EQ(received_.size(), 1u);
+  EXPECT_EQ(received_[0], packet);
+}
+
+TEST_F(H4FramerTest, maximum_size_packets_wrap_the_buffer) {
+  H4Packet big = make_acl(0xffff, 0x11);
+  H4Packet small = make_event(4, 0x22);
+  for (int i = 0; i < 5; i++) {
+    // Leaves a partial packet at the end of the buffer each round
+    framer_.Append(small.data(), small.size());
+    framer_.Append(big.data(), big.size() - 10);
+    framer_.Dispatch(collector());
+    framer_.Append(big.data() + big.size() - 10, 10);
+    framer_.Dispatch(collector());
+  }
+  ASSERT_EQ(received_.size(), 10u);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(received_[2 * i], small);
+    EXPECT_EQ(received_[2 * i + 1], big);
+  }
+}
+
+TEST_F(H4FramerTest, read_from_socket) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  H4Packet stream;
+  for (int i = 0; i < 10; i++) {
+    H4Packet packet = make_acl(27, i);
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  ASSERT_EQ(write(fds[1], stream.data(), stream.size()), static_cast<ssize_t>(stream.size()));
+  EXPECT_EQ(framer_.ReadAndDispatch(fds[0], collector()), static_cast<ssize_t>(stream.size()));
+  EXPECT_EQ(received_.size(), 10u);
+  close(fds[1]);
+  EXPECT_EQ(framer_.ReadAndDispatch(fds[0], collector()), 0);
+  close(fds[0]);
+}
+
+TEST(H4WriterTest, coalesces_queued_packets) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  H4Writer writer;
+  H4Packet expected;
+  for (int i = 0; i < 3; i++) {
+    H4Packet h4_packet = make_acl(10 * i, i);
+    expected.insert(expected.end(), h4_packet.begin(), h4_packet.end());
+    writer.Enqueue(kH4Acl, HciPacket(h4_packet.begin() + 1, h4_packet.end()));
+  }
+  EXPECT_EQ(writer.WriteTo(fds[1]), static_cast<ssize_t>(expected.size()));
+  EXPECT_TRUE(writer.Empty());
+  H4Packet received(expected.size());
+  ASSERT_EQ(read(fds[0], received.data(), received.size()), static_cast<ssize_t>(expected.size()));
+  EXPECT_EQ(received, expected);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST(H4WriterTest, resumes_partial_writes) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  int send_buffer_size = 4096;
+  ASSERT_EQ(setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &send_buffer_size, sizeof(send_buffer_size)), 0);
+  ASSERT_EQ(fcntl(fds[1], F_SETFL, O_NONBLOCK), 0);
+  H4Writer writer;
+  H4Packet expected;
+  for (int i = 0; i < 200; i++) {
+    H4Packet h4_packet = make_acl(1000, i);
+    expected.insert(expected.end(), h4_packet.begin(), h4_packet.end());
+    writer.Enqueue(kH4Acl, HciPacket(h4_packet.begin() + 1, h4_packet.end()));
+  }
+  H4Packet received;
+  uint8_t buffer[8192];
+  while (!writer.Empty()) {
+    ssize_t written = writer.WriteTo(fds[1]);
+    ASSERT_TRUE(written > 0 || errno == EAGAIN);
+    ssize_t read_size = read(fds[0], buffer, sizeof(buffer));
+    ASSERT_GT(read_size, 0);
+    received.insert(received.end(), buffer, buffer + read_size);
+  }
+  ASSERT_EQ(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+  ssize_t read_size;
+  while ((read_size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+    received.insert(received.end(), buffer, buffer + read_size);
+  }
+  EXPECT_EQ(received, expected);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -15,6 +15,7 @@
  */
 
 #include "hal/hci_hal_host_rootcanal.h"
+#include "hal/h4_framer.h"
 #include "hal/hci_hal.h"
 
 #include <netdb.h>
@@ -24,7 +25,6 @@
 #include <chrono>
 #include <csignal>
 #include <mutex>
-#include <queue>
 
 #include "hal/snoop_logger.h"
 #include "os/log.h"
@@ -34,17 +34,6 @@
 namespace {
 constexpr int INVALID_FD = -1;
 
-constexpr uint8_t kH4Command = 0x01;
-constexpr uint8_t kH4Acl = 0x02;
-constexpr uint8_t kH4Sco = 0x03;
-constexpr uint8_t kH4Event = 0x04;
-
-constexpr uint8_t kH4HeaderSize = 1;
-constexpr uint8_t kHciAclHeaderSize = 4;
-constexpr uint8_t kHciScoHeaderSize = 3;
-constexpr uint8_t kHciEvtHeaderSize = 2;
-constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
-
 int ConnectToRootCanal(const std::string& server, int port) {
   int socket_fd = socket(AF_INET, SOCK_STREAM, 0);
   if (socket_fd < 1) {
@@ -116,28 +105,22 @@ class HciHalHostRootcanal : public HciHal {
   void sendHciCommand(HciPacket command) override {
     std::lock_guard<std::mutex> lock(api_mutex_);
     ASSERT(sock_fd_ != INVALID_FD);
-    std::vector<uint8_t> packet = std::move(command);
-    btsnoop_logger_->capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
-    packet.insert(packet.cbegin(), kH4Command);
-    write_to_rootcanal_fd(packet);
+    btsnoop_logger_->capture(command, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+    write_to_rootcanal_fd(kH4Command, std::move(command));
   }
 
   void sendAclData(HciPacket data) override {
     std::lock_guard<std::mutex> lock(api_mutex_);
     ASSERT(sock_fd_ != INVALID_FD);
-    std::vector<uint8_t> packet = std::move(data);
-    btsnoop_logger_->capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
-    packet.insert(packet.cbegin(), kH4Acl);
-    write_to_rootcanal_fd(packet);
+    btsnoop_logger_->capture(data, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+    write_to_rootcanal_fd(kH4Acl, std::move(data));
   }
 
   void sendScoData(HciPacket data) override {
     std::lock_guard<std::mutex> lock(api_mutex_);
     ASSERT(sock_fd_ != INVALID_FD);
-    std::vector<uint8_t> packet = std::move(data);
-    btsnoop_logger_->capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
-    packet.insert(packet.cbegin(), kH4Sco);
-    write_to_rootcanal_fd(packet);
+    btsnoop_logger_->capture(data, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
+    write_to_rootcanal_fd(kH4Sco, std::move(data));
   }
 
  protected:
@@ -188,13 +171,13 @@ class HciHalHostRootcanal : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  H4Writer hci_outgoing_queue_;
+  H4Framer hci_incoming_framer_;
   SnoopLogger* btsnoop_logger_ = nullptr;
 
-  void write_to_rootcanal_fd(HciPacket packet) {
-    // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
-    if (hci_outgoing_queue_.size() == 1) {
+  void write_to_rootcanal_fd(uint8_t type, HciPacket packet) {
+    hci_outgoing_queue_.Enqueue(type, std::move(packet));
+    if (hci_outgoing_queue_.Size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(
           reactable_, common::Bind(&HciHalHostRootcanal::incoming_packet_received, common::Unretained(this)),
           common::Bind(&HciHalHostRootcanal::send_packet_ready, common::Unretained(this)));
@@ -203,13 +186,12 @@ class HciHalHostRootcanal : public HciHal {
 
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(this->api_mutex_);
-    auto packet_to_send = this->hci_outgoing_queue_.front();
-    auto bytes_written = write(this->sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
-    this->hci_outgoing_queue_.pop();
+    // Everything queued since the last wakeup goes out in one writev
+    auto bytes_written = hci_outgoing_queue_.WriteTo(this->sock_fd_);
     if (bytes_written == -1) {
       abort();
     }
-    if (hci_outgoing_queue_.empty()) {
+    if (hci_outgoing_queue_.Empty()) {
       this->hci_incoming_thread_.GetReactor()->ModifyRegistration(
           this->reactable_, common::Bind(&HciHalHostRootcanal::incoming_packet_received, common::Unretained(this)),
           common::Closure());
@@ -224,94 +206,53 @@ class HciHalHostRootcanal : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
 
-    ssize_t received_size;
-    RUN_NO_INTR(received_size = recv(sock_fd_, buf, kH4HeaderSize, 0));
+    ssize_t received_size = hci_incoming_framer_.ReadAndDispatch(
+        sock_fd_, [this](uint8_t type, HciPacket packet) { dispatch_incoming_packet(type, std::move(packet)); });
     ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
     if (received_size == 0) {
       LOG_WARN("Can't read H4 header. EOF received");
       raise(SIGINT);
       return;
     }
+  }
 
-    if (buf[0] == kH4Event) {
-      RUN_NO_INTR(received_size = recv(sock_fd_, buf + kH4HeaderSize, kHciEvtHeaderSize, 0));
-      ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
-      ASSERT_LOG(received_size == kHciEvtHeaderSize, "malformed HCI event header received");
-
-      uint8_t hci_evt_parameter_total_length = buf[2];
-      ssize_t payload_size;
-      RUN_NO_INTR(payload_size =
-                      recv(sock_fd_, buf + kH4HeaderSize + kHciEvtHeaderSize, hci_evt_parameter_total_length, 0));
-      ASSERT_LOG(payload_size != -1, "Can't receive from socket: %s", strerror(errno));
-      ASSERT_LOG(payload_size == hci_evt_parameter_total_length,
-                 "malformed HCI event total parameter size received: %zu != %d", payload_size,
-                 hci_evt_parameter_total_length);
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + payload_size);
-      btsnoop_logger_->capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
-      {
+  void dispatch_incoming_packet(uint8_t type, HciPacket packet) {
+    switch (type) {
+      case kH4Event: {
+        btsnoop_logger_->capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Acl) {
-      RUN_NO_INTR(received_size = recv(sock_fd_, buf + kH4HeaderSize, kHciAclHeaderSize, 0));
-      ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
-      ASSERT_LOG(received_size == kHciAclHeaderSize, "malformed ACL header received");
-
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
-      int payload_size;
-      RUN_NO_INTR(payload_size = recv(sock_fd_, buf + kH4HeaderSize + kHciAclHeaderSize, hci_acl_data_total_length, 0));
-      ASSERT_LOG(payload_size != -1, "Can't receive from socket: %s", strerror(errno));
-      ASSERT_LOG(payload_size == hci_acl_data_total_length, "malformed ACL length received: %d != %d", payload_size,
-                 hci_acl_data_total_length);
-      ASSERT_LOG(hci_acl_data_total_length <= kBufSize - kH4HeaderSize - kHciAclHeaderSize, "packet too long");
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + payload_size);
-      btsnoop_logger_->capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
-      {
+      case kH4Acl: {
+        btsnoop_logger_->capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Sco) {
-      RUN_NO_INTR(received_size = recv(sock_fd_, buf + kH4HeaderSize, kHciScoHeaderSize, 0));
-      ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
-      ASSERT_LOG(received_size == kHciScoHeaderSize, "malformed SCO header received");
-
-      uint8_t hci_sco_data_total_length = buf[3];
-      int payload_size;
-      RUN_NO_INTR(payload_size = recv(sock_fd_, buf + kH4HeaderSize + kHciScoHeaderSize, hci_sco_data_total_length, 0));
-      ASSERT_LOG(payload_size != -1, "Can't receive from socket: %s", strerror(errno));
-      ASSERT_LOG(payload_size == hci_sco_data_total_length, "malformed SCO packet received: size mismatch");
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + payload_size);
-      btsnoop_logger_->capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
-      {
+      case kH4Sco: {
+        btsnoop_logger_->capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataReceived(std::move(packet));
+        break;
       }
+      default:
+        LOG_WARN("Dropping an unexpected H4 packet of type 0x%02hhx", type);
+        break;
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
@@ -16,6 +16,12 @@
 
 #include "module.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <queue>
+#include <thread>
+
 using ::bluetooth::os::Handler;
 using ::bluetooth::os::Thread;
 
@@ -50,12 +56,14 @@ Module* Module::GetDependency(const ModuleFactory* module) const {
 }
 
 Module* ModuleRegistry::Get(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto instance = started_modules_.find(module);
   ASSERT(instance != started_modules_.end());
   return instance->second;
 }
 
 bool ModuleRegistry::IsStarted(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   return started_modules_.find(module) != started_modules_.end();
 }
 
@@ -71,9 +79,12 @@ void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread)
 }
 
 Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
-  auto started_instance = started_modules_.find(module);
-  if (started_instance != started_modules_.end()) {
-    return started_instance->second;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto started_instance = started_modules_.find(module);
+    if (started_instance != started_modules_.end()) {
+      return started_instance->second;
+    }
   }
 
   Module* instance = module->ctor_();
@@ -82,10 +93,114 @@ Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
   instance->ListDependencies(&instance->dependencies_);
   Start(&instance->dependencies_, thread);
 
+  auto begin = std::chrono::steady_clock::now();
   instance->Start();
+  record_started(module, instance, begin, std::chrono::steady_clock::now());
+  return instance;
+}
+
+void ModuleRegistry::Start(ModuleList* modules, Thread* thread, size_t num_workers) {
+  if (num_workers <= 1) {
+    Start(modules, thread);
+    return;
+  }
+
+  struct PendingModule {
+    Module* instance = nullptr;
+    size_t unstarted_dependencies = 0;
+    std::vector<const ModuleFactory*> dependents;
+  };
+
+  // Construct every module that is not yet started and collect its dependencies, so the whole graph is known
+  // before anything starts
+  std::map<const ModuleFactory*, PendingModule> pending;
+  std::vector<const ModuleFactory*> to_visit(modules->list_.begin(), modules->list_.end());
+  while (!to_visit.empty()) {
+    const ModuleFactory* module = to_visit.back();
+    to_visit.pop_back();
+    if (IsStarted(module) || pending.find(module) != pending.end()) {
+      continue;
+    }
+    Module* instance = module->ctor_();
+    set_registry_and_handler(instance, thread);
+    instance->ListDependencies(&instance->dependencies_);
+    pending[module].instance = instance;
+    to_visit.insert(to_visit.end(), instance->dependencies_.list_.begin(), instance->dependencies_.list_.end());
+  }
+
+  std::queue<const ModuleFactory*> ready;
+  for (auto& entry : pending) {
+    for (auto dependency : entry.second.instance->dependencies_.list_) {
+      auto pending_dependency = pending.find(dependency);
+      if (pending_dependency != pending.end()) {
+        entry.second.unstarted_dependencies++;
+        pending_dependency->second.dependents.push_back(entry.first);
+      }
+    }
+    if (entry.second.unstarted_dependencies == 0) {
+      ready.push(entry.first);
+    }
+  }
+
+  std::mutex scheduler_mutex;
+  std::condition_variable scheduler_cv;
+  size_t remaining = pending.size();
+  size_t in_flight = 0;
+  ASSERT_LOG(remaining == 0 || !ready.empty(), "Module dependency graph has a cycle");
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(scheduler_mutex);
+    while (true) {
+      scheduler_cv.wait(lock, [&]() { return remaining == 0 || !ready.empty(); });
+      if (remaining == 0) {
+        return;
+      }
+      const ModuleFactory* module = ready.front();
+      ready.pop();
+      in_flight++;
+      Module* instance = pending[module].instance;
+      lock.unlock();
+
+      auto begin = std::chrono::steady_clock::now();
+      instance->Start();
+      record_started(module, instance, begin, std::chrono::steady_clock::now());
+
+      lock.lock();
+      in_flight--;
+      remaining--;
+      for (auto dependent : pending[module].dependents) {
+        if (--pending[dependent].unstarted_dependencies == 0) {
+          ready.push(dependent);
+        }
+      }
+      ASSERT_LOG(remaining == 0 || in_flight > 0 || !ready.empty(), "Module dependency graph has a cycle");
+      scheduler_cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < std::min(num_workers, pending.size()); i++) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+}
+
+void ModuleRegistry::record_started(const ModuleFactory* module, Module* instance,
+                                    std::chrono::steady_clock::time_point begin,
+                                    std::chrono::steady_clock::time_point end) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (timeline_complete_) {
+    timeline_.clear();
+    timeline_complete_ = false;
+  }
+  ModuleTiming& timing = timeline_[module];
+  timing.name = instance->ToString();
+  timing.start_begin = begin;
+  timing.start_end = end;
   start_order_.push_back(module);
   started_modules_[module] = instance;
-  return instance;
 }
 
 void ModuleRegistry::StopAll() {
@@ -95,20 +210,77 @@ void ModuleRegistry::StopAll() {
     ASSERT(instance != started_modules_.end());
 
     // Clear the handler before stopping the module to allow it to shut down gracefully.
+    auto begin = std::chrono::steady_clock::now();
     instance->second->handler_->Clear();
     instance->second->handler_->WaitUntilStopped(kModuleStopTimeout);
     instance->second->Stop();
 
     delete instance->second->handler_;
     delete instance->second;
-    started_modules_.erase(instance);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      started_modules_.erase(instance);
+      auto timing = timeline_.find(*it);
+      if (timing != timeline_.end()) {
+        timing->second.stop_duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+        timing->second.stopped = true;
+      }
+    }
   }
 
+  std::lock_guard<std::mutex> lock(mutex_);
   ASSERT(started_modules_.empty());
   start_order_.clear();
+  timeline_complete_ = true;
+}
+
+std::vector<ModuleTiming> ModuleRegistry::GetTimeline() const {
+  std::vector<ModuleTiming> timeline;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : timeline_) {
+      timeline.push_back(entry.second);
+    }
+  }
+  std::sort(timeline.begin(), timeline.end(),
+            [](const ModuleTiming& a, const ModuleTiming& b) { return a.start_begin < b.start_begin; });
+  return timeline;
+}
+
+void ModuleRegistry::DumpTimeline(int fd) const {
+  auto timeline = GetTimeline();
+  if (timeline.empty()) {
+    dprintf(fd, "Module startup timeline: no modules started\n");
+    return;
+  }
+
+  auto origin = timeline.front().start_begin;
+  auto finish = origin;
+  std::chrono::microseconds total_start{0};
+  for (auto& timing : timeline) {
+    finish = std::max(finish, timing.start_end);
+    total_start += std::chrono::duration_cast<std::chrono::microseconds>(timing.start_end - timing.start_begin);
+  }
+  auto wall = std::chrono::duration_cast<std::chrono::microseconds>(finish - origin);
+
+  dprintf(fd, "Module startup timeline: %zu modules, wall %.3f ms, sum of starts %.3f ms\n", timeline.size(),
+          wall.count() / 1000.0, total_start.count() / 1000.0);
+  for (auto& timing : timeline) {
+    auto offset = std::chrono::duration_cast<std::chrono::microseconds>(timing.start_begin - origin);
+    auto start = std::chrono::duration_cast<std::chrono::microseconds>(timing.start_end - timing.start_begin);
+    if (timing.stopped) {
+      dprintf(fd, "  +%9.3f ms start %9.3f ms stop %9.3f ms  %s\n", offset.count() / 1000.0, start.count() / 1000.0,
+              timing.stop_duration.count() / 1000.0, timing.name.c_str());
+    } else {
+      dprintf(fd, "  +%9.3f ms start %9.3f ms                 %s\n", offset.count() / 1000.0, start.count() / 1000.0,
+              timing.name.c_str());
+    }
+  }
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto started_instance = started_modules_.find(module);
   if (started_instance != started_modules_.end()) {
     return started_instance->second->GetHandler();
@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <future>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -95,6 +97,15 @@ class Module {
   const ModuleRegistry* registry_;
 };
 
+// Start and stop timing of a single module, as recorded by the module registry
+struct ModuleTiming {
+  std::string name;
+  std::chrono::steady_clock::time_point start_begin;
+  std::chrono::steady_clock::time_point start_end;
+  std::chrono::microseconds stop_duration{0};
+  bool stopped = false;
+};
+
 class ModuleRegistry {
  friend Module;
  friend class StackManager;
@@ -117,9 +128,21 @@ class ModuleRegistry {
 
   Module* Start(const ModuleFactory* id, ::bluetooth::os::Thread* thread);
 
+  // Start all the modules on this list and their dependencies using up to
+  // |num_workers| threads. A module is started as soon as all of its
+  // dependencies are started, so independent modules start concurrently.
+  // Falls back to the sequential Start() above when |num_workers| <= 1.
+  void Start(ModuleList* modules, ::bluetooth::os::Thread* thread, size_t num_workers);
+
   // Stop all running modules in reverse order of start
   void StopAll();
 
+  // Per module timings of the last start up (and shut down, once stopped), in start order
+  std::vector<ModuleTiming> GetTimeline() const;
+
+  // Print the startup timeline to |fd|
+  void DumpTimeline(int fd) const;
+
  protected:
   Module* Get(const ModuleFactory* module) const;
 
@@ -127,8 +150,16 @@ class ModuleRegistry {
 
   os::Handler* GetModuleHandler(const ModuleFactory* module) const;
 
+  void record_started(const ModuleFactory* module, Module* instance, std::chrono::steady_clock::time_point begin,
+                      std::chrono::steady_clock::time_point end);
+
+  // Guards started_modules_, start_order_ and timeline_, which are accessed by modules
+  // starting concurrently on the start workers
+  mutable std::mutex mutex_;
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
+  std::map<const ModuleFactory*, ModuleTiming> timeline_;
+  bool timeline_complete_ = false;
 };
 
 class TestModuleRegistry : public ModuleRegistry {
@@ -199,5 +199,44 @@ TEST_F(ModuleTest, two_dependencies) {
   EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
 }
 
+TEST_F(ModuleTest, two_dependencies_parallel_start) {
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->Start(&list, thread_, 4);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleTwoDependencies>());
+
+  registry_->StopAll();
+
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
+}
+
+TEST_F(ModuleTest, timeline_records_start_and_stop) {
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->Start(&list, thread_, 2);
+
+  auto timeline = registry_->GetTimeline();
+  EXPECT_EQ(timeline.size(), 4u);
+  for (auto& timing : timeline) {
+    EXPECT_LE(timing.start_begin, timing.start_end);
+    EXPECT_FALSE(timing.stopped);
+  }
+
+  registry_->StopAll();
+
+  timeline = registry_->GetTimeline();
+  EXPECT_EQ(timeline.size(), 4u);
+  for (auto& timing : timeline) {
+    EXPECT_TRUE(timing.stopped);
+  }
+}
+
 }  // namespace
 }  // namespace bluetooth
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/crypto_worker_pool.h"
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace security {
+
+CryptoWorkerPool::CryptoWorkerPool()
+    : CryptoWorkerPool(std::clamp<size_t>(std::thread::hardware_concurrency(), 1, kMaxWorkers)) {}
+
+CryptoWorkerPool::CryptoWorkerPool(size_t num_workers) {
+  num_workers = std::max<size_t>(num_workers, 1);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&CryptoWorkerPool::WorkerMain, this);
+  }
+}
+
+CryptoWorkerPool::~CryptoWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_available_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void CryptoWorkerPool::WorkerMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+    if (stopping_) return;
+
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace security
+}  // namespace bluetooth
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace bluetooth {
+namespace security {
+
+/* Runs the expensive part of LE Secure Connections pairing, the P-256 point multiplications and the key derivations
+ * following them, on a fixed set of threads shared by all the pairings in progress.
+ *
+ * Each pairing keeps its state machine on its own thread and only blocks on the result, so pairing with many devices
+ * at once never runs more point multiplications in parallel than there are workers. */
+class CryptoWorkerPool {
+ public:
+  /* Point multiplications are CPU bound, more workers than that would only fight for the cores */
+  static constexpr size_t kMaxWorkers = 4;
+
+  /* One worker per core, up to kMaxWorkers */
+  CryptoWorkerPool();
+  explicit CryptoWorkerPool(size_t num_workers);
+
+  /* Tasks not started yet are dropped, their futures get a broken promise */
+  ~CryptoWorkerPool();
+
+  CryptoWorkerPool(const CryptoWorkerPool&) = delete;
+  CryptoWorkerPool& operator=(const CryptoWorkerPool&) = delete;
+
+  /* Queues |task| to run on the first free worker, the returned future receives its result */
+  template <class F>
+  std::future<std::invoke_result_t<F>> Post(F task) {
+    using Result = std::invoke_result_t<F>;
+    auto packaged_task = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> result = packaged_task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace([packaged_task]() { (*packaged_task)(); });
+    }
+    task_available_.notify_one();
+    return result;
+  }
+
+  size_t GetNumWorkers() const {
+    return workers_.size();
+  }
+
+ private:
+  void WorkerMain();
+
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::queue<std::function<void()>> tasks_;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace security
+}  // namespace bluetooth
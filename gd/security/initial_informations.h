@@ -29,6 +29,7 @@
 #include "os/handler.h"
 #include "packet/base_packet_builder.h"
 #include "packet/packet_view.h"
+#include "security/crypto_worker_pool.h"
 #include "security/ecdh_keys.h"
 #include "security/pairing_failure.h"
 #include "security/smp_packets.h"
@@ -107,6 +108,9 @@ struct InitialInformations {
   os::EnqueueBuffer<packet::BasePacketBuilder>* proper_l2cap_interface;
   os::Handler* l2cap_handler;
 
+  /* Runs the point multiplications and key derivations, if null they run on the pairing thread */
+  CryptoWorkerPool* crypto_worker_pool = nullptr;
+
   /* Callback to execute once the Pairing process is finished */
   std::function<void(PairingResultOrFailure)> OnPairingFinished;
 };
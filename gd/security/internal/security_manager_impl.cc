@@ -86,10 +86,14 @@ void SecurityManagerImpl::CreateBondLe(hci::AddressWithType address) {
     return;
   }
 
-  pending_le_pairing_.address_ = address;
+  if (pending_le_pairings_.count(address) != 0) {
+    LOG_WARN("Already pairing with %s", address.ToString().c_str());
+    return;
+  }
+  pending_le_pairings_[address];
 
   l2cap_manager_le_->ConnectServices(
-      address, common::BindOnce(&SecurityManagerImpl::OnConnectionFailureLe, common::Unretained(this)),
+      address, common::BindOnce(&SecurityManagerImpl::OnConnectionFailureLe, common::Unretained(this), address),
       security_handler_);
 }
 
@@ -234,9 +238,11 @@ void SecurityManagerImpl::OnHciEventReceived(hci::EventPacketView packet) {
         LOG_ERROR("Invalid EncryptionChange packet received");
         return;
       }
-      if (enc_chg_packet.GetConnectionHandle() == pending_le_pairing_.connection_handle_) {
-        pending_le_pairing_.handler_->OnHciEvent(event);
-        return;
+      for (auto& [address, pairing] : pending_le_pairings_) {
+        if (pairing.handler_ != nullptr && enc_chg_packet.GetConnectionHandle() == pairing.connection_handle_) {
+          pairing.handler_->OnHciEvent(event);
+          return;
+        }
       }
       break;
     }
@@ -259,7 +265,10 @@ void SecurityManagerImpl::OnPairingPromptAccepted(const bluetooth::hci::AddressW
   if (entry != pairing_handler_map_.end()) {
     entry->second->OnPairingPromptAccepted(address, confirmed);
   } else {
-    pending_le_pairing_.handler_->OnUiAction(PairingEvent::UI_ACTION_TYPE::PAIRING_ACCEPTED, confirmed);
+    auto le_entry = pending_le_pairings_.find(address);
+    if (le_entry != pending_le_pairings_.end() && le_entry->second.handler_ != nullptr) {
+      le_entry->second.handler_->OnUiAction(PairingEvent::UI_ACTION_TYPE::PAIRING_ACCEPTED, confirmed);
+    }
   }
 }
 
@@ -268,8 +277,9 @@ void SecurityManagerImpl::OnConfirmYesNo(const bluetooth::hci::AddressWithType&
   if (entry != pairing_handler_map_.end()) {
     entry->second->OnConfirmYesNo(address, confirmed);
   } else {
-    if (pending_le_pairing_.address_ == address) {
-      pending_le_pairing_.handler_->OnUiAction(PairingEvent::UI_ACTION_TYPE::CONFIRM_YESNO, confirmed);
+    auto le_entry = pending_le_pairings_.find(address);
+    if (le_entry != pending_le_pairings_.end() && le_entry->second.handler_ != nullptr) {
+      le_entry->second.handler_->OnUiAction(PairingEvent::UI_ACTION_TYPE::CONFIRM_YESNO, confirmed);
     }
   }
 }
@@ -279,8 +289,9 @@ void SecurityManagerImpl::OnPasskeyEntry(const bluetooth::hci::AddressWithType&
   if (entry != pairing_handler_map_.end()) {
     entry->second->OnPasskeyEntry(address, passkey);
   } else {
-    if (pending_le_pairing_.address_ == address) {
-      pending_le_pairing_.handler_->OnUiAction(PairingEvent::UI_ACTION_TYPE::PASSKEY, passkey);
+    auto le_entry = pending_le_pairings_.find(address);
+    if (le_entry != pending_le_pairings_.end() && le_entry->second.handler_ != nullptr) {
+      le_entry->second.handler_->OnUiAction(PairingEvent::UI_ACTION_TYPE::PASSKEY, passkey);
     }
   }
 }
@@ -304,33 +315,39 @@ void SecurityManagerImpl::OnL2capRegistrationCompleteLe(
              "Failed to register to LE SMP Fixed Channel Service");
 }
 
-void SecurityManagerImpl::OnSmpCommandLe() {
-  auto packet = pending_le_pairing_.channel_->GetQueueUpEnd()->TryDequeue();
+void SecurityManagerImpl::OnSmpCommandLe(hci::AddressWithType address) {
+  auto entry = pending_le_pairings_.find(address);
+  if (entry == pending_le_pairings_.end()) return;
+  PendingLePairing& pairing = entry->second;
+  auto packet = pairing.channel_->GetQueueUpEnd()->TryDequeue();
   if (!packet) LOG_ERROR("Received dequeue, but no data ready...");
 
   auto temp_cmd_view = CommandView::Create(*packet);
-  pending_le_pairing_.handler_->OnCommandView(temp_cmd_view);
+  pairing.handler_->OnCommandView(temp_cmd_view);
 }
 
 void SecurityManagerImpl::OnConnectionOpenLe(std::unique_ptr<l2cap::le::FixedChannel> channel) {
-  if (pending_le_pairing_.address_ != channel->GetDevice()) {
+  auto entry = pending_le_pairings_.find(channel->GetDevice());
+  if (entry == pending_le_pairings_.end()) {
     return;
   }
-  pending_le_pairing_.channel_ = std::move(channel);
-  pending_le_pairing_.channel_->RegisterOnCloseCallback(
-      security_handler_, common::BindOnce(&SecurityManagerImpl::OnConnectionClosedLe, common::Unretained(this),
-                                          pending_le_pairing_.channel_->GetDevice()));
+  hci::AddressWithType address = entry->first;
+  PendingLePairing& pairing = entry->second;
+  pairing.channel_ = std::move(channel);
+  pairing.channel_->RegisterOnCloseCallback(
+      security_handler_,
+      common::BindOnce(&SecurityManagerImpl::OnConnectionClosedLe, common::Unretained(this), address));
   // TODO: this enqueue buffer must be stored together with pairing_handler, and we must make sure it doesn't go out of
   // scope while the pairing happens
-  pending_le_pairing_.enqueue_buffer_ =
-      std::make_unique<os::EnqueueBuffer<packet::BasePacketBuilder>>(pending_le_pairing_.channel_->GetQueueUpEnd());
-  pending_le_pairing_.channel_->GetQueueUpEnd()->RegisterDequeue(
-      security_handler_, common::Bind(&SecurityManagerImpl::OnSmpCommandLe, common::Unretained(this)));
+  pairing.enqueue_buffer_ =
+      std::make_unique<os::EnqueueBuffer<packet::BasePacketBuilder>>(pairing.channel_->GetQueueUpEnd());
+  pairing.channel_->GetQueueUpEnd()->RegisterDequeue(
+      security_handler_, common::Bind(&SecurityManagerImpl::OnSmpCommandLe, common::Unretained(this), address));
 
   // TODO: this doesn't have to be a unique ptr, if there is a way to properly std::move it into place where it's stored
-  pending_le_pairing_.connection_handle_ = pending_le_pairing_.channel_->GetAclConnection()->GetHandle();
+  pairing.connection_handle_ = pairing.channel_->GetAclConnection()->GetHandle();
   InitialInformations initial_informations{
-      .my_role = pending_le_pairing_.channel_->GetAclConnection()->GetRole(),
+      .my_role = pairing.channel_->GetAclConnection()->GetRole(),
       .my_connection_address = {hci::Address{{0x00, 0x11, 0xFF, 0xFF, 0x33, 0x22}} /*TODO: obtain my address*/,
                                 hci::AddressType::RANDOM_DEVICE_ADDRESS},
       /*TODO: properly obtain capabilities from device-specific storage*/
@@ -341,8 +358,8 @@ void SecurityManagerImpl::OnConnectionOpenLe(std::unique_ptr<l2cap::le::FixedCha
                                 .initiator_key_distribution = 0x07,
                                 .responder_key_distribution = 0x07},
       .remotely_initiated = false,
-      .connection_handle = pending_le_pairing_.channel_->GetAclConnection()->GetHandle(),
-      .remote_connection_address = pending_le_pairing_.channel_->GetDevice(),
+      .connection_handle = pairing.channel_->GetAclConnection()->GetHandle(),
+      .remote_connection_address = pairing.channel_->GetDevice(),
       .remote_name = "TODO: grab proper device name in sec mgr",
       /* contains pairing request, if the pairing was remotely initiated */
       .pairing_request = std::nullopt,  // TODO: handle remotely initiated pairing in SecurityManager properly
@@ -354,31 +371,44 @@ void SecurityManagerImpl::OnConnectionOpenLe(std::unique_ptr<l2cap::le::FixedCha
 
       /* HCI interface to use */
       .le_security_interface = hci_security_interface_le_,
-      .proper_l2cap_interface = pending_le_pairing_.enqueue_buffer_.get(),
+      .proper_l2cap_interface = pairing.enqueue_buffer_.get(),
       .l2cap_handler = security_handler_,
+      .crypto_worker_pool = &crypto_worker_pool_,
       /* Callback to execute once the Pairing process is finished */
       // TODO: make it an common::OnceCallback ?
-      .OnPairingFinished = std::bind(&SecurityManagerImpl::OnPairingFinished, this, std::placeholders::_1),
+      .OnPairingFinished =
+          [this, address](PairingResultOrFailure result) {
+            // Invoked on the pairing thread, which is joined when the entry goes away, so finish on our handler
+            security_handler_->Post(common::BindOnce(&SecurityManagerImpl::OnPairingFinished, common::Unretained(this),
+                                                     address, std::move(result)));
+          },
   };
-  pending_le_pairing_.handler_ = std::make_unique<PairingHandlerLe>(PairingHandlerLe::PHASE1, initial_informations);
+  pairing.handler_ = std::make_unique<PairingHandlerLe>(PairingHandlerLe::PHASE1, initial_informations);
 }
 
 void SecurityManagerImpl::OnConnectionClosedLe(hci::AddressWithType address, hci::ErrorCode error_code) {
-  if (pending_le_pairing_.address_ != address) {
+  auto entry = pending_le_pairings_.find(address);
+  if (entry == pending_le_pairings_.end()) {
     return;
   }
-  pending_le_pairing_.handler_->SendExitSignal();
+  PendingLePairing& pairing = entry->second;
+  if (pairing.handler_ != nullptr) pairing.handler_->SendExitSignal();
+  if (pairing.channel_ != nullptr) pairing.channel_->GetQueueUpEnd()->UnregisterDequeue();
   NotifyDeviceBondFailed(address, PairingFailure("Connection closed"));
+  // Joins the pairing thread, which returns as soon as it gets the exit signal
+  pending_le_pairings_.erase(entry);
 }
 
-void SecurityManagerImpl::OnConnectionFailureLe(bluetooth::l2cap::le::FixedChannelManager::ConnectionResult result) {
+void SecurityManagerImpl::OnConnectionFailureLe(hci::AddressWithType address,
+                                                bluetooth::l2cap::le::FixedChannelManager::ConnectionResult result) {
   if (result.connection_result_code ==
       bluetooth::l2cap::le::FixedChannelManager::ConnectionResultCode::FAIL_ALL_SERVICES_HAVE_CHANNEL) {
     // TODO: already connected
   }
 
   // This callback is invoked only for devices we attempted to connect to.
-  NotifyDeviceBondFailed(pending_le_pairing_.address_, PairingFailure("Connection establishment failed"));
+  pending_le_pairings_.erase(address);
+  NotifyDeviceBondFailed(address, PairingFailure("Connection establishment failed"));
 }
 
 SecurityManagerImpl::SecurityManagerImpl(os::Handler* security_handler, l2cap::le::L2capLeModule* l2cap_le_module,
@@ -397,18 +427,27 @@ SecurityManagerImpl::SecurityManagerImpl(os::Handler* security_handler, l2cap::l
       common::Bind(&SecurityManagerImpl::OnConnectionOpenLe, common::Unretained(this)), security_handler_);
 }
 
-void SecurityManagerImpl::OnPairingFinished(security::PairingResultOrFailure pairing_result) {
-  LOG_INFO(" ■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■ Received pairing result");
+void SecurityManagerImpl::OnPairingFinished(hci::AddressWithType address,
+                                            security::PairingResultOrFailure pairing_result) {
+  auto entry = pending_le_pairings_.find(address);
+  if (entry == pending_le_pairings_.end()) {
+    // Connection went away first, the failure was already reported
+    return;
+  }
+  PendingLePairing& pairing = entry->second;
+  if (pairing.channel_ != nullptr) pairing.channel_->GetQueueUpEnd()->UnregisterDequeue();
+  // The pairing thread has returned, this joins it. The device can be bonded with again from now on.
+  pending_le_pairings_.erase(entry);
 
   if (std::holds_alternative<PairingFailure>(pairing_result)) {
     PairingFailure failure = std::get<PairingFailure>(pairing_result);
-    LOG_INFO(" ■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■ failure message: %s",
-             failure.message.c_str());
+    LOG_INFO("Pairing with %s failed: %s", address.ToString().c_str(), failure.message.c_str());
+    NotifyDeviceBondFailed(address, pairing_result);
     return;
   }
 
-  LOG_INFO("Pairing with %s was successfull",
-           std::get<PairingResult>(pairing_result).connection_address.ToString().c_str());
+  LOG_INFO("Pairing with %s was successful", address.ToString().c_str());
+  NotifyDeviceBonded(address);
 }
 
 }  // namespace internal
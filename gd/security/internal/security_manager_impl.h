@@ -24,6 +24,7 @@
 #include "l2cap/le/l2cap_le_module.h"
 #include "os/handler.h"
 #include "security/channel/security_manager_channel.h"
+#include "security/crypto_worker_pool.h"
 #include "security/initial_informations.h"
 #include "security/pairing/classic_pairing_handler.h"
 #include "security/pairing_handler_le.h"
@@ -142,11 +143,12 @@ class SecurityManagerImpl : public channel::ISecurityManagerChannelListener, pub
                               hci::AuthenticationRequirements authentication_requirements);
   void OnL2capRegistrationCompleteLe(l2cap::le::FixedChannelManager::RegistrationResult result,
                                      std::unique_ptr<l2cap::le::FixedChannelService> le_smp_service);
-  void OnSmpCommandLe();
+  void OnSmpCommandLe(hci::AddressWithType address);
   void OnConnectionOpenLe(std::unique_ptr<l2cap::le::FixedChannel> channel);
   void OnConnectionClosedLe(hci::AddressWithType address, hci::ErrorCode error_code);
-  void OnConnectionFailureLe(bluetooth::l2cap::le::FixedChannelManager::ConnectionResult result);
-  void OnPairingFinished(bluetooth::security::PairingResultOrFailure pairing_result);
+  void OnConnectionFailureLe(hci::AddressWithType address,
+                             bluetooth::l2cap::le::FixedChannelManager::ConnectionResult result);
+  void OnPairingFinished(hci::AddressWithType address, bluetooth::security::PairingResultOrFailure pairing_result);
   void OnHciLeEvent(hci::LeMetaEventView event);
 
   os::Handler* security_handler_ __attribute__((unused));
@@ -158,13 +160,18 @@ class SecurityManagerImpl : public channel::ISecurityManagerChannelListener, pub
   SecurityRecordDatabase security_database_;
   std::unordered_map<hci::Address, std::shared_ptr<pairing::PairingHandler>> pairing_handler_map_;
 
-  struct {
-    hci::AddressWithType address_;
+  // Shared by all the LE pairings, declared before them so that it outlives their pairing threads
+  CryptoWorkerPool crypto_worker_pool_;
+
+  struct PendingLePairing {
     std::unique_ptr<l2cap::le::FixedChannel> channel_;
-    uint8_t connection_handle_;
-    std::unique_ptr<PairingHandlerLe> handler_;
+    uint16_t connection_handle_;
     std::unique_ptr<os::EnqueueBuffer<packet::BasePacketBuilder>> enqueue_buffer_;
-  } pending_le_pairing_;
+    // Last, so that the pairing thread is joined before the channel and buffer it uses go away
+    std::unique_ptr<PairingHandlerLe> handler_;
+  };
+  // LE pairings in progress, one per device we are bonding with
+  std::unordered_map<hci::AddressWithType, PendingLePairing> pending_le_pairings_;
 };
 }  // namespace internal
 }  // namespace security
@@ -21,6 +21,7 @@
 #include <array>
 #include <chrono>
 #include <condition_variable>
+#include <future>
 #include <mutex>
 #include <optional>
 #include <queue>
@@ -186,6 +187,26 @@ class PairingHandlerLe {
     return data;
   }
 
+  /* Runs |task| on the crypto worker pool, or right there if there is none, and returns its result */
+  template <class F>
+  static std::invoke_result_t<F> RunCrypto(const InitialInformations& i, F task) {
+    if (i.crypto_worker_pool == nullptr) return task();
+    return i.crypto_worker_pool->Post(std::move(task)).get();
+  }
+
+  /* Starts generating our ECDH key pair on the crypto worker pool, so that it is ready by the time phase 1 and the
+   * accept prompt are done */
+  void PrepareMyKeyPair(const InitialInformations& i) {
+    if (i.crypto_worker_pool == nullptr || i.my_oob_data) return;
+    if ((i.myPairingCapabilities.auth_req & AuthReqMaskSc) == 0) return;
+    my_key_pair_ = i.crypto_worker_pool->Post(GenerateECDHKeyPair);
+  }
+
+  std::pair<std::array<uint8_t, 32>, EcdhPublicKey> GetMyKeyPair(const InitialInformations& i) {
+    if (my_key_pair_.valid()) return my_key_pair_.get();
+    return RunCrypto(i, GenerateECDHKeyPair);
+  }
+
   std::variant<PairingFailure, KeyExchangeResult> ExchangePublicKeys(const InitialInformations& i,
                                                                      OobDataFlag remote_have_oob_data);
 
@@ -491,6 +512,9 @@ class PairingHandlerLe {
   std::mutex queue_guard;
   std::queue<PairingEvent> queue;
 
+  // Our key pair for Secure Connections, when it is generated ahead of the public key exchange
+  std::future<std::pair<std::array<uint8_t, 32>, EcdhPublicKey>> my_key_pair_;
+
   std::thread thread_;
 };
 }  // namespace security
@@ -25,7 +25,7 @@ std::variant<PairingFailure, KeyExchangeResult> PairingHandlerLe::ExchangePublic
                                                                                      OobDataFlag remote_have_oob_data) {
   // Generate ECDH, or use one that was used for OOB data
   const auto [private_key, public_key] = (remote_have_oob_data == OobDataFlag::NOT_PRESENT || !i.my_oob_data)
-                                             ? GenerateECDHKeyPair()
+                                             ? GetMyKeyPair(i)
                                              : std::make_pair(i.my_oob_data->private_key, i.my_oob_data->public_key);
 
   LOG_INFO("Public key exchange start");
@@ -73,7 +73,9 @@ std::variant<PairingFailure, KeyExchangeResult> PairingHandlerLe::ExchangePublic
 
   LOG_INFO("Public key exchange finish");
 
-  std::array<uint8_t, 32> dhkey = ComputeDHKey(private_key, remote_public_key);
+  std::array<uint8_t, 32> dhkey = RunCrypto(i, [my_private_key = private_key, remote_public_key]() {
+    return ComputeDHKey(my_private_key, remote_public_key);
+  });
 
   const EcdhPublicKey& PKa = IAmMaster(i) ? public_key : remote_public_key;
   const EcdhPublicKey& PKb = IAmMaster(i) ? remote_public_key : public_key;
@@ -127,7 +129,8 @@ Stage2ResultOrFailure PairingHandlerLe::DoSecureConnectionsStage2(const InitialI
                                                                   const std::array<uint8_t, 32>& dhkey) {
   LOG_INFO("Authentication stage 2 started");
 
-  auto [Na, Nb, ra, rb] = stage1result;
+  Octet16 Na, Nb, ra, rb;
+  std::tie(Na, Nb, ra, rb) = stage1result;
 
   // 2.3.5.6.5 Authentication stage 2 long term key calculation
   uint8_t a[7];
@@ -145,9 +148,6 @@ Stage2ResultOrFailure PairingHandlerLe::DoSecureConnectionsStage2(const InitialI
     b[6] = (uint8_t)i.my_connection_address.GetAddressType();
   }
 
-  Octet16 ltk, mac_key;
-  crypto_toolbox::f5((uint8_t*)dhkey.data(), Na, Nb, a, b, &mac_key, &ltk);
-
   // DHKey exchange and check
 
   std::array<uint8_t, 3> iocapA{static_cast<uint8_t>(pairing_request.GetIoCapability()),
@@ -166,9 +166,14 @@ Stage2ResultOrFailure PairingHandlerLe::DoSecureConnectionsStage2(const InitialI
   // LOG(INFO) << +(IAmMaster(i)) << " a = " << base::HexEncode(a, 7);
   // LOG(INFO) << +(IAmMaster(i)) << " b = " << base::HexEncode(b, 7);
 
-  Octet16 Ea = crypto_toolbox::f6(mac_key, Na, Nb, rb, iocapA.data(), a, b);
+  Octet16 ltk, Ea, Eb;
+  RunCrypto(i, [&]() {
+    Octet16 mac_key;
+    crypto_toolbox::f5((uint8_t*)dhkey.data(), Na, Nb, a, b, &mac_key, &ltk);
 
-  Octet16 Eb = crypto_toolbox::f6(mac_key, Nb, Na, ra, iocapB.data(), b, a);
+    Ea = crypto_toolbox::f6(mac_key, Na, Nb, rb, iocapA.data(), a, b);
+    Eb = crypto_toolbox::f6(mac_key, Nb, Na, ra, iocapB.data(), b, a);
+  });
 
   if (IAmMaster(i)) {
     // send Pairing DHKey Check
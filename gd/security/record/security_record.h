@@ -18,11 +18,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/address_with_type.h"
+#include "os/log.h"
 
 namespace bluetooth {
 namespace security {
@@ -98,7 +101,7 @@ class SecurityRecord {
   bool pairing_ = false;
 
  public:
-  /* Identity Address */
+  /* Identity Address, set with irk through SecurityRecordDatabase::SetIdentity() which indexes both */
   std::optional<hci::AddressWithType> identity_address_;
 
   std::optional<crypto_toolbox::Octet16> ltk;
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/security_record_database.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+
+namespace bluetooth {
+namespace security {
+
+namespace {
+
+// The sections are shared with the legacy stack, which keeps its own bonds there under names like "LinkKey". All the
+// keys of a record are prefixed so that writing or removing it never touches them
+constexpr char kAddressTypeKey[] = "SecurityAddrType";
+constexpr char kLinkKeyKey[] = "SecurityLinkKey";
+constexpr char kLinkKeyTypeKey[] = "SecurityLinkKeyType";
+constexpr char kIdentityAddressKey[] = "SecurityIdentityAddr";
+constexpr char kIdentityAddressTypeKey[] = "SecurityIdentityAddrType";
+constexpr char kIrkKey[] = "SecurityLeIrk";
+constexpr char kLtkKey[] = "SecurityLeLtk";
+constexpr char kEdivKey[] = "SecurityLeEdiv";
+constexpr char kRandKey[] = "SecurityLeRand";
+constexpr char kSignatureKeyKey[] = "SecurityLeSignatureKey";
+
+const char* const kRecordKeys[] = {kAddressTypeKey, kLinkKeyKey, kLinkKeyTypeKey, kIdentityAddressKey,
+                                   kIdentityAddressTypeKey, kIrkKey, kLtkKey, kEdivKey, kRandKey, kSignatureKeyKey};
+
+template <size_t N>
+std::string ToHex(const std::array<uint8_t, N>& bytes) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(2 * N);
+  for (uint8_t byte : bytes) {
+    hex.push_back(kDigits[byte >> 4]);
+    hex.push_back(kDigits[byte & 0x0f]);
+  }
+  return hex;
+}
+
+int FromHexDigit(char digit) {
+  if (digit >= '0' && digit <= '9') return digit - '0';
+  if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+  if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+  return -1;
+}
+
+template <size_t N>
+std::optional<std::array<uint8_t, N>> FromHex(const std::string* hex) {
+  if (hex == nullptr || hex->size() != 2 * N) return std::nullopt;
+  std::array<uint8_t, N> bytes;
+  for (size_t i = 0; i < N; i++) {
+    int high = FromHexDigit((*hex)[2 * i]);
+    int low = FromHexDigit((*hex)[2 * i + 1]);
+    if (high < 0 || low < 0) return std::nullopt;
+    bytes[i] = (high << 4) | low;
+  }
+  return bytes;
+}
+
+std::optional<long> FromDecimal(const std::string* value) {
+  if (value == nullptr || value->empty()) return std::nullopt;
+  char* end = nullptr;
+  long number = std::strtol(value->c_str(), &end, 10);
+  if (*end != '\0') return std::nullopt;
+  return number;
+}
+
+const std::string* FindValue(const section_t& section, const char* key) {
+  for (const entry_t& entry : section.entries) {
+    if (entry.key == key) return &entry.value;
+  }
+  return nullptr;
+}
+
+// Removes the keys of the record from its section, and the section too if nothing else is left in it
+std::list<section_t>::iterator RemoveRecordKeys(config_t* config, const std::string& name) {
+  auto section = std::find_if(config->sections.begin(), config->sections.end(),
+                              [&name](const section_t& section) { return section.name == name; });
+  if (section == config->sections.end()) return section;
+
+  section->entries.remove_if([](const entry_t& entry) {
+    return std::any_of(std::begin(kRecordKeys), std::end(kRecordKeys),
+                       [&entry](const char* key) { return entry.key == key; });
+  });
+  if (!section->entries.empty()) return section;
+  config->sections.erase(section);
+  return config->sections.end();
+}
+
+void WriteRecord(config_t* config, record::SecurityRecord& record) {
+  hci::AddressWithType pseudo_address = record.GetPseudoAddress();
+  std::string name = pseudo_address.GetAddress().ToString();
+  auto section = RemoveRecordKeys(config, name);
+
+  // Devices seen but never paired have nothing worth storing
+  if (!record.IsPaired() && !record.ltk.has_value() && !record.irk.has_value()) return;
+
+  if (section == config->sections.end()) {
+    config->sections.push_back(section_t{.name = name});
+    section = std::prev(config->sections.end());
+  }
+  auto set = [&section](const char* key, std::string value) {
+    section->entries.push_back(entry_t{.key = key, .value = std::move(value)});
+  };
+
+  set(kAddressTypeKey, std::to_string(static_cast<int>(pseudo_address.GetAddressType())));
+  if (record.IsPaired()) {
+    set(kLinkKeyKey, ToHex(record.GetLinkKey()));
+    set(kLinkKeyTypeKey, std::to_string(static_cast<int>(record.GetKeyType())));
+  }
+  if (record.identity_address_.has_value()) {
+    set(kIdentityAddressKey, record.identity_address_->GetAddress().ToString());
+    set(kIdentityAddressTypeKey, std::to_string(static_cast<int>(record.identity_address_->GetAddressType())));
+  }
+  if (record.irk.has_value()) set(kIrkKey, ToHex(*record.irk));
+  if (record.ltk.has_value()) set(kLtkKey, ToHex(*record.ltk));
+  if (record.ediv.has_value()) set(kEdivKey, std::to_string(*record.ediv));
+  if (record.rand.has_value()) set(kRandKey, ToHex(*record.rand));
+  if (record.signature_key.has_value()) set(kSignatureKeyKey, ToHex(*record.signature_key));
+}
+
+}  // namespace
+
+record::SecurityRecord& SecurityRecordDatabase::FindOrCreate(hci::AddressWithType address) {
+  record::SecurityRecord* record = Find(address);
+  // Security record check
+  if (record != nullptr) return *record;
+
+  // No security record, create one
+  auto& created = records_[address];
+  created = std::make_unique<record::SecurityRecord>(address);
+  return *created;
+}
+
+void SecurityRecordDatabase::Remove(const hci::AddressWithType& address) {
+  record::SecurityRecord* record = Find(address);
+
+  // No record exists
+  if (record == nullptr) return;
+
+  hci::AddressWithType pseudo_address = record->GetPseudoAddress();
+  Unindex(record);
+  changed_.erase(pseudo_address);
+  removed_.insert(pseudo_address);
+  records_.erase(pseudo_address);
+}
+
+record::SecurityRecord* SecurityRecordDatabase::Find(const hci::AddressWithType& address) {
+  auto identity = identity_index_.find(address);
+  if (identity != identity_index_.end()) return identity->second;
+
+  auto record = records_.find(address);
+  if (record != records_.end()) return record->second.get();
+
+  if (!address.IsRpa()) return nullptr;
+
+  auto resolved = resolved_rpas_.find(address);
+  if (resolved != resolved_rpas_.end()) return resolved->second;
+
+  // One AES computation per IRK, so remember the result
+  for (record::SecurityRecord* irk_record : irk_records_) {
+    if (address.IsRpaThatMatchesIrk(irk_record->irk.value())) {
+      if (resolved_rpas_.size() >= kMaxResolvedRpas) resolved_rpas_.clear();
+      resolved_rpas_[address] = irk_record;
+      return irk_record;
+    }
+  }
+  return nullptr;
+}
+
+void SecurityRecordDatabase::SetIdentity(record::SecurityRecord& record, hci::AddressWithType identity_address,
+                                         crypto_toolbox::Octet16 irk) {
+  Unindex(&record);
+  record.identity_address_ = identity_address;
+  record.irk = irk;
+  Index(&record);
+  MarkChanged(record);
+}
+
+void SecurityRecordDatabase::MarkChanged(record::SecurityRecord& record) {
+  changed_.insert(record.GetPseudoAddress());
+}
+
+void SecurityRecordDatabase::Load(const config_t& config) {
+  for (const section_t& section : config.sections) {
+    hci::Address address;
+    std::optional<long> address_type = FromDecimal(FindValue(section, kAddressTypeKey));
+    if (!address_type.has_value() || !hci::Address::FromString(section.name, address)) continue;
+
+    hci::AddressWithType pseudo_address(address, static_cast<hci::AddressType>(*address_type));
+    auto& record = records_[pseudo_address];
+    if (record != nullptr) Unindex(record.get());
+    record = std::make_unique<record::SecurityRecord>(pseudo_address);
+
+    auto link_key = FromHex<16>(FindValue(section, kLinkKeyKey));
+    std::optional<long> key_type = FromDecimal(FindValue(section, kLinkKeyTypeKey));
+    if (link_key.has_value() && key_type.has_value()) {
+      record->SetLinkKey(*link_key, static_cast<hci::KeyType>(*key_type));
+    } else {
+      record->CancelPairing();
+    }
+    record->SetPersisted(true);
+
+    hci::Address identity_address;
+    std::optional<long> identity_address_type = FromDecimal(FindValue(section, kIdentityAddressTypeKey));
+    const std::string* identity_address_string = FindValue(section, kIdentityAddressKey);
+    if (identity_address_type.has_value() && identity_address_string != nullptr &&
+        hci::Address::FromString(*identity_address_string, identity_address)) {
+      record->identity_address_ =
+          hci::AddressWithType(identity_address, static_cast<hci::AddressType>(*identity_address_type));
+    }
+    record->irk = FromHex<16>(FindValue(section, kIrkKey));
+    record->ltk = FromHex<16>(FindValue(section, kLtkKey));
+    std::optional<long> ediv = FromDecimal(FindValue(section, kEdivKey));
+    if (ediv.has_value()) record->ediv = static_cast<uint16_t>(*ediv);
+    record->rand = FromHex<8>(FindValue(section, kRandKey));
+    record->signature_key = FromHex<16>(FindValue(section, kSignatureKeyKey));
+    Index(record.get());
+  }
+}
+
+size_t SecurityRecordDatabase::WriteChanges(config_t* config) {
+  size_t updated = 0;
+  for (const hci::AddressWithType& pseudo_address : removed_) {
+    RemoveRecordKeys(config, pseudo_address.GetAddress().ToString());
+    updated++;
+  }
+  for (const hci::AddressWithType& pseudo_address : changed_) {
+    auto record = records_.find(pseudo_address);
+    if (record == records_.end()) continue;
+    WriteRecord(config, *record->second);
+    updated++;
+  }
+  removed_.clear();
+  changed_.clear();
+  return updated;
+}
+
+void SecurityRecordDatabase::Index(record::SecurityRecord* record) {
+  if (record->identity_address_.has_value()) identity_index_.emplace(*record->identity_address_, record);
+  if (record->irk.has_value()) irk_records_.push_back(record);
+}
+
+void SecurityRecordDatabase::Unindex(record::SecurityRecord* record) {
+  if (record->identity_address_.has_value()) {
+    auto identity = identity_index_.find(*record->identity_address_);
+    if (identity != identity_index_.end() && identity->second == record) identity_index_.erase(identity);
+  }
+  irk_records_.erase(std::remove(irk_records_.begin(), irk_records_.end(), record), irk_records_.end());
+  for (auto resolved = resolved_rpas_.begin(); resolved != resolved_rpas_.end();) {
+    if (resolved->second == record) {
+      resolved = resolved_rpas_.erase(resolved);
+    } else {
+      ++resolved;
+    }
+  }
+}
+
+}  // namespace security
+}  // namespace bluetooth
@@ -16,48 +16,82 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "security/record/security_record.h"
+#include "storage/legacy_osi_config.h"
 
 namespace bluetooth {
 namespace security {
 
+/**
+ * Security records of all the devices we have seen, indexed by pseudo and identity address, and by the resolvable
+ * private addresses already resolved with their IRK.
+ *
+ * Records are stored in the sections of a config_t, one section per device named after its pseudo address, under keys
+ * starting with "Security". Only the records marked as changed since the last WriteChanges() are written again.
+ */
 class SecurityRecordDatabase {
  public:
-  using iterator = std::vector<record::SecurityRecord>::iterator;
+  /* Resolved RPAs kept before the cache is emptied, devices change their RPA every 15 minutes or so */
+  static constexpr size_t kMaxResolvedRpas = 1024;
 
-  record::SecurityRecord& FindOrCreate(hci::AddressWithType address) {
-    auto it = Find(address);
-    // Security record check
-    if (it != records_.end()) return *it;
+  record::SecurityRecord& FindOrCreate(hci::AddressWithType address);
 
-    // No security record, create one
-    records_.emplace_back(address);
-    return records_.back();
-  }
+  void Remove(const hci::AddressWithType& address);
 
-  void Remove(const hci::AddressWithType& address) {
-    auto it = Find(address);
+  /**
+   * Returns the record of the device using the given address, or nullptr if there is none. The identity addresses
+   * are looked up first, then the pseudo addresses, then the IRKs
+   */
+  record::SecurityRecord* Find(const hci::AddressWithType& address);
 
-    // No record exists
-    if (it == records_.end()) return;
+  /**
+   * Sets the identity the device distributed while pairing. Must be used instead of setting the fields of the record
+   * directly, to keep them indexed
+   */
+  void SetIdentity(record::SecurityRecord& record, hci::AddressWithType identity_address, crypto_toolbox::Octet16 irk);
 
-    record::SecurityRecord& last = records_.back();
-    *it = std::move(last);
-    records_.pop_back();
-  }
+  /**
+   * Marks the record as changed, so that the next WriteChanges() stores it
+   */
+  void MarkChanged(record::SecurityRecord& record);
 
-  iterator Find(hci::AddressWithType address) {
-    for (auto it = records_.begin(); it != records_.end(); ++it) {
-      record::SecurityRecord& record = *it;
-      if (record.identity_address_.has_value() && record.identity_address_.value() == address) return it;
-      if (record.GetPseudoAddress() == address) return it;
-      if (record.irk.has_value() && address.IsRpaThatMatchesIrk(record.irk.value())) return it;
-    }
-    return records_.end();
+  size_t Size() const {
+    return records_.size();
   }
 
-  std::vector<record::SecurityRecord> records_;
+  /**
+   * Adds the records stored in config, as written by WriteChanges(). Sections of other modules are skipped
+   */
+  void Load(const config_t& config);
+
+  /**
+   * Updates in config the sections of the records changed or removed since the last call, leaving other sections and
+   * keys untouched.
+   *
+   * @return number of records updated, config doesn't need saving if it is 0
+   */
+  size_t WriteChanges(config_t* config);
+
+ private:
+  void Index(record::SecurityRecord* record);
+  void Unindex(record::SecurityRecord* record);
+
+  /* Records owned by pseudo address */
+  std::unordered_map<hci::AddressWithType, std::unique_ptr<record::SecurityRecord>> records_;
+  std::unordered_map<hci::AddressWithType, record::SecurityRecord*> identity_index_;
+  /* Records with an IRK, tried in turn on RPAs not resolved yet */
+  std::vector<record::SecurityRecord*> irk_records_;
+  std::unordered_map<hci::AddressWithType, record::SecurityRecord*> resolved_rpas_;
+
+  /* Pseudo addresses of the records to write or remove on the next WriteChanges() */
+  std::unordered_set<hci::AddressWithType> changed_;
+  std::unordered_set<hci::AddressWithType> removed_;
 };
 
 }  // namespace security
-}  // namespace bluetooth
\ No newline at end of file
+}  // namespace bluetooth
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+#include "security/security_record_database.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace security {
+
+namespace {
+
+using hci::Address;
+using hci::AddressType;
+using hci::AddressWithType;
+
+hci::AddressWithType MakeRpa(const crypto_toolbox::Octet16& irk, std::mt19937* random) {
+  uint8_t prand[3] = {(uint8_t)(*random)(), (uint8_t)(*random)(), (uint8_t)(0x40 | ((*random)() & 0x3f))};
+  crypto_toolbox::Octet16 hash = crypto_toolbox::aes_128(irk, prand, 3);
+  return AddressWithType(Address{{prand[2], prand[1], prand[0], hash[2], hash[1], hash[0]}},
+                         AddressType::RANDOM_DEVICE_ADDRESS);
+}
+
+// Half classic devices with a link key, half LE devices that distributed their identity, as seen by a phone that
+// has been around for a while
+class SecurityRecords {
+ public:
+  explicit SecurityRecords(int num_records) : random_(num_records) {
+    for (int i = 0; i < num_records; i++) {
+      Address address{{0x00, 0x11, (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i, 0x01}};
+      if (i % 2 == 0) {
+        AddressWithType pseudo_address(address, AddressType::PUBLIC_DEVICE_ADDRESS);
+        record::SecurityRecord& record = database_.FindOrCreate(pseudo_address);
+        record.SetLinkKey(RandomKey(), hci::KeyType::AUTHENTICATED_P256);
+        database_.MarkChanged(record);
+        pseudo_addresses_.push_back(pseudo_address);
+      } else {
+        crypto_toolbox::Octet16 irk = RandomKey();
+        AddressWithType pseudo_address = MakeRpa(irk, &random_);
+        record::SecurityRecord& record = database_.FindOrCreate(pseudo_address);
+        record.ltk = RandomKey();
+        record.ediv = i;
+        database_.SetIdentity(record, AddressWithType(address, AddressType::PUBLIC_IDENTITY_ADDRESS), irk);
+        pseudo_addresses_.push_back(pseudo_address);
+        irks_.push_back(irk);
+      }
+    }
+    database_.WriteChanges(&config_);
+  }
+
+  crypto_toolbox::Octet16 RandomKey() {
+    crypto_toolbox::Octet16 key;
+    for (uint8_t& byte : key) byte = random_();
+    return key;
+  }
+
+  std::mt19937 random_;
+  SecurityRecordDatabase database_;
+  config_t config_;
+  std::vector<AddressWithType> pseudo_addresses_;
+  std::vector<crypto_toolbox::Octet16> irks_;
+};
+
+// What Find() used to do: match every record in turn
+record::SecurityRecord* LinearFind(std::vector<record::SecurityRecord>& records, const AddressWithType& address) {
+  for (record::SecurityRecord& record : records) {
+    if (record.identity_address_.has_value() && record.identity_address_.value() == address) return &record;
+    if (record.GetPseudoAddress() == address) return &record;
+    if (record.irk.has_value() && address.IsRpaThatMatchesIrk(record.irk.value())) return &record;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+static void BM_FindByPseudoAddress(State& state) {
+  SecurityRecords records(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(records.database_.Find(records.pseudo_addresses_[i]));
+    i = (i + 1) % records.pseudo_addresses_.size();
+  }
+}
+BENCHMARK(BM_FindByPseudoAddress)->Arg(1000)->Arg(4000);
+
+static void BM_FindByPseudoAddressLinear(State& state) {
+  SecurityRecords records(state.range(0));
+  std::vector<record::SecurityRecord> linear;
+  for (const AddressWithType& address : records.pseudo_addresses_) {
+    linear.push_back(*records.database_.Find(address));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LinearFind(linear, records.pseudo_addresses_[i]));
+    i = (i + 1) % records.pseudo_addresses_.size();
+  }
+}
+BENCHMARK(BM_FindByPseudoAddressLinear)->Arg(1000)->Arg(4000);
+
+// A bonded LE device reconnecting with an RPA already resolved
+static void BM_FindByResolvedRpa(State& state) {
+  SecurityRecords records(state.range(0));
+  std::vector<AddressWithType> rpas;
+  for (size_t i = 0; i < 64; i++) rpas.push_back(MakeRpa(records.irks_[i * 7], &records.random_));
+  for (const AddressWithType& rpa : rpas) records.database_.Find(rpa);
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(records.database_.Find(rpas[i]));
+    i = (i + 1) % rpas.size();
+  }
+}
+BENCHMARK(BM_FindByResolvedRpa)->Arg(1000)->Arg(4000);
+
+// A device we never bonded with advertising with an RPA, the worst case: every IRK is tried
+static void BM_FindUnknownRpa(State& state) {
+  SecurityRecords records(state.range(0));
+  crypto_toolbox::Octet16 irk = records.RandomKey();
+  AddressWithType rpa = MakeRpa(irk, &records.random_);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(records.database_.Find(rpa));
+  }
+}
+BENCHMARK(BM_FindUnknownRpa)->Arg(1000)->Arg(4000);
+
+// Storing the keys of a device after pairing, with the other records unchanged or all rewritten
+static void BM_WriteChanges(State& state) {
+  SecurityRecords records(state.range(0));
+  bool write_all = state.range(1);
+  size_t i = 0;
+  for (auto _ : state) {
+    if (write_all) {
+      for (const AddressWithType& address : records.pseudo_addresses_) {
+        records.database_.MarkChanged(*records.database_.Find(address));
+      }
+    } else {
+      records.database_.MarkChanged(*records.database_.Find(records.pseudo_addresses_[i]));
+      i = (i + 1) % records.pseudo_addresses_.size();
+    }
+    benchmark::DoNotOptimize(records.database_.WriteChanges(&records.config_));
+  }
+}
+BENCHMARK(BM_WriteChanges)->ArgNames({"records", "all"})->Args({1000, 0})->Args({1000, 1})->Args({4000, 0});
+
+}  // namespace security
+}  // namespace bluetooth
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/crypto_worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace bluetooth {
+namespace security {
+namespace {
+
+using namespace std::chrono_literals;
+
+TEST(CryptoWorkerPoolTest, default_number_of_workers) {
+  CryptoWorkerPool pool;
+  EXPECT_GE(pool.GetNumWorkers(), 1u);
+  EXPECT_LE(pool.GetNumWorkers(), CryptoWorkerPool::kMaxWorkers);
+  EXPECT_EQ(CryptoWorkerPool(0).GetNumWorkers(), 1u);
+}
+
+TEST(CryptoWorkerPoolTest, post_returns_results) {
+  CryptoWorkerPool pool(3);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; i++) {
+    results.push_back(pool.Post([i]() { return i * i; }));
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(results[i].get(), i * i);
+  }
+
+  std::atomic<bool> ran(false);
+  pool.Post([&ran]() { ran = true; }).get();
+  EXPECT_TRUE(ran);
+}
+
+TEST(CryptoWorkerPoolTest, runs_at_most_num_workers_tasks_at_once) {
+  CryptoWorkerPool pool(2);
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  std::vector<std::future<void>> results;
+  for (int i = 0; i < 16; i++) {
+    results.push_back(pool.Post([&running, &max_running]() {
+      int now_running = ++running;
+      int max = max_running;
+      while (now_running > max && !max_running.compare_exchange_weak(max, now_running)) {
+      }
+      std::this_thread::sleep_for(1ms);
+      running--;
+    }));
+  }
+  for (std::future<void>& result : results) result.get();
+  EXPECT_GE(max_running, 1);
+  EXPECT_LE(max_running, 2);
+}
+
+}  // namespace
+}  // namespace security
+}  // namespace bluetooth
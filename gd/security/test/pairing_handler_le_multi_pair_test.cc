@@ -0,0 +1,269 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/testing/wired_pair_of_bidi_queues.h"
+#include "hci/le_security_interface.h"
+#include "security/crypto_worker_pool.h"
+#include "security/pairing_handler_le.h"
+#include "security/test/mocks.h"
+
+// run:
+// out/host/linux-x86/nativetest/bluetooth_test_gd/bluetooth_test_gd --gtest_filter=PairingHandlerMultiPairTest.*
+
+namespace bluetooth {
+namespace security {
+namespace {
+
+using hci::Address;
+using hci::AddressType;
+using hci::CommandStatusView;
+using hci::EncryptionChangeBuilder;
+using hci::EncryptionEnabled;
+using hci::ErrorCode;
+using hci::EventPacketBuilder;
+using hci::EventPacketView;
+using hci::LeSecurityCommandBuilder;
+using testing::_;
+using testing::InvokeWithoutArgs;
+using testing::Matcher;
+
+constexpr int kNumDevices = 16;
+
+EventPacketView EventBuilderToView(std::unique_ptr<EventPacketBuilder> builder) {
+  std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*packet_bytes);
+  builder->Serialize(it);
+  PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
+  auto temp_evt_view = EventPacketView::Create(packet_bytes_view);
+  return EventPacketView::Create(temp_evt_view);
+}
+
+/* A master pairing with a slave over their own L2CAP channel, with a fake HCI that reports the link encrypted as
+ * soon as the master starts the encryption. The slave accepts the pairing prompt right away. */
+class PairingCouple {
+ public:
+  PairingCouple(uint8_t index, os::Handler* handler, CryptoWorkerPool* crypto_worker_pool)
+      : handler_(handler), l2cap_(handler) {
+    // master sends it's packets into queue A, slave into queue B
+    l2cap_.GetQueueAUpEnd()->RegisterDequeue(
+        handler_, common::Bind(&PairingCouple::DequeueCallbackMaster, common::Unretained(this)));
+    l2cap_.GetQueueBUpEnd()->RegisterDequeue(
+        handler_, common::Bind(&PairingCouple::DequeueCallbackSlave, common::Unretained(this)));
+    up_buffer_a_ = std::make_unique<os::EnqueueBuffer<packet::BasePacketBuilder>>(l2cap_.GetQueueAUpEnd());
+    up_buffer_b_ = std::make_unique<os::EnqueueBuffer<packet::BasePacketBuilder>>(l2cap_.GetQueueBUpEnd());
+
+    hci::AddressWithType master_address{Address{{0x26, 0x64, 0x76, 0x86, 0xab, index}},
+                                        AddressType::RANDOM_DEVICE_ADDRESS};
+    hci::AddressWithType slave_address{Address{{0x33, 0x58, 0x24, 0x76, 0x11, index}},
+                                       AddressType::RANDOM_DEVICE_ADDRESS};
+    uint16_t master_connection_handle = 0x100 + index;
+    uint16_t slave_connection_handle = 0x200 + index;
+
+    master_setup_ = {
+        .my_role = hci::Role::MASTER,
+        .my_connection_address = master_address,
+        .myPairingCapabilities = {.io_capability = IoCapability::NO_INPUT_NO_OUTPUT,
+                                  .oob_data_flag = OobDataFlag::NOT_PRESENT,
+                                  .auth_req = AuthReqMaskBondingFlag | AuthReqMaskMitm | AuthReqMaskSc,
+                                  .maximum_encryption_key_size = 16,
+                                  .initiator_key_distribution = KeyMaskId | KeyMaskSign,
+                                  .responder_key_distribution = KeyMaskId | KeyMaskSign},
+        .remotely_initiated = false,
+        .connection_handle = master_connection_handle,
+        .remote_connection_address = slave_address,
+        .user_interface = &master_user_interface_,
+        .user_interface_handler = handler_,
+        .le_security_interface = &master_le_security_mock_,
+        .proper_l2cap_interface = up_buffer_a_.get(),
+        .l2cap_handler = handler_,
+        .crypto_worker_pool = crypto_worker_pool,
+        .OnPairingFinished = [this](PairingResultOrFailure result) { master_result_ = result; },
+    };
+
+    slave_setup_ = {
+        .my_role = hci::Role::SLAVE,
+        .my_connection_address = slave_address,
+        .myPairingCapabilities = {.io_capability = IoCapability::NO_INPUT_NO_OUTPUT,
+                                  .oob_data_flag = OobDataFlag::NOT_PRESENT,
+                                  .auth_req = AuthReqMaskBondingFlag | AuthReqMaskMitm | AuthReqMaskSc,
+                                  .maximum_encryption_key_size = 16,
+                                  .initiator_key_distribution = KeyMaskId | KeyMaskSign,
+                                  .responder_key_distribution = KeyMaskId | KeyMaskSign},
+        .remotely_initiated = true,
+        .connection_handle = slave_connection_handle,
+        .remote_connection_address = master_address,
+        .user_interface = &slave_user_interface_,
+        .user_interface_handler = handler_,
+        .le_security_interface = &slave_le_security_mock_,
+        .proper_l2cap_interface = up_buffer_b_.get(),
+        .l2cap_handler = handler_,
+        .crypto_worker_pool = crypto_worker_pool,
+        .OnPairingFinished = [this](PairingResultOrFailure result) { slave_result_ = result; },
+    };
+
+    EXPECT_CALL(slave_user_interface_, DisplayPairingPrompt(_, _)).Times(1).WillOnce(InvokeWithoutArgs([this] {
+      std::lock_guard<std::mutex> lock(handlers_guard_);
+      slave_->OnUiAction(PairingEvent::PAIRING_ACCEPTED, 0x01 /* Non-zero value means success */);
+    }));
+
+    EXPECT_CALL(master_le_security_mock_,
+                EnqueueCommand(_, Matcher<common::OnceCallback<void(CommandStatusView)>>(_), _))
+        .Times(1)
+        .WillOnce([this, master_connection_handle, slave_connection_handle](
+                      std::unique_ptr<LeSecurityCommandBuilder> command,
+                      common::OnceCallback<void(CommandStatusView)> on_status, os::Handler* handler) {
+          std::lock_guard<std::mutex> lock(handlers_guard_);
+          master_->OnHciEvent(EventBuilderToView(
+              EncryptionChangeBuilder::Create(ErrorCode::SUCCESS, master_connection_handle, EncryptionEnabled::ON)));
+          slave_->OnHciEvent(EventBuilderToView(
+              EncryptionChangeBuilder::Create(ErrorCode::SUCCESS, slave_connection_handle, EncryptionEnabled::ON)));
+        });
+  }
+
+  ~PairingCouple() {
+    master_.reset();
+    slave_.reset();
+    l2cap_.GetQueueAUpEnd()->UnregisterDequeue();
+    l2cap_.GetQueueBUpEnd()->UnregisterDequeue();
+  }
+
+  void StartPairing() {
+    std::lock_guard<std::mutex> lock(handlers_guard_);
+    master_ = std::make_unique<PairingHandlerLe>(PairingHandlerLe::PHASE1, master_setup_);
+  }
+
+  void WaitUntilPairingFinished() {
+    // The master finishes after the slave sent its last keys, the slave exists by then
+    master_->WaitUntilPairingFinished();
+    PairingHandlerLe* slave;
+    {
+      std::lock_guard<std::mutex> lock(handlers_guard_);
+      slave = slave_.get();
+    }
+    ASSERT_NE(slave, nullptr);
+    slave->WaitUntilPairingFinished();
+  }
+
+  bool Succeeded() const {
+    return master_result_.has_value() && std::holds_alternative<PairingResult>(*master_result_) &&
+           slave_result_.has_value() && std::holds_alternative<PairingResult>(*slave_result_);
+  }
+
+ private:
+  void DequeueCallbackMaster() {
+    auto packet_bytes_view = l2cap_.GetQueueAUpEnd()->TryDequeue();
+    if (!packet_bytes_view) LOG_ERROR("Received dequeue, but no data ready...");
+
+    std::lock_guard<std::mutex> lock(handlers_guard_);
+    master_->OnCommandView(CommandView::Create(*packet_bytes_view));
+  }
+
+  void DequeueCallbackSlave() {
+    auto packet_bytes_view = l2cap_.GetQueueBUpEnd()->TryDequeue();
+    if (!packet_bytes_view) LOG_ERROR("Received dequeue, but no data ready...");
+
+    CommandView command = CommandView::Create(*packet_bytes_view);
+    std::lock_guard<std::mutex> lock(handlers_guard_);
+    if (!slave_) {
+      // The pairing request from the master is what starts the pairing on the slave side
+      slave_setup_.pairing_request = PairingRequestView::Create(command);
+      slave_ = std::make_unique<PairingHandlerLe>(PairingHandlerLe::PHASE1, slave_setup_);
+      return;
+    }
+    slave_->OnCommandView(command);
+  }
+
+  os::Handler* handler_;
+  common::testing::WiredPairOfL2capQueues l2cap_;
+  std::unique_ptr<os::EnqueueBuffer<packet::BasePacketBuilder>> up_buffer_a_;
+  std::unique_ptr<os::EnqueueBuffer<packet::BasePacketBuilder>> up_buffer_b_;
+
+  UIMock master_user_interface_;
+  UIMock slave_user_interface_;
+  LeSecurityInterfaceMock master_le_security_mock_;
+  LeSecurityInterfaceMock slave_le_security_mock_;
+
+  InitialInformations master_setup_;
+  InitialInformations slave_setup_;
+  std::optional<PairingResultOrFailure> master_result_;
+  std::optional<PairingResultOrFailure> slave_result_;
+
+  // Guards the handlers, created on the test thread and the L2CAP handler and used from the pairing threads
+  std::mutex handlers_guard_;
+  std::unique_ptr<PairingHandlerLe> master_;
+  std::unique_ptr<PairingHandlerLe> slave_;
+};
+
+class PairingHandlerMultiPairTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+  }
+
+  void TearDown() override {
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+  }
+
+  /* Pairs kNumDevices couples at once, and returns how long it took for all of them to finish */
+  std::chrono::milliseconds PairAll(CryptoWorkerPool* crypto_worker_pool) {
+    std::vector<std::unique_ptr<PairingCouple>> couples;
+    for (int i = 0; i < kNumDevices; i++) {
+      couples.push_back(std::make_unique<PairingCouple>(i, handler_, crypto_worker_pool));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& couple : couples) couple->StartPairing();
+    for (auto& couple : couples) couple->WaitUntilPairingFinished();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    for (int i = 0; i < kNumDevices; i++) {
+      EXPECT_TRUE(couples[i]->Succeeded()) << "couple " << i;
+    }
+    return elapsed;
+  }
+
+  os::Thread* thread_;
+  os::Handler* handler_;
+};
+
+TEST_F(PairingHandlerMultiPairTest, pair_sixteen_devices_with_crypto_worker_pool) {
+  CryptoWorkerPool crypto_worker_pool;
+  std::chrono::milliseconds elapsed = PairAll(&crypto_worker_pool);
+  LOG_INFO("Paired %d devices in %lld ms with %zu crypto workers", kNumDevices, (long long)elapsed.count(),
+           crypto_worker_pool.GetNumWorkers());
+  RecordProperty("pairing_time_ms", elapsed.count());
+}
+
+TEST_F(PairingHandlerMultiPairTest, pair_sixteen_devices_on_pairing_threads) {
+  std::chrono::milliseconds elapsed = PairAll(nullptr);
+  LOG_INFO("Paired %d devices in %lld ms on the pairing threads", kNumDevices, (long long)elapsed.count());
+  RecordProperty("pairing_time_ms", elapsed.count());
+}
+
+}  // namespace
+}  // namespace security
+}  // namespace bluetooth
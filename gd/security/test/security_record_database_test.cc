@@ -0,0 +1,210 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/security_record_database.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace security {
+namespace {
+
+using hci::Address;
+using hci::AddressType;
+using hci::AddressWithType;
+
+const AddressWithType kPublic1{Address{{0x00, 0x11, 0x22, 0x33, 0x44, 0x55}}, AddressType::PUBLIC_DEVICE_ADDRESS};
+const AddressWithType kPublic2{Address{{0x00, 0x11, 0x22, 0x33, 0x44, 0x66}}, AddressType::PUBLIC_DEVICE_ADDRESS};
+const AddressWithType kIdentity{Address{{0xc0, 0x11, 0x22, 0x33, 0x44, 0x77}}, AddressType::RANDOM_IDENTITY_ADDRESS};
+const crypto_toolbox::Octet16 kIrk{0x90, 0x5e, 0x60, 0x59, 0xc9, 0x11, 0x43, 0x7b,
+                                   0x04, 0x09, 0x6a, 0x53, 0x28, 0xe6, 0x59, 0x6d};
+const crypto_toolbox::Octet16 kOtherIrk{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                                        0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+const std::array<uint8_t, 16> kLinkKey{0x4c, 0x68, 0x38, 0x41, 0x39, 0xf5, 0x74, 0xd8,
+                                       0x36, 0xbc, 0xf3, 0x4e, 0x9d, 0xfb, 0x01, 0xbf};
+
+// Resolvable private address generated from irk, as a device would
+AddressWithType MakeRpa(const crypto_toolbox::Octet16& irk, uint8_t seed) {
+  uint8_t prand[3] = {seed, 0x22, 0x40 | (seed & 0x3f)};
+  crypto_toolbox::Octet16 hash = crypto_toolbox::aes_128(irk, prand, 3);
+  return AddressWithType(Address{{prand[2], prand[1], prand[0], hash[2], hash[1], hash[0]}},
+                         AddressType::RANDOM_DEVICE_ADDRESS);
+}
+
+const section_t* FindSection(const config_t& config, const AddressWithType& address) {
+  for (const section_t& section : config.sections) {
+    if (section.name == address.GetAddress().ToString()) return &section;
+  }
+  return nullptr;
+}
+
+TEST(SecurityRecordDatabaseTest, find_or_create_returns_same_record) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& record = database.FindOrCreate(kPublic1);
+  EXPECT_EQ(&record, &database.FindOrCreate(kPublic1));
+  EXPECT_EQ(&record, database.Find(kPublic1));
+  EXPECT_NE(&record, &database.FindOrCreate(kPublic2));
+  EXPECT_EQ(database.Size(), 2u);
+}
+
+TEST(SecurityRecordDatabaseTest, references_stay_valid) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& record = database.FindOrCreate(kPublic1);
+  for (uint8_t i = 0; i < 100; i++) {
+    database.FindOrCreate(
+        AddressWithType(Address{{0x00, 0x00, 0x00, 0x00, 0x01, i}}, AddressType::PUBLIC_DEVICE_ADDRESS));
+  }
+  EXPECT_EQ(record.GetPseudoAddress(), kPublic1);
+  EXPECT_EQ(&record, database.Find(kPublic1));
+}
+
+TEST(SecurityRecordDatabaseTest, find_by_identity_and_rpa) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& record = database.FindOrCreate(MakeRpa(kIrk, 1));
+  database.SetIdentity(record, kIdentity, kIrk);
+
+  EXPECT_EQ(database.Find(kIdentity), &record);
+  EXPECT_EQ(database.Find(MakeRpa(kIrk, 2)), &record);
+  // Resolved once, then found in the cache
+  EXPECT_EQ(database.Find(MakeRpa(kIrk, 2)), &record);
+  EXPECT_EQ(database.Find(MakeRpa(kOtherIrk, 2)), nullptr);
+  EXPECT_EQ(&database.FindOrCreate(MakeRpa(kIrk, 3)), &record);
+  EXPECT_EQ(database.Size(), 1u);
+}
+
+TEST(SecurityRecordDatabaseTest, identity_found_before_pseudo_address) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& pseudo = database.FindOrCreate(kIdentity);
+  record::SecurityRecord& record = database.FindOrCreate(kPublic1);
+  database.SetIdentity(record, kIdentity, kIrk);
+
+  EXPECT_EQ(database.Find(kIdentity), &record);
+  database.Remove(kPublic1);
+  EXPECT_EQ(database.Find(kIdentity), &pseudo);
+}
+
+TEST(SecurityRecordDatabaseTest, remove_by_any_address) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& record = database.FindOrCreate(kPublic1);
+  database.SetIdentity(record, kIdentity, kIrk);
+  AddressWithType rpa = MakeRpa(kIrk, 4);
+  ASSERT_EQ(database.Find(rpa), &record);
+
+  database.Remove(rpa);
+  EXPECT_EQ(database.Size(), 0u);
+  EXPECT_EQ(database.Find(kPublic1), nullptr);
+  EXPECT_EQ(database.Find(kIdentity), nullptr);
+  EXPECT_EQ(database.Find(rpa), nullptr);
+}
+
+TEST(SecurityRecordDatabaseTest, new_identity_replaces_old_one) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& record = database.FindOrCreate(kPublic1);
+  database.SetIdentity(record, kIdentity, kIrk);
+  AddressWithType rpa = MakeRpa(kIrk, 5);
+  ASSERT_EQ(database.Find(rpa), &record);
+
+  AddressWithType new_identity(Address{{0x00, 0x11, 0x22, 0x33, 0x44, 0x88}}, AddressType::PUBLIC_IDENTITY_ADDRESS);
+  database.SetIdentity(record, new_identity, kOtherIrk);
+  EXPECT_EQ(database.Find(kIdentity), nullptr);
+  EXPECT_EQ(database.Find(rpa), nullptr);
+  EXPECT_EQ(database.Find(new_identity), &record);
+  EXPECT_EQ(database.Find(MakeRpa(kOtherIrk, 5)), &record);
+}
+
+TEST(SecurityRecordDatabaseTest, write_and_load) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& classic = database.FindOrCreate(kPublic1);
+  classic.SetLinkKey(kLinkKey, hci::KeyType::AUTHENTICATED_P256);
+  database.MarkChanged(classic);
+  record::SecurityRecord& le = database.FindOrCreate(MakeRpa(kIrk, 6));
+  le.ltk = kOtherIrk;
+  le.ediv = 0x1234;
+  le.rand = {1, 2, 3, 4, 5, 6, 7, 8};
+  database.SetIdentity(le, kIdentity, kIrk);
+  // Seen, but nothing to store
+  database.MarkChanged(database.FindOrCreate(kPublic2));
+
+  config_t config;
+  EXPECT_EQ(database.WriteChanges(&config), 3u);
+  EXPECT_EQ(config.sections.size(), 2u);
+  EXPECT_EQ(database.WriteChanges(&config), 0u);
+
+  SecurityRecordDatabase loaded;
+  loaded.Load(config);
+  ASSERT_EQ(loaded.Size(), 2u);
+  record::SecurityRecord* loaded_classic = loaded.Find(kPublic1);
+  ASSERT_NE(loaded_classic, nullptr);
+  EXPECT_TRUE(loaded_classic->IsBonded());
+  EXPECT_FALSE(loaded_classic->IsPairing());
+  EXPECT_EQ(loaded_classic->GetLinkKey(), kLinkKey);
+  EXPECT_EQ(loaded_classic->GetKeyType(), hci::KeyType::AUTHENTICATED_P256);
+
+  record::SecurityRecord* loaded_le = loaded.Find(MakeRpa(kIrk, 7));
+  ASSERT_NE(loaded_le, nullptr);
+  EXPECT_EQ(loaded.Find(kIdentity), loaded_le);
+  EXPECT_EQ(loaded_le->GetPseudoAddress(), MakeRpa(kIrk, 6));
+  EXPECT_EQ(loaded_le->ltk, std::optional(kOtherIrk));
+  EXPECT_EQ(loaded_le->ediv, std::optional<uint16_t>(0x1234));
+  EXPECT_EQ(loaded_le->rand, (std::optional<std::array<uint8_t, 8>>({1, 2, 3, 4, 5, 6, 7, 8})));
+  EXPECT_FALSE(loaded_le->signature_key.has_value());
+  EXPECT_EQ(loaded.WriteChanges(&config), 0u);
+}
+
+TEST(SecurityRecordDatabaseTest, write_changes_only_touches_changed_records) {
+  SecurityRecordDatabase database;
+  record::SecurityRecord& record_1 = database.FindOrCreate(kPublic1);
+  record_1.SetLinkKey(kLinkKey, hci::KeyType::COMBINATION);
+  database.MarkChanged(record_1);
+  record::SecurityRecord& record_2 = database.FindOrCreate(kPublic2);
+  record_2.SetLinkKey(kLinkKey, hci::KeyType::COMBINATION);
+  database.MarkChanged(record_2);
+
+  // Other modules store their own keys in the device sections, the legacy stack its own bond
+  config_t config;
+  config.sections.push_back(section_t{.name = "Adapter", .entries = {{"Address", "00:00:00:00:00:01"}}});
+  config.sections.push_back(section_t{.name = kPublic2.GetAddress().ToString(),
+                                      .entries = {{"Name", "Headset"}, {"LinkKey", "legacy bond"}}});
+  ASSERT_EQ(database.WriteChanges(&config), 2u);
+
+  // Edits of the file made behind our back are kept, unless the record changes
+  section_t* section_1 = const_cast<section_t*>(FindSection(config, kPublic1));
+  section_t* section_2 = const_cast<section_t*>(FindSection(config, kPublic2));
+  section_1->entries.push_back({"SecurityLeIrk", "not written by the database"});
+  section_2->entries.push_back({"SecurityLeIrk", "not written by the database"});
+  record_1.SetLinkKey(kLinkKey, hci::KeyType::AUTHENTICATED_P192);
+  database.MarkChanged(record_1);
+  ASSERT_EQ(database.WriteChanges(&config), 1u);
+  section_1 = const_cast<section_t*>(FindSection(config, kPublic1));
+  ASSERT_NE(section_1, nullptr);
+  EXPECT_EQ(section_1->entries.back().key, "SecurityLinkKeyType");
+  EXPECT_EQ(section_2->entries.back().key, "SecurityLeIrk");
+
+  database.Remove(kPublic1);
+  database.Remove(kPublic2);
+  ASSERT_EQ(database.WriteChanges(&config), 2u);
+  EXPECT_EQ(FindSection(config, kPublic1), nullptr);
+  const section_t* remaining = FindSection(config, kPublic2);
+  ASSERT_NE(remaining, nullptr);
+  ASSERT_EQ(remaining->entries.size(), 2u);
+  EXPECT_EQ(remaining->entries.front().key, "Name");
+  EXPECT_EQ(remaining->entries.back().key, "LinkKey");
+  EXPECT_EQ(config.sections.front().name, "Adapter");
+}
+
+}  // namespace
+}  // namespace security
+}  // namespace bluetooth
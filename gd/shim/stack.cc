@@ -42,6 +42,11 @@
 
 using ::bluetooth::os::Thread;
 
+namespace {
+// Number of threads used to start independent gd modules concurrently
+constexpr size_t kNumModuleStartWorkers = 4;
+}  // namespace
+
 struct bluetooth::shim::Stack::impl {
   void Start() {
     if (is_running_) {
@@ -72,7 +77,9 @@ struct bluetooth::shim::Stack::impl {
     modules.add<::bluetooth::shim::L2cap>();
 
     stack_thread_ = new Thread("gd_stack_thread", Thread::Priority::NORMAL);
-    stack_manager_.StartUp(&modules, stack_thread_);
+    stack_manager_.StartUp(&modules, stack_thread_, kNumModuleStartWorkers);
+    stack_manager_.GetInstance<::bluetooth::shim::Dumpsys>()->RegisterDumpsysFunction(
+        static_cast<void*>(this), [this](int fd) { stack_manager_.DumpStartupTimeline(fd); });
     // TODO(cmanton) Gd stack has spun up another thread with no
     // ability to ascertain the completion
     is_running_ = true;
@@ -85,6 +92,7 @@ struct bluetooth::shim::Stack::impl {
       return;
     }
 
+    stack_manager_.GetInstance<::bluetooth::shim::Dumpsys>()->UnregisterDumpsysFunction(static_cast<void*>(this));
     stack_manager_.ShutDown();
     delete stack_thread_;
     is_running_ = false;
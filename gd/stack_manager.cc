@@ -32,14 +32,14 @@ using ::bluetooth::os::Thread;
 
 namespace bluetooth {
 
-void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
+void StackManager::StartUp(ModuleList* modules, Thread* stack_thread, size_t num_start_workers) {
   management_thread_ = new Thread("management_thread", Thread::Priority::NORMAL);
   handler_ = new Handler(management_thread_);
 
   std::promise<void> promise;
   auto future = promise.get_future();
   handler_->Post(common::BindOnce(&StackManager::handle_start_up, common::Unretained(this), modules, stack_thread,
-                                  std::move(promise)));
+                                  num_start_workers, std::move(promise)));
 
   auto init_status = future.wait_for(std::chrono::seconds(3));
   ASSERT_LOG(init_status == std::future_status::ready, "Can't start stack");
@@ -47,8 +47,9 @@ void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
   LOG_INFO("init complete");
 }
 
-void StackManager::handle_start_up(ModuleList* modules, Thread* stack_thread, std::promise<void> promise) {
-  registry_.Start(modules, stack_thread);
+void StackManager::handle_start_up(ModuleList* modules, Thread* stack_thread, size_t num_start_workers,
+                                   std::promise<void> promise) {
+  registry_.Start(modules, stack_thread, num_start_workers);
   promise.set_value();
 }
 
@@ -66,6 +67,10 @@ void StackManager::ShutDown() {
   delete management_thread_;
 }
 
+void StackManager::DumpStartupTimeline(int fd) const {
+  registry_.DumpTimeline(fd);
+}
+
 void StackManager::handle_shut_down(std::promise<void> promise) {
   registry_.StopAll();
   promise.set_value();
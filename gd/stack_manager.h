@@ -24,9 +24,14 @@ namespace bluetooth {
 
 class StackManager {
  public:
-  void StartUp(ModuleList *modules, os::Thread* stack_thread);
+  // Start |modules| on |stack_thread|. With |num_start_workers| > 1, modules whose dependencies
+  // are already up are started concurrently instead of one at a time in list order.
+  void StartUp(ModuleList* modules, os::Thread* stack_thread, size_t num_start_workers = 1);
   void ShutDown();
 
+  // Print per module start/stop timings of the last start up to |fd|
+  void DumpStartupTimeline(int fd) const;
+
   template <class T>
   T* GetInstance() const {
     return static_cast<T*>(registry_.Get(&T::Factory));
@@ -37,7 +42,8 @@ class StackManager {
   os::Handler* handler_ = nullptr;
   ModuleRegistry registry_;
 
-  void handle_start_up(ModuleList* modules, os::Thread* stack_thread, std::promise<void> promise);
+  void handle_start_up(ModuleList* modules, os::Thread* stack_thread, size_t num_start_workers,
+                       std::promise<void> promise);
   void handle_shut_down(std::promise<void> promise);
 };
 
@@ -0,0 +1,40 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+
+#include "bt_types.h"
+
+// Largest command, preamble included, served from the pool.
+#define COMMAND_BUFFER_POOL_MAX_SIZE 64
+
+// Number of pooled buffers. Commands queued while waiting for command
+// credits hold on to their buffer, so this covers bursts of commands.
+#define COMMAND_BUFFER_POOL_COUNT 64
+
+// Returns a buffer for an HCI command of |size| bytes, BT_HDR not included.
+// Commands of up to COMMAND_BUFFER_POOL_MAX_SIZE bytes are served from a set
+// of preallocated buffers. Larger commands, or all of them once the pool is
+// exhausted, are allocated with osi_malloc().
+BT_HDR* command_buffer_alloc(size_t size);
+
+// Releases |buffer|, which is either a pooled buffer or was allocated with
+// osi_malloc(). Every HCI command buffer must be released this way.
+void command_buffer_free(BT_HDR* buffer);
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "command_buffer_pool.h"
+
+#include <stdint.h>
+
+#include <mutex>
+
+#include "osi/include/allocator.h"
+
+namespace {
+
+constexpr size_t kBufferSize = BT_HDR_SIZE + COMMAND_BUFFER_POOL_MAX_SIZE;
+static_assert(kBufferSize % alignof(void*) == 0,
+              "pooled buffers must stay aligned");
+
+// Commands are built on the main thread, and freed either there or on the
+// HCI thread once the controller answered.
+class CommandBufferPool {
+ public:
+  CommandBufferPool() : free_count_(COMMAND_BUFFER_POOL_COUNT) {
+    for (size_t i = 0; i < COMMAND_BUFFER_POOL_COUNT; i++) {
+      free_[i] = buffers_[i];
+    }
+  }
+
+  BT_HDR* Alloc() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_count_ == 0) return nullptr;
+    return reinterpret_cast<BT_HDR*>(free_[--free_count_]);
+  }
+
+  bool Owns(const BT_HDR* buffer) const {
+    uintptr_t address = reinterpret_cast<uintptr_t>(buffer);
+    uintptr_t first = reinterpret_cast<uintptr_t>(buffers_);
+    return address >= first && address < first + sizeof(buffers_);
+  }
+
+  void Free(BT_HDR* buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_[free_count_++] = reinterpret_cast<uint8_t*>(buffer);
+  }
+
+ private:
+  std::mutex mutex_;
+  alignas(void*) uint8_t buffers_[COMMAND_BUFFER_POOL_COUNT][kBufferSize];
+  uint8_t* free_[COMMAND_BUFFER_POOL_COUNT];
+  size_t free_count_;
+};
+
+CommandBufferPool& pool() {
+  static CommandBufferPool* pool = new CommandBufferPool();
+  return *pool;
+}
+
+}  // namespace
+
+BT_HDR* command_buffer_alloc(size_t size) {
+  if (size <= COMMAND_BUFFER_POOL_MAX_SIZE) {
+    BT_HDR* buffer = pool().Alloc();
+    if (buffer != nullptr) return buffer;
+  }
+  return static_cast<BT_HDR*>(osi_malloc(BT_HDR_SIZE + size));
+}
+
+void command_buffer_free(BT_HDR* buffer) {
+  if (buffer != nullptr && pool().Owns(buffer)) {
+    pool().Free(buffer);
+    return;
+  }
+  osi_free(buffer);
+}
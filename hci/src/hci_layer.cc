@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <chrono>
 #include <mutex>
 
@@ -39,6 +40,8 @@
 #include "btif/include/btif_bqr.h"
 #include "btsnoop.h"
 #include "buffer_allocator.h"
+#include "command_buffer_pool.h"
+#include "common/latency_tracer.h"
 #include "common/message_loop_thread.h"
 #include "common/metrics.h"
 #include "common/once_timer.h"
@@ -56,6 +59,7 @@
 
 #define BT_HCI_TIMEOUT_TAG_NUM 1010000
 
+using bluetooth::common::LatencyTracer;
 using bluetooth::common::MessageLoopThread;
 using bluetooth::common::OnceTimer;
 
@@ -92,6 +96,10 @@ static const uint32_t ROOT_INFLAMMED_RESTART_MS = 5000;
 static const int HCI_UNKNOWN_COMMAND_TIMED_OUT = 0x00ffffff;
 static const int HCI_STARTUP_TIMED_OUT = 0x00eeeeee;
 
+// Number of commands after HCI start up whose round trip time is recorded in
+// the startup timeline. Covers the controller start up sequence.
+static const int STARTUP_COMMANDS_TO_RECORD = 64;
+
 // Our interface
 static bool interface_created;
 static hci_t interface;
@@ -103,6 +111,7 @@ static const packet_fragmenter_t* packet_fragmenter;
 
 static future_t* startup_future;
 static MessageLoopThread hci_thread("bt_hci_thread");
+static std::atomic_int startup_commands_to_record;
 
 static alarm_t* startup_timer;
 
@@ -125,6 +134,7 @@ static uint8_t root_inflamed_vendor_error_code = 0;
 static base::Callback<void(const base::Location&, BT_HDR*)> send_data_upwards;
 
 static bool filter_incoming_event(BT_HDR* packet);
+static void record_startup_command(const waiting_command_t* wait_entry);
 static waiting_command_t* get_waiting_command(command_opcode_t opcode);
 static int get_num_waiting_commands();
 
@@ -164,8 +174,11 @@ void hci_event_received(const base::Location& from_here, BT_HDR* packet) {
 }
 
 void acl_event_received(BT_HDR* packet) {
+  LatencyTracer::Begin(LatencyTracer::HCI_RX);
   btsnoop->capture(packet, true);
   packet_fragmenter->reassemble_and_dispatch(packet);
+  // Drops the trace of a fragment held back for reassembly
+  LatencyTracer::End();
 }
 
 void sco_data_received(BT_HDR* packet) {
@@ -202,6 +215,7 @@ static future_t* hci_module_start_up(void) {
   // This value can change when you get a command complete or command status
   // event.
   command_credits = 1;
+  startup_commands_to_record = STARTUP_COMMANDS_TO_RECORD;
 
   // For now, always use the default timeout on non-Android builds.
   uint64_t startup_timeout_ms = DEFAULT_STARTUP_TIMEOUT_MS;
@@ -397,7 +411,7 @@ static void enqueue_command(waiting_command_t* wait_entry) {
   if (command_credits > 0) {
     if (!hci_thread.DoInThread(FROM_HERE, std::move(callback))) {
       // HCI Layer was shut down or not running
-      buffer_allocator->free(wait_entry->command);
+      command_buffer_free(wait_entry->command);
       osi_free(wait_entry);
       return;
     }
@@ -662,6 +676,7 @@ static bool filter_incoming_event(BT_HDR* packet) {
       }
     } else {
       update_command_response_timer();
+      record_startup_command(wait_entry);
       if (wait_entry->complete_callback) {
         wait_entry->complete_callback(packet, wait_entry->context);
       } else if (wait_entry->complete_future) {
@@ -692,6 +707,7 @@ static bool filter_incoming_event(BT_HDR* packet) {
           __func__, opcode);
     } else {
       update_command_response_timer();
+      record_startup_command(wait_entry);
       if (wait_entry->status_callback)
         wait_entry->status_callback(status, wait_entry->command,
                                     wait_entry->context);
@@ -733,7 +749,7 @@ intercepted:
 
     // If it has a callback, it's responsible for freeing the command
     if (event_code == HCI_COMMAND_COMPLETE_EVT || !wait_entry->status_callback)
-      buffer_allocator->free(wait_entry->command);
+      command_buffer_free(wait_entry->command);
 
     osi_free(wait_entry);
   } else {
@@ -749,11 +765,22 @@ static void dispatch_reassembled(BT_HDR* packet) {
   CHECK((packet->event & MSG_EVT_MASK) != MSG_HC_TO_STACK_HCI_EVT);
   CHECK(!send_data_upwards.is_null());
 
+  LatencyTracer::Park(packet);
   send_data_upwards.Run(FROM_HERE, packet);
 }
 
 // Misc internal functions
 
+static void record_startup_command(const waiting_command_t* wait_entry) {
+  if (startup_commands_to_record <= 0) return;
+  startup_commands_to_record--;
+
+  char name[16];
+  snprintf(name, sizeof(name), "0x%04x", wait_entry->opcode);
+  module_timeline_record(name, "hci_cmd", wait_entry->timestamp,
+                         std::chrono::steady_clock::now());
+}
+
 static waiting_command_t* get_waiting_command(command_opcode_t opcode) {
   std::lock_guard<std::recursive_timed_mutex> lock(
       commands_pending_response_mutex);
@@ -32,6 +32,7 @@
 
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "buffer_allocator.h"
 #include "hci_internals.h"
@@ -106,48 +107,73 @@ static int rfkill(int block);
 int reader_thread_ctrl_fd = -1;
 Thread* reader_thread = NULL;
 
+// Largest packet the user channel hands us, without its packet type byte
+#define HCI_USER_CHANNEL_MAX_PACKET_SIZE 2000
+
+/* Reads one packet from the user channel: the packet type goes to |type| and
+ * the rest straight into |packet|, which avoids a bounce buffer. */
+static ssize_t read_packet(int fd, uint8_t* type, BT_HDR* packet) {
+  struct iovec iov[2];
+  iov[0].iov_base = type;
+  iov[0].iov_len = 1;
+  iov[1].iov_base = packet->data;
+  iov[1].iov_len = HCI_USER_CHANNEL_MAX_PACKET_SIZE;
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+
+  ssize_t len;
+  OSI_NO_INTR(len = recvmsg(fd, &msg, MSG_DONTWAIT));
+  if (len > 0 && (msg.msg_flags & MSG_TRUNC))
+    LOG(FATAL) << "This packet did not fit in the buffer, increase "
+                  "HCI_USER_CHANNEL_MAX_PACKET_SIZE!";
+  return len;
+}
+
+static void dispatch_packet(uint8_t type, BT_HDR* packet) {
+  switch (type) {
+    case HCI_PACKET_TYPE_COMMAND:
+      packet->event = MSG_HC_TO_STACK_HCI_EVT;
+      hci_event_received(FROM_HERE, packet);
+      break;
+    case HCI_PACKET_TYPE_ACL_DATA:
+      packet->event = MSG_HC_TO_STACK_HCI_ACL;
+      acl_event_received(packet);
+      break;
+    case HCI_PACKET_TYPE_SCO_DATA:
+      packet->event = MSG_HC_TO_STACK_HCI_SCO;
+      sco_data_received(packet);
+      break;
+    case HCI_PACKET_TYPE_EVENT:
+      packet->event = MSG_HC_TO_STACK_HCI_EVT;
+      hci_event_received(FROM_HERE, packet);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected event type: " << +type;
+      break;
+  }
+}
+
 void monitor_socket(int ctrl_fd, int fd) {
   const allocator_t* buffer_allocator = buffer_allocator_get_interface();
-  const size_t buf_size = 2000;
-  uint8_t buf[buf_size];
-  ssize_t len = read(fd, buf, buf_size);
-
-  while (len > 0) {
-    if (len == buf_size)
-      LOG(FATAL) << "This packet filled buffer, if it have continuation we "
-                    "don't know how to merge it, increase buffer size!";
-
-    uint8_t type = buf[0];
-
-    size_t packet_size = buf_size + BT_HDR_SIZE;
-    BT_HDR* packet =
-        reinterpret_cast<BT_HDR*>(buffer_allocator->alloc(packet_size));
-    packet->offset = 0;
-    packet->layer_specific = 0;
-    packet->len = len - 1;
-    memcpy(packet->data, buf + 1, len - 1);
-
-    switch (type) {
-      case HCI_PACKET_TYPE_COMMAND:
-        packet->event = MSG_HC_TO_STACK_HCI_EVT;
-        hci_event_received(FROM_HERE, packet);
-        break;
-      case HCI_PACKET_TYPE_ACL_DATA:
-        packet->event = MSG_HC_TO_STACK_HCI_ACL;
-        acl_event_received(packet);
-        break;
-      case HCI_PACKET_TYPE_SCO_DATA:
-        packet->event = MSG_HC_TO_STACK_HCI_SCO;
-        sco_data_received(packet);
-        break;
-      case HCI_PACKET_TYPE_EVENT:
-        packet->event = MSG_HC_TO_STACK_HCI_EVT;
-        hci_event_received(FROM_HERE, packet);
-        break;
-      default:
-        LOG(FATAL) << "Unexpected event type: " << +type;
-        break;
+  const size_t packet_size = HCI_USER_CHANNEL_MAX_PACKET_SIZE + BT_HDR_SIZE;
+  BT_HDR* packet =
+      reinterpret_cast<BT_HDR*>(buffer_allocator->alloc(packet_size));
+
+  while (true) {
+    // Hand up every packet already queued on the socket before sleeping again
+    uint8_t type;
+    ssize_t len;
+    while ((len = read_packet(fd, &type, packet)) > 0) {
+      packet->offset = 0;
+      packet->layer_specific = 0;
+      packet->len = len - 1;
+      dispatch_packet(type, packet);
+      packet = reinterpret_cast<BT_HDR*>(buffer_allocator->alloc(packet_size));
     }
+    if (len == 0 || errno != EAGAIN) break;
 
     fd_set fds;
     FD_ZERO(&fds);
@@ -158,11 +184,11 @@ void monitor_socket(int ctrl_fd, int fd) {
 
     if (FD_ISSET(ctrl_fd, &fds)) {
       LOG(INFO) << "exitting";
-      return;
+      break;
     }
-
-    len = read(fd, buf, buf_size);
   }
+
+  buffer_allocator->free(packet);
 }
 
 /* TODO: should thread the device waiting and return immedialty */
@@ -265,16 +291,20 @@ void hci_transmit(BT_HDR* packet) {
       break;
   }
 
-  uint8_t* addr = packet->data + packet->offset - 1;
-  uint8_t store = *addr;
-  *addr = type;
-  size_t ret = write(bt_vendor_fd, addr, packet->len + 1);
-
-  *(addr) = store;
+  // The user channel takes one packet per write, so the type byte goes in
+  // its own iovec instead of being patched in front of the payload
+  struct iovec iov[2];
+  iov[0].iov_base = &type;
+  iov[0].iov_len = 1;
+  iov[1].iov_base = packet->data + packet->offset;
+  iov[1].iov_len = packet->len;
 
-  if (ret != packet->len + 1) LOG(ERROR) << "Should have send whole packet";
+  ssize_t ret;
+  OSI_NO_INTR(ret = writev(bt_vendor_fd, iov, 2));
 
   if (ret == -1) PLOG(FATAL) << "write failed";
+
+  if (ret != packet->len + 1) LOG(ERROR) << "Should have send whole packet";
 }
 
 static int wait_hcidev(void) {
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <set>
+#include <vector>
+
+#include "command_buffer_pool.h"
+#include "osi/include/allocator.h"
+#include "osi/test/AllocationTestHarness.h"
+
+class CommandBufferPoolTest : public AllocationTestHarness {};
+
+// Fills the whole buffer, for the sanitizers to catch a buffer too small
+static void fill(BT_HDR* buffer, size_t size) {
+  buffer->offset = 0;
+  buffer->len = size;
+  memset(buffer->data, 0x5a, size);
+}
+
+TEST_F(CommandBufferPoolTest, test_pooled_buffers_are_reused) {
+  BT_HDR* buffer = command_buffer_alloc(COMMAND_BUFFER_POOL_MAX_SIZE);
+  ASSERT_NE(buffer, nullptr);
+  fill(buffer, COMMAND_BUFFER_POOL_MAX_SIZE);
+  command_buffer_free(buffer);
+
+  EXPECT_EQ(command_buffer_alloc(5), buffer);
+  command_buffer_free(buffer);
+}
+
+TEST_F(CommandBufferPoolTest, test_large_command) {
+  BT_HDR* buffer = command_buffer_alloc(4 * COMMAND_BUFFER_POOL_MAX_SIZE);
+  ASSERT_NE(buffer, nullptr);
+  fill(buffer, 4 * COMMAND_BUFFER_POOL_MAX_SIZE);
+  command_buffer_free(buffer);
+}
+
+TEST_F(CommandBufferPoolTest, test_exhausted_pool) {
+  std::vector<BT_HDR*> buffers;
+  for (int i = 0; i < 2 * COMMAND_BUFFER_POOL_COUNT; i++) {
+    BT_HDR* buffer = command_buffer_alloc(COMMAND_BUFFER_POOL_MAX_SIZE);
+    ASSERT_NE(buffer, nullptr);
+    fill(buffer, COMMAND_BUFFER_POOL_MAX_SIZE);
+    buffers.push_back(buffer);
+  }
+  EXPECT_EQ(std::set<BT_HDR*>(buffers.begin(), buffers.end()).size(),
+            buffers.size());
+
+  for (BT_HDR* buffer : buffers) command_buffer_free(buffer);
+}
+
+TEST_F(CommandBufferPoolTest, test_free_osi_buffer) {
+  // Commands built outside of the pool, e.g. by the packet factory
+  BT_HDR* buffer = static_cast<BT_HDR*>(osi_malloc(BT_HDR_SIZE + 10));
+  command_buffer_free(buffer);
+  command_buffer_free(nullptr);
+}
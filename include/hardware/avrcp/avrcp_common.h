@@ -155,7 +155,7 @@ class AttributeEntry {
 
   Attribute attribute() const { return attribute_; }
 
-  std::string value() const { return value_; }
+  const std::string& value() const { return value_; }
 
   static constexpr size_t kHeaderSize() {
     size_t ret = 0;
@@ -63,6 +63,22 @@ typedef struct {
   uint8_t is_notify;
 } btgatt_notify_params_t;
 
+/** One notification of a btgatt_notify_batch_t */
+typedef struct {
+  uint16_t handle;
+  uint16_t len;
+  /** Offset of the value in btgatt_notify_batch_t::values */
+  uint32_t offset;
+} btgatt_notify_entry_t;
+
+/** Notifications received from one remote device, in the order received */
+typedef struct {
+  RawAddress bda;
+  std::vector<btgatt_notify_entry_t> entries;
+  /** Values of all the entries, back to back */
+  std::vector<uint8_t> values;
+} btgatt_notify_batch_t;
+
 typedef struct {
   RawAddress* bda1;
   bluetooth::Uuid* uuid1;
@@ -124,6 +140,14 @@ typedef void (*register_for_notification_callback)(int conn_id, int registered,
 typedef void (*notify_callback)(int conn_id,
                                 const btgatt_notify_params_t& p_data);
 
+/**
+ * Remote device notification batch callback. When provided and batching is
+ * enabled, notifications are accumulated for a short window and delivered
+ * together instead of through notify_cb. Indications always use notify_cb.
+ */
+typedef void (*notify_batch_callback)(int conn_id,
+                                      const btgatt_notify_batch_t& batch);
+
 /** Reports result of a GATT read operation */
 typedef void (*read_characteristic_callback)(int conn_id, int status,
                                              btgatt_read_params_t* p_data);
@@ -201,6 +225,7 @@ typedef struct {
   services_added_callback services_added_cb;
   phy_updated_callback phy_updated_cb;
   conn_updated_callback conn_updated_cb;
+  notify_batch_callback notify_batch_cb;
 } btgatt_client_callbacks_t;
 
 /** Represents the standard BT-GATT client interface. */
@@ -410,6 +410,20 @@
 #define BTM_PM_DEBUG FALSE
 #endif
 
+/* The time an ACL link is kept active after it woke up, before a request to
+ * put it back to a low power mode is sent to the controller, in milliseconds.
+ * It keeps bursty traffic from flapping the link in and out of sniff mode.
+ * 0 sends the requests right away. */
+#ifndef BTM_PM_SNIFF_HOLDOFF_MS
+#define BTM_PM_SNIFF_HOLDOFF_MS 1000
+#endif
+
+/* The maximum number of ACL links with a power mode command in progress at
+ * the same time. 1 sends the commands for one link after the other. */
+#ifndef BTM_PM_MAX_PEND_CMDS
+#define BTM_PM_MAX_PEND_CMDS MAX_L2CAP_LINKS
+#endif
+
 /* If the user does not respond to security process requests within this many
  * seconds, a negative response would be sent automatically.
  * 30 is LMP response timeout value */
@@ -754,6 +768,12 @@
 #define SDP_MAX_LIST_BYTE_COUNT 4096
 #endif
 
+/* The maximum number of bytes, over all its continuation fragments, of the
+ * attribute lists of a response to a discovery request. */
+#ifndef SDP_MAX_DISC_RSP_BYTE_COUNT
+#define SDP_MAX_DISC_RSP_BYTE_COUNT 65536
+#endif
+
 /* The maximum number of parameters in an SDP protocol element. */
 #ifndef SDP_MAX_PROTOCOL_PARAMS
 #define SDP_MAX_PROTOCOL_PARAMS 2
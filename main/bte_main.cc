@@ -53,6 +53,7 @@
 #include "osi/include/future.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "shim/hci_layer.h"
 #include "shim/shim.h"
 #include "stack_config.h"
@@ -71,6 +72,9 @@
 #endif  // defined(OS_GENERIC)
 #endif  // BT_BLE_STACK_CONF_FILE
 
+/* Overlap core stack initialization with the HCI layer start up */
+#define PARALLEL_STARTUP_PROPERTY "persist.bluetooth.parallel_startup"
+
 /******************************************************************************
  *  Variables
  *****************************************************************************/
@@ -161,6 +165,14 @@ void bte_main_enable() {
     LOG_INFO(LOG_TAG, "%s Gd shim module enabled", __func__);
     module_start_up(get_module(GD_SHIM_MODULE));
     module_start_up(get_module(GD_HCI_MODULE));
+  } else if (osi_property_get_bool(PARALLEL_STARTUP_PROPERTY, false)) {
+    LOG_INFO(LOG_TAG, "%s Parallel start up enabled", __func__);
+    // btsnoop must be up before the first HCI packet is sent, but the core
+    // stack control blocks do not need the controller and can be initialized
+    // while the HCI layer waits for the vendor library to load the firmware.
+    module_start_up(get_module(BTSNOOP_MODULE));
+    BTU_StartUpOverlapped(module_start_up_async(get_module(HCI_MODULE)));
+    return;
   } else {
     module_start_up(get_module(BTSNOOP_MODULE));
     module_start_up(get_module(HCI_MODULE));
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "main/shim/bt_hdr_packet.h"
+
+#include <algorithm>
+
+#include "osi/include/allocator.h"
+
+namespace bluetooth {
+namespace shim {
+
+BtHdrPacketBuilder::BtHdrPacketBuilder(BT_HDR* bt_hdr) : bt_hdr_(bt_hdr) {}
+
+BtHdrPacketBuilder::~BtHdrPacketBuilder() { osi_free(bt_hdr_); }
+
+size_t BtHdrPacketBuilder::size() const { return bt_hdr_->len; }
+
+void BtHdrPacketBuilder::Serialize(packet::BitInserter& it) const {
+  const uint8_t* data = bt_hdr_->data + bt_hdr_->offset;
+  for (uint16_t i = 0; i < bt_hdr_->len; i++) {
+    it.insert_byte(data[i]);
+  }
+}
+
+BT_HDR* MakeLegacyPacket(
+    const packet::PacketView<packet::kLittleEndian>& packet) {
+  BT_HDR* bt_hdr =
+      static_cast<BT_HDR*>(osi_malloc(sizeof(BT_HDR) + packet.size()));
+  bt_hdr->event = 0;
+  bt_hdr->len = packet.size();
+  bt_hdr->offset = 0;
+  bt_hdr->layer_specific = 0;
+  std::copy(packet.begin(), packet.end(), bt_hdr->data);
+  return bt_hdr;
+}
+
+}  // namespace shim
+}  // namespace bluetooth
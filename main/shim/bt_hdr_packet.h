@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "packet/base_packet_builder.h"
+#include "packet/packet_view.h"
+#include "stack/include/bt_types.h"
+
+namespace bluetooth {
+namespace shim {
+
+/**
+ * Sends the payload of a legacy BT_HDR as a gd packet.
+ *
+ * The builder owns the BT_HDR, and serializes its payload straight from it
+ * when gd sends the packet.
+ */
+class BtHdrPacketBuilder : public packet::BasePacketBuilder {
+ public:
+  explicit BtHdrPacketBuilder(BT_HDR* bt_hdr);
+  ~BtHdrPacketBuilder() override;
+
+  size_t size() const override;
+  void Serialize(packet::BitInserter& it) const override;
+
+ private:
+  BT_HDR* bt_hdr_;
+
+  BtHdrPacketBuilder(const BtHdrPacketBuilder&) = delete;
+  BtHdrPacketBuilder& operator=(const BtHdrPacketBuilder&) = delete;
+};
+
+/**
+ * Makes the BT_HDR handed to the legacy stack for an SDU received by gd.
+ *
+ * A BT_HDR holds its payload inline, so it is copied once from the gd
+ * buffers.
+ */
+BT_HDR* MakeLegacyPacket(
+    const packet::PacketView<packet::kLittleEndian>& packet);
+
+}  // namespace shim
+}  // namespace bluetooth
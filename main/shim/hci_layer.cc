@@ -23,6 +23,7 @@
 
 #include "btcore/include/module.h"
 #include "hci/hci_layer.h"
+#include "hci/include/command_buffer_pool.h"
 #include "main/shim/hci_layer.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
@@ -176,6 +177,8 @@ static void transmit_command(BT_HDR* command,
   auto payload = MakeUniquePacket(data, len);
   auto packet =
       bluetooth::hci::CommandPacketBuilder::Create(op_code, std::move(payload));
+  // The payload was copied, the callbacks are given the response instead
+  command_buffer_free(command);
 
   if (IsCommandStatusOpcode(op_code)) {
     bluetooth::shim::GetHciLayer()->EnqueueCommand(
@@ -16,7 +16,9 @@
 #define LOG_TAG "bt_shim_l2cap"
 
 #include <cstdint>
+#include <memory>
 
+#include "main/shim/bt_hdr_packet.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/entry.h"
 #include "main/shim/l2cap.h"
@@ -29,7 +31,6 @@
 namespace {
 constexpr char kModuleName[] = "shim::legacy::L2cap";
 constexpr bool kDisconnectResponseRequired = false;
-constexpr size_t kBtHdrSize = sizeof(BT_HDR);
 constexpr uint16_t kConnectionFail = 1;
 constexpr uint16_t kConnectionSuccess = 0;
 constexpr uint16_t kInvalidConnectionInterfaceDescriptor = 0;
@@ -302,24 +303,24 @@ void bluetooth::shim::legacy::L2cap::OnRemoteInitiatedConnectionCreated(
 
 bool bluetooth::shim::legacy::L2cap::Write(uint16_t cid, BT_HDR* bt_hdr) {
   CHECK(bt_hdr != nullptr);
-  const uint8_t* data = bt_hdr->data + bt_hdr->offset;
-  size_t len = bt_hdr->len;
+  // The buffer is ours, as with L2CA_DataWrite()
+  auto packet = std::make_unique<BtHdrPacketBuilder>(bt_hdr);
+  size_t len = packet->size();
   if (!ConnectionExists(cid) || len == 0) {
     return false;
   }
   LOG_DEBUG(LOG_TAG, "Writing data cid:%hd len:%zd", cid, len);
-  bluetooth::shim::GetL2cap()->Write(cid, data, len);
+  bluetooth::shim::GetL2cap()->Write(cid, std::move(packet));
   return true;
 }
 
 void bluetooth::shim::legacy::L2cap::SetDownstreamCallbacks(uint16_t cid) {
   bluetooth::shim::GetL2cap()->SetReadDataReadyCallback(
-      cid, [this](uint16_t cid, std::vector<const uint8_t> data) {
-        LOG_DEBUG(LOG_TAG, "OnDataReady cid:%hd len:%zd", cid, data.size());
-        BT_HDR* bt_hdr =
-            static_cast<BT_HDR*>(osi_calloc(data.size() + kBtHdrSize));
-        std::copy(data.begin(), data.end(), bt_hdr->data);
-        bt_hdr->len = data.size();
+      cid,
+      [this](uint16_t cid,
+             std::unique_ptr<packet::PacketView<packet::kLittleEndian>> sdu) {
+        LOG_DEBUG(LOG_TAG, "OnDataReady cid:%hd len:%zd", cid, sdu->size());
+        BT_HDR* bt_hdr = MakeLegacyPacket(*sdu);
         classic_.Callbacks(CidToPsm(cid))->pL2CA_DataInd_Cb(cid, bt_hdr);
       });
 
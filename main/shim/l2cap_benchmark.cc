@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "main/shim/bt_hdr_packet.h"
+#include "osi/include/allocator.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+using bluetooth::packet::BasePacketBuilder;
+using bluetooth::packet::BitInserter;
+using bluetooth::packet::kLittleEndian;
+using bluetooth::packet::PacketView;
+using bluetooth::packet::RawBuilder;
+using bluetooth::shim::BtHdrPacketBuilder;
+using bluetooth::shim::MakeLegacyPacket;
+
+namespace {
+
+// Headroom reserved by the legacy profiles in front of the payload
+constexpr uint16_t kLegacyOffset = 13;
+
+BT_HDR* make_bt_hdr(size_t len) {
+  BT_HDR* bt_hdr =
+      static_cast<BT_HDR*>(osi_malloc(sizeof(BT_HDR) + kLegacyOffset + len));
+  bt_hdr->offset = kLegacyOffset;
+  bt_hdr->len = len;
+  memset(bt_hdr->data + bt_hdr->offset, 0x5a, len);
+  return bt_hdr;
+}
+
+// The gd L2CAP channel sending the packet
+void gd_send(std::unique_ptr<BasePacketBuilder> packet,
+             std::vector<uint8_t>* pdu) {
+  pdu->clear();
+  BitInserter it(*pdu);
+  packet->Serialize(it);
+}
+
+// The former write path: the payload is copied into a vector, which is
+// copied again into a RawBuilder
+std::unique_ptr<BasePacketBuilder> write_copy(BT_HDR* bt_hdr,
+                                              size_t* copied) {
+  const uint8_t* data = bt_hdr->data + bt_hdr->offset;
+  std::vector<uint8_t> bytes(data, data + bt_hdr->len);
+  auto payload = std::make_unique<RawBuilder>();
+  payload->AddOctets(bytes);
+  *copied += 2 * bt_hdr->len;
+  osi_free(bt_hdr);
+  return payload;
+}
+
+using VectorCallback = std::function<void(uint16_t, std::vector<uint8_t>)>;
+using ViewCallback = std::function<void(
+    uint16_t, std::unique_ptr<PacketView<kLittleEndian>>)>;
+
+}  // namespace
+
+static void BM_ShimL2capWrite_Copy(State& state) {
+  size_t copied = 0;
+  std::vector<uint8_t> pdu;
+  for (auto _ : state) {
+    gd_send(write_copy(make_bt_hdr(state.range(0)), &copied), &pdu);
+    benchmark::DoNotOptimize(pdu.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_copied_per_sdu"] = (double)copied / state.iterations();
+}
+BENCHMARK(BM_ShimL2capWrite_Copy)->Arg(48)->Arg(672)->Arg(1017);
+
+static void BM_ShimL2capWrite_BtHdr(State& state) {
+  std::vector<uint8_t> pdu;
+  for (auto _ : state) {
+    gd_send(std::make_unique<BtHdrPacketBuilder>(make_bt_hdr(state.range(0))),
+            &pdu);
+    benchmark::DoNotOptimize(pdu.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_copied_per_sdu"] = 0;
+}
+BENCHMARK(BM_ShimL2capWrite_BtHdr)->Arg(48)->Arg(672)->Arg(1017);
+
+// The former read path: the SDU is copied into a vector, which is copied
+// again as the callback argument, then into the BT_HDR
+static void BM_ShimL2capRead_Copy(State& state) {
+  auto sdu = std::make_shared<std::vector<uint8_t>>(state.range(0), 0x5a);
+  size_t copied = 0;
+  VectorCallback on_data_ready = [&copied](uint16_t cid,
+                                           std::vector<uint8_t> data) {
+    BT_HDR* bt_hdr =
+        static_cast<BT_HDR*>(osi_calloc(data.size() + sizeof(BT_HDR)));
+    std::copy(data.begin(), data.end(), bt_hdr->data);
+    bt_hdr->len = data.size();
+    copied += data.size();
+    benchmark::DoNotOptimize(bt_hdr);
+    osi_free(bt_hdr);
+  };
+  for (auto _ : state) {
+    auto packet = std::make_unique<PacketView<kLittleEndian>>(sdu);
+    std::vector<uint8_t> data(packet->begin(), packet->end());
+    copied += 2 * data.size();
+    on_data_ready(0x40, data);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_copied_per_sdu"] = (double)copied / state.iterations();
+}
+BENCHMARK(BM_ShimL2capRead_Copy)->Arg(48)->Arg(672)->Arg(1017);
+
+static void BM_ShimL2capRead_View(State& state) {
+  auto sdu = std::make_shared<std::vector<uint8_t>>(state.range(0), 0x5a);
+  size_t copied = 0;
+  ViewCallback on_data_ready =
+      [&copied](uint16_t cid, std::unique_ptr<PacketView<kLittleEndian>> sdu) {
+        BT_HDR* bt_hdr = MakeLegacyPacket(*sdu);
+        copied += bt_hdr->len;
+        benchmark::DoNotOptimize(bt_hdr);
+        osi_free(bt_hdr);
+      };
+  for (auto _ : state) {
+    on_data_ready(0x40, std::make_unique<PacketView<kLittleEndian>>(sdu));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_copied_per_sdu"] = (double)copied / state.iterations();
+}
+BENCHMARK(BM_ShimL2capRead_View)->Arg(48)->Arg(672)->Arg(1017);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "osi/include/allocation_tracker.h"
+#include "osi/include/allocator.h"
+
+using ::benchmark::State;
+
+void allocation_tracker_uninit(void);
+
+namespace {
+
+constexpr size_t kAllocationSize = 64;
+
+// Every thread of a run sets the same tracker state before allocating, and
+// frees what it allocated before the next run changes it
+void SetUpTracker(bool enabled, uint32_t sample_rate) {
+  if (!enabled) {
+    allocation_tracker_uninit();
+    return;
+  }
+  allocation_tracker_init();
+  allocation_tracker_set_sample_rate(sample_rate);
+}
+
+void AllocateAndFree(State& state) {
+  for (auto _ : state) {
+    void* ptr = osi_malloc(kAllocationSize);
+    benchmark::DoNotOptimize(ptr);
+    osi_free(ptr);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+static void BM_OsiMallocUntracked(State& state) {
+  SetUpTracker(false, 1);
+  AllocateAndFree(state);
+}
+BENCHMARK(BM_OsiMallocUntracked)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_OsiMallocTracked(State& state) {
+  SetUpTracker(true, 1);
+  AllocateAndFree(state);
+}
+BENCHMARK(BM_OsiMallocTracked)->Threads(1)->Threads(4)->UseRealTime();
+
+static void BM_OsiMallocSampled(State& state) {
+  SetUpTracker(true, 16);
+  AllocateAndFree(state);
+}
+BENCHMARK(BM_OsiMallocSampled)->Threads(1)->Threads(4)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -38,6 +38,13 @@ void allocation_tracker_reset(void);
 // unallocated memory.
 size_t allocation_tracker_expect_no_allocations(void);
 
+// Track only one allocation out of |sample_rate| in each thread. Canaries
+// are still checked on every allocation, but unfreed allocations and call
+// sites are only reported for the sampled ones. 1, the default, tracks every
+// allocation. The default is read from the
+// persist.bluetooth.alloc_sample_rate property by |allocation_tracker_init|.
+void allocation_tracker_set_sample_rate(uint32_t sample_rate);
+
 // Notify the tracker of a new allocation belonging to |allocator_id|.
 // If |ptr| is NULL, this function does nothing. |requested_size| is the
 // size of the allocation without any canaries. The caller must allocate
@@ -47,6 +54,12 @@ size_t allocation_tracker_expect_no_allocations(void);
 void* allocation_tracker_notify_alloc(allocator_id_t allocator_id, void* ptr,
                                       size_t requested_size);
 
+// Same as |allocation_tracker_notify_alloc|, counting the allocation for
+// |call_site| instead of the caller of this function.
+void* allocation_tracker_notify_alloc_from(allocator_id_t allocator_id,
+                                           void* ptr, size_t requested_size,
+                                           const void* call_site);
+
 // Notify the tracker of an allocation that is being freed. |ptr| must be a
 // pointer returned by a call to |allocation_tracker_notify_alloc| with the
 // same |allocator_id|. If |ptr| is NULL, this function does nothing. Returns
@@ -23,31 +23,160 @@
 #include <base/logging.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
+
+#define ALLOC_SAMPLE_RATE_PROPERTY "persist.bluetooth.alloc_sample_rate"
+
+// Stored in front of the canary preceding each allocation, so that
+// allocations which are not sampled can be checked when freed
+typedef struct {
+  size_t size;
+  allocator_id_t allocator_id;
+  bool sampled;
+} header_t;
 
 typedef struct {
-  uint8_t allocator_id;
-  void* ptr;
   size_t size;
-  bool freed;
+  const void* call_site;
 } allocation_t;
 
+typedef struct {
+  size_t alloc_count;
+  size_t alloc_size;
+  size_t used_count;
+  size_t used_size;
+} call_site_stats_t;
+
+// Sampled allocations are spread over shards by address, so that threads
+// allocating at the same time seldom wait for each other
+typedef struct alignas(64) {
+  std::mutex lock;
+  std::unordered_map<void*, allocation_t> allocations;
+  std::unordered_map<const void*, call_site_stats_t> call_sites;
+} shard_t;
+
+// Memory allocation statistics of one thread. Only that thread writes them,
+// so they are updated without a lock or atomic read-modify-write.
+typedef struct {
+  std::atomic<size_t> alloc_counter;
+  std::atomic<size_t> free_counter;
+  std::atomic<size_t> alloc_total_size;
+  std::atomic<size_t> free_total_size;
+} thread_stats_t;
+
 static const size_t canary_size = 8;
+static const size_t front_size = sizeof(header_t) + canary_size;
 static char canary[canary_size];
-static std::unordered_map<void*, allocation_t*> allocations;
+static const size_t num_shards = 64;
+static shard_t shards[num_shards];
 static std::mutex tracker_lock;
-static bool enabled = false;
+static std::atomic<bool> enabled(false);
+static std::atomic<uint32_t> sample_rate(1);
+
+// Deletes the statistics of a thread when it exits, once added to
+// exited_thread_stats
+typedef struct thread_stats_owner_t {
+  thread_stats_t* stats = nullptr;
+  ~thread_stats_owner_t();
+} thread_stats_owner_t;
+
+static std::mutex thread_stats_lock;
+// Never freed, threads may still allocate while the process exits
+static std::vector<thread_stats_t*>* all_thread_stats =
+    new std::vector<thread_stats_t*>();
+// Threads which exited, and their allocations after that
+static thread_stats_t exited_thread_stats;
+static thread_local thread_stats_t* thread_stats = nullptr;
+static thread_local thread_stats_owner_t thread_stats_owner;
+static thread_local bool thread_exited = false;
+static thread_local uint32_t allocations_until_sample = 0;
+
+static shard_t& shard_for(const void* ptr) {
+  uint64_t key = (uintptr_t)ptr >> 4;
+  return shards[(key * 0x9E3779B97F4A7C15ull) >> 58];
+}
+
+thread_stats_owner_t::~thread_stats_owner_t() {
+  thread_exited = true;
+  if (stats == nullptr) return;
+
+  std::unique_lock<std::mutex> lock(thread_stats_lock);
+  exited_thread_stats.alloc_counter += stats->alloc_counter;
+  exited_thread_stats.free_counter += stats->free_counter;
+  exited_thread_stats.alloc_total_size += stats->alloc_total_size;
+  exited_thread_stats.free_total_size += stats->free_total_size;
+  all_thread_stats->erase(
+      std::find(all_thread_stats->begin(), all_thread_stats->end(), stats));
+  delete stats;
+  thread_stats = nullptr;
+}
 
-// Memory allocation statistics
-static size_t alloc_counter = 0;
-static size_t free_counter = 0;
-static size_t alloc_total_size = 0;
-static size_t free_total_size = 0;
+// Returns nullptr once the thread is exiting, its statistics then go to
+// exited_thread_stats
+static thread_stats_t* get_thread_stats(void) {
+  if (thread_stats == nullptr && !thread_exited) {
+    thread_stats = new thread_stats_t();
+    thread_stats_owner.stats = thread_stats;
+    std::unique_lock<std::mutex> lock(thread_stats_lock);
+    all_thread_stats->push_back(thread_stats);
+  }
+  return thread_stats;
+}
+
+static void add_stat(std::atomic<size_t>& stat, size_t value) {
+  stat.store(stat.load(std::memory_order_relaxed) + value,
+             std::memory_order_relaxed);
+}
+
+static void count_alloc(size_t size) {
+  thread_stats_t* stats = get_thread_stats();
+  if (stats == nullptr) {
+    exited_thread_stats.alloc_counter += 1;
+    exited_thread_stats.alloc_total_size += size;
+    return;
+  }
+  add_stat(stats->alloc_counter, 1);
+  add_stat(stats->alloc_total_size, size);
+}
+
+static void count_free(size_t size) {
+  thread_stats_t* stats = get_thread_stats();
+  if (stats == nullptr) {
+    exited_thread_stats.free_counter += 1;
+    exited_thread_stats.free_total_size += size;
+    return;
+  }
+  add_stat(stats->free_counter, 1);
+  add_stat(stats->free_total_size, size);
+}
+
+static bool should_sample(void) {
+  uint32_t rate = sample_rate.load(std::memory_order_relaxed);
+  if (rate <= 1) return true;
+  if (allocations_until_sample == 0) {
+    allocations_until_sample = rate - 1;
+    return true;
+  }
+  allocations_until_sample--;
+  return false;
+}
+
+static void clear_shards(void) {
+  for (shard_t& shard : shards) {
+    std::unique_lock<std::mutex> lock(shard.lock);
+    shard.allocations.clear();
+    shard.call_sites.clear();
+  }
+}
 
 void allocation_tracker_init(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
@@ -58,6 +187,9 @@ void allocation_tracker_init(void) {
 
   LOG_DEBUG(LOG_TAG, "canary initialized");
 
+  int32_t rate = osi_property_get_int32(ALLOC_SAMPLE_RATE_PROPERTY, 1);
+  sample_rate = rate > 1 ? rate : 1;
+
   enabled = true;
 }
 
@@ -66,7 +198,7 @@ void allocation_tracker_uninit(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
   if (!enabled) return;
 
-  allocations.clear();
+  clear_shards();
   enabled = false;
 }
 
@@ -74,7 +206,11 @@ void allocation_tracker_reset(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
   if (!enabled) return;
 
-  allocations.clear();
+  clear_shards();
+}
+
+void allocation_tracker_set_sample_rate(uint32_t rate) {
+  sample_rate = rate > 1 ? rate : 1;
 }
 
 size_t allocation_tracker_expect_no_allocations(void) {
@@ -83,14 +219,17 @@ size_t allocation_tracker_expect_no_allocations(void) {
 
   size_t unfreed_memory_size = 0;
 
-  for (const auto& entry : allocations) {
-    allocation_t* allocation = entry.second;
-    if (!allocation->freed) {
+  for (shard_t& shard : shards) {
+    std::unique_lock<std::mutex> shard_lock(shard.lock);
+    for (const auto& entry : shard.allocations) {
+      const allocation_t& allocation = entry.second;
       unfreed_memory_size +=
-          allocation->size;  // Report back the unfreed byte count
+          allocation.size;  // Report back the unfreed byte count
       LOG_ERROR(LOG_TAG,
-                "%s found unfreed allocation. address: 0x%zx size: %zd bytes",
-                __func__, (uintptr_t)allocation->ptr, allocation->size);
+                "%s found unfreed allocation. address: 0x%zx size: %zd bytes "
+                "from: %p",
+                __func__, (uintptr_t)entry.first, allocation.size,
+                allocation.call_site);
     }
   }
 
@@ -99,33 +238,41 @@ size_t allocation_tracker_expect_no_allocations(void) {
 
 void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
                                       size_t requested_size) {
-  char* return_ptr;
-  {
-    std::unique_lock<std::mutex> lock(tracker_lock);
-    if (!enabled || !ptr) return ptr;
-
-    // Keep statistics
-    alloc_counter++;
-    alloc_total_size += allocation_tracker_resize_for_canary(requested_size);
-
-    return_ptr = ((char*)ptr) + canary_size;
-
-    auto map_entry = allocations.find(return_ptr);
-    allocation_t* allocation;
-    if (map_entry != allocations.end()) {
-      allocation = map_entry->second;
-      CHECK(allocation->freed);  // Must have been freed before
-    } else {
-      allocation = (allocation_t*)calloc(1, sizeof(allocation_t));
-      allocations[return_ptr] = allocation;
-    }
+  return allocation_tracker_notify_alloc_from(allocator_id, ptr,
+                                              requested_size,
+                                              __builtin_return_address(0));
+}
+
+void* allocation_tracker_notify_alloc_from(uint8_t allocator_id, void* ptr,
+                                           size_t requested_size,
+                                           const void* call_site) {
+  if (!enabled || !ptr) return ptr;
 
-    allocation->allocator_id = allocator_id;
-    allocation->freed = false;
-    allocation->size = requested_size;
-    allocation->ptr = return_ptr;
+  char* return_ptr = ((char*)ptr) + front_size;
+  header_t* header = (header_t*)ptr;
+  header->size = requested_size;
+  header->allocator_id = allocator_id;
+  header->sampled = should_sample();
+
+  if (header->sampled) {
+    shard_t& shard = shard_for(return_ptr);
+    std::unique_lock<std::mutex> lock(shard.lock);
+    bool inserted =
+        shard.allocations
+            .emplace(return_ptr, allocation_t{requested_size, call_site})
+            .second;
+    CHECK(inserted);  // Must have been freed before
+
+    call_site_stats_t& stats = shard.call_sites[call_site];
+    stats.alloc_count++;
+    stats.alloc_size += requested_size;
+    stats.used_count++;
+    stats.used_size += requested_size;
   }
 
+  // Keep statistics
+  count_alloc(allocation_tracker_resize_for_canary(requested_size));
+
   // Add the canary on both sides
   memcpy(return_ptr - canary_size, canary, canary_size);
   memcpy(return_ptr + requested_size, canary, canary_size);
@@ -135,53 +282,108 @@ void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
 
 void* allocation_tracker_notify_free(UNUSED_ATTR uint8_t allocator_id,
                                      void* ptr) {
-  std::unique_lock<std::mutex> lock(tracker_lock);
-
   if (!enabled || !ptr) return ptr;
 
-  auto map_entry = allocations.find(ptr);
-  CHECK(map_entry != allocations.end());
-  allocation_t* allocation = map_entry->second;
-  CHECK(allocation);          // Must have been tracked before
-  CHECK(!allocation->freed);  // Must not be a double free
-  CHECK(allocation->allocator_id ==
+  header_t* header = (header_t*)(((char*)ptr) - front_size);
+  size_t size = header->size;
+
+  // Whether the allocation is in the shards depends on the sample rate at the
+  // time it was allocated, which may have changed since. Every allocation is
+  // sampled when not sampling, which also catches double frees and frees of
+  // memory that was never allocated.
+  if (header->sampled) {
+    shard_t& shard = shard_for(ptr);
+    std::unique_lock<std::mutex> lock(shard.lock);
+    auto map_entry = shard.allocations.find(ptr);
+    CHECK(map_entry != shard.allocations.end());  // Must have been tracked
+    CHECK(map_entry->second.size == size);
+
+    call_site_stats_t& stats = shard.call_sites[map_entry->second.call_site];
+    stats.used_count--;
+    stats.used_size -= size;
+
+    // Free the hash map entry to avoid unlimited memory usage growth.
+    shard.allocations.erase(map_entry);
+  }
+
+  CHECK(header->allocator_id ==
         allocator_id);  // Must be from the same allocator
 
   // Keep statistics
-  free_counter++;
-  free_total_size += allocation_tracker_resize_for_canary(allocation->size);
-
-  allocation->freed = true;
+  count_free(allocation_tracker_resize_for_canary(size));
 
   UNUSED_ATTR const char* beginning_canary = ((char*)ptr) - canary_size;
-  UNUSED_ATTR const char* end_canary = ((char*)ptr) + allocation->size;
+  UNUSED_ATTR const char* end_canary = ((char*)ptr) + size;
 
   for (size_t i = 0; i < canary_size; i++) {
     CHECK(beginning_canary[i] == canary[i]);
     CHECK(end_canary[i] == canary[i]);
   }
 
-  // Free the hash map entry to avoid unlimited memory usage growth.
-  // Double-free of memory is detected with "assert(allocation)" above
-  // as the allocation entry will not be present.
-  allocations.erase(ptr);
-  free(allocation);
-
-  return ((char*)ptr) - canary_size;
+  return header;
 }
 
 size_t allocation_tracker_resize_for_canary(size_t size) {
-  return (!enabled) ? size : size + (2 * canary_size);
+  return (!enabled) ? size : size + front_size + canary_size;
 }
 
 void osi_allocator_debug_dump(int fd) {
   dprintf(fd, "\nBluetooth Memory Allocation Statistics:\n");
 
-  std::unique_lock<std::mutex> lock(tracker_lock);
+  size_t alloc_counter = 0;
+  size_t free_counter = 0;
+  size_t alloc_total_size = 0;
+  size_t free_total_size = 0;
+  {
+    std::unique_lock<std::mutex> lock(thread_stats_lock);
+    alloc_counter = exited_thread_stats.alloc_counter;
+    free_counter = exited_thread_stats.free_counter;
+    alloc_total_size = exited_thread_stats.alloc_total_size;
+    free_total_size = exited_thread_stats.free_total_size;
+    for (const thread_stats_t* stats : *all_thread_stats) {
+      alloc_counter += stats->alloc_counter.load(std::memory_order_relaxed);
+      free_counter += stats->free_counter.load(std::memory_order_relaxed);
+      alloc_total_size +=
+          stats->alloc_total_size.load(std::memory_order_relaxed);
+      free_total_size += stats->free_total_size.load(std::memory_order_relaxed);
+    }
+  }
 
   dprintf(fd, "  Total allocated/free/used counts : %zu / %zu / %zu\n",
           alloc_counter, free_counter, alloc_counter - free_counter);
   dprintf(fd, "  Total allocated/free/used octets : %zu / %zu / %zu\n",
           alloc_total_size, free_total_size,
           alloc_total_size - free_total_size);
+
+  if (!enabled) return;
+
+  std::unordered_map<const void*, call_site_stats_t> call_sites;
+  for (shard_t& shard : shards) {
+    std::unique_lock<std::mutex> lock(shard.lock);
+    for (const auto& entry : shard.call_sites) {
+      call_site_stats_t& stats = call_sites[entry.first];
+      stats.alloc_count += entry.second.alloc_count;
+      stats.alloc_size += entry.second.alloc_size;
+      stats.used_count += entry.second.used_count;
+      stats.used_size += entry.second.used_size;
+    }
+  }
+
+  std::vector<std::pair<const void*, call_site_stats_t>> top(call_sites.begin(),
+                                                            call_sites.end());
+  size_t num_top = std::min(top.size(), (size_t)10);
+  std::partial_sort(top.begin(), top.begin() + num_top, top.end(),
+                    [](const auto& a, const auto& b) {
+                      return a.second.used_size > b.second.used_size;
+                    });
+
+  dprintf(fd, "  Call sites using the most octets (1 in %u sampled):\n",
+          sample_rate.load());
+  for (size_t i = 0; i < num_top; i++) {
+    const call_site_stats_t& stats = top[i].second;
+    dprintf(fd,
+            "    %p : allocated %zu (%zu octets), used %zu (%zu octets)\n",
+            top[i].first, stats.alloc_count, stats.alloc_size,
+            stats.used_count, stats.used_size);
+  }
 }
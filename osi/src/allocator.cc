@@ -24,14 +24,17 @@
 
 static const allocator_id_t alloc_allocator_id = 42;
 
+// Allocations are counted for the code calling the osi_ functions
+#define CALL_SITE __builtin_return_address(0)
+
 char* osi_strdup(const char* str) {
   size_t size = strlen(str) + 1;  // + 1 for the null terminator
   size_t real_size = allocation_tracker_resize_for_canary(size);
   void* ptr = malloc(real_size);
   CHECK(ptr);
 
-  char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size));
+  char* new_string = static_cast<char*>(allocation_tracker_notify_alloc_from(
+      alloc_allocator_id, ptr, size, CALL_SITE));
   if (!new_string) return NULL;
 
   memcpy(new_string, str, size);
@@ -46,8 +49,8 @@ char* osi_strndup(const char* str, size_t len) {
   void* ptr = malloc(real_size);
   CHECK(ptr);
 
-  char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size + 1));
+  char* new_string = static_cast<char*>(allocation_tracker_notify_alloc_from(
+      alloc_allocator_id, ptr, size + 1, CALL_SITE));
   if (!new_string) return NULL;
 
   memcpy(new_string, str, size);
@@ -59,14 +62,16 @@ void* osi_malloc(size_t size) {
   size_t real_size = allocation_tracker_resize_for_canary(size);
   void* ptr = malloc(real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  return allocation_tracker_notify_alloc_from(alloc_allocator_id, ptr, size,
+                                             CALL_SITE);
 }
 
 void* osi_calloc(size_t size) {
   size_t real_size = allocation_tracker_resize_for_canary(size);
   void* ptr = calloc(1, real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  return allocation_tracker_notify_alloc_from(alloc_allocator_id, ptr, size,
+                                             CALL_SITE);
 }
 
 void osi_free(void* ptr) {
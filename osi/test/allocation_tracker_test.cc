@@ -18,7 +18,12 @@
 
 #include <gtest/gtest.h>
 
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
 #include "osi/include/allocation_tracker.h"
+#include "osi/include/allocator.h"
 
 void allocation_tracker_uninit(void);
 
@@ -62,3 +67,146 @@ TEST(AllocationTrackerTest, test_canaries_on) {
 
   free(dummy_allocation);
 }
+
+TEST(AllocationTrackerTest, test_sampling) {
+  allocation_tracker_uninit();
+  allocation_tracker_init();
+  allocation_tracker_set_sample_rate(4);
+
+  size_t with_canary_size = allocation_tracker_resize_for_canary(4);
+  std::vector<void*> useable_ptrs;
+  for (int i = 0; i < 8; i++) {
+    void* dummy_allocation = malloc(with_canary_size);
+    useable_ptrs.push_back(
+        allocation_tracker_notify_alloc(allocator_id, dummy_allocation, 4));
+  }
+  // Only one allocation out of four is reported
+  EXPECT_EQ(8U, allocation_tracker_expect_no_allocations());
+
+  for (void* useable_ptr : useable_ptrs) {
+    free(allocation_tracker_notify_free(allocator_id, useable_ptr));
+  }
+  EXPECT_EQ(0U, allocation_tracker_expect_no_allocations());
+
+  allocation_tracker_set_sample_rate(1);
+}
+
+TEST(AllocationTrackerTest, test_sample_rate_change) {
+  allocation_tracker_uninit();
+  allocation_tracker_init();
+  allocation_tracker_set_sample_rate(4);
+
+  size_t with_canary_size = allocation_tracker_resize_for_canary(4);
+  std::vector<void*> useable_ptrs;
+  for (int i = 0; i < 4; i++) {
+    void* dummy_allocation = malloc(with_canary_size);
+    useable_ptrs.push_back(
+        allocation_tracker_notify_alloc(allocator_id, dummy_allocation, 4));
+  }
+
+  // Allocations which were not sampled must still be freed once every
+  // allocation is sampled, and the other way round
+  allocation_tracker_set_sample_rate(1);
+  for (int i = 0; i < 4; i++) {
+    void* dummy_allocation = malloc(with_canary_size);
+    useable_ptrs.push_back(
+        allocation_tracker_notify_alloc(allocator_id, dummy_allocation, 4));
+  }
+  EXPECT_EQ(20U, allocation_tracker_expect_no_allocations());
+
+  allocation_tracker_set_sample_rate(4);
+  for (void* useable_ptr : useable_ptrs) {
+    free(allocation_tracker_notify_free(allocator_id, useable_ptr));
+  }
+  EXPECT_EQ(0U, allocation_tracker_expect_no_allocations());
+
+  allocation_tracker_set_sample_rate(1);
+}
+
+// Reads the total allocation and free counts from the debug dump
+static void get_alloc_counts(size_t* alloc_counter, size_t* free_counter) {
+  FILE* file = tmpfile();
+  ASSERT_NE(nullptr, file);
+  osi_allocator_debug_dump(fileno(file));
+  rewind(file);
+
+  char line[256];
+  bool found = false;
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    size_t used_counter;
+    if (sscanf(line, "  Total allocated/free/used counts : %zu / %zu / %zu",
+               alloc_counter, free_counter, &used_counter) == 3) {
+      found = true;
+    }
+  }
+  fclose(file);
+  EXPECT_TRUE(found);
+}
+
+TEST(AllocationTrackerTest, test_exited_thread_stats) {
+  allocation_tracker_uninit();
+  allocation_tracker_init();
+
+  size_t alloc_counter_before, free_counter_before;
+  get_alloc_counts(&alloc_counter_before, &free_counter_before);
+
+  size_t with_canary_size = allocation_tracker_resize_for_canary(4);
+  void* useable_ptr = nullptr;
+  std::thread thread([with_canary_size, &useable_ptr]() {
+    for (int i = 0; i < 10; i++) {
+      void* dummy_allocation = malloc(with_canary_size);
+      free(allocation_tracker_notify_free(
+          allocator_id,
+          allocation_tracker_notify_alloc(allocator_id, dummy_allocation, 4)));
+    }
+    useable_ptr = allocation_tracker_notify_alloc(
+        allocator_id, malloc(with_canary_size), 4);
+  });
+  thread.join();
+
+  // The counts of the thread are kept after it exited
+  size_t alloc_counter, free_counter;
+  get_alloc_counts(&alloc_counter, &free_counter);
+  EXPECT_EQ(alloc_counter_before + 11, alloc_counter);
+  EXPECT_EQ(free_counter_before + 10, free_counter);
+
+  free(allocation_tracker_notify_free(allocator_id, useable_ptr));
+  EXPECT_EQ(0U, allocation_tracker_expect_no_allocations());
+}
+
+TEST(AllocationTrackerTest, test_threads) {
+  allocation_tracker_uninit();
+  allocation_tracker_init();
+
+  static const int num_threads = 4;
+  static const int num_allocations = 1000;
+  size_t with_canary_size = allocation_tracker_resize_for_canary(16);
+  std::vector<std::vector<void*>> useable_ptrs(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([with_canary_size, &useable_ptrs, i]() {
+      std::vector<void*>& ptrs = useable_ptrs[i];
+      for (int j = 0; j < num_allocations; j++) {
+        void* dummy_allocation = malloc(with_canary_size);
+        ptrs.push_back(allocation_tracker_notify_alloc(allocator_id,
+                                                       dummy_allocation, 16));
+      }
+      // Free half of them, from the last one
+      for (int j = 0; j < num_allocations / 2; j++) {
+        free(allocation_tracker_notify_free(allocator_id, ptrs.back()));
+        ptrs.pop_back();
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  EXPECT_EQ(16U * num_threads * num_allocations / 2,
+            allocation_tracker_expect_no_allocations());
+
+  for (const std::vector<void*>& ptrs : useable_ptrs) {
+    for (void* useable_ptr : ptrs) {
+      free(allocation_tracker_notify_free(allocator_id, useable_ptr));
+    }
+  }
+  EXPECT_EQ(0U, allocation_tracker_expect_no_allocations());
+}
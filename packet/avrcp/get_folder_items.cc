@@ -61,18 +61,17 @@ size_t GetFolderItemsResponseBuilder::size() const {
 
   len += 2;  // UID Counter
   len += 2;  // Number of Items;
-  for (const auto& item : items_) {
-    len += item.size();
-  }
+  len += items_size_;
 
   return len;
 }
 
 bool GetFolderItemsResponseBuilder::Serialize(
     const std::shared_ptr<::bluetooth::Packet>& pkt) {
-  ReserveSpace(pkt, size());
+  size_t len = size();
+  ReserveSpace(pkt, len);
 
-  BrowsePacketBuilder::PushHeader(pkt, size() - BrowsePacket::kMinSize());
+  BrowsePacketBuilder::PushHeader(pkt, len - BrowsePacket::kMinSize());
 
   if (status_ == Status::NO_ERROR && items_.size() == 0) {
     // Return range out of bounds if there are zero items in the folder
@@ -96,27 +95,33 @@ bool GetFolderItemsResponseBuilder::Serialize(
 bool GetFolderItemsResponseBuilder::AddMediaPlayer(MediaPlayerItem item) {
   CHECK(scope_ == Scope::MEDIA_PLAYER_LIST);
 
-  if (size() + item.size() > mtu_) return false;
+  size_t item_size = item.size();
+  if (size() + item_size > mtu_) return false;
 
   items_.push_back(MediaListItem(item));
+  items_size_ += item_size;
   return true;
 }
 
 bool GetFolderItemsResponseBuilder::AddSong(MediaElementItem item) {
   CHECK(scope_ == Scope::VFS || scope_ == Scope::NOW_PLAYING);
 
-  if (size() + item.size() > mtu_) return false;
+  size_t item_size = item.size();
+  if (size() + item_size > mtu_) return false;
 
   items_.push_back(MediaListItem(item));
+  items_size_ += item_size;
   return true;
 }
 
 bool GetFolderItemsResponseBuilder::AddFolder(FolderItem item) {
   CHECK(scope_ == Scope::VFS);
 
-  if (size() + item.size() > mtu_) return false;
+  size_t item_size = item.size();
+  if (size() + item_size > mtu_) return false;
 
   items_.push_back(MediaListItem(item));
+  items_size_ += item_size;
   return true;
 }
 
@@ -149,35 +154,22 @@ void GetFolderItemsResponseBuilder::PushMediaPlayerItem(
       pkt, 0x02);  // Player Play Status // TODO: Add this as a passed field
 
   // Features
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0xb7);
-  AddPayloadOctets1(pkt, 0x01);
+  static const uint8_t kBrowsableFeatures[] = {
+      0x00, 0x00, 0x00, 0x00, 0x00, 0xb7, 0x01, 0x0C,
+      0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  static const uint8_t kFeatures[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0xb7,
+                                      0x01, 0x04, 0x00, 0x00, 0x00, 0x00,
+                                      0x00, 0x00, 0x00, 0x00};
   if (item.browsable_) {
-    AddPayloadOctets1(pkt, 0x0C);
-    AddPayloadOctets1(pkt, 0x0a);
+    AddPayloadBytes(pkt, kBrowsableFeatures, sizeof(kBrowsableFeatures));
   } else {
-    AddPayloadOctets1(pkt, 0x04);
-    AddPayloadOctets1(pkt, 0x00);
+    AddPayloadBytes(pkt, kFeatures, sizeof(kFeatures));
   }
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
-  AddPayloadOctets1(pkt, 0x00);
 
   AddPayloadOctets2(pkt, base::ByteSwap((uint16_t)0x006a));
   uint16_t name_len = item.name_.size();
   AddPayloadOctets2(pkt, base::ByteSwap(name_len));
-
-  for (const uint8_t& byte : item.name_) {
-    AddPayloadOctets1(pkt, byte);
-  }
+  AddPayloadBytes(pkt, item.name_);
 }
 
 void GetFolderItemsResponseBuilder::PushFolderItem(
@@ -192,9 +184,7 @@ void GetFolderItemsResponseBuilder::PushFolderItem(
                     base::ByteSwap((uint16_t)0x006a));  // UTF-8 Character Set
   uint16_t name_len = item.name_.size();
   AddPayloadOctets2(pkt, base::ByteSwap(name_len));
-  for (const uint8_t& byte : item.name_) {
-    AddPayloadOctets1(pkt, byte);
-  }
+  AddPayloadBytes(pkt, item.name_);
 }
 
 void GetFolderItemsResponseBuilder::PushMediaElementItem(
@@ -209,9 +199,7 @@ void GetFolderItemsResponseBuilder::PushMediaElementItem(
                     base::ByteSwap((uint16_t)0x006a));  // UTF-8 Character Set
   uint16_t name_len = item.name_.size();
   AddPayloadOctets2(pkt, base::ByteSwap(name_len));
-  for (const uint8_t& byte : item.name_) {
-    AddPayloadOctets1(pkt, byte);
-  }
+  AddPayloadBytes(pkt, item.name_);
 
   AddPayloadOctets1(pkt, (uint8_t)item.attributes_.size());
   for (const auto& entry : item.attributes_) {
@@ -219,13 +207,11 @@ void GetFolderItemsResponseBuilder::PushMediaElementItem(
     AddPayloadOctets2(pkt,
                       base::ByteSwap((uint16_t)0x006a));  // UTF-8 Character Set
 
-    std::string attr_val = entry.value();
+    const std::string& attr_val = entry.value();
     uint16_t attr_len = attr_val.size();
 
     AddPayloadOctets2(pkt, base::ByteSwap(attr_len));
-    for (const uint8_t& byte : attr_val) {
-      AddPayloadOctets1(pkt, byte);
-    }
+    AddPayloadBytes(pkt, attr_val);
   }
 }
 
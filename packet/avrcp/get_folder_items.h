@@ -43,6 +43,9 @@ class GetFolderItemsResponseBuilder : public BrowsePacketBuilder {
  protected:
   Scope scope_;
   std::vector<MediaListItem> items_;
+  // Sum of the sizes of |items_|, updated as they are added so that size()
+  // does not walk every item and attribute.
+  size_t items_size_;
   Status status_;
   uint16_t uid_counter_;
   size_t mtu_;
@@ -51,6 +54,7 @@ class GetFolderItemsResponseBuilder : public BrowsePacketBuilder {
                                 uint16_t uid_counter, size_t mtu)
       : BrowsePacketBuilder(BrowsePdu::GET_FOLDER_ITEMS),
         scope_(scope),
+        items_size_(0),
         status_(status),
         uid_counter_(uid_counter),
         mtu_(mtu){};
@@ -126,4 +126,13 @@ uint8_t Iterator::operator*() const {
   return packet_->get_at_index(index_);
 }
 
+const uint8_t* Iterator::consume(size_t length) {
+  CHECK_NE(index_, packet_->packet_end_index_);
+  CHECK_LE(index_ + length, packet_->packet_end_index_);
+
+  const uint8_t* bytes = packet_->get_data() + index_;
+  index_ += length;
+  return bytes;
+}
+
 }  // namespace bluetooth
\ No newline at end of file
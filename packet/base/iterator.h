@@ -62,10 +62,10 @@ class Iterator
     static_assert(std::is_integral<FixedWidthIntegerType>::value,
                   "Iterator::extract requires an integral type.");
 
+    const uint8_t* bytes = consume(sizeof(FixedWidthIntegerType));
     FixedWidthIntegerType extracted_value = 0;
     for (size_t i = 0; i < sizeof(FixedWidthIntegerType); i++) {
-      extracted_value |= static_cast<FixedWidthIntegerType>(**this) << i * 8;
-      (*this)++;
+      extracted_value |= static_cast<FixedWidthIntegerType>(bytes[i]) << i * 8;
     }
 
     return extracted_value;
@@ -77,11 +77,11 @@ class Iterator
     static_assert(std::is_integral<FixedWidthIntegerType>::value,
                   "Iterator::extract requires an integral type.");
 
+    const uint8_t* bytes = consume(sizeof(FixedWidthIntegerType));
     FixedWidthIntegerType extracted_value = 0;
     for (size_t i = 0; i < sizeof(FixedWidthIntegerType); i++) {
-      extracted_value |= static_cast<FixedWidthIntegerType>(**this)
+      extracted_value |= static_cast<FixedWidthIntegerType>(bytes[i])
                          << (sizeof(FixedWidthIntegerType) - 1 - i) * 8;
-      (*this)++;
     }
 
     return extracted_value;
@@ -93,6 +93,10 @@ class Iterator
   uint64_t extract64() { return extract<uint64_t>(); }
 
  private:
+  // Returns the next |length| bytes of the packet, which must all be within
+  // the packet bounds, and moves past them.
+  const uint8_t* consume(size_t length);
+
   std::shared_ptr<const Packet> packet_;
   size_t index_;
 };  // Iterator
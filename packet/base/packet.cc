@@ -38,13 +38,15 @@ uint8_t Packet::operator[](size_t i) {
   return get_at_index(i + packet_start_index_);
 }
 
-size_t Packet::get_length() const { return data_->size(); }
+size_t Packet::get_length() const {
+  return view_ ? view_capacity_ : data_->size();
+}
 
 // Iterators use the absolute index to access data.
 uint8_t Packet::get_at_index(size_t index) const {
   CHECK_GE(index, packet_start_index_);
   CHECK_LT(index, packet_end_index_);
-  return data_->at(index);
+  return get_data()[index];
 }
 
 }  // namespace bluetooth
\ No newline at end of file
@@ -17,6 +17,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -39,8 +41,15 @@ class Packet : public std::enable_shared_from_this<Packet> {
         packet_end_index_(0),
         data_(std::make_shared<std::vector<uint8_t>>(0)){};
   Packet(std::shared_ptr<const Packet> pkt, size_t start, size_t end)
-      : packet_start_index_(start), packet_end_index_(end), data_(pkt->data_){};
-  Packet(std::shared_ptr<const Packet> pkt) : data_(pkt->data_) {
+      : packet_start_index_(start),
+        packet_end_index_(end),
+        data_(pkt->data_),
+        view_(pkt->view_),
+        view_capacity_(pkt->view_capacity_){};
+  Packet(std::shared_ptr<const Packet> pkt)
+      : data_(pkt->data_),
+        view_(pkt->view_),
+        view_capacity_(pkt->view_capacity_) {
     auto indices = pkt->GetPayloadIndecies();
     packet_start_index_ = indices.first;
     packet_end_index_ = indices.second;
@@ -85,11 +94,23 @@ class Packet : public std::enable_shared_from_this<Packet> {
   size_t packet_end_index_;
   std::shared_ptr<std::vector<uint8_t>> data_;
 
+  // When set, the packet bytes are in an external buffer of |view_capacity_|
+  // bytes instead of |data_|, e.g. the payload of a BT_HDR. Parsing reads the
+  // buffer in place, and builders serialize into it up to its capacity. The
+  // buffer is kept alive by the owner shared with |view_|, if any.
+  std::shared_ptr<uint8_t> view_;
+  size_t view_capacity_ = 0;
+
  private:
   // Only Available to the iterators
   virtual size_t get_length() const;
   virtual uint8_t get_at_index(size_t index) const;
 
+  // The packet bytes, indexed like |packet_start_index_|
+  const uint8_t* get_data() const {
+    return view_ ? view_.get() : data_->data();
+  }
+
   // Returns the begining and end indicies of the payload of the packet.
   // Used when constructing a packet from another packet when moving
   // between layers.
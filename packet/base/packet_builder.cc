@@ -17,6 +17,7 @@
 #include "packet_builder.h"
 
 #include <base/logging.h>
+#include <algorithm>
 
 #include "packet.h"
 
@@ -24,13 +25,44 @@ namespace bluetooth {
 
 void PacketBuilder::ReserveSpace(const std::shared_ptr<Packet>& pkt,
                                  size_t size) {
+  // The capacity of an external buffer is fixed
+  if (pkt->view_) return;
+
   pkt->data_->reserve(size);
 }
 
+bool PacketBuilder::AddPayloadBytes(const std::shared_ptr<Packet>& pkt,
+                                    const void* bytes, size_t length) {
+  const uint8_t* p_bytes = static_cast<const uint8_t*>(bytes);
+
+  if (pkt->view_) {
+    if (pkt->packet_end_index_ + length > pkt->view_capacity_) return false;
+    std::copy(p_bytes, p_bytes + length,
+              pkt->view_.get() + pkt->packet_end_index_);
+    pkt->packet_end_index_ += length;
+    return true;
+  }
+
+  pkt->data_->insert(pkt->data_->end(), p_bytes, p_bytes + length);
+  pkt->packet_end_index_ += length;
+  return true;
+}
+
 bool PacketBuilder::AddPayloadOctets(const std::shared_ptr<Packet>& pkt,
                                      size_t octets, uint64_t value) {
   CHECK_LE(octets, sizeof(uint64_t));
 
+  if (pkt->view_) {
+    if (pkt->packet_end_index_ + octets > pkt->view_capacity_) return false;
+    uint8_t* p_data = pkt->view_.get() + pkt->packet_end_index_;
+    for (size_t i = 0; i < octets; i++) {
+      p_data[i] = value & 0xff;
+      value = value >> 8;
+    }
+    pkt->packet_end_index_ += octets;
+    return true;
+  }
+
   for (size_t i = 0; i < octets; i++) {
     pkt->data_->push_back(value & 0xff);
     pkt->packet_end_index_++;
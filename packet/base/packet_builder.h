@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 namespace bluetooth {
 
@@ -50,11 +51,20 @@ class PacketBuilder {
   bool AddPayloadOctets8(const std::shared_ptr<Packet>& pkt, uint64_t value) {
     return AddPayloadOctets(pkt, 8, value);
   }
+  // Add the |length| bytes at |bytes| to the payload as they are, e.g. a
+  // string value. Returns false if the packet buffer is too small.
+  bool AddPayloadBytes(const std::shared_ptr<Packet>& pkt, const void* bytes,
+                       size_t length);
+  bool AddPayloadBytes(const std::shared_ptr<Packet>& pkt,
+                       const std::string& value) {
+    return AddPayloadBytes(pkt, value.data(), value.size());
+  }
 
  private:
   // Add |octets| bytes to the payload.  Return true if:
   // - the value of |value| fits in |octets| bytes and
-  // - the new size of the payload is still < |kMaxPayloadOctets|
+  // - the new size of the payload is still < |kMaxPayloadOctets| and
+  // - the new size fits in the packet buffer, when building in place
   bool AddPayloadOctets(const std::shared_ptr<Packet>& pkt, size_t octets,
                         uint64_t value);
 };
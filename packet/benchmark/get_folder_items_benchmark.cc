@@ -0,0 +1,145 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "avrcp_test_packets.h"
+#include "get_folder_items.h"
+#include "packet_test_helper.h"
+
+using ::benchmark::State;
+using namespace bluetooth;
+using namespace bluetooth::avrcp;
+
+namespace {
+
+// Room for the largest browse response, as sent in one L2CAP SDU
+constexpr size_t kBufferSize = 0xFFFF;
+
+using TestBrowsePacket = TestPacketType<BrowsePacket>;
+using TestGetFolderItemsReqPacket = TestPacketType<GetFolderItemsRequest>;
+
+// A now playing list of |count| songs, with the attributes a head unit asks
+// for while browsing
+std::vector<MediaElementItem> make_songs(size_t count) {
+  std::vector<MediaElementItem> songs;
+  for (size_t i = 0; i < count; i++) {
+    std::string id = std::to_string(i);
+    std::set<AttributeEntry> attributes;
+    attributes.insert(AttributeEntry(Attribute::TITLE, "Song Title " + id));
+    attributes.insert(AttributeEntry(Attribute::ARTIST_NAME, "Artist Name"));
+    attributes.insert(AttributeEntry(Attribute::ALBUM_NAME, "Album Name"));
+    attributes.insert(AttributeEntry(Attribute::TRACK_NUMBER, id));
+    attributes.insert(AttributeEntry(Attribute::PLAYING_TIME, "215000"));
+    songs.push_back(MediaElementItem(i + 1, "Song Title " + id, attributes));
+  }
+  return songs;
+}
+
+std::unique_ptr<GetFolderItemsResponseBuilder> make_response(
+    const std::vector<MediaElementItem>& songs) {
+  auto builder = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, kBufferSize);
+  for (const auto& song : songs) {
+    builder->AddSong(song);
+  }
+  return builder;
+}
+
+}  // namespace
+
+// Serializes into a vector backed packet, then copies it into the outgoing
+// buffer byte by byte, like SendMessage did
+static void BM_GetFolderItemsResponse_VectorCopy(State& state) {
+  auto songs = make_songs(state.range(0));
+  std::vector<uint8_t> buffer(kBufferSize);
+  size_t size = 0;
+  for (auto _ : state) {
+    auto builder = make_response(songs);
+    auto packet = TestBrowsePacket::Make();
+    builder->Serialize(packet);
+    uint8_t* p_data = buffer.data();
+    for (auto it = packet->begin(); it != packet->end(); it++) {
+      *p_data++ = *it;
+    }
+    size = packet->size();
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_GetFolderItemsResponse_VectorCopy)->Arg(16)->Arg(64)->Arg(256);
+
+// Serializes in place into the outgoing buffer
+static void BM_GetFolderItemsResponse_InPlace(State& state) {
+  auto songs = make_songs(state.range(0));
+  std::shared_ptr<uint8_t> buffer(new uint8_t[kBufferSize],
+                                  std::default_delete<uint8_t[]>());
+  size_t size = 0;
+  for (auto _ : state) {
+    auto builder = make_response(songs);
+    auto packet = TestBrowsePacket::Make(buffer, 0, kBufferSize);
+    builder->Serialize(packet);
+    size = packet->size();
+    benchmark::DoNotOptimize(buffer.get());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_GetFolderItemsResponse_InPlace)->Arg(16)->Arg(64)->Arg(256);
+
+// Copies the received request into a vector, as AvrcpMessageConverter does,
+// then parses it
+static void BM_GetFolderItemsRequest_VectorCopy(State& state) {
+  const uint8_t* p_data = get_folder_items_request_vfs.data();
+  size_t size = get_folder_items_request_vfs.size();
+  for (auto _ : state) {
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < size; i++) {
+      data.push_back(p_data[i]);
+    }
+    auto request = TestGetFolderItemsReqPacket::Make(std::move(data));
+    benchmark::DoNotOptimize(request->IsValid());
+    benchmark::DoNotOptimize(request->GetScope());
+    benchmark::DoNotOptimize(request->GetStartItem());
+    benchmark::DoNotOptimize(request->GetEndItem());
+    benchmark::DoNotOptimize(request->GetAttributesRequested());
+  }
+}
+BENCHMARK(BM_GetFolderItemsRequest_VectorCopy);
+
+// Parses the received request in place
+static void BM_GetFolderItemsRequest_InPlace(State& state) {
+  size_t size = get_folder_items_request_vfs.size();
+  std::shared_ptr<uint8_t> buffer(new uint8_t[size],
+                                  std::default_delete<uint8_t[]>());
+  std::copy(get_folder_items_request_vfs.begin(),
+            get_folder_items_request_vfs.end(), buffer.get());
+  for (auto _ : state) {
+    auto request = TestGetFolderItemsReqPacket::Make(buffer, size, size);
+    benchmark::DoNotOptimize(request->IsValid());
+    benchmark::DoNotOptimize(request->GetScope());
+    benchmark::DoNotOptimize(request->GetStartItem());
+    benchmark::DoNotOptimize(request->GetEndItem());
+    benchmark::DoNotOptimize(request->GetAttributesRequested());
+  }
+}
+BENCHMARK(BM_GetFolderItemsRequest_InPlace);
+
+BENCHMARK_MAIN();
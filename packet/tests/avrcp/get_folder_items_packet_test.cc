@@ -127,6 +127,24 @@ TEST(GetFolderItemsResponseBuilderTest, builderSongAddTest) {
   ASSERT_EQ(test_packet->GetData(), get_folder_items_song_response);
 }
 
+TEST(GetFolderItemsResponseBuilderTest, builderInPlaceTest) {
+  auto builder = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  std::set<AttributeEntry> attributes;
+  attributes.insert(AttributeEntry(Attribute::TITLE, "Test Title"));
+  auto song = MediaElementItem(0x02, "Test Title", attributes);
+  builder->AddSong(song);
+
+  size_t size = get_folder_items_song_response.size();
+  std::shared_ptr<uint8_t> buffer(new uint8_t[size],
+                                  std::default_delete<uint8_t[]>());
+  auto test_packet = TestGetFolderItemsReqPacket::Make(buffer, 0, size);
+  ASSERT_TRUE(builder->Serialize(test_packet));
+  ASSERT_EQ(test_packet->size(), size);
+  ASSERT_EQ(std::vector<uint8_t>(buffer.get(), buffer.get() + size),
+            get_folder_items_song_response);
+}
+
 TEST(GetFolderItemsResponseBuilderTest, builderSongAddMtuTest) {
   MediaElementItem song1(0x01, "Song 1 that fits", std::set<AttributeEntry>());
   MediaElementItem song2(0x02, "Song 2 that doesn't fit",
@@ -222,6 +240,22 @@ TEST(GetFolderItemsRequestTest, getterTest) {
   ASSERT_EQ(test_packet->GetAttributesRequested(), attribute_list);
 }
 
+TEST(GetFolderItemsRequestTest, getterInPlaceTest) {
+  size_t size = get_folder_items_request_vfs.size();
+  std::shared_ptr<uint8_t> buffer(new uint8_t[size],
+                                  std::default_delete<uint8_t[]>());
+  std::copy(get_folder_items_request_vfs.begin(),
+            get_folder_items_request_vfs.end(), buffer.get());
+  auto test_packet = TestGetFolderItemsReqPacket::Make(buffer, size, size);
+
+  ASSERT_TRUE(test_packet->IsValid());
+  ASSERT_EQ(test_packet->GetScope(), Scope::VFS);
+  ASSERT_EQ(test_packet->GetStartItem(), 0x00000000u);
+  ASSERT_EQ(test_packet->GetEndItem(), 0x00000005u);
+  std::vector<Attribute> attribute_list = {Attribute::TITLE};
+  ASSERT_EQ(test_packet->GetAttributesRequested(), attribute_list);
+}
+
 TEST(GetFolderItemsRequestBuilderTest, builderZeroAttrsTest) {
   auto builder =
       GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 0, 9, {});
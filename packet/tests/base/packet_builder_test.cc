@@ -68,4 +68,51 @@ TEST(PacketBuilderTest, addPayloadOctetsTest) {
   }
 }
 
+TEST(PacketBuilderTest, serializeInPlaceTest) {
+  auto builder = TestPacketBuilder::MakeBuilder(test_l2cap_data);
+  std::vector<uint8_t> buffer(test_l2cap_data.size());
+  auto packet = TestPacket::Make(
+      std::shared_ptr<uint8_t>(std::shared_ptr<uint8_t>(), buffer.data()), 0,
+      buffer.size());
+
+  ASSERT_TRUE(builder->Serialize(packet));
+  ASSERT_EQ(packet->size(), test_l2cap_data.size());
+  ASSERT_EQ(buffer, test_l2cap_data);
+  ASSERT_EQ(packet->GetData().size(), 0u);
+}
+
+TEST(PacketBuilderTest, addPayloadBytesTest) {
+  auto builder = TestPacketBuilder::MakeBuilder(test_l2cap_data);
+  auto packet = TestPacket::Make();
+
+  builder->AddPayloadOctets1(packet, 0x01u);
+  ASSERT_TRUE(builder->AddPayloadBytes(packet, std::string("\x02\x03")));
+  ASSERT_TRUE(
+      builder->AddPayloadBytes(packet, test_l2cap_data.data(), 0x04u));
+
+  ASSERT_EQ(packet->size(), 0x07u);
+  ASSERT_EQ((*packet)[1], 0x02u);
+  ASSERT_EQ((*packet)[2], 0x03u);
+  for (size_t i = 0; i < 0x04; i++) {
+    ASSERT_EQ((*packet)[i + 3], test_l2cap_data[i]);
+  }
+}
+
+TEST(PacketBuilderTest, bufferOverflowTest) {
+  auto builder = TestPacketBuilder::MakeBuilder(test_l2cap_data);
+  uint8_t buffer[5] = {};
+  auto packet = TestPacket::Make(
+      std::shared_ptr<uint8_t>(std::shared_ptr<uint8_t>(), buffer), 0,
+      sizeof(buffer));
+
+  ASSERT_TRUE(builder->AddPayloadOctets4(packet, 0x04030201u));
+  ASSERT_FALSE(builder->AddPayloadOctets2(packet, 0x0605u));
+  ASSERT_FALSE(builder->AddPayloadBytes(packet, test_l2cap_data.data(), 2));
+  ASSERT_TRUE(builder->AddPayloadOctets1(packet, 0x05u));
+  ASSERT_EQ(packet->size(), sizeof(buffer));
+  for (size_t i = 0; i < sizeof(buffer); i++) {
+    ASSERT_EQ(buffer[i], i + 1);
+  }
+}
+
 }  // namespace bluetooth
\ No newline at end of file
@@ -75,6 +75,7 @@ class TestPacketBuilder : public PacketBuilder {
   using PacketBuilder::AddPayloadOctets4;
   using PacketBuilder::AddPayloadOctets6;
   using PacketBuilder::AddPayloadOctets8;
+  using PacketBuilder::AddPayloadBytes;
 
   size_t size() const override { return data_.size(); };
 
@@ -56,6 +56,19 @@ class TestPacketType : public PacketType {
     return pkt;
   }
 
+  // Makes a packet over |size| bytes of |buffer| that builders can extend up
+  // to |capacity| bytes, without copying them
+  static std::shared_ptr<TestPacketType<PacketType>> Make(
+      std::shared_ptr<uint8_t> buffer, size_t size, size_t capacity) {
+    auto pkt = std::shared_ptr<TestPacketType<PacketType>>(
+        new TestPacketType<PacketType>());
+    pkt->packet_start_index_ = 0;
+    pkt->packet_end_index_ = size;
+    pkt->view_ = std::move(buffer);
+    pkt->view_capacity_ = capacity;
+    return pkt;
+  }
+
   const std::vector<uint8_t>& GetData() { return *PacketType::data_; }
 
   std::shared_ptr<std::vector<uint8_t>> GetDataPointer() {
@@ -19,6 +19,8 @@
 #include <iostream>
 #include <vector>
 
+#include "bt_types.h"
+#include "osi/include/allocator.h"
 #include "packet/avrcp/avrcp_packet.h"
 
 // These classes are temporary placeholders to easily switch between BT_HDR and
@@ -60,6 +62,58 @@ class VectorPacket : public ::bluetooth::Packet {
   virtual bool IsValid() const override { return true; }
 };
 
+// A packet over the payload of a BT_HDR, read or built in place.
+class BtHdrPacket : public ::bluetooth::Packet {
+ public:
+  using Packet::Packet;  // Inherit constructors
+
+  // Views the |len| bytes at |offset| in |p_buf|, without copying them. The
+  // packet takes the ownership of |p_buf|.
+  static std::shared_ptr<BtHdrPacket> Make(BT_HDR* p_buf) {
+    auto pkt = std::shared_ptr<BtHdrPacket>(new BtHdrPacket());
+    std::shared_ptr<BT_HDR> owner(p_buf, osi_free);
+    pkt->view_ = std::shared_ptr<uint8_t>(
+        owner, reinterpret_cast<uint8_t*>(p_buf + 1) + p_buf->offset);
+    pkt->view_capacity_ = p_buf->len;
+    pkt->packet_start_index_ = 0;
+    pkt->packet_end_index_ = p_buf->len;
+    return pkt;
+  };
+
+  // Makes an empty packet that builders serialize into at |offset| in
+  // |p_buf|, up to |capacity| bytes. The caller keeps the ownership of
+  // |p_buf|, which must outlive the packet.
+  static std::shared_ptr<BtHdrPacket> MakeEmpty(BT_HDR* p_buf,
+                                                size_t capacity) {
+    auto pkt = std::shared_ptr<BtHdrPacket>(new BtHdrPacket());
+    pkt->view_ = std::shared_ptr<uint8_t>(
+        std::shared_ptr<uint8_t>(),
+        reinterpret_cast<uint8_t*>(p_buf + 1) + p_buf->offset);
+    pkt->view_capacity_ = capacity;
+    pkt->packet_start_index_ = 0;
+    pkt->packet_end_index_ = 0;
+    return pkt;
+  };
+
+  virtual std::string ToString() const override {
+    std::stringstream ss;
+    ss << "BtHdrPacket:" << std::endl;
+    ss << "  └ Payload =";
+    for (auto it = begin(); it != end(); it++) {
+      ss << " " << loghex(*it);
+    }
+    ss << std::endl;
+
+    return ss.str();
+  };
+
+  virtual std::pair<size_t, size_t> GetPayloadIndecies() const override {
+    return std::pair<size_t, size_t>(packet_start_index_, packet_end_index_);
+  }
+
+  virtual bool IsValid() const override { return true; }
+};
+
 // TODO (apanicke): When deleting the old AVRCP Stack, remove this class and
 // instead create a BT_HDR Parsing packet.
 class AvrcpMessageConverter {
@@ -90,6 +144,14 @@ class AvrcpMessageConverter {
       } break;
       case AVRC_OP_BROWSE: {
         tAVRC_MSG_BROWSE* msg = (tAVRC_MSG_BROWSE*)m;
+        // Take ownership of the received buffer and parse the browse message
+        // in place. Clearing p_browse_pkt tells AVRC not to free the buffer
+        // once the message callback returns.
+        if (msg->p_browse_pkt != nullptr) {
+          BT_HDR* p_pkt = msg->p_browse_pkt;
+          msg->p_browse_pkt = nullptr;
+          return BtHdrPacket::Make(p_pkt);
+        }
         // The first 3 bytes are header bytes that aren't actually in AVRCP
         // packets
         for (int i = 0; i < msg->browse_len; i++) {
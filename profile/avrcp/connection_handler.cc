@@ -18,6 +18,7 @@
 
 #include <base/bind.h>
 #include <base/logging.h>
+#include <algorithm>
 #include <map>
 
 #include "avrc_defs.h"
@@ -521,7 +522,14 @@ void ConnectionHandler::SdpCb(RawAddress bdaddr, SdpCallback cb,
 void ConnectionHandler::SendMessage(
     uint8_t handle, uint8_t label, bool browse,
     std::unique_ptr<::bluetooth::PacketBuilder> message) {
-  std::shared_ptr<::bluetooth::Packet> packet = VectorPacket::Make();
+  // The message is serialized in place in the buffer handed over to AVRC
+  size_t buffer_size = std::max<size_t>(
+      BT_DEFAULT_BUFFER_SIZE, BT_HDR_SIZE + AVCT_MSG_OFFSET + message->size());
+  BT_HDR* pkt = (BT_HDR*)osi_malloc(buffer_size);
+  pkt->offset = AVCT_MSG_OFFSET;
+
+  std::shared_ptr<::bluetooth::Packet> packet = BtHdrPacket::MakeEmpty(
+      pkt, buffer_size - BT_HDR_SIZE - AVCT_MSG_OFFSET);
   message->Serialize(packet);
 
   uint8_t ctype = AVRC_RSP_ACCEPT;
@@ -532,9 +540,6 @@ void ConnectionHandler::SendMessage(
 
   DLOG(INFO) << "SendMessage to handle=" << loghex(handle);
 
-  BT_HDR* pkt = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-
-  pkt->offset = AVCT_MSG_OFFSET;
   // TODO (apanicke): Update this constant. Currently this is a unique event
   // used to tell the AVRCP API layer that the data is properly formatted and
   // doesn't need to be processed. In the future, this is the only place sending
@@ -554,10 +559,6 @@ void ConnectionHandler::SendMessage(
   }
 
   pkt->len = packet->size();
-  uint8_t* p_data = (uint8_t*)(pkt + 1) + pkt->offset;
-  for (auto it = packet->begin(); it != packet->end(); it++) {
-    *p_data++ = *it;
-  }
 
   avrc_->MsgReq(handle, label, ctype, pkt);
 }
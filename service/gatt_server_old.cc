@@ -447,6 +447,7 @@ const btgatt_client_callbacks_t gatt_client_callbacks = {
     nullptr, /* services_added_cb */
     nullptr, /* phy_update_cb */
     nullptr, /* conn_update_cb */
+    nullptr, /* notify_batch_cb */
 };
 
 const btgatt_scanner_callbacks_t gatt_scanner_callbacks = {
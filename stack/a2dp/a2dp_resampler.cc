@@ -0,0 +1,274 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "a2dp_resampler"
+
+#include "a2dp_resampler.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <numeric>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "osi/include/log.h"
+
+namespace {
+
+// Limits the coefficient table to 128 KiB with kQualityHigh. The common A2DP
+// rates need at most 441 phases, e.g. for 32 kHz to 44.1 kHz.
+constexpr uint32_t kMaxPhases = 512;
+
+// Input frames converted at a time
+constexpr size_t kBlockFrames = 256;
+
+// Multiple of the SIMD vector length
+constexpr size_t kTapsAlignment = 8;
+
+struct QualityParams {
+  size_t taps_per_phase;
+  // Kaiser window shape
+  double beta;
+  // Cutoff frequency, relative to the Nyquist frequency of the lowest rate
+  double cutoff;
+};
+
+// Indexed by A2dpResampler::Quality
+const QualityParams kQualityParams[] = {
+    {16, 5.0, 0.80},  // kQualityLow
+    {32, 8.0, 0.90},  // kQualityMedium
+    {64, 10.0, 0.94},  // kQualityHigh
+};
+
+// Zeroth order modified Bessel function of the first kind
+double bessel_i0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  double half_x = x / 2.0;
+  for (int k = 1; k < 32; k++) {
+    term *= (half_x / k) * (half_x / k);
+    sum += term;
+    if (term < sum * 1e-12) break;
+  }
+  return sum;
+}
+
+// Returns the sum of the products of the |n| samples of |a| and |b|, |n|
+// being a multiple of kTapsAlignment.
+inline float dot_product(const float* a, const float* b, size_t n) {
+#if defined(__SSE2__)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 =
+        _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4),
+                                       _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 acc = _mm_add_ps(acc0, acc1);
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(acc);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  float32x4_t acc0 = vdupq_n_f32(0);
+  float32x4_t acc1 = vdupq_n_f32(0);
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  float32x4_t acc = vaddq_f32(acc0, acc1);
+#if defined(__aarch64__)
+  return vaddvq_f32(acc);
+#else
+  float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  sum = vpadd_f32(sum, sum);
+  return vget_lane_f32(sum, 0);
+#endif
+#else
+  float acc0 = 0;
+  float acc1 = 0;
+  for (size_t i = 0; i < n; i += 2) {
+    acc0 += a[i] * b[i];
+    acc1 += a[i + 1] * b[i + 1];
+  }
+  return acc0 + acc1;
+#endif
+}
+
+// Rounds to the nearest sample, without the libm call of lrintf()
+inline int16_t to_sample(float value) {
+  value = std::min(std::max(value, -32768.0f), 32767.0f);
+  return static_cast<int16_t>(value < 0 ? value - 0.5f : value + 0.5f);
+}
+
+}  // namespace
+
+std::unique_ptr<A2dpResampler> A2dpResampler::create(uint32_t src_rate,
+                                                     uint32_t dst_rate,
+                                                     uint8_t channel_count,
+                                                     Quality quality) {
+  if (src_rate == 0 || dst_rate == 0 || channel_count < 1 ||
+      channel_count > 2 || quality < kQualityLow || quality > kQualityHigh) {
+    LOG_ERROR(LOG_TAG, "%s: unsupported conversion %u -> %u channels %u",
+              __func__, src_rate, dst_rate, channel_count);
+    return nullptr;
+  }
+  uint32_t gcd = std::gcd(src_rate, dst_rate);
+  uint32_t interpolation = dst_rate / gcd;
+  uint32_t decimation = src_rate / gcd;
+  if (interpolation > kMaxPhases) {
+    LOG_ERROR(LOG_TAG, "%s: %u -> %u needs too many filter phases (%u)",
+              __func__, src_rate, dst_rate, interpolation);
+    return nullptr;
+  }
+
+  size_t taps_per_phase = kQualityParams[quality].taps_per_phase;
+  // When decimating, the filter is proportionally longer to keep the same
+  // transition band relative to the destination rate.
+  if (decimation > interpolation) {
+    taps_per_phase = taps_per_phase * decimation / interpolation;
+    taps_per_phase = (taps_per_phase + kTapsAlignment - 1) / kTapsAlignment *
+                     kTapsAlignment;
+  }
+
+  std::unique_ptr<A2dpResampler> resampler(
+      new A2dpResampler(src_rate, dst_rate, channel_count, quality,
+                        interpolation, decimation, taps_per_phase));
+  resampler->initFilter();
+  return resampler;
+}
+
+A2dpResampler::A2dpResampler(uint32_t src_rate, uint32_t dst_rate,
+                             uint8_t channel_count, Quality quality,
+                             uint32_t interpolation, uint32_t decimation,
+                             size_t taps_per_phase)
+    : src_rate_(src_rate),
+      dst_rate_(dst_rate),
+      channel_count_(channel_count),
+      quality_(quality),
+      interpolation_(interpolation),
+      decimation_(decimation),
+      taps_per_phase_(taps_per_phase),
+      history_(channel_count,
+               std::vector<float>(taps_per_phase - 1 + kBlockFrames)),
+      phase_(0),
+      input_position_(0) {}
+
+void A2dpResampler::initFilter() {
+  const QualityParams& params = kQualityParams[quality_];
+  size_t length = taps_per_phase_ * interpolation_;
+  double center = (length - 1) / 2.0;
+  // Cutoff in cycles per sample at the interpolated rate
+  double cutoff = params.cutoff * 0.5 * std::min(src_rate_, dst_rate_) /
+                  (static_cast<double>(src_rate_) * interpolation_);
+  double window_norm = bessel_i0(params.beta);
+
+  std::vector<double> prototype(length);
+  for (size_t j = 0; j < length; j++) {
+    double t = j - center;
+    double x = 2.0 * cutoff * t;
+    double sinc = (x == 0.0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+    double r = t / (center + 0.5);
+    double window =
+        bessel_i0(params.beta * sqrt(std::max(0.0, 1.0 - r * r))) /
+        window_norm;
+    prototype[j] = sinc * window;
+  }
+
+  // Phase p filters the input with the taps p, p + L, p + 2L... each phase
+  // being normalized to unity gain at DC.
+  coefficients_.resize(length);
+  for (uint32_t p = 0; p < interpolation_; p++) {
+    double sum = 0;
+    for (size_t k = 0; k < taps_per_phase_; k++) {
+      sum += prototype[p + k * interpolation_];
+    }
+    float* phase = &coefficients_[p * taps_per_phase_];
+    for (size_t k = 0; k < taps_per_phase_; k++) {
+      phase[taps_per_phase_ - 1 - k] = prototype[p + k * interpolation_] / sum;
+    }
+  }
+}
+
+size_t A2dpResampler::maxOutputFrames(size_t src_frames) const {
+  return (src_frames * interpolation_ + decimation_ - 1) / decimation_ + 1;
+}
+
+size_t A2dpResampler::resample(const int16_t* p_src, size_t src_frames,
+                               int16_t* p_dst, size_t dst_capacity_frames) {
+  size_t history_frames = taps_per_phase_ - 1;
+  size_t written = 0;
+  while (src_frames > 0) {
+    size_t block_frames = std::min(src_frames, kBlockFrames);
+    for (uint8_t ch = 0; ch < channel_count_; ch++) {
+      float* p_history = history_[ch].data() + history_frames;
+      for (size_t i = 0; i < block_frames; i++) {
+        p_history[i] = p_src[i * channel_count_ + ch];
+      }
+    }
+    written += processBlock(block_frames, p_dst + written * channel_count_,
+                            dst_capacity_frames - written);
+    for (auto& history : history_) {
+      memmove(history.data(), history.data() + block_frames,
+              history_frames * sizeof(float));
+    }
+    p_src += block_frames * channel_count_;
+    src_frames -= block_frames;
+  }
+  return written;
+}
+
+size_t A2dpResampler::processBlock(size_t block_frames, int16_t* p_dst,
+                                   size_t dst_capacity_frames) {
+  size_t written = 0;
+  // The output frame at |input_position_| uses the inputs up to that
+  // position, i.e. the history buffer from |input_position_| for
+  // |taps_per_phase_| samples.
+  while (input_position_ < block_frames) {
+    if (written < dst_capacity_frames) {
+      const float* phase = &coefficients_[phase_ * taps_per_phase_];
+      for (uint8_t ch = 0; ch < channel_count_; ch++) {
+        const float* window = history_[ch].data() + input_position_;
+        *p_dst++ = to_sample(dot_product(phase, window, taps_per_phase_));
+      }
+      written++;
+    } else {
+      LOG_ERROR(LOG_TAG, "%s: output buffer is full, dropping frame",
+                __func__);
+    }
+    // The ratio is close to one, cheaper than a division
+    phase_ += decimation_;
+    while (phase_ >= interpolation_) {
+      phase_ -= interpolation_;
+      input_position_++;
+    }
+  }
+  input_position_ -= block_frames;
+  return written;
+}
+
+void A2dpResampler::reset() {
+  for (auto& history : history_) {
+    std::fill(history.begin(), history.end(), 0.0f);
+  }
+  phase_ = 0;
+  input_position_ = 0;
+}
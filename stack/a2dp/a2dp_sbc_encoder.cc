@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "a2dp_resampler.h"
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "bt_common.h"
@@ -134,12 +135,19 @@ typedef struct {
 
 static tA2DP_SBC_ENCODER_CB a2dp_sbc_encoder_cb;
 
+// Converts the 16-bit feeding PCM when its sample rate differs from the SBC
+// one. Not part of a2dp_sbc_encoder_cb, which is cleared with memset().
+static std::unique_ptr<A2dpResampler> a2dp_sbc_resampler;
+
 static void a2dp_sbc_encoder_update(uint16_t peer_mtu,
                                     A2dpCodecConfig* a2dp_codec_config,
                                     bool* p_restart_input,
                                     bool* p_restart_output,
                                     bool* p_config_updated);
 static bool a2dp_sbc_read_feeding(uint32_t* bytes);
+static uint32_t a2dp_sbc_resample(const int16_t* p_src, uint32_t src_bytes,
+                                  int16_t* p_dst, uint32_t dst_bytes,
+                                  uint32_t dst_rate);
 static void a2dp_sbc_encode_frames(uint8_t nb_frame);
 static void a2dp_sbc_get_num_frame_iteration(uint8_t* num_of_iterations,
                                              uint8_t* num_of_frames,
@@ -398,12 +406,14 @@ static void a2dp_sbc_encoder_update(uint16_t peer_mtu,
 
 void a2dp_sbc_encoder_cleanup(void) {
   memset(&a2dp_sbc_encoder_cb, 0, sizeof(a2dp_sbc_encoder_cb));
+  a2dp_sbc_resampler.reset();
 }
 
 void a2dp_sbc_feeding_reset(void) {
   /* By default, just clear the entire state */
   memset(&a2dp_sbc_encoder_cb.feeding_state, 0,
          sizeof(a2dp_sbc_encoder_cb.feeding_state));
+  if (a2dp_sbc_resampler != nullptr) a2dp_sbc_resampler->reset();
 
   a2dp_sbc_encoder_cb.feeding_state.bytes_per_tick =
       (a2dp_sbc_encoder_cb.feeding_params.sample_rate *
@@ -419,6 +429,7 @@ void a2dp_sbc_feeding_reset(void) {
 void a2dp_sbc_feeding_flush(void) {
   a2dp_sbc_encoder_cb.feeding_state.counter = 0;
   a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue = 0;
+  if (a2dp_sbc_resampler != nullptr) a2dp_sbc_resampler->reset();
 }
 
 uint64_t a2dp_sbc_get_encoder_interval_ms(void) {
@@ -752,23 +763,34 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
   }
   a2dp_sbc_encoder_cb.stats.media_read_total_actual_reads_count++;
 
-  /* Initialize PCM up-sampling engine */
-  a2dp_sbc_init_up_sample(a2dp_sbc_encoder_cb.feeding_params.sample_rate,
-                          sbc_sampling,
-                          a2dp_sbc_encoder_cb.feeding_params.bits_per_sample,
-                          a2dp_sbc_encoder_cb.feeding_params.channel_count);
-
   /*
    * Re-sample the read buffer.
    * The output PCM buffer will be stereo, 16 bit per sample.
    */
-  dst_size_used = a2dp_sbc_up_sample(
-      (uint8_t*)read_buffer,
-      (uint8_t*)up_sampled_buffer +
-          a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
-      nb_byte_read, sizeof(up_sampled_buffer) -
-                        a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
-      &src_size_used);
+  if (a2dp_sbc_encoder_cb.feeding_params.bits_per_sample == 16) {
+    dst_size_used = a2dp_sbc_resample(
+        (int16_t*)read_buffer, nb_byte_read,
+        (int16_t*)((uint8_t*)up_sampled_buffer +
+                   a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue),
+        sizeof(up_sampled_buffer) -
+            a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
+        sbc_sampling);
+  } else {
+    /* Initialize PCM up-sampling engine */
+    a2dp_sbc_init_up_sample(a2dp_sbc_encoder_cb.feeding_params.sample_rate,
+                            sbc_sampling,
+                            a2dp_sbc_encoder_cb.feeding_params.bits_per_sample,
+                            a2dp_sbc_encoder_cb.feeding_params.channel_count);
+
+    dst_size_used = a2dp_sbc_up_sample(
+        (uint8_t*)read_buffer,
+        (uint8_t*)up_sampled_buffer +
+            a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
+        nb_byte_read,
+        sizeof(up_sampled_buffer) -
+            a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
+        &src_size_used);
+  }
 
   /* update the residue */
   a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue += dst_size_used;
@@ -791,6 +813,46 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
   return true;
 }
 
+// Converts |src_bytes| of feeding PCM to |dst_rate| stereo PCM.
+// Returns the number of bytes written to |p_dst|.
+static uint32_t a2dp_sbc_resample(const int16_t* p_src, uint32_t src_bytes,
+                                  int16_t* p_dst, uint32_t dst_bytes,
+                                  uint32_t dst_rate) {
+  uint32_t src_rate = a2dp_sbc_encoder_cb.feeding_params.sample_rate;
+  uint8_t channel_count = a2dp_sbc_encoder_cb.feeding_params.channel_count;
+
+  if (a2dp_sbc_resampler == nullptr ||
+      a2dp_sbc_resampler->srcRate() != src_rate ||
+      a2dp_sbc_resampler->dstRate() != dst_rate ||
+      a2dp_sbc_resampler->channelCount() != channel_count) {
+    a2dp_sbc_resampler = A2dpResampler::create(
+        src_rate, dst_rate, channel_count, A2dpResampler::kQualityHigh);
+    if (a2dp_sbc_resampler == nullptr) {
+      LOG_ERROR(LOG_TAG, "%s: cannot resample %u Hz to %u Hz", __func__,
+                src_rate, dst_rate);
+      return 0;
+    }
+  }
+
+  size_t src_frames = src_bytes / (channel_count * sizeof(int16_t));
+  size_t dst_frames = dst_bytes / (2 * sizeof(int16_t));
+  if (a2dp_sbc_resampler->maxOutputFrames(src_frames) > dst_frames) {
+    LOG_ERROR(LOG_TAG, "%s: no room for %zu frames", __func__, src_frames);
+    return 0;
+  }
+  size_t frames =
+      a2dp_sbc_resampler->resample(p_src, src_frames, p_dst, dst_frames);
+
+  /* Mono is sent on both channels, expanded in place from the end */
+  if (channel_count == 1) {
+    for (size_t i = frames; i-- > 0;) {
+      p_dst[2 * i + 1] = p_dst[i];
+      p_dst[2 * i] = p_dst[i];
+    }
+  }
+  return frames * 2 * sizeof(int16_t);
+}
+
 static uint8_t calculate_max_frames_per_packet(void) {
   uint16_t effective_mtu_size = a2dp_sbc_encoder_cb.TxAaMtuSize;
   SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
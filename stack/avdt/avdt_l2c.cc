@@ -32,6 +32,7 @@
 #include "bta/include/bta_av_api.h"
 #include "btm_api.h"
 #include "btm_int.h"
+#include "common/latency_tracer.h"
 #include "device/include/interop.h"
 #include "l2c_api.h"
 #include "l2cdefs.h"
@@ -508,6 +509,9 @@ void avdt_l2c_congestion_ind_cback(uint16_t lcid, bool is_congested) {
 void avdt_l2c_data_ind_cback(uint16_t lcid, BT_HDR* p_buf) {
   AvdtpTransportChannel* p_tbl;
 
+  bluetooth::common::LatencyTracer::Stamp(
+      bluetooth::common::LatencyTracer::AVDTP_RX);
+
   /* look up info for this channel */
   p_tbl = avdt_ad_tc_tbl_by_lcid(lcid);
   if (p_tbl != NULL) {
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <math.h>
+
+#include <vector>
+
+#include "stack/include/a2dp_resampler.h"
+#include "stack/include/a2dp_sbc_up_sample.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// One 20 ms media tick of 44.1 kHz stereo
+constexpr uint32_t kSrcRate = 44100;
+constexpr uint32_t kDstRate = 48000;
+constexpr size_t kTickFrames = kSrcRate / 50;
+
+std::vector<int16_t> make_tick() {
+  std::vector<int16_t> pcm(kTickFrames * 2);
+  for (size_t i = 0; i < kTickFrames; i++) {
+    pcm[2 * i] = pcm[2 * i + 1] =
+        static_cast<int16_t>(16384 * sin(2.0 * M_PI * 997.0 * i / kSrcRate));
+  }
+  return pcm;
+}
+
+void BM_Resample(State& state, A2dpResampler::Quality quality) {
+  auto resampler = A2dpResampler::create(kSrcRate, kDstRate, 2, quality);
+  std::vector<int16_t> src = make_tick();
+  std::vector<int16_t> dst(resampler->maxOutputFrames(kTickFrames) * 2);
+  for (auto _ : state) {
+    size_t frames = resampler->resample(src.data(), kTickFrames, dst.data(),
+                                        dst.size() / 2);
+    benchmark::DoNotOptimize(frames);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kTickFrames);
+}
+
+}  // namespace
+
+// The sample-and-hold conversion used before, for reference
+static void BM_SbcUpSample(State& state) {
+  std::vector<int16_t> src = make_tick();
+  std::vector<int16_t> dst(kTickFrames * 2 * 2);
+  a2dp_sbc_init_up_sample(kSrcRate, kDstRate, 16, 2);
+  for (auto _ : state) {
+    uint32_t src_used;
+    int bytes = a2dp_sbc_up_sample(src.data(), dst.data(),
+                                   src.size() * sizeof(int16_t),
+                                   dst.size() * sizeof(int16_t), &src_used);
+    benchmark::DoNotOptimize(bytes);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kTickFrames);
+}
+BENCHMARK(BM_SbcUpSample);
+
+static void BM_Resample_QualityLow(State& state) {
+  BM_Resample(state, A2dpResampler::kQualityLow);
+}
+BENCHMARK(BM_Resample_QualityLow);
+
+static void BM_Resample_QualityMedium(State& state) {
+  BM_Resample(state, A2dpResampler::kQualityMedium);
+}
+BENCHMARK(BM_Resample_QualityMedium);
+
+static void BM_Resample_QualityHigh(State& state) {
+  BM_Resample(state, A2dpResampler::kQualityHigh);
+}
+BENCHMARK(BM_Resample_QualityHigh);
+
+BENCHMARK_MAIN();
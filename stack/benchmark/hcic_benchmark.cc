@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "bt_target.h"
+#include "hci/include/command_buffer_pool.h"
+#include "osi/include/allocator.h"
+#include "stack/hcic/hcic_builder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+using BleUpdLlConnParamsCmd =
+    hcic::Command<HCI_BLE_UPD_LL_CONN_PARAMS,
+                  HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS, hcic::Uint16,
+                  hcic::Uint16, hcic::Uint16, hcic::Uint16, hcic::Uint16,
+                  hcic::Uint16, hcic::Uint16>;
+using BleSetScanEnableCmd =
+    hcic::Command<HCI_BLE_WRITE_SCAN_ENABLE,
+                  HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE, hcic::Uint8,
+                  hcic::Uint8>;
+
+// The former builders: a buffer of HCI_CMD_BUF_SIZE bytes for every command
+BT_HDR* legacy_upd_ll_conn_params(uint16_t handle, uint16_t conn_int_min,
+                                  uint16_t conn_int_max, uint16_t conn_latency,
+                                  uint16_t conn_timeout, uint16_t min_ce_len,
+                                  uint16_t max_ce_len) {
+  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
+  uint8_t* pp = (uint8_t*)(p + 1);
+
+  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS;
+  p->offset = 0;
+
+  UINT16_TO_STREAM(pp, HCI_BLE_UPD_LL_CONN_PARAMS);
+  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS);
+
+  UINT16_TO_STREAM(pp, handle);
+  UINT16_TO_STREAM(pp, conn_int_min);
+  UINT16_TO_STREAM(pp, conn_int_max);
+  UINT16_TO_STREAM(pp, conn_latency);
+  UINT16_TO_STREAM(pp, conn_timeout);
+  UINT16_TO_STREAM(pp, min_ce_len);
+  UINT16_TO_STREAM(pp, max_ce_len);
+  return p;
+}
+
+BT_HDR* legacy_set_scan_enable(uint8_t scan_enable, uint8_t duplicate) {
+  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
+  uint8_t* pp = (uint8_t*)(p + 1);
+
+  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE;
+  p->offset = 0;
+
+  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_SCAN_ENABLE);
+  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE);
+
+  UINT8_TO_STREAM(pp, scan_enable);
+  UINT8_TO_STREAM(pp, duplicate);
+  return p;
+}
+
+// The commands of a burst wait for command credits in the HCI layer, and are
+// released once the controller answered them
+void complete(std::vector<BT_HDR*>* in_flight, void (*free_fn)(BT_HDR*)) {
+  for (BT_HDR* p : *in_flight) free_fn(p);
+  in_flight->clear();
+}
+
+void legacy_free(BT_HDR* p) { osi_free(p); }
+
+}  // namespace
+
+// All the LE links get new connection parameters at once, e.g. when the
+// screen turns off
+static void BM_ConnParamsBurst_Legacy(State& state) {
+  std::vector<BT_HDR*> in_flight;
+  for (auto _ : state) {
+    for (uint16_t handle = 0; handle < state.range(0); handle++) {
+      in_flight.push_back(legacy_upd_ll_conn_params(handle, 0x18, 0x28, 0,
+                                                    0x1f4, 0, 0));
+    }
+    complete(&in_flight, legacy_free);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConnParamsBurst_Legacy)->Arg(7)->Arg(16);
+
+static void BM_ConnParamsBurst_Pooled(State& state) {
+  std::vector<BT_HDR*> in_flight;
+  for (auto _ : state) {
+    for (uint16_t handle = 0; handle < state.range(0); handle++) {
+      in_flight.push_back(
+          BleUpdLlConnParamsCmd::Build(handle, 0x18, 0x28, 0, 0x1f4, 0, 0));
+    }
+    complete(&in_flight, command_buffer_free);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConnParamsBurst_Pooled)->Arg(7)->Arg(16);
+
+// Scanning turned on and off repeatedly, e.g. by several scanning apps. The
+// largest storm does not fit in the pool.
+static void BM_ScanEnableStorm_Legacy(State& state) {
+  std::vector<BT_HDR*> in_flight;
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      in_flight.push_back(legacy_set_scan_enable(i & 1, 0));
+    }
+    complete(&in_flight, legacy_free);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScanEnableStorm_Legacy)->Arg(8)->Arg(32)->Arg(128);
+
+static void BM_ScanEnableStorm_Pooled(State& state) {
+  std::vector<BT_HDR*> in_flight;
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      in_flight.push_back(BleSetScanEnableCmd::Build(i & 1, 0));
+    }
+    complete(&in_flight, command_buffer_free);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScanEnableStorm_Pooled)->Arg(8)->Arg(32)->Arg(128);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "stack/sdp/sdpint.h"
+
+using ::benchmark::State;
+
+tSDP_CB sdp_cb;
+
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// Large enough for the records of the largest response
+constexpr size_t kDbSize = 256 * 1024;
+
+// Builds responses to service search attribute requests, the random choices
+// seeded so that every run parses the same responses
+class ResponseGenerator {
+ public:
+  explicit ResponseGenerator(uint32_t seed) : random_(seed) {}
+
+  Bytes Response(int num_records) {
+    Bytes records;
+    for (int i = 0; i < num_records; i++) Append(&records, Record());
+    return Element(DATA_ELE_SEQ_DESC_TYPE, records);
+  }
+
+ private:
+  int Random(int n) {
+    return std::uniform_int_distribution<int>(0, n - 1)(random_);
+  }
+
+  static void Append(Bytes* out, const Bytes& bytes) {
+    out->insert(out->end(), bytes.begin(), bytes.end());
+  }
+
+  static Bytes Element(uint8_t type, const Bytes& value) {
+    Bytes element;
+    if (value.size() < 0x100) {
+      element = {(uint8_t)((type << 3) | SIZE_IN_NEXT_BYTE),
+                 (uint8_t)value.size()};
+    } else {
+      element = {(uint8_t)((type << 3) | SIZE_IN_NEXT_WORD),
+                 (uint8_t)(value.size() >> 8), (uint8_t)value.size()};
+    }
+    Append(&element, value);
+    return element;
+  }
+
+  Bytes Fixed(uint8_t type, uint8_t size_index, int len) {
+    Bytes element = {(uint8_t)((type << 3) | size_index)};
+    for (int i = 0; i < len; i++) element.push_back(Random(256));
+    return element;
+  }
+
+  Bytes Uuid128() {
+    static const uint8_t kBaseUuid[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                        0x10, 0x00, 0x80, 0x00, 0x00, 0x80,
+                                        0x5F, 0x9B, 0x34, 0xFB};
+    bool vendor = Random(3) == 0;
+    Bytes element = {(UUID_DESC_TYPE << 3) | SIZE_SIXTEEN_BYTES};
+    for (int i = 0; i < 16; i++)
+      element.push_back((i < 4 || vendor) ? Random(256) : kBaseUuid[i]);
+    return element;
+  }
+
+  Bytes Text() {
+    // Mostly names, some long descriptions
+    int len = Random(5) ? Random(40) : 200 + Random(300);
+    Bytes text;
+    for (int i = 0; i < len; i++) text.push_back('a' + Random(26));
+    return Element(Random(4) ? TEXT_STR_DESC_TYPE : URL_DESC_TYPE, text);
+  }
+
+  Bytes Value(int nest_level) {
+    switch (Random(nest_level < 3 ? 12 : 9)) {
+      case 0:
+        return Fixed(UINT_DESC_TYPE, SIZE_ONE_BYTE, 1);
+      case 1:
+        return Fixed(UINT_DESC_TYPE, SIZE_TWO_BYTES, 2);
+      case 2:
+        return Fixed(UINT_DESC_TYPE, SIZE_FOUR_BYTES, 4);
+      case 3:
+        return Fixed(TWO_COMP_INT_DESC_TYPE, SIZE_EIGHT_BYTES, 8);
+      case 4:
+        return Fixed(UUID_DESC_TYPE, SIZE_TWO_BYTES, 2);
+      case 5:
+        return Uuid128();
+      case 6:
+      case 7:
+        return Text();
+      case 8:
+        return Fixed(BOOLEAN_DESC_TYPE, SIZE_ONE_BYTE, 1);
+      default: {
+        // Protocol and profile descriptor lists, and the like
+        Bytes values;
+        for (int i = Random(5); i > 0; i--)
+          Append(&values, Value(nest_level + 1));
+        return Element(DATA_ELE_SEQ_DESC_TYPE, values);
+      }
+    }
+  }
+
+  Bytes Record() {
+    std::set<uint16_t> attr_ids = {ATTR_ID_SERVICE_RECORD_HDL,
+                                   ATTR_ID_SERVICE_CLASS_ID_LIST,
+                                   ATTR_ID_PROTOCOL_DESC_LIST};
+    size_t num_attrs = 3 + Random(12);
+    while (attr_ids.size() < num_attrs) attr_ids.insert(Random(0x400));
+
+    Bytes attrs;
+    for (uint16_t attr_id : attr_ids) {
+      Append(&attrs, {(UINT_DESC_TYPE << 3) | SIZE_TWO_BYTES,
+                      (uint8_t)(attr_id >> 8), (uint8_t)attr_id});
+      Append(&attrs, Value(0));
+    }
+    return Element(DATA_ELE_SEQ_DESC_TYPE, attrs);
+  }
+
+  std::mt19937 random_;
+};
+
+// Empties the database, without clearing the memory the parser fills in
+tSDP_DISCOVERY_DB* InitDb(std::vector<uint8_t>* storage) {
+  tSDP_DISCOVERY_DB* p_db =
+      reinterpret_cast<tSDP_DISCOVERY_DB*>(storage->data());
+  p_db->p_first_rec = NULL;
+  p_db->mem_size = storage->size() - sizeof(tSDP_DISCOVERY_DB);
+  p_db->mem_free = p_db->mem_size;
+  p_db->p_free_mem = (uint8_t*)(p_db + 1);
+  return p_db;
+}
+
+}  // namespace
+
+// A phone answering a service search attribute request for all its records,
+// the response split in continuation fragments of the given size
+static void BM_ParseSearchAttrResponse(State& state) {
+  Bytes response = ResponseGenerator(state.range(0)).Response(state.range(1));
+  size_t fragment_len = state.range(2);
+  std::vector<uint8_t> storage(kDbSize);
+  tSDP_DISC_PARSER parser;
+
+  for (auto _ : state) {
+    tSDP_DISCOVERY_DB* p_db = InitDb(&storage);
+
+    sdp_disc_parse_start(&parser, p_db, RawAddress::kAny, SDP_DISC_PARSE_LIST);
+    for (size_t offset = 0; offset < response.size(); offset += fragment_len) {
+      size_t len = std::min(fragment_len, response.size() - offset);
+      if (sdp_disc_parse_data(&parser, &response[offset], len) !=
+          SDP_SUCCESS) {
+        state.SkipWithError("Invalid response");
+        return;
+      }
+    }
+    if (sdp_disc_parse_end(&parser) != SDP_SUCCESS) {
+      state.SkipWithError("Incomplete response");
+      return;
+    }
+    benchmark::DoNotOptimize(p_db->p_first_rec);
+  }
+  state.SetBytesProcessed(state.iterations() * response.size());
+}
+
+// A few responses for each size, fragments the size of the default and of
+// the largest L2CAP MTU used by the SDP servers
+static void SearchAttrResponses(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"seed", "records", "fragment"});
+  for (int seed = 1; seed <= 3; seed++) {
+    for (int num_records : {8, 32, 64}) {
+      for (int fragment_len : {48, 672})
+        b->Args({seed, num_records, fragment_len});
+    }
+  }
+}
+BENCHMARK(BM_ParseSearchAttrResponse)->Apply(SearchAttrResponses);
+
+BENCHMARK_MAIN();
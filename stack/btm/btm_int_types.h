@@ -647,6 +647,11 @@ typedef struct {
 #endif
   tBTM_PM_STATE state; /* contains the current mode of the connection */
   bool chg_ind;        /* a request change indication */
+  bool cmd_pend;       /* waiting for the status of a mode command */
+  uint8_t pend_id;     /* the id of the module the mode command is sent for */
+  uint64_t active_since_ms; /* when the connection last entered active mode */
+  uint64_t defer_until_ms;  /* low power request held back until then, or 0 */
+  tBTM_PM_LINK_STATS stats;
 } tBTM_PM_MCB;
 
 #define BTM_PM_REC_NOT_USED 0
@@ -748,8 +753,7 @@ typedef struct {
   ****************************************************/
   tBTM_PM_MCB pm_mode_db[MAX_L2CAP_LINKS];       /* per ACL link */
   tBTM_PM_RCB pm_reg_db[BTM_MAX_PM_RECORDS + 1]; /* per application/module */
-  uint8_t pm_pend_link; /* the index of acl_db, which has a pending PM cmd */
-  uint8_t pm_pend_id;   /* the id pf the module, which has a pending PM cmd */
+  alarm_t* pm_defer_timer; /* sends the held back low power requests */
 
   /*****************************************************
   **      Device control
@@ -52,6 +52,7 @@ void btm_init(void) {
   btm_cb.sec_pending_q = fixed_queue_new(SIZE_MAX);
   btm_cb.sec_collision_timer = alarm_new("btm.sec_collision_timer");
   btm_cb.pairing_timer = alarm_new("btm.pairing_timer");
+  btm_cb.pm_defer_timer = alarm_new("btm.pm_defer_timer");
 
 #if defined(BTM_INITIAL_TRACE_LEVEL)
   btm_cb.trace_level = BTM_INITIAL_TRACE_LEVEL;
@@ -99,4 +100,7 @@ void btm_free(void) {
 
   alarm_free(btm_cb.pairing_timer);
   btm_cb.pairing_timer = NULL;
+
+  alarm_free(btm_cb.pm_defer_timer);
+  btm_cb.pm_defer_timer = NULL;
 }
@@ -42,6 +42,7 @@
 #include "btm_int.h"
 #include "btm_int_types.h"
 #include "btu.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "hcidefs.h"
 #include "hcimsgs.h"
@@ -77,6 +78,10 @@ const uint8_t
 static int btm_pm_find_acl_ind(const RawAddress& remote_bda);
 static tBTM_STATUS btm_pm_snd_md_req(uint8_t pm_id, int link_ind,
                                      const tBTM_PM_PWR_MD* p_mode);
+static bool btm_pm_link_busy(int link_ind);
+static bool btm_pm_defer_needed(const tBTM_PM_MCB* p_cb,
+                                const tBTM_PM_PWR_MD* p_mode);
+static void btm_pm_set_defer_timer(void);
 static const char* mode_to_string(const tBTM_PM_MODE mode);
 
 #if (BTM_PM_DEBUG == TRUE)
@@ -152,6 +157,7 @@ tBTM_STATUS BTM_SetPowerMode(uint8_t pm_id, const RawAddress& remote_bda,
   tBTM_PM_MCB* p_cb = nullptr; /* per ACL link */
   tBTM_PM_MODE mode;
   int temp_pm_id;
+  bool defer;
 
   if (pm_id >= BTM_MAX_PM_RECORDS) {
     pm_id = BTM_PM_SET_ONLY_ID;
@@ -186,7 +192,9 @@ tBTM_STATUS BTM_SetPowerMode(uint8_t pm_id, const RawAddress& remote_bda,
     }
   }
 
-  if (mode == p_cb->state) {
+  /* while a low power request is held back, a wake up request is stored to
+   * cancel it */
+  if (mode == p_cb->state && p_cb->defer_until_ms == 0) {
     /* already in the requested mode and the current interval has less latency
      * than the max */
     if ((mode == BTM_PM_MD_ACTIVE) ||
@@ -206,11 +214,14 @@ tBTM_STATUS BTM_SetPowerMode(uint8_t pm_id, const RawAddress& remote_bda,
     temp_pm_id = BTM_MAX_PM_RECORDS;
   }
 
+  /* a low power request right after the link woke up is held back */
+  defer = btm_pm_defer_needed(p_cb, p_mode);
+
   /* update mode database */
   if (((pm_id != BTM_PM_SET_ONLY_ID) &&
        (btm_cb.pm_reg_db[pm_id].mask & BTM_PM_REG_SET)) ||
       ((pm_id == BTM_PM_SET_ONLY_ID) &&
-       (btm_cb.pm_pend_link != MAX_L2CAP_LINKS))) {
+       (defer || btm_pm_link_busy(acl_ind)))) {
 #if (BTM_PM_DEBUG == TRUE)
     BTM_TRACE_DEBUG("BTM_SetPowerMode: Saving cmd acl_ind %d temp_pm_id %d",
                     acl_ind, temp_pm_id);
@@ -221,15 +232,25 @@ tBTM_STATUS BTM_SetPowerMode(uint8_t pm_id, const RawAddress& remote_bda,
     p_cb->chg_ind = true;
   }
 
+  if (defer) {
+    /* sent by btm_pm_defer_timeout, unless the link is woken up meanwhile */
+    if (p_cb->defer_until_ms == 0) {
+      p_cb->defer_until_ms = p_cb->active_since_ms + BTM_PM_SNIFF_HOLDOFF_MS;
+      btm_pm_set_defer_timer();
+    }
+    p_cb->stats.deferred++;
+    BTM_TRACE_DEBUG("%s: btm_pm mode %d deferred:%d", __func__, mode, acl_ind);
+    return BTM_CMD_STORED;
+  }
+
 #if (BTM_PM_DEBUG == TRUE)
-  BTM_TRACE_DEBUG("btm_pm state:0x%x, pm_pend_link: %d", p_cb->state,
-                  btm_cb.pm_pend_link);
+  BTM_TRACE_DEBUG("btm_pm state:0x%x, cmd_pend: %d", p_cb->state,
+                  p_cb->cmd_pend);
 #endif  // BTM_PM_DEBUG
   /* if mode == hold or pending, return */
-  if ((p_cb->state == BTM_PM_STS_HOLD) || (p_cb->state == BTM_PM_STS_PENDING) ||
-      (btm_cb.pm_pend_link != MAX_L2CAP_LINKS)) {
+  if (btm_pm_link_busy(acl_ind)) {
     /* command pending */
-    if (acl_ind != btm_cb.pm_pend_link) {
+    if (!p_cb->cmd_pend) {
       /* set the stored mask */
       p_cb->state |= BTM_PM_STORED_MASK;
       BTM_TRACE_DEBUG("%s: btm_pm state stored:%d", __func__, acl_ind);
@@ -237,6 +258,12 @@ tBTM_STATUS BTM_SetPowerMode(uint8_t pm_id, const RawAddress& remote_bda,
     return BTM_CMD_STORED;
   }
 
+  if (p_cb->defer_until_ms != 0) {
+    /* the held back request is replaced by this one */
+    p_cb->defer_until_ms = 0;
+    if (mode == BTM_PM_MD_ACTIVE) p_cb->stats.flaps_avoided++;
+  }
+
   return btm_pm_snd_md_req(pm_id, acl_ind, p_mode);
 }
 
@@ -271,6 +298,32 @@ tBTM_STATUS BTM_ReadPowerMode(const RawAddress& remote_bda,
   return BTM_SUCCESS;
 }
 
+/*******************************************************************************
+ *
+ * Function         BTM_PmReadLinkStats
+ *
+ * Description      This returns the counters of the power mode changes of a
+ *                  specific ACL connection.
+ *
+ * Input Param      remote_bda - device address of desired ACL connection
+ *
+ * Output Param     p_stats - address where the counters are copied into
+ *                            (valid only if return code is BTM_SUCCESS)
+ *
+ * Returns          BTM_SUCCESS if successful,
+ *                  BTM_UNKNOWN_ADDR if bd addr is not active or bad
+ *
+ ******************************************************************************/
+tBTM_STATUS BTM_PmReadLinkStats(const RawAddress& remote_bda,
+                                tBTM_PM_LINK_STATS* p_stats) {
+  int acl_ind = btm_pm_find_acl_ind(remote_bda);
+
+  if (acl_ind == MAX_L2CAP_LINKS) return (BTM_UNKNOWN_ADDR);
+
+  *p_stats = btm_cb.pm_mode_db[acl_ind].stats;
+  return BTM_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         btm_read_power_mode_state
@@ -356,12 +409,15 @@ tBTM_STATUS BTM_SetSsrParams(const RawAddress& remote_bda, uint16_t max_lat,
  ******************************************************************************/
 void btm_pm_reset(void) {
   int xx;
-  tBTM_PM_STATUS_CBACK* cb = NULL;
+  tBTM_PM_STATUS_CBACK* cb[MAX_L2CAP_LINKS] = {};
 
-  /* clear the pending request for application */
-  if ((btm_cb.pm_pend_id != BTM_PM_SET_ONLY_ID) &&
-      (btm_cb.pm_reg_db[btm_cb.pm_pend_id].mask & BTM_PM_REG_NOTIF)) {
-    cb = btm_cb.pm_reg_db[btm_cb.pm_pend_id].cback;
+  /* clear the pending requests for application */
+  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
+    tBTM_PM_MCB* p_cb = &btm_cb.pm_mode_db[xx];
+    if (p_cb->cmd_pend && (p_cb->pend_id != BTM_PM_SET_ONLY_ID) &&
+        (btm_cb.pm_reg_db[p_cb->pend_id].mask & BTM_PM_REG_NOTIF)) {
+      cb[xx] = btm_cb.pm_reg_db[p_cb->pend_id].cback;
+    }
   }
 
   /* clear the register record */
@@ -369,12 +425,16 @@ void btm_pm_reset(void) {
     btm_cb.pm_reg_db[xx].mask = BTM_PM_REC_NOT_USED;
   }
 
-  if (cb != NULL && btm_cb.pm_pend_link < MAX_L2CAP_LINKS)
-    (*cb)(btm_cb.acl_db[btm_cb.pm_pend_link].remote_addr, BTM_PM_STS_ERROR,
-          BTM_DEV_RESET, 0);
+  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
+    if (cb[xx] != NULL)
+      (*cb[xx])(btm_cb.acl_db[xx].remote_addr, BTM_PM_STS_ERROR, BTM_DEV_RESET,
+                0);
 
-  /* no command pending */
-  btm_cb.pm_pend_link = MAX_L2CAP_LINKS;
+    /* no command pending */
+    btm_cb.pm_mode_db[xx].cmd_pend = false;
+    btm_cb.pm_mode_db[xx].defer_until_ms = 0;
+  }
+  alarm_cancel(btm_cb.pm_defer_timer);
 }
 
 /*******************************************************************************
@@ -391,6 +451,7 @@ void btm_pm_sm_alloc(uint8_t ind) {
   tBTM_PM_MCB* p_db = &btm_cb.pm_mode_db[ind]; /* per ACL link */
   memset(p_db, 0, sizeof(tBTM_PM_MCB));
   p_db->state = BTM_PM_ST_ACTIVE;
+  p_db->active_since_ms = bluetooth::common::time_get_os_boottime_ms();
 #if (BTM_PM_DEBUG == TRUE)
   BTM_TRACE_DEBUG("btm_pm_sm_alloc ind:%d st:%d", ind, p_db->state);
 #endif  // BTM_PM_DEBUG
@@ -598,10 +659,10 @@ static tBTM_STATUS btm_pm_snd_md_req(uint8_t pm_id, int link_ind,
   }
 #endif  // BTM_SSR_INCLUDED
   /* Default is failure */
-  btm_cb.pm_pend_link = MAX_L2CAP_LINKS;
+  p_cb->cmd_pend = false;
 
   /* send the appropriate HCI command */
-  btm_cb.pm_pend_id = pm_id;
+  p_cb->pend_id = pm_id;
 
 #if (BTM_PM_DEBUG == TRUE)
   BTM_TRACE_DEBUG("btm_pm_snd_md_req state:0x%x, link_ind: %d", p_cb->state,
@@ -615,14 +676,14 @@ static tBTM_STATUS btm_pm_snd_md_req(uint8_t pm_id, int link_ind,
       switch (p_cb->state) {
         case BTM_PM_MD_SNIFF:
           btsnd_hcic_exit_sniff_mode(btm_cb.acl_db[link_ind].hci_handle);
-          btm_cb.pm_pend_link = link_ind;
+          p_cb->cmd_pend = true;
           break;
         case BTM_PM_MD_PARK:
           btsnd_hcic_exit_park_mode(btm_cb.acl_db[link_ind].hci_handle);
-          btm_cb.pm_pend_link = link_ind;
+          p_cb->cmd_pend = true;
           break;
         default:
-          /* Failure btm_cb.pm_pend_link = MAX_L2CAP_LINKS */
+          /* Failure p_cb->cmd_pend = false */
           break;
       }
       break;
@@ -630,43 +691,169 @@ static tBTM_STATUS btm_pm_snd_md_req(uint8_t pm_id, int link_ind,
     case BTM_PM_MD_HOLD:
       btsnd_hcic_hold_mode(btm_cb.acl_db[link_ind].hci_handle, md_res.max,
                            md_res.min);
-      btm_cb.pm_pend_link = link_ind;
+      p_cb->cmd_pend = true;
       break;
 
     case BTM_PM_MD_SNIFF:
       btsnd_hcic_sniff_mode(btm_cb.acl_db[link_ind].hci_handle, md_res.max,
                             md_res.min, md_res.attempt, md_res.timeout);
-      btm_cb.pm_pend_link = link_ind;
+      p_cb->cmd_pend = true;
       break;
 
     case BTM_PM_MD_PARK:
       btsnd_hcic_park_mode(btm_cb.acl_db[link_ind].hci_handle, md_res.max,
                            md_res.min);
-      btm_cb.pm_pend_link = link_ind;
+      p_cb->cmd_pend = true;
       break;
     default:
-      /* Failure btm_cb.pm_pend_link = MAX_L2CAP_LINKS */
+      /* Failure p_cb->cmd_pend = false */
       break;
   }
 
-  if (btm_cb.pm_pend_link == MAX_L2CAP_LINKS) {
+  if (!p_cb->cmd_pend) {
 /* the command was not sent */
 #if (BTM_PM_DEBUG == TRUE)
-    BTM_TRACE_DEBUG("pm_pend_link: %d", btm_cb.pm_pend_link);
+    BTM_TRACE_DEBUG("cmd_pend: %d", p_cb->cmd_pend);
 #endif  // BTM_PM_DEBUG
     return (BTM_NO_RESOURCES);
   }
 
+  p_cb->stats.cmds_sent++;
   return BTM_CMD_STARTED;
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_pm_link_busy
+ *
+ * Description      This function checks if a mode command cannot be sent for
+ *                  an ACL link now: the link waits for the status or the
+ *                  result of a command, or BTM_PM_MAX_PEND_CMDS links do.
+ *
+ * Returns          true if the request for the link has to be stored.
+ *
+ ******************************************************************************/
+static bool btm_pm_link_busy(int link_ind) {
+  tBTM_PM_MCB* p_cb = &btm_cb.pm_mode_db[link_ind];
+  tBTM_PM_STATE state = p_cb->state & ~BTM_PM_STORED_MASK;
+  int xx, pend_cmds = 0;
+
+  if ((state == BTM_PM_STS_HOLD) || (state == BTM_PM_STS_PENDING) ||
+      p_cb->cmd_pend)
+    return true;
+
+  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
+    if (btm_cb.acl_db[xx].in_use && btm_cb.pm_mode_db[xx].cmd_pend)
+      pend_cmds++;
+  }
+  return pend_cmds >= BTM_PM_MAX_PEND_CMDS;
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_pm_defer_needed
+ *
+ * Description      This function checks if a request has to be held back,
+ *                  because it would put an ACL link back to a low power mode
+ *                  less than BTM_PM_SNIFF_HOLDOFF_MS after it woke up. Wake
+ *                  up and forced requests are never held back.
+ *
+ * Returns          true if the request has to be held back.
+ *
+ ******************************************************************************/
+static bool btm_pm_defer_needed(const tBTM_PM_MCB* p_cb,
+                                const tBTM_PM_PWR_MD* p_mode) {
+  if (BTM_PM_SNIFF_HOLDOFF_MS == 0 || p_mode->mode == BTM_PM_MD_ACTIVE ||
+      (p_mode->mode & BTM_PM_MD_FORCE) || p_cb->state != BTM_PM_STS_ACTIVE)
+    return false;
+
+  return p_cb->defer_until_ms != 0 ||
+         bluetooth::common::time_get_os_boottime_ms() <
+             p_cb->active_since_ms + BTM_PM_SNIFF_HOLDOFF_MS;
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_pm_defer_timeout
+ *
+ * Description      This function is called when the held back requests of
+ *                  the ACL links are due. The resulting modes are sent for
+ *                  all the due links together.
+ *
+ * Returns          none.
+ *
+ ******************************************************************************/
+static void btm_pm_defer_timeout(UNUSED_ATTR void* data) {
+  uint64_t now = bluetooth::common::time_get_os_boottime_ms();
+  tBTM_PM_MCB* p_cb;
+  int xx;
+
+  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
+    p_cb = &btm_cb.pm_mode_db[xx];
+    if (!btm_cb.acl_db[xx].in_use || p_cb->defer_until_ms == 0 ||
+        p_cb->defer_until_ms > now)
+      continue;
+
+    p_cb->defer_until_ms = 0;
+    if (btm_pm_link_busy(xx)) {
+      /* sent once the command in progress is done */
+      if (p_cb->cmd_pend)
+        p_cb->chg_ind = true;
+      else
+        p_cb->state |= BTM_PM_STORED_MASK;
+      continue;
+    }
+
+    if (btm_pm_snd_md_req(BTM_PM_SET_ONLY_ID, xx, NULL) == BTM_CMD_STORED &&
+        p_cb->state == BTM_PM_STS_ACTIVE) {
+      /* woken up again before the request was due, the link stays active */
+      p_cb->stats.flaps_avoided++;
+    }
+  }
+
+  btm_pm_set_defer_timer();
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_pm_set_defer_timer
+ *
+ * Description      This function starts the timer for the earliest held back
+ *                  request, or stops it if there is none.
+ *
+ * Returns          none.
+ *
+ ******************************************************************************/
+static void btm_pm_set_defer_timer(void) {
+  uint64_t next_ms = 0;
+  uint64_t now;
+  int xx;
+
+  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
+    uint64_t until_ms = btm_cb.pm_mode_db[xx].defer_until_ms;
+    if (btm_cb.acl_db[xx].in_use && until_ms != 0 &&
+        (next_ms == 0 || until_ms < next_ms))
+      next_ms = until_ms;
+  }
+
+  if (next_ms == 0) {
+    alarm_cancel(btm_cb.pm_defer_timer);
+    return;
+  }
+
+  now = bluetooth::common::time_get_os_boottime_ms();
+  alarm_set_on_mloop(btm_cb.pm_defer_timer, next_ms > now ? next_ms - now : 0,
+                     btm_pm_defer_timeout, NULL);
+}
+
 /*******************************************************************************
  *
  * Function         btm_pm_check_stored
  *
  * Description      This function is called when an HCI command status event
  *                  occurs to check if there's any PM command issued while
- *                  waiting for HCI command status.
+ *                  waiting for HCI command status. The commands of all the
+ *                  links that are no longer busy are sent together.
  *
  * Returns          none.
  *
@@ -674,11 +861,11 @@ static tBTM_STATUS btm_pm_snd_md_req(uint8_t pm_id, int link_ind,
 static void btm_pm_check_stored(void) {
   int xx;
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
-    if (btm_cb.pm_mode_db[xx].state & BTM_PM_STORED_MASK) {
+    if ((btm_cb.pm_mode_db[xx].state & BTM_PM_STORED_MASK) &&
+        btm_cb.acl_db[xx].in_use && !btm_pm_link_busy(xx)) {
       btm_cb.pm_mode_db[xx].state &= ~BTM_PM_STORED_MASK;
       BTM_TRACE_DEBUG("btm_pm_check_stored :%d", xx);
       btm_pm_snd_md_req(BTM_PM_SET_ONLY_ID, xx, NULL);
-      break;
     }
   }
 }
@@ -691,17 +878,24 @@ static void btm_pm_check_stored(void) {
  *                  occurs for power manager related commands.
  *
  * Input Parms      status - status of the event (HCI_SUCCESS if no errors)
+ *                  hci_handle - connection handle the command was sent for
  *
  * Returns          none.
  *
  ******************************************************************************/
-void btm_pm_proc_cmd_status(uint8_t status) {
+void btm_pm_proc_cmd_status(uint8_t status, uint16_t hci_handle) {
   tBTM_PM_MCB* p_cb;
   tBTM_PM_STATUS pm_status;
+  int xx;
 
-  if (btm_cb.pm_pend_link >= MAX_L2CAP_LINKS) return;
+  xx = btm_handle_to_acl_index(hci_handle);
+  if (xx >= MAX_L2CAP_LINKS || !btm_cb.pm_mode_db[xx].cmd_pend) {
+    /* the link is gone, others may have been waiting for its command */
+    btm_pm_check_stored();
+    return;
+  }
 
-  p_cb = &btm_cb.pm_mode_db[btm_cb.pm_pend_link];
+  p_cb = &btm_cb.pm_mode_db[xx];
 
   if (status == HCI_SUCCESS) {
     p_cb->state = BTM_PM_ST_PENDING;
@@ -712,22 +906,23 @@ void btm_pm_proc_cmd_status(uint8_t status) {
   } else /* the command was not successfull. Stay in the same state */
   {
     pm_status = BTM_PM_STS_ERROR;
+    p_cb->stats.cmds_failed++;
   }
 
+  /* no pending cmd now */
+  p_cb->cmd_pend = false;
+
   /* notify the caller is appropriate */
-  if ((btm_cb.pm_pend_id != BTM_PM_SET_ONLY_ID) &&
-      (btm_cb.pm_reg_db[btm_cb.pm_pend_id].mask & BTM_PM_REG_NOTIF)) {
-    (*btm_cb.pm_reg_db[btm_cb.pm_pend_id].cback)(
-        btm_cb.acl_db[btm_cb.pm_pend_link].remote_addr, pm_status, 0, status);
+  if ((p_cb->pend_id != BTM_PM_SET_ONLY_ID) &&
+      (btm_cb.pm_reg_db[p_cb->pend_id].mask & BTM_PM_REG_NOTIF)) {
+    (*btm_cb.pm_reg_db[p_cb->pend_id].cback)(btm_cb.acl_db[xx].remote_addr,
+                                             pm_status, 0, status);
   }
 
-/* no pending cmd now */
 #if (BTM_PM_DEBUG == TRUE)
-  BTM_TRACE_DEBUG(
-      "btm_pm_proc_cmd_status state:0x%x, pm_pend_link: %d(new: %d)",
-      p_cb->state, btm_cb.pm_pend_link, MAX_L2CAP_LINKS);
+  BTM_TRACE_DEBUG("btm_pm_proc_cmd_status state:0x%x, link_ind: %d",
+                  p_cb->state, xx);
 #endif  // BTM_PM_DEBUG
-  btm_cb.pm_pend_link = MAX_L2CAP_LINKS;
 
   btm_pm_check_stored();
 }
@@ -769,6 +964,25 @@ void btm_pm_proc_mode_change(uint8_t hci_status, uint16_t hci_handle,
   p_cb->state = mode;
   p_cb->interval = interval;
 
+  if (hci_status == HCI_SUCCESS &&
+      (old_state & ~BTM_PM_STORED_MASK) != mode) {
+    switch (mode) {
+      case BTM_PM_MD_ACTIVE:
+        p_cb->active_since_ms = bluetooth::common::time_get_os_boottime_ms();
+        p_cb->stats.to_active++;
+        break;
+      case BTM_PM_MD_HOLD:
+        p_cb->stats.to_hold++;
+        break;
+      case BTM_PM_MD_SNIFF:
+        p_cb->stats.to_sniff++;
+        break;
+      case BTM_PM_MD_PARK:
+        p_cb->stats.to_park++;
+        break;
+    }
+  }
+
   BTM_TRACE_DEBUG("%s switched from %s to %s.", __func__,
                   mode_to_string(old_state), mode_to_string(p_cb->state));
 
@@ -796,15 +1010,19 @@ void btm_pm_proc_mode_change(uint8_t hci_status, uint16_t hci_handle,
 #if (BTM_PM_DEBUG == TRUE)
     BTM_TRACE_DEBUG("btm_pm_proc_mode_change: Sending stored req:%d", xx);
 #endif  // BTM_PM_DEBUG
-    btm_pm_snd_md_req(BTM_PM_SET_ONLY_ID, xx, NULL);
+    if (btm_pm_link_busy(xx))
+      p_cb->state |= BTM_PM_STORED_MASK;
+    else
+      btm_pm_snd_md_req(BTM_PM_SET_ONLY_ID, xx, NULL);
   } else {
+    /* the requests of all the links that can take them are sent together */
     for (zz = 0; zz < MAX_L2CAP_LINKS; zz++) {
-      if (btm_cb.pm_mode_db[zz].chg_ind) {
+      if (btm_cb.pm_mode_db[zz].chg_ind && btm_cb.acl_db[zz].in_use &&
+          btm_cb.pm_mode_db[zz].defer_until_ms == 0 && !btm_pm_link_busy(zz)) {
 #if (BTM_PM_DEBUG == TRUE)
         BTM_TRACE_DEBUG("btm_pm_proc_mode_change: Sending PM req :%d", zz);
 #endif  // BTM_PM_DEBUG
         btm_pm_snd_md_req(BTM_PM_SET_ONLY_ID, zz, NULL);
-        break;
       }
     }
   }
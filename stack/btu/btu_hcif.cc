@@ -49,6 +49,7 @@
 #include "btu.h"
 #include "common/metrics.h"
 #include "device/include/controller.h"
+#include "hci/include/command_buffer_pool.h"
 #include "hci_evt_length.h"
 #include "hci_layer.h"
 #include "hcimsgs.h"
@@ -921,14 +922,14 @@ static void btu_hcif_command_status_evt_with_cb_on_task(uint8_t status,
   cmd_with_cb_data_cleanup(cb_wrapper);
   osi_free(cb_wrapper);
 
-  osi_free(event);
+  command_buffer_free(event);
 }
 
 static void btu_hcif_command_status_evt_with_cb(uint8_t status, BT_HDR* command,
                                                 void* context) {
   // Command is pending, we  report only error.
   if (!status) {
-    osi_free(command);
+    command_buffer_free(command);
     return;
   }
 
@@ -1648,12 +1649,15 @@ static void btu_hcif_hdl_command_status(uint16_t opcode, uint8_t status,
         // Allow SCO initiation to continue if waiting for change mode event
         STREAM_TO_UINT16(handle, p_cmd);
         btm_sco_chk_pend_unpark(status, handle);
+        btm_pm_proc_cmd_status(status, handle);
+        break;
       }
       FALLTHROUGH_INTENDED; /* FALLTHROUGH */
     case HCI_HOLD_MODE:
     case HCI_SNIFF_MODE:
     case HCI_PARK_MODE:
-      btm_pm_proc_cmd_status(status);
+      STREAM_TO_UINT16(handle, p_cmd);
+      btm_pm_proc_cmd_status(status, handle);
       break;
 
     default:
@@ -1684,7 +1688,7 @@ static void btu_hcif_command_status_evt_on_task(uint8_t status, BT_HDR* event,
   btu_hcif_log_command_metrics(opcode, stream + 1, status, true);
 
   btu_hcif_hdl_command_status(opcode, status, stream, context);
-  osi_free(event);
+  command_buffer_free(event);
 }
 
 static void btu_hcif_command_status_evt(uint8_t status, BT_HDR* command,
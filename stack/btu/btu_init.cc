@@ -101,7 +101,21 @@ void btu_free_core() {
  * Returns          void
  *
  *****************************************************************************/
-void BTU_StartUp() {
+void BTU_StartUp() { BTU_StartUpOverlapped(nullptr); }
+
+/*****************************************************************************
+ *
+ * Function         BTU_StartUpOverlapped
+ *
+ * Description      Initializes the BTU control block while the HCI layer is
+ *                  still starting up. |hci_start_up_future| is awaited on the
+ *                  startup thread before the rest of the stack is enabled.
+ *                  A NULL future behaves like BTU_StartUp().
+ *
+ * Returns          void
+ *
+ *****************************************************************************/
+void BTU_StartUpOverlapped(future_t* hci_start_up_future) {
   btu_trace_level = HCI_INITIAL_TRACE_LEVEL;
   bt_startup_thread.StartUp();
   if (!bt_startup_thread.EnableRealTimeScheduling()) {
@@ -110,8 +124,9 @@ void BTU_StartUp() {
     BTU_ShutDown();
     return;
   }
-  if (!bt_startup_thread.DoInThread(FROM_HERE,
-                                    base::Bind(btu_task_start_up, nullptr))) {
+  if (!bt_startup_thread.DoInThread(
+          FROM_HERE, base::Bind(btu_task_start_up,
+                                static_cast<void*>(hci_start_up_future)))) {
     LOG(ERROR) << __func__ << ": Unable to continue start-up on "
                << bt_startup_thread;
     BTU_ShutDown();
@@ -23,10 +23,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <chrono>
+
 #include "bta/sys/bta_sys.h"
 #include "btcore/include/module.h"
 #include "bte.h"
 #include "btif/include/btif_common.h"
+#include "common/latency_tracer.h"
 #include "common/message_loop_thread.h"
 #include "osi/include/osi.h"
 #include "stack/btm/btm_int.h"
@@ -38,6 +41,7 @@
 #include <base/run_loop.h>
 #include <base/threading/thread.h>
 
+using bluetooth::common::LatencyTracer;
 using bluetooth::common::MessageLoopThread;
 
 /* Define BTU storage area */
@@ -50,7 +54,9 @@ void btu_hci_msg_process(BT_HDR* p_msg) {
   switch (p_msg->event & BT_EVT_MASK) {
     case BT_EVT_TO_BTU_HCI_ACL:
       /* All Acl Data goes to L2CAP */
+      LatencyTracer::Resume(p_msg, LatencyTracer::BTU_DISPATCH);
       l2c_rcv_acl_data(p_msg);
+      LatencyTracer::End();
       break;
 
     case BT_EVT_TO_BTU_L2C_SEG_XMIT:
@@ -108,8 +114,15 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
   return BT_STATUS_SUCCESS;
 }
 
-void btu_task_start_up(UNUSED_ATTR void* context) {
-  LOG(INFO) << "Bluetooth chip preload is complete";
+void btu_task_start_up(void* context) {
+  future_t* hci_start_up_future = (future_t*)context;
+  if (hci_start_up_future) {
+    LOG(INFO) << "Initializing core stack while the chip is being preloaded";
+  } else {
+    LOG(INFO) << "Bluetooth chip preload is complete";
+  }
+
+  auto begin = std::chrono::steady_clock::now();
 
   /* Initialize the mandatory core stack control blocks
      (BTU, BTM, L2CAP, and SDP)
@@ -120,6 +133,8 @@ void btu_task_start_up(UNUSED_ATTR void* context) {
   BTE_InitStack();
 
   bta_sys_init();
+  module_timeline_record("btu_init_core", "step", begin,
+                         std::chrono::steady_clock::now());
 
   /* Initialise platform trace levels at this point as BTE_InitStack() and
    * bta_sys_init()
@@ -135,6 +150,15 @@ void btu_task_start_up(UNUSED_ATTR void* context) {
   if (!main_thread.EnableRealTimeScheduling()) {
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
   }
+
+  if (hci_start_up_future) {
+    begin = std::chrono::steady_clock::now();
+    if (future_await(hci_start_up_future) != FUTURE_SUCCESS) {
+      LOG(ERROR) << __func__ << ": HCI layer failed to start up";
+    }
+    module_timeline_record("hci_start_up_wait", "step", begin,
+                           std::chrono::steady_clock::now());
+  }
   if (do_in_jni_thread(FROM_HERE, base::Bind(btif_init_ok, 0, nullptr)) !=
       BT_STATUS_SUCCESS) {
     LOG(FATAL) << __func__ << ": unable to continue starting Bluetooth";
@@ -34,10 +34,14 @@ using base::StringPrintf;
 using bluetooth::Uuid;
 
 #define GATTP_MAX_NUM_INC_SVR 0
-#define GATTP_MAX_CHAR_NUM 2
+#define GATTP_MAX_CHAR_NUM 3
 #define GATTP_MAX_ATTR_NUM (GATTP_MAX_CHAR_NUM * 2 + GATTP_MAX_NUM_INC_SVR + 1)
 #define GATTP_MAX_CHAR_VALUE_SIZE 50
 
+/* Client Supported Features bits accepted from peer clients */
+#define GATTP_CL_SUPP_FEAT_ROBUST_CACHING 0x01
+#define GATTP_CL_SUPP_FEAT_MASK GATTP_CL_SUPP_FEAT_ROBUST_CACHING
+
 #ifndef GATTP_ATTR_DB_SIZE
 #define GATTP_ATTR_DB_SIZE                                    \
   GATT_DB_MEM_SIZE(GATTP_MAX_NUM_INC_SVR, GATTP_MAX_CHAR_NUM, \
@@ -182,6 +186,80 @@ void gatt_profile_clcb_dealloc(tGATT_PROFILE_CLCB* p_clcb) {
   memset(p_clcb, 0, sizeof(tGATT_PROFILE_CLCB));
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_read_profile_attr
+ *
+ * Description      Reads the value of a GATT profile characteristic for the
+ *                  peer client of |conn_id|.
+ *
+ * Returns          GATT status, |p_rsp| holds the value on success.
+ *
+ ******************************************************************************/
+static tGATT_STATUS gatt_read_profile_attr(uint16_t conn_id,
+                                           const tGATT_READ_REQ& req,
+                                           tGATT_VALUE* p_rsp) {
+  uint8_t value[OCTET16_LEN];
+  uint16_t len = 0;
+
+  if (req.handle == gatt_cb.handle_of_database_hash) {
+    /* computed on demand, the service list changes without notice */
+    Octet16 hash = gatts_calculate_database_hash(*gatt_cb.srv_list_info);
+    memcpy(value, hash.data(), OCTET16_LEN);
+    len = OCTET16_LEN;
+  } else if (req.handle == gatt_cb.handle_of_cl_supp_feat) {
+    tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(GATT_GET_TCB_IDX(conn_id));
+    if (p_tcb == NULL) return GATT_INTERNAL_ERROR;
+    value[0] = p_tcb->cl_supp_feat;
+    len = 1;
+  } else {
+    return GATT_READ_NOT_PERMIT;
+  }
+
+  uint16_t offset = req.is_long ? req.offset : 0;
+  if (offset > len) return GATT_INVALID_OFFSET;
+
+  p_rsp->handle = req.handle;
+  p_rsp->offset = offset;
+  p_rsp->len = len - offset;
+  memcpy(p_rsp->value, value + offset, p_rsp->len);
+  return GATT_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_write_cl_supp_feat
+ *
+ * Description      Stores the Client Supported Features written by the peer
+ *                  client of |conn_id|. Features can't be disabled again for
+ *                  the lifetime of the connection.
+ *
+ * Returns          GATT status.
+ *
+ ******************************************************************************/
+static tGATT_STATUS gatt_write_cl_supp_feat(uint16_t conn_id,
+                                            const tGATT_WRITE_REQ& req) {
+  if (req.is_prep || req.offset != 0) return GATT_WRITE_NOT_PERMIT;
+  if (req.len == 0) return GATT_INVALID_ATTR_LEN;
+
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(GATT_GET_TCB_IDX(conn_id));
+  if (p_tcb == NULL) return GATT_INTERNAL_ERROR;
+
+  uint8_t feat = req.value[0];
+  for (uint16_t i = 1; i < req.len; i++) {
+    if (req.value[i] != 0) return GATT_VALUE_NOT_ALLOWED;
+  }
+
+  if ((feat & ~GATTP_CL_SUPP_FEAT_MASK) || (p_tcb->cl_supp_feat & ~feat)) {
+    LOG(ERROR) << __func__ << ": rejected features " << loghex(feat);
+    return GATT_VALUE_NOT_ALLOWED;
+  }
+
+  VLOG(1) << __func__ << ": features " << loghex(feat);
+  p_tcb->cl_supp_feat = feat;
+  return GATT_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         gatt_request_cback
@@ -201,11 +279,24 @@ static void gatt_request_cback(uint16_t conn_id, uint32_t trans_id,
 
   switch (type) {
     case GATTS_REQ_TYPE_READ_CHARACTERISTIC:
+      status = gatt_read_profile_attr(conn_id, p_data->read_req,
+                                      &rsp_msg.attr_value);
+      break;
+
     case GATTS_REQ_TYPE_READ_DESCRIPTOR:
       status = GATT_READ_NOT_PERMIT;
       break;
 
     case GATTS_REQ_TYPE_WRITE_CHARACTERISTIC:
+      if (p_data->write_req.handle == gatt_cb.handle_of_cl_supp_feat) {
+        status = gatt_write_cl_supp_feat(conn_id, p_data->write_req);
+        rsp_msg.handle = p_data->write_req.handle;
+      } else {
+        status = GATT_WRITE_NOT_PERMIT;
+      }
+      if (!p_data->write_req.need_rsp) ignore = true;
+      break;
+
     case GATTS_REQ_TYPE_WRITE_DESCRIPTOR:
       status = GATT_WRITE_NOT_PERMIT;
       break;
@@ -283,6 +374,8 @@ void gatt_profile_db_init(void) {
   Uuid service_uuid = Uuid::From16Bit(UUID_SERVCLASS_GATT_SERVER);
 
   Uuid char_uuid = Uuid::From16Bit(GATT_UUID_GATT_SRV_CHGD);
+  Uuid cl_supp_feat_uuid = Uuid::From16Bit(GATT_UUID_CLIENT_SUP_FEAT);
+  Uuid database_hash_uuid = Uuid::From16Bit(GATT_UUID_DATABASE_HASH);
 
   btgatt_db_element_t service[] = {
       {
@@ -294,6 +387,18 @@ void gatt_profile_db_init(void) {
           .type = BTGATT_DB_CHARACTERISTIC,
           .properties = GATT_CHAR_PROP_BIT_INDICATE,
           .permissions = 0,
+      },
+      {
+          .uuid = cl_supp_feat_uuid,
+          .type = BTGATT_DB_CHARACTERISTIC,
+          .properties = GATT_CHAR_PROP_BIT_READ | GATT_CHAR_PROP_BIT_WRITE,
+          .permissions = GATT_PERM_READ | GATT_PERM_WRITE,
+      },
+      {
+          .uuid = database_hash_uuid,
+          .type = BTGATT_DB_CHARACTERISTIC,
+          .properties = GATT_CHAR_PROP_BIT_READ,
+          .permissions = GATT_PERM_READ,
       }};
 
   GATTS_AddService(gatt_cb.gatt_if, service,
@@ -301,6 +406,8 @@ void gatt_profile_db_init(void) {
 
   service_handle = service[0].attribute_handle;
   gatt_cb.handle_of_h_r = service[1].attribute_handle;
+  gatt_cb.handle_of_cl_supp_feat = service[2].attribute_handle;
+  gatt_cb.handle_of_database_hash = service[3].attribute_handle;
 
   VLOG(1) << __func__ << ": gatt_if=" << +gatt_cb.gatt_if;
 }
@@ -292,6 +292,9 @@ typedef struct {
   std::queue<tGATT_CMD_Q> cl_cmd_q;
   alarm_t* ind_ack_timer; /* local app confirm to indication timer */
 
+  /* Client Supported Features written by the peer client */
+  uint8_t cl_supp_feat;
+
   bool in_use;
   uint8_t tcb_idx;
 } tGATT_TCB;
@@ -379,6 +382,8 @@ typedef struct {
   tGATT_PROFILE_CLCB profile_clcb[GATT_MAX_APPS];
   uint16_t
       handle_of_h_r; /* Handle of the handles reused characteristic value */
+  uint16_t handle_of_cl_supp_feat; /* Client Supported Features value */
+  uint16_t handle_of_database_hash; /* Database Hash value */
 
   tGATT_APPL_INFO cb_info;
 
@@ -574,4 +579,8 @@ extern tGATT_STATUS gatts_read_attr_perm_check(tGATT_SVC_DB* p_db, bool is_long,
                                                uint8_t key_size);
 extern bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
 
+/* gatt_sr_hash.cc */
+extern Octet16 gatts_calculate_database_hash(
+    const std::list<tGATT_SRV_LIST_ELEM>& srv_list);
+
 #endif
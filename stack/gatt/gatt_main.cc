@@ -29,6 +29,7 @@
 #include "btif_storage.h"
 #include "btm_ble_int.h"
 #include "btm_int.h"
+#include "common/latency_tracer.h"
 #include "connection_manager.h"
 #include "device/include/interop.h"
 #include "gatt_int.h"
@@ -851,6 +852,8 @@ static void gatt_send_conn_cback(tGATT_TCB* p_tcb) {
  *
  ******************************************************************************/
 void gatt_data_process(tGATT_TCB& tcb, BT_HDR* p_buf) {
+  bluetooth::common::LatencyTracer::Stamp(
+      bluetooth::common::LatencyTracer::GATT_RX);
   uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   uint8_t op_code, pseudo_op_code;
 
@@ -0,0 +1,134 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  this file contains the computation of the GATT server Database Hash
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include "gatt_int.h"
+#include "stack/crypto_toolbox/crypto_toolbox.h"
+
+using bluetooth::Uuid;
+
+static void append_uint16(std::vector<uint8_t>& buf, uint16_t value) {
+  buf.push_back(value & 0xff);
+  buf.push_back(value >> 8);
+}
+
+/* UUIDs in attribute values are 16 bit or 128 bit, 32 bit is sent as 128 */
+static void append_uuid(std::vector<uint8_t>& buf, const Uuid& uuid) {
+  if (uuid.Is16Bit()) {
+    append_uint16(buf, uuid.As16Bit());
+    return;
+  }
+
+  Uuid::UUID128Bit uuid128 = uuid.To128BitLE();
+  buf.insert(buf.end(), uuid128.begin(), uuid128.end());
+}
+
+/* Appends the fields of |attr| covered by the Database Hash */
+static void append_attr_for_hash(std::vector<uint8_t>& buf,
+                                 const tGATT_ATTR& attr,
+                                 const tGATT_ATTR* p_next_attr) {
+  if (!attr.uuid.Is16Bit()) return;
+
+  uint16_t type = attr.uuid.As16Bit();
+  switch (type) {
+    case GATT_UUID_PRI_SERVICE:
+    case GATT_UUID_SEC_SERVICE:
+      append_uint16(buf, attr.handle);
+      append_uint16(buf, type);
+      append_uuid(buf, attr.p_value->uuid);
+      break;
+
+    case GATT_UUID_INCLUDE_SERVICE: {
+      const tGATT_INCL_SRVC& incl = attr.p_value->incl_handle;
+      append_uint16(buf, attr.handle);
+      append_uint16(buf, type);
+      append_uint16(buf, incl.s_handle);
+      append_uint16(buf, incl.e_handle);
+      if (incl.service_type.Is16Bit())
+        append_uint16(buf, incl.service_type.As16Bit());
+      break;
+    }
+
+    case GATT_UUID_CHAR_DECLARE:
+      append_uint16(buf, attr.handle);
+      append_uint16(buf, type);
+      buf.push_back(attr.p_value->char_decl.property);
+      append_uint16(buf, attr.p_value->char_decl.char_val_handle);
+      /* the characteristic value attribute follows its declaration */
+      if (p_next_attr) append_uuid(buf, p_next_attr->uuid);
+      break;
+
+    /* the extended properties value is owned by the application, so like the
+     * other descriptors only the handle and type are covered */
+    case GATT_UUID_CHAR_EXT_PROP:
+    case GATT_UUID_CHAR_DESCRIPTION:
+    case GATT_UUID_CHAR_CLIENT_CONFIG:
+    case GATT_UUID_CHAR_SRVR_CONFIG:
+    case GATT_UUID_CHAR_PRESENT_FORMAT:
+    case GATT_UUID_CHAR_AGG_FORMAT:
+      append_uint16(buf, attr.handle);
+      append_uint16(buf, type);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         gatts_calculate_database_hash
+ *
+ * Description      Computes the Database Hash of the server attribute table,
+ *                  the AES-CMAC with a zero key over the handle, type and
+ *                  value of the service, include and characteristic
+ *                  declarations and the handle and type of the descriptors,
+ *                  in handle order.
+ *
+ * Returns          The hash, in the byte order it is sent over the air.
+ *
+ ******************************************************************************/
+Octet16 gatts_calculate_database_hash(
+    const std::list<tGATT_SRV_LIST_ELEM>& srv_list) {
+  std::vector<uint8_t> buf;
+
+  /* the list is kept sorted by service start handle */
+  for (const tGATT_SRV_LIST_ELEM& srv : srv_list) {
+    if (!srv.p_db) continue;
+
+    const std::vector<tGATT_ATTR>& attrs = srv.p_db->attr_list;
+    for (size_t i = 0; i < attrs.size(); i++) {
+      const tGATT_ATTR* p_next = (i + 1 < attrs.size()) ? &attrs[i + 1] : NULL;
+      append_attr_for_hash(buf, attrs[i], p_next);
+    }
+  }
+
+  /* the toolbox expects its input with the least significant octet first */
+  std::reverse(buf.begin(), buf.end());
+
+  Octet16 key{0};
+  return crypto_toolbox::aes_cmac(key, buf.data(), buf.size());
+}
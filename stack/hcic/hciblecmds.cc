@@ -26,6 +26,7 @@
 #include "bt_common.h"
 #include "bt_target.h"
 #include "btu.h"
+#include "hcic_builder.h"
 #include "hcidefs.h"
 #include "hcimsgs.h"
 
@@ -33,6 +34,155 @@
 #include <stddef.h>
 #include <string.h>
 
+/* Commands with a fixed parameter layout, with their parameters in the order
+ * they are sent */
+namespace {
+
+using BleSetRandomAddrCmd = hcic::Command<HCI_BLE_WRITE_RANDOM_ADDR,
+                                          HCIC_PARAM_SIZE_WRITE_RANDOM_ADDR_CMD,
+                                          hcic::BdAddr /* random_bda */>;
+using BleWriteAdvParamsCmd = hcic::Command<HCI_BLE_WRITE_ADV_PARAMS,
+                                           HCIC_PARAM_SIZE_BLE_WRITE_ADV_PARAMS,
+                                           hcic::Uint16 /* adv_int_min */,
+                                           hcic::Uint16 /* adv_int_max */,
+                                           hcic::Uint8 /* adv_type */,
+                                           hcic::Uint8 /* addr_type_own */,
+                                           hcic::Uint8 /* addr_type_dir */,
+                                           hcic::BdAddr /* direct_bda */,
+                                           hcic::Uint8 /* channel_map */,
+                                           hcic::Uint8 /* adv_filter_policy */>;
+using BleReadAdvChnlTxPowerCmd = hcic::Command<HCI_BLE_READ_ADV_CHNL_TX_POWER,
+                                               HCIC_PARAM_SIZE_READ_CMD>;
+using BleSetAdvEnableCmd = hcic::Command<HCI_BLE_WRITE_ADV_ENABLE,
+                                         HCIC_PARAM_SIZE_WRITE_ADV_ENABLE,
+                                         hcic::Uint8 /* adv_enable */>;
+using BleSetScanParamsCmd = hcic::Command<HCI_BLE_WRITE_SCAN_PARAMS,
+                                          HCIC_PARAM_SIZE_BLE_WRITE_SCAN_PARAM,
+                                          hcic::Uint8 /* scan_type */,
+                                          hcic::Uint16 /* scan_int */,
+                                          hcic::Uint16 /* scan_win */,
+                                          hcic::Uint8 /* addr_type_own */,
+                                          hcic::Uint8 /* scan_filter_policy */>;
+using BleSetScanEnableCmd = hcic::Command<HCI_BLE_WRITE_SCAN_ENABLE,
+                                          HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE,
+                                          hcic::Uint8 /* scan_enable */,
+                                          hcic::Uint8 /* duplicate */>;
+using BleCreateLlConnCmd = hcic::Command<HCI_BLE_CREATE_LL_CONN,
+                                         HCIC_PARAM_SIZE_BLE_CREATE_LL_CONN,
+                                         hcic::Uint16 /* scan_int */,
+                                         hcic::Uint16 /* scan_win */,
+                                         hcic::Uint8 /* init_filter_policy */,
+                                         hcic::Uint8 /* addr_type_peer */,
+                                         hcic::BdAddr /* bda_peer */,
+                                         hcic::Uint8 /* addr_type_own */,
+                                         hcic::Uint16 /* conn_int_min */,
+                                         hcic::Uint16 /* conn_int_max */,
+                                         hcic::Uint16 /* conn_latency */,
+                                         hcic::Uint16 /* conn_timeout */,
+                                         hcic::Uint16 /* min_ce_len */,
+                                         hcic::Uint16 /* max_ce_len */>;
+using BleCreateConnCancelCmd =
+    hcic::Command<HCI_BLE_CREATE_CONN_CANCEL,
+                  HCIC_PARAM_SIZE_BLE_CREATE_CONN_CANCEL>;
+using BleUpdLlConnParamsCmd =
+    hcic::Command<HCI_BLE_UPD_LL_CONN_PARAMS,
+                  HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS,
+                  hcic::Uint16 /* handle */, hcic::Uint16 /* conn_int_min */,
+                  hcic::Uint16 /* conn_int_max */,
+                  hcic::Uint16 /* conn_latency */,
+                  hcic::Uint16 /* conn_timeout */,
+                  hcic::Uint16 /* min_ce_len */, hcic::Uint16 /* max_ce_len */>;
+using BleReadChnlMapCmd = hcic::Command<HCI_BLE_READ_CHNL_MAP,
+                                        HCIC_PARAM_SIZE_READ_CHNL_MAP,
+                                        hcic::Uint16 /* handle */>;
+using BleReadRemoteFeatCmd = hcic::Command<HCI_BLE_READ_REMOTE_FEAT,
+                                           HCIC_PARAM_SIZE_BLE_READ_REMOTE_FEAT,
+                                           hcic::Uint16 /* handle */>;
+using BleLtkReqReplyCmd = hcic::Command<HCI_BLE_LTK_REQ_REPLY,
+                                        HCIC_PARAM_SIZE_LTK_REQ_REPLY,
+                                        hcic::Uint16 /* handle */,
+                                        hcic::Key128 /* ltk */>;
+using BleLtkReqNegReplyCmd = hcic::Command<HCI_BLE_LTK_REQ_NEG_REPLY,
+                                           HCIC_PARAM_SIZE_LTK_REQ_NEG_REPLY,
+                                           hcic::Uint16 /* handle */>;
+using BleReceiverTestCmd = hcic::Command<HCI_BLE_RECEIVER_TEST,
+                                         HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                         hcic::Uint8 /* rx_freq */>;
+using BleTransmitterTestCmd = hcic::Command<HCI_BLE_TRANSMITTER_TEST,
+                                            HCIC_PARAM_SIZE_WRITE_PARAM3,
+                                            hcic::Uint8 /* tx_freq */,
+                                            hcic::Uint8 /* test_data_len */,
+                                            hcic::Uint8 /* payload */>;
+using BleTestEndCmd = hcic::Command<HCI_BLE_TEST_END, HCIC_PARAM_SIZE_READ_CMD>;
+using BleReadHostSupportedCmd = hcic::Command<HCI_READ_LE_HOST_SUPPORT,
+                                              HCIC_PARAM_SIZE_READ_CMD>;
+using BleRcParamReqReplyCmd =
+    hcic::Command<HCI_BLE_RC_PARAM_REQ_REPLY,
+                  HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_REPLY,
+                  hcic::Uint16 /* handle */, hcic::Uint16 /* conn_int_min */,
+                  hcic::Uint16 /* conn_int_max */,
+                  hcic::Uint16 /* conn_latency */,
+                  hcic::Uint16 /* conn_timeout */,
+                  hcic::Uint16 /* min_ce_len */, hcic::Uint16 /* max_ce_len */>;
+using BleRcParamReqNegReplyCmd =
+    hcic::Command<HCI_BLE_RC_PARAM_REQ_NEG_REPLY,
+                  HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_NEG_REPLY,
+                  hcic::Uint16 /* handle */, hcic::Uint8 /* reason */>;
+using BleAddDeviceResolvingListCmd =
+    hcic::Command<HCI_BLE_ADD_DEV_RESOLVING_LIST,
+                  HCIC_PARAM_SIZE_BLE_ADD_DEV_RESOLVING_LIST,
+                  hcic::Uint8 /* addr_type_peer */, hcic::BdAddr /* bda_peer */,
+                  hcic::Key128 /* irk_peer */, hcic::Key128 /* irk_local */>;
+using BleRmDeviceResolvingListCmd =
+    hcic::Command<HCI_BLE_RM_DEV_RESOLVING_LIST,
+                  HCIC_PARAM_SIZE_BLE_RM_DEV_RESOLVING_LIST,
+                  hcic::Uint8 /* addr_type_peer */,
+                  hcic::BdAddr /* bda_peer */>;
+using BleSetPrivacyModeCmd = hcic::Command<HCI_BLE_SET_PRIVACY_MODE,
+                                           HCIC_PARAM_SIZE_BLE_SET_PRIVACY_MODE,
+                                           hcic::Uint8 /* addr_type_peer */,
+                                           hcic::BdAddr /* bda_peer */,
+                                           hcic::Uint8 /* privacy_type */>;
+using BleClearResolvingListCmd =
+    hcic::Command<HCI_BLE_CLEAR_RESOLVING_LIST,
+                  HCIC_PARAM_SIZE_BLE_CLEAR_RESOLVING_LIST>;
+using BleReadResolvableAddrPeerCmd =
+    hcic::Command<HCI_BLE_READ_RESOLVABLE_ADDR_PEER,
+                  HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_PEER,
+                  hcic::Uint8 /* addr_type_peer */,
+                  hcic::BdAddr /* bda_peer */>;
+using BleReadResolvableAddrLocalCmd =
+    hcic::Command<HCI_BLE_READ_RESOLVABLE_ADDR_LOCAL,
+                  HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_LOCAL,
+                  hcic::Uint8 /* addr_type_peer */,
+                  hcic::BdAddr /* bda_peer */>;
+using BleSetAddrResolutionEnableCmd =
+    hcic::Command<HCI_BLE_SET_ADDR_RESOLUTION_ENABLE,
+                  HCIC_PARAM_SIZE_BLE_SET_ADDR_RESOLUTION_ENABLE,
+                  hcic::Uint8 /* addr_resolution_enable */>;
+using BleSetRandPrivAddrTimeoutCmd =
+    hcic::Command<HCI_BLE_SET_RAND_PRIV_ADDR_TIMOUT,
+                  HCIC_PARAM_SIZE_BLE_SET_RAND_PRIV_ADDR_TIMOUT,
+                  hcic::Uint16 /* rpa_timout */>;
+using BleSetDataLengthCmd = hcic::Command<HCI_BLE_SET_DATA_LENGTH,
+                                          HCIC_PARAM_SIZE_BLE_SET_DATA_LENGTH,
+                                          hcic::Uint16 /* conn_handle */,
+                                          hcic::Uint16 /* tx_octets */,
+                                          hcic::Uint16 /* tx_time */>;
+using BleEnhRxTestCmd = hcic::Command<HCI_BLE_ENH_RECEIVER_TEST,
+                                      HCIC_PARAM_SIZE_BLE_ENH_RX_TEST,
+                                      hcic::Uint8 /* rx_chan */,
+                                      hcic::Uint8 /* phy */,
+                                      hcic::Uint8 /* mod_index */>;
+using BleEnhTxTestCmd = hcic::Command<HCI_BLE_ENH_TRANSMITTER_TEST,
+                                      HCIC_PARAM_SIZE_BLE_ENH_TX_TEST,
+                                      hcic::Uint8 /* tx_chan */,
+                                      hcic::Uint8 /* data_len */,
+                                      hcic::Uint8 /* payload */,
+                                      hcic::Uint8 /* phy */>;
+
+}  // namespace
+
 void btsnd_hcic_ble_set_local_used_feat(uint8_t feat_set[8]) {
   BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
   uint8_t* pp = (uint8_t*)(p + 1);
@@ -47,18 +197,8 @@ void btsnd_hcic_ble_set_local_used_feat(uint8_t feat_set[8]) {
 }
 
 void btsnd_hcic_ble_set_random_addr(const RawAddress& random_bda) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_RANDOM_ADDR_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_RANDOM_ADDR);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_RANDOM_ADDR_CMD);
-
-  BDADDR_TO_STREAM(pp, random_bda);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetRandomAddrCmd::Build(random_bda));
 }
 
 void btsnd_hcic_ble_write_adv_params(uint16_t adv_int_min, uint16_t adv_int_max,
@@ -67,37 +207,16 @@ void btsnd_hcic_ble_write_adv_params(uint16_t adv_int_min, uint16_t adv_int_max,
                                      const RawAddress& direct_bda,
                                      uint8_t channel_map,
                                      uint8_t adv_filter_policy) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_ADV_PARAMS;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_ADV_PARAMS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_ADV_PARAMS);
-
-  UINT16_TO_STREAM(pp, adv_int_min);
-  UINT16_TO_STREAM(pp, adv_int_max);
-  UINT8_TO_STREAM(pp, adv_type);
-  UINT8_TO_STREAM(pp, addr_type_own);
-  UINT8_TO_STREAM(pp, addr_type_dir);
-  BDADDR_TO_STREAM(pp, direct_bda);
-  UINT8_TO_STREAM(pp, channel_map);
-  UINT8_TO_STREAM(pp, adv_filter_policy);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleWriteAdvParamsCmd::Build(adv_int_min, adv_int_max,
+                                                adv_type, addr_type_own,
+                                                addr_type_dir, direct_bda,
+                                                channel_map,
+                                                adv_filter_policy));
 }
 void btsnd_hcic_ble_read_adv_chnl_tx_power(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_ADV_CHNL_TX_POWER);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReadAdvChnlTxPowerCmd::Build());
 }
 
 void btsnd_hcic_ble_set_adv_data(uint8_t data_len, uint8_t* p_data) {
@@ -147,54 +266,21 @@ void btsnd_hcic_ble_set_scan_rsp_data(uint8_t data_len, uint8_t* p_scan_rsp) {
 }
 
 void btsnd_hcic_ble_set_adv_enable(uint8_t adv_enable) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_ADV_ENABLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_ADV_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_ADV_ENABLE);
-
-  UINT8_TO_STREAM(pp, adv_enable);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetAdvEnableCmd::Build(adv_enable));
 }
 void btsnd_hcic_ble_set_scan_params(uint8_t scan_type, uint16_t scan_int,
                                     uint16_t scan_win, uint8_t addr_type_own,
                                     uint8_t scan_filter_policy) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_SCAN_PARAM;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_SCAN_PARAMS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_PARAM);
-
-  UINT8_TO_STREAM(pp, scan_type);
-  UINT16_TO_STREAM(pp, scan_int);
-  UINT16_TO_STREAM(pp, scan_win);
-  UINT8_TO_STREAM(pp, addr_type_own);
-  UINT8_TO_STREAM(pp, scan_filter_policy);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetScanParamsCmd::Build(scan_type, scan_int, scan_win,
+                                               addr_type_own,
+                                               scan_filter_policy));
 }
 
 void btsnd_hcic_ble_set_scan_enable(uint8_t scan_enable, uint8_t duplicate) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_SCAN_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE);
-
-  UINT8_TO_STREAM(pp, scan_enable);
-  UINT8_TO_STREAM(pp, duplicate);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetScanEnableCmd::Build(scan_enable, duplicate));
 }
 
 /* link layer connection management commands */
@@ -203,45 +289,19 @@ void btsnd_hcic_ble_create_ll_conn(
     uint8_t addr_type_peer, const RawAddress& bda_peer, uint8_t addr_type_own,
     uint16_t conn_int_min, uint16_t conn_int_max, uint16_t conn_latency,
     uint16_t conn_timeout, uint16_t min_ce_len, uint16_t max_ce_len) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_CREATE_LL_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_CREATE_LL_CONN);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_CREATE_LL_CONN);
-
-  UINT16_TO_STREAM(pp, scan_int);
-  UINT16_TO_STREAM(pp, scan_win);
-  UINT8_TO_STREAM(pp, init_filter_policy);
-
-  UINT8_TO_STREAM(pp, addr_type_peer);
-  BDADDR_TO_STREAM(pp, bda_peer);
-  UINT8_TO_STREAM(pp, addr_type_own);
-
-  UINT16_TO_STREAM(pp, conn_int_min);
-  UINT16_TO_STREAM(pp, conn_int_max);
-  UINT16_TO_STREAM(pp, conn_latency);
-  UINT16_TO_STREAM(pp, conn_timeout);
-
-  UINT16_TO_STREAM(pp, min_ce_len);
-  UINT16_TO_STREAM(pp, max_ce_len);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleCreateLlConnCmd::Build(scan_int, scan_win,
+                                              init_filter_policy,
+                                              addr_type_peer, bda_peer,
+                                              addr_type_own, conn_int_min,
+                                              conn_int_max, conn_latency,
+                                              conn_timeout, min_ce_len,
+                                              max_ce_len));
 }
 
 void btsnd_hcic_ble_create_conn_cancel(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_CREATE_CONN_CANCEL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_CREATE_CONN_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_CREATE_CONN_CANCEL);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleCreateConnCancelCmd::Build());
 }
 
 void btsnd_hcic_ble_clear_white_list(
@@ -282,25 +342,11 @@ void btsnd_hcic_ble_upd_ll_conn_params(uint16_t handle, uint16_t conn_int_min,
                                        uint16_t conn_timeout,
                                        uint16_t min_ce_len,
                                        uint16_t max_ce_len) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_UPD_LL_CONN_PARAMS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  UINT16_TO_STREAM(pp, conn_int_min);
-  UINT16_TO_STREAM(pp, conn_int_max);
-  UINT16_TO_STREAM(pp, conn_latency);
-  UINT16_TO_STREAM(pp, conn_timeout);
-  UINT16_TO_STREAM(pp, min_ce_len);
-  UINT16_TO_STREAM(pp, max_ce_len);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleUpdLlConnParamsCmd::Build(handle, conn_int_min,
+                                                 conn_int_max, conn_latency,
+                                                 conn_timeout, min_ce_len,
+                                                 max_ce_len));
 }
 
 void btsnd_hcic_ble_set_host_chnl_class(
@@ -320,33 +366,13 @@ void btsnd_hcic_ble_set_host_chnl_class(
 }
 
 void btsnd_hcic_ble_read_chnl_map(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CHNL_MAP;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_CHNL_MAP);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CHNL_MAP);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReadChnlMapCmd::Build(handle));
 }
 
 void btsnd_hcic_ble_read_remote_feat(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_READ_REMOTE_FEAT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_REMOTE_FEAT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_READ_REMOTE_FEAT);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReadRemoteFeatCmd::Build(handle));
 }
 
 /* security management commands */
@@ -410,93 +436,34 @@ void btsnd_hcic_ble_start_enc(uint16_t handle,
 }
 
 void btsnd_hcic_ble_ltk_req_reply(uint16_t handle, const Octet16& ltk) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LTK_REQ_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_LTK_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LTK_REQ_REPLY);
-
-  UINT16_TO_STREAM(pp, handle);
-  ARRAY_TO_STREAM(pp, ltk.data(), HCIC_BLE_ENCRYT_KEY_SIZE);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleLtkReqReplyCmd::Build(handle, ltk));
 }
 
 void btsnd_hcic_ble_ltk_req_neg_reply(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LTK_REQ_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_LTK_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LTK_REQ_NEG_REPLY);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleLtkReqNegReplyCmd::Build(handle));
 }
 
 void btsnd_hcic_ble_receiver_test(uint8_t rx_freq) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RECEIVER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, rx_freq);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReceiverTestCmd::Build(rx_freq));
 }
 
 void btsnd_hcic_ble_transmitter_test(uint8_t tx_freq, uint8_t test_data_len,
                                      uint8_t payload) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM3;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_TRANSMITTER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM3);
-
-  UINT8_TO_STREAM(pp, tx_freq);
-  UINT8_TO_STREAM(pp, test_data_len);
-  UINT8_TO_STREAM(pp, payload);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleTransmitterTestCmd::Build(tx_freq, test_data_len,
+                                                 payload));
 }
 
 void btsnd_hcic_ble_test_end(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_TEST_END);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, BleTestEndCmd::Build());
 }
 
 void btsnd_hcic_ble_read_host_supported(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LE_HOST_SUPPORT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReadHostSupportedCmd::Build());
 }
 
 #if (BLE_LLT_INCLUDED == TRUE)
@@ -507,40 +474,16 @@ void btsnd_hcic_ble_rc_param_req_reply(uint16_t handle, uint16_t conn_int_min,
                                        uint16_t conn_timeout,
                                        uint16_t min_ce_len,
                                        uint16_t max_ce_len) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RC_PARAM_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_REPLY);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, conn_int_min);
-  UINT16_TO_STREAM(pp, conn_int_max);
-  UINT16_TO_STREAM(pp, conn_latency);
-  UINT16_TO_STREAM(pp, conn_timeout);
-  UINT16_TO_STREAM(pp, min_ce_len);
-  UINT16_TO_STREAM(pp, max_ce_len);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleRcParamReqReplyCmd::Build(handle, conn_int_min,
+                                                 conn_int_max, conn_latency,
+                                                 conn_timeout, min_ce_len,
+                                                 max_ce_len));
 }
 
 void btsnd_hcic_ble_rc_param_req_neg_reply(uint16_t handle, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RC_PARAM_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_NEG_REPLY);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, reason);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleRcParamReqNegReplyCmd::Build(handle, reason));
 }
 #endif
 
@@ -548,181 +491,74 @@ void btsnd_hcic_ble_add_device_resolving_list(uint8_t addr_type_peer,
                                               const RawAddress& bda_peer,
                                               const Octet16& irk_peer,
                                               const Octet16& irk_local) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_ADD_DEV_RESOLVING_LIST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_ADD_DEV_RESOLVING_LIST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_ADD_DEV_RESOLVING_LIST);
-  UINT8_TO_STREAM(pp, addr_type_peer);
-  BDADDR_TO_STREAM(pp, bda_peer);
-  ARRAY_TO_STREAM(pp, irk_peer.data(), HCIC_BLE_ENCRYT_KEY_SIZE);
-  ARRAY_TO_STREAM(pp, irk_local.data(), HCIC_BLE_ENCRYT_KEY_SIZE);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleAddDeviceResolvingListCmd::Build(addr_type_peer,
+                                                        bda_peer, irk_peer,
+                                                        irk_local));
 }
 
 void btsnd_hcic_ble_rm_device_resolving_list(uint8_t addr_type_peer,
                                              const RawAddress& bda_peer) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_RM_DEV_RESOLVING_LIST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RM_DEV_RESOLVING_LIST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_RM_DEV_RESOLVING_LIST);
-  UINT8_TO_STREAM(pp, addr_type_peer);
-  BDADDR_TO_STREAM(pp, bda_peer);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleRmDeviceResolvingListCmd::Build(addr_type_peer,
+                                                       bda_peer));
 }
 
 void btsnd_hcic_ble_set_privacy_mode(uint8_t addr_type_peer,
                                      const RawAddress& bda_peer,
                                      uint8_t privacy_type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_PRIVACY_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_PRIVACY_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_PRIVACY_MODE);
-  UINT8_TO_STREAM(pp, addr_type_peer);
-  BDADDR_TO_STREAM(pp, bda_peer);
-  UINT8_TO_STREAM(pp, privacy_type);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetPrivacyModeCmd::Build(addr_type_peer, bda_peer,
+                                                privacy_type));
 }
 
 void btsnd_hcic_ble_clear_resolving_list(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_CLEAR_RESOLVING_LIST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_CLEAR_RESOLVING_LIST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_CLEAR_RESOLVING_LIST);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleClearResolvingListCmd::Build());
 }
 
 void btsnd_hcic_ble_read_resolvable_addr_peer(uint8_t addr_type_peer,
                                               const RawAddress& bda_peer) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_PEER;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_RESOLVABLE_ADDR_PEER);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_PEER);
-  UINT8_TO_STREAM(pp, addr_type_peer);
-  BDADDR_TO_STREAM(pp, bda_peer);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReadResolvableAddrPeerCmd::Build(addr_type_peer,
+                                                        bda_peer));
 }
 
 void btsnd_hcic_ble_read_resolvable_addr_local(uint8_t addr_type_peer,
                                                const RawAddress& bda_peer) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_LOCAL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_RESOLVABLE_ADDR_LOCAL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_LOCAL);
-  UINT8_TO_STREAM(pp, addr_type_peer);
-  BDADDR_TO_STREAM(pp, bda_peer);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleReadResolvableAddrLocalCmd::Build(addr_type_peer,
+                                                         bda_peer));
 }
 
 void btsnd_hcic_ble_set_addr_resolution_enable(uint8_t addr_resolution_enable) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_ADDR_RESOLUTION_ENABLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_ADDR_RESOLUTION_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_ADDR_RESOLUTION_ENABLE);
-  UINT8_TO_STREAM(pp, addr_resolution_enable);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(
+      LOCAL_BR_EDR_CONTROLLER_ID,
+      BleSetAddrResolutionEnableCmd::Build(addr_resolution_enable));
 }
 
 void btsnd_hcic_ble_set_rand_priv_addr_timeout(uint16_t rpa_timout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_RAND_PRIV_ADDR_TIMOUT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_RAND_PRIV_ADDR_TIMOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_RAND_PRIV_ADDR_TIMOUT);
-  UINT16_TO_STREAM(pp, rpa_timout);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetRandPrivAddrTimeoutCmd::Build(rpa_timout));
 }
 
 void btsnd_hcic_ble_set_data_length(uint16_t conn_handle, uint16_t tx_octets,
                                     uint16_t tx_time) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_DATA_LENGTH;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_DATA_LENGTH);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_DATA_LENGTH);
-
-  UINT16_TO_STREAM(pp, conn_handle);
-  UINT16_TO_STREAM(pp, tx_octets);
-  UINT16_TO_STREAM(pp, tx_time);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleSetDataLengthCmd::Build(conn_handle, tx_octets,
+                                               tx_time));
 }
 
 void btsnd_hcic_ble_enh_rx_test(uint8_t rx_chan, uint8_t phy,
                                 uint8_t mod_index) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_ENH_RX_TEST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_ENH_RECEIVER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_ENH_RX_TEST);
-
-  UINT8_TO_STREAM(pp, rx_chan);
-  UINT8_TO_STREAM(pp, phy);
-  UINT8_TO_STREAM(pp, mod_index);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleEnhRxTestCmd::Build(rx_chan, phy, mod_index));
 }
 
 void btsnd_hcic_ble_enh_tx_test(uint8_t tx_chan, uint8_t data_len,
                                 uint8_t payload, uint8_t phy) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_ENH_TX_TEST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_ENH_TRANSMITTER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_ENH_TX_TEST);
-  UINT8_TO_STREAM(pp, tx_chan);
-  UINT8_TO_STREAM(pp, data_len);
-  UINT8_TO_STREAM(pp, payload);
-  UINT8_TO_STREAM(pp, phy);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    BleEnhTxTestCmd::Build(tx_chan, data_len, payload, phy));
 }
 
 void btsnd_hcic_ble_set_extended_scan_params(uint8_t own_address_type,
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Builders for the HCI commands with a fixed parameter layout. A command is
+ *  declared once, as its opcode followed by the type of each parameter in
+ *  the order they are sent:
+ *
+ *    using DisconnectCmd = hcic::Command<HCI_DISCONNECT,
+ *                                        HCIC_PARAM_SIZE_DISCONNECT,
+ *                                        hcic::Uint16, hcic::Uint8>;
+ *
+ *  and DisconnectCmd::Build(handle, reason) returns the command, in a buffer
+ *  of its exact size taken from the command buffer pool.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bt_types.h"
+#include "hci/include/command_buffer_pool.h"
+#include "hcimsgs.h"
+
+namespace hcic {
+
+/* Parameter types, with their size and encoding in the command */
+struct Uint8 {
+  using Type = uint8_t;
+  static constexpr size_t kSize = 1;
+  static void Write(uint8_t*& pp, const Type& value) {
+    UINT8_TO_STREAM(pp, value);
+  }
+};
+
+struct Uint16 {
+  using Type = uint16_t;
+  static constexpr size_t kSize = 2;
+  static void Write(uint8_t*& pp, const Type& value) {
+    UINT16_TO_STREAM(pp, value);
+  }
+};
+
+struct Uint32 {
+  using Type = uint32_t;
+  static constexpr size_t kSize = 4;
+  static void Write(uint8_t*& pp, const Type& value) {
+    UINT32_TO_STREAM(pp, value);
+  }
+};
+
+struct BdAddr {
+  using Type = RawAddress;
+  static constexpr size_t kSize = BD_ADDR_LEN;
+  static void Write(uint8_t*& pp, const Type& value) {
+    BDADDR_TO_STREAM(pp, value);
+  }
+};
+
+/* 128 bit key sent as is, as done for the LE keys */
+struct Key128 {
+  using Type = Octet16;
+  static constexpr size_t kSize = OCTET16_LEN;
+  static void Write(uint8_t*& pp, const Type& value) {
+    ARRAY_TO_STREAM(pp, value.data(), OCTET16_LEN);
+  }
+};
+
+/* 128 bit key sent in reverse order, as done for the BR/EDR link keys and
+ * OOB data */
+struct ReversedKey128 {
+  using Type = Octet16;
+  static constexpr size_t kSize = OCTET16_LEN;
+  static void Write(uint8_t*& pp, const Type& value) {
+    ARRAY16_TO_STREAM(pp, value.data());
+  }
+};
+
+template <uint16_t kOpcode, uint8_t kParamSize, typename... Params>
+class Command {
+ public:
+  static_assert((Params::kSize + ... + 0) == kParamSize,
+                "parameters do not match the size of the command");
+
+  /* Size of the command, preamble included */
+  static constexpr uint16_t kSize = HCIC_PREAMBLE_SIZE + kParamSize;
+
+  static BT_HDR* Build(const typename Params::Type&... params) {
+    BT_HDR* p = command_buffer_alloc(kSize);
+    uint8_t* pp = (uint8_t*)(p + 1);
+
+    p->len = kSize;
+    p->offset = 0;
+
+    UINT16_TO_STREAM(pp, kOpcode);
+    UINT8_TO_STREAM(pp, kParamSize);
+    (Params::Write(pp, params), ...);
+    return p;
+  }
+};
+
+}  // namespace hcic
@@ -26,6 +26,7 @@
 #include "bt_common.h"
 #include "bt_target.h"
 #include "btu.h"
+#include "hcic_builder.h"
 #include "hcidefs.h"
 #include "hcimsgs.h"
 
@@ -34,6 +35,238 @@
 
 #include "btm_int.h" /* Included for UIPC_* macro definitions */
 
+/* Commands with a fixed parameter layout, with their parameters in the order
+ * they are sent */
+namespace {
+
+using InqCancelCmd = hcic::Command<HCI_INQUIRY_CANCEL,
+                                   HCIC_PARAM_SIZE_INQ_CANCEL>;
+using ExitPerInqCmd = hcic::Command<HCI_EXIT_PERIODIC_INQUIRY_MODE,
+                                    HCIC_PARAM_SIZE_EXIT_PER_INQ>;
+using DisconnectCmd = hcic::Command<HCI_DISCONNECT, HCIC_PARAM_SIZE_DISCONNECT,
+                                    hcic::Uint16 /* handle */,
+                                    hcic::Uint8 /* reason */>;
+using AddSCOConnCmd = hcic::Command<HCI_ADD_SCO_CONNECTION,
+                                    HCIC_PARAM_SIZE_ADD_SCO_CONN,
+                                    hcic::Uint16 /* handle */,
+                                    hcic::Uint16 /* packet_types */>;
+using CreateConnCancelCmd = hcic::Command<HCI_CREATE_CONNECTION_CANCEL,
+                                          HCIC_PARAM_SIZE_CREATE_CONN_CANCEL,
+                                          hcic::BdAddr /* dest */>;
+using AcceptConnCmd = hcic::Command<HCI_ACCEPT_CONNECTION_REQUEST,
+                                    HCIC_PARAM_SIZE_ACCEPT_CONN,
+                                    hcic::BdAddr /* dest */,
+                                    hcic::Uint8 /* role */>;
+using RejectConnCmd = hcic::Command<HCI_REJECT_CONNECTION_REQUEST,
+                                    HCIC_PARAM_SIZE_REJECT_CONN,
+                                    hcic::BdAddr /* dest */,
+                                    hcic::Uint8 /* reason */>;
+using LinkKeyReqReplyCmd = hcic::Command<HCI_LINK_KEY_REQUEST_REPLY,
+                                         HCIC_PARAM_SIZE_LINK_KEY_REQ_REPLY,
+                                         hcic::BdAddr /* bd_addr */,
+                                         hcic::ReversedKey128 /* link_key */>;
+using LinkKeyNegReplyCmd = hcic::Command<HCI_LINK_KEY_REQUEST_NEG_REPLY,
+                                         HCIC_PARAM_SIZE_LINK_KEY_NEG_REPLY,
+                                         hcic::BdAddr /* bd_addr */>;
+using PinCodeNegReplyCmd = hcic::Command<HCI_PIN_CODE_REQUEST_NEG_REPLY,
+                                         HCIC_PARAM_SIZE_PIN_CODE_NEG_REPLY,
+                                         hcic::BdAddr /* bd_addr */>;
+using ChangeConnTypeCmd = hcic::Command<HCI_CHANGE_CONN_PACKET_TYPE,
+                                        HCIC_PARAM_SIZE_CHANGE_CONN_TYPE,
+                                        hcic::Uint16 /* handle */,
+                                        hcic::Uint16 /* packet_types */>;
+using AuthRequestCmd = hcic::Command<HCI_AUTHENTICATION_REQUESTED,
+                                     HCIC_PARAM_SIZE_CMD_HANDLE,
+                                     hcic::Uint16 /* handle */>;
+using SetConnEncryptCmd = hcic::Command<HCI_SET_CONN_ENCRYPTION,
+                                        HCIC_PARAM_SIZE_SET_CONN_ENCRYPT,
+                                        hcic::Uint16 /* handle */,
+                                        hcic::Uint8 /* enable */>;
+using RmtNameReqCancelCmd = hcic::Command<HCI_RMT_NAME_REQUEST_CANCEL,
+                                          HCIC_PARAM_SIZE_RMT_NAME_REQ_CANCEL,
+                                          hcic::BdAddr /* bd_addr */>;
+using RmtFeaturesReqCmd = hcic::Command<HCI_READ_RMT_FEATURES,
+                                        HCIC_PARAM_SIZE_CMD_HANDLE,
+                                        hcic::Uint16 /* handle */>;
+using RmtExtFeaturesCmd = hcic::Command<HCI_READ_RMT_EXT_FEATURES,
+                                        HCIC_PARAM_SIZE_RMT_EXT_FEATURES,
+                                        hcic::Uint16 /* handle */,
+                                        hcic::Uint8 /* page_num */>;
+using RmtVerReqCmd = hcic::Command<HCI_READ_RMT_VERSION_INFO,
+                                   HCIC_PARAM_SIZE_CMD_HANDLE,
+                                   hcic::Uint16 /* handle */>;
+using ReadRmtClkOffsetCmd = hcic::Command<HCI_READ_RMT_CLOCK_OFFSET,
+                                          HCIC_PARAM_SIZE_CMD_HANDLE,
+                                          hcic::Uint16 /* handle */>;
+using ReadLmpHandleCmd = hcic::Command<HCI_READ_LMP_HANDLE,
+                                       HCIC_PARAM_SIZE_CMD_HANDLE,
+                                       hcic::Uint16 /* handle */>;
+using SetupEscoConnCmd = hcic::Command<HCI_SETUP_ESCO_CONNECTION,
+                                       HCIC_PARAM_SIZE_SETUP_ESCO,
+                                       hcic::Uint16 /* handle */,
+                                       hcic::Uint32 /* transmit_bandwidth */,
+                                       hcic::Uint32 /* receive_bandwidth */,
+                                       hcic::Uint16 /* max_latency */,
+                                       hcic::Uint16 /* voice */,
+                                       hcic::Uint8 /* retrans_effort */,
+                                       hcic::Uint16 /* packet_types */>;
+using AcceptEscoConnCmd = hcic::Command<HCI_ACCEPT_ESCO_CONNECTION,
+                                        HCIC_PARAM_SIZE_ACCEPT_ESCO,
+                                        hcic::BdAddr /* bd_addr */,
+                                        hcic::Uint32 /* transmit_bandwidth */,
+                                        hcic::Uint32 /* receive_bandwidth */,
+                                        hcic::Uint16 /* max_latency */,
+                                        hcic::Uint16 /* content_fmt */,
+                                        hcic::Uint8 /* retrans_effort */,
+                                        hcic::Uint16 /* packet_types */>;
+using RejectEscoConnCmd = hcic::Command<HCI_REJECT_ESCO_CONNECTION,
+                                        HCIC_PARAM_SIZE_REJECT_ESCO,
+                                        hcic::BdAddr /* bd_addr */,
+                                        hcic::Uint8 /* reason */>;
+using HoldModeCmd = hcic::Command<HCI_HOLD_MODE, HCIC_PARAM_SIZE_HOLD_MODE,
+                                  hcic::Uint16 /* handle */,
+                                  hcic::Uint16 /* max_hold_period */,
+                                  hcic::Uint16 /* min_hold_period */>;
+using SniffModeCmd = hcic::Command<HCI_SNIFF_MODE, HCIC_PARAM_SIZE_SNIFF_MODE,
+                                   hcic::Uint16 /* handle */,
+                                   hcic::Uint16 /* max_sniff_period */,
+                                   hcic::Uint16 /* min_sniff_period */,
+                                   hcic::Uint16 /* sniff_attempt */,
+                                   hcic::Uint16 /* sniff_timeout */>;
+using ExitSniffModeCmd = hcic::Command<HCI_EXIT_SNIFF_MODE,
+                                       HCIC_PARAM_SIZE_CMD_HANDLE,
+                                       hcic::Uint16 /* handle */>;
+using ParkModeCmd = hcic::Command<HCI_PARK_MODE, HCIC_PARAM_SIZE_PARK_MODE,
+                                  hcic::Uint16 /* handle */,
+                                  hcic::Uint16 /* beacon_max_interval */,
+                                  hcic::Uint16 /* beacon_min_interval */>;
+using ExitParkModeCmd = hcic::Command<HCI_EXIT_PARK_MODE,
+                                      HCIC_PARAM_SIZE_CMD_HANDLE,
+                                      hcic::Uint16 /* handle */>;
+using QosSetupCmd = hcic::Command<HCI_QOS_SETUP, HCIC_PARAM_SIZE_QOS_SETUP,
+                                  hcic::Uint16 /* handle */,
+                                  hcic::Uint8 /* flags */,
+                                  hcic::Uint8 /* service_type */,
+                                  hcic::Uint32 /* token_rate */,
+                                  hcic::Uint32 /* peak */,
+                                  hcic::Uint32 /* latency */,
+                                  hcic::Uint32 /* delay_var */>;
+using SwitchRoleCmd = hcic::Command<HCI_SWITCH_ROLE,
+                                    HCIC_PARAM_SIZE_SWITCH_ROLE,
+                                    hcic::BdAddr /* bd_addr */,
+                                    hcic::Uint8 /* role */>;
+using WritePolicySetCmd = hcic::Command<HCI_WRITE_POLICY_SETTINGS,
+                                        HCIC_PARAM_SIZE_WRITE_POLICY_SET,
+                                        hcic::Uint16 /* handle */,
+                                        hcic::Uint16 /* settings */>;
+using WriteDefPolicySetCmd = hcic::Command<HCI_WRITE_DEF_POLICY_SETTINGS,
+                                           HCIC_PARAM_SIZE_WRITE_DEF_POLICY_SET,
+                                           hcic::Uint16 /* settings */>;
+using WritePinTypeCmd = hcic::Command<HCI_WRITE_PIN_TYPE,
+                                      HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                      hcic::Uint8 /* type */>;
+using DeleteStoredKeyCmd = hcic::Command<HCI_DELETE_STORED_LINK_KEY,
+                                         HCIC_PARAM_SIZE_DELETE_STORED_KEY,
+                                         hcic::BdAddr /* bd_addr */,
+                                         hcic::Uint8 /* delete_all_flag */>;
+using ReadNameCmd = hcic::Command<HCI_READ_LOCAL_NAME,
+                                  HCIC_PARAM_SIZE_READ_CMD>;
+using WritePageToutCmd = hcic::Command<HCI_WRITE_PAGE_TOUT,
+                                       HCIC_PARAM_SIZE_WRITE_PARAM2,
+                                       hcic::Uint16 /* timeout */>;
+using WriteScanEnableCmd = hcic::Command<HCI_WRITE_SCAN_ENABLE,
+                                         HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                         hcic::Uint8 /* flag */>;
+using WritePagescanCfgCmd = hcic::Command<HCI_WRITE_PAGESCAN_CFG,
+                                          HCIC_PARAM_SIZE_WRITE_PAGESCAN_CFG,
+                                          hcic::Uint16 /* interval */,
+                                          hcic::Uint16 /* window */>;
+using WriteInqscanCfgCmd = hcic::Command<HCI_WRITE_INQUIRYSCAN_CFG,
+                                         HCIC_PARAM_SIZE_WRITE_INQSCAN_CFG,
+                                         hcic::Uint16 /* interval */,
+                                         hcic::Uint16 /* window */>;
+using WriteAuthEnableCmd = hcic::Command<HCI_WRITE_AUTHENTICATION_ENABLE,
+                                         HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                         hcic::Uint8 /* flag */>;
+using WriteVoiceSettingsCmd = hcic::Command<HCI_WRITE_VOICE_SETTINGS,
+                                            HCIC_PARAM_SIZE_WRITE_PARAM2,
+                                            hcic::Uint16 /* flags */>;
+using WriteAutoFlushToutCmd =
+    hcic::Command<HCI_WRITE_AUTOMATIC_FLUSH_TIMEOUT,
+                  HCIC_PARAM_SIZE_WRITE_AUTOMATIC_FLUSH_TIMEOUT,
+                  hcic::Uint16 /* handle */, hcic::Uint16 /* tout */>;
+using ReadTxPowerCmd = hcic::Command<HCI_READ_TRANSMIT_POWER_LEVEL,
+                                     HCIC_PARAM_SIZE_READ_TX_POWER,
+                                     hcic::Uint16 /* handle */,
+                                     hcic::Uint8 /* type */>;
+using SniffSubRateCmd = hcic::Command<HCI_SNIFF_SUB_RATE,
+                                      HCIC_PARAM_SIZE_SNIFF_SUB_RATE,
+                                      hcic::Uint16 /* handle */,
+                                      hcic::Uint16 /* max_lat */,
+                                      hcic::Uint16 /* min_remote_lat */,
+                                      hcic::Uint16 /* min_local_lat */>;
+using IoCapReqReplyCmd = hcic::Command<HCI_IO_CAPABILITY_REQUEST_REPLY,
+                                       HCIC_PARAM_SIZE_IO_CAP_RESP,
+                                       hcic::BdAddr /* bd_addr */,
+                                       hcic::Uint8 /* capability */,
+                                       hcic::Uint8 /* oob_present */,
+                                       hcic::Uint8 /* auth_req */>;
+using IoCapReqNegReplyCmd = hcic::Command<HCI_IO_CAP_REQ_NEG_REPLY,
+                                          HCIC_PARAM_SIZE_IO_CAP_NEG_REPLY,
+                                          hcic::BdAddr /* bd_addr */,
+                                          hcic::Uint8 /* err_code */>;
+using ReadLocalOobDataCmd = hcic::Command<HCI_READ_LOCAL_OOB_DATA,
+                                          HCIC_PARAM_SIZE_R_LOCAL_OOB>;
+using UserPasskeyReplyCmd = hcic::Command<HCI_USER_PASSKEY_REQ_REPLY,
+                                          HCIC_PARAM_SIZE_U_PKEY_REPLY,
+                                          hcic::BdAddr /* bd_addr */,
+                                          hcic::Uint32 /* value */>;
+using UserPasskeyNegReplyCmd = hcic::Command<HCI_USER_PASSKEY_REQ_NEG_REPLY,
+                                             HCIC_PARAM_SIZE_U_PKEY_NEG_REPLY,
+                                             hcic::BdAddr /* bd_addr */>;
+using RemOobReplyCmd = hcic::Command<HCI_REM_OOB_DATA_REQ_REPLY,
+                                     HCIC_PARAM_SIZE_REM_OOB_REPLY,
+                                     hcic::BdAddr /* bd_addr */,
+                                     hcic::ReversedKey128 /* c */,
+                                     hcic::ReversedKey128 /* r */>;
+using RemOobNegReplyCmd = hcic::Command<HCI_REM_OOB_DATA_REQ_NEG_REPLY,
+                                        HCIC_PARAM_SIZE_REM_OOB_NEG_REPLY,
+                                        hcic::BdAddr /* bd_addr */>;
+using ReadInqTxPowerCmd = hcic::Command<HCI_READ_INQ_TX_POWER_LEVEL,
+                                        HCIC_PARAM_SIZE_R_TX_POWER>;
+using SendKeypressNotifCmd = hcic::Command<HCI_SEND_KEYPRESS_NOTIF,
+                                           HCIC_PARAM_SIZE_SEND_KEYPRESS_NOTIF,
+                                           hcic::BdAddr /* bd_addr */,
+                                           hcic::Uint8 /* notif */>;
+using EnhancedFlushCmd = hcic::Command<HCI_ENHANCED_FLUSH,
+                                       HCIC_PARAM_SIZE_ENHANCED_FLUSH,
+                                       hcic::Uint16 /* handle */,
+                                       hcic::Uint8 /* packet_type */>;
+using GetLinkQualityCmd = hcic::Command<HCI_GET_LINK_QUALITY,
+                                        HCIC_PARAM_SIZE_CMD_HANDLE,
+                                        hcic::Uint16 /* handle */>;
+using ReadRssiCmd = hcic::Command<HCI_READ_RSSI, HCIC_PARAM_SIZE_CMD_HANDLE,
+                                  hcic::Uint16 /* handle */>;
+using ReadFailedContactCounterCmd =
+    hcic::Command<HCI_READ_FAILED_CONTACT_COUNTER, HCIC_PARAM_SIZE_CMD_HANDLE,
+                  hcic::Uint16 /* handle */>;
+using ReadAutomaticFlushTimeoutCmd =
+    hcic::Command<HCI_READ_AUTOMATIC_FLUSH_TIMEOUT, HCIC_PARAM_SIZE_CMD_HANDLE,
+                  hcic::Uint16 /* handle */>;
+using EnableTestModeCmd = hcic::Command<HCI_ENABLE_DEV_UNDER_TEST_MODE,
+                                        HCIC_PARAM_SIZE_READ_CMD>;
+using WriteInqscanTypeCmd = hcic::Command<HCI_WRITE_INQSCAN_TYPE,
+                                          HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                          hcic::Uint8 /* type */>;
+using WriteInquiryModeCmd = hcic::Command<HCI_WRITE_INQUIRY_MODE,
+                                          HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                          hcic::Uint8 /* mode */>;
+using WritePagescanTypeCmd = hcic::Command<HCI_WRITE_PAGESCAN_TYPE,
+                                           HCIC_PARAM_SIZE_WRITE_PARAM1,
+                                           hcic::Uint8 /* type */>;
+
+}  // namespace
+
 void btsnd_hcic_inquiry(const LAP inq_lap, uint8_t duration,
                         uint8_t response_cnt) {
   BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
@@ -53,15 +286,7 @@ void btsnd_hcic_inquiry(const LAP inq_lap, uint8_t duration,
 }
 
 void btsnd_hcic_inq_cancel(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_INQ_CANCEL;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_INQUIRY_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_INQ_CANCEL);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, InqCancelCmd::Build());
 }
 
 void btsnd_hcic_per_inq_mode(uint16_t max_period, uint16_t min_period,
@@ -86,15 +311,7 @@ void btsnd_hcic_per_inq_mode(uint16_t max_period, uint16_t min_period,
 }
 
 void btsnd_hcic_exit_per_inq(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_EXIT_PER_INQ;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_EXIT_PERIODIC_INQUIRY_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_EXIT_PER_INQ);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, ExitPerInqCmd::Build());
 }
 
 void btsnd_hcic_create_conn(const RawAddress& dest, uint16_t packet_types,
@@ -128,112 +345,39 @@ void btsnd_hcic_create_conn(const RawAddress& dest, uint16_t packet_types,
 }
 
 void btsnd_hcic_disconnect(uint16_t handle, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_DISCONNECT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_DISCONNECT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_DISCONNECT);
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, reason);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    DisconnectCmd::Build(handle, reason));
 }
 
 void btsnd_hcic_add_SCO_conn(uint16_t handle, uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ADD_SCO_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ADD_SCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ADD_SCO_CONN);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, packet_types);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    AddSCOConnCmd::Build(handle, packet_types));
 }
 
 void btsnd_hcic_create_conn_cancel(const RawAddress& dest) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CREATE_CONN_CANCEL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_CREATE_CONNECTION_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CREATE_CONN_CANCEL);
-
-  BDADDR_TO_STREAM(pp, dest);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    CreateConnCancelCmd::Build(dest));
 }
 
 void btsnd_hcic_accept_conn(const RawAddress& dest, uint8_t role) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ACCEPT_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ACCEPT_CONNECTION_REQUEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ACCEPT_CONN);
-  BDADDR_TO_STREAM(pp, dest);
-  UINT8_TO_STREAM(pp, role);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    AcceptConnCmd::Build(dest, role));
 }
 
 void btsnd_hcic_reject_conn(const RawAddress& dest, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REJECT_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REJECT_CONNECTION_REQUEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REJECT_CONN);
-
-  BDADDR_TO_STREAM(pp, dest);
-  UINT8_TO_STREAM(pp, reason);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RejectConnCmd::Build(dest, reason));
 }
 
 void btsnd_hcic_link_key_req_reply(const RawAddress& bd_addr,
                                    const LinkKey& link_key) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LINK_KEY_REQ_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_LINK_KEY_REQUEST_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LINK_KEY_REQ_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  ARRAY16_TO_STREAM(pp, link_key.data());
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    LinkKeyReqReplyCmd::Build(bd_addr, link_key));
 }
 
 void btsnd_hcic_link_key_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LINK_KEY_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_LINK_KEY_REQUEST_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LINK_KEY_NEG_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    LinkKeyNegReplyCmd::Build(bd_addr));
 }
 
 void btsnd_hcic_pin_code_req_reply(const RawAddress& bd_addr,
@@ -259,65 +403,22 @@ void btsnd_hcic_pin_code_req_reply(const RawAddress& bd_addr,
 }
 
 void btsnd_hcic_pin_code_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_PIN_CODE_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_PIN_CODE_REQUEST_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_PIN_CODE_NEG_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    PinCodeNegReplyCmd::Build(bd_addr));
 }
 
 void btsnd_hcic_change_conn_type(uint16_t handle, uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CHANGE_CONN_TYPE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_CHANGE_CONN_PACKET_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CHANGE_CONN_TYPE);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, packet_types);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ChangeConnTypeCmd::Build(handle, packet_types));
 }
 
 void btsnd_hcic_auth_request(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_AUTHENTICATION_REQUESTED);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, AuthRequestCmd::Build(handle));
 }
 
 void btsnd_hcic_set_conn_encrypt(uint16_t handle, bool enable) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SET_CONN_ENCRYPT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SET_CONN_ENCRYPTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SET_CONN_ENCRYPT);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, enable);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    SetConnEncryptCmd::Build(handle, enable));
 }
 
 void btsnd_hcic_rmt_name_req(const RawAddress& bd_addr,
@@ -341,118 +442,43 @@ void btsnd_hcic_rmt_name_req(const RawAddress& bd_addr,
 }
 
 void btsnd_hcic_rmt_name_req_cancel(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_RMT_NAME_REQ_CANCEL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_RMT_NAME_REQUEST_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_RMT_NAME_REQ_CANCEL);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RmtNameReqCancelCmd::Build(bd_addr));
 }
 
 void btsnd_hcic_rmt_features_req(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_FEATURES);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RmtFeaturesReqCmd::Build(handle));
 }
 
 void btsnd_hcic_rmt_ext_features(uint16_t handle, uint8_t page_num) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_RMT_EXT_FEATURES;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_EXT_FEATURES);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_RMT_EXT_FEATURES);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, page_num);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RmtExtFeaturesCmd::Build(handle, page_num));
 }
 
 void btsnd_hcic_rmt_ver_req(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_VERSION_INFO);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, RmtVerReqCmd::Build(handle));
 }
 
 void btsnd_hcic_read_rmt_clk_offset(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_CLOCK_OFFSET);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ReadRmtClkOffsetCmd::Build(handle));
 }
 
 void btsnd_hcic_read_lmp_handle(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LMP_HANDLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ReadLmpHandleCmd::Build(handle));
 }
 
 void btsnd_hcic_setup_esco_conn(uint16_t handle, uint32_t transmit_bandwidth,
                                 uint32_t receive_bandwidth,
                                 uint16_t max_latency, uint16_t voice,
                                 uint8_t retrans_effort, uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SETUP_ESCO;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SETUP_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SETUP_ESCO);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT32_TO_STREAM(pp, transmit_bandwidth);
-  UINT32_TO_STREAM(pp, receive_bandwidth);
-  UINT16_TO_STREAM(pp, max_latency);
-  UINT16_TO_STREAM(pp, voice);
-  UINT8_TO_STREAM(pp, retrans_effort);
-  UINT16_TO_STREAM(pp, packet_types);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    SetupEscoConnCmd::Build(handle, transmit_bandwidth,
+                                            receive_bandwidth, max_latency,
+                                            voice, retrans_effort,
+                                            packet_types));
 }
 
 void btsnd_hcic_accept_esco_conn(const RawAddress& bd_addr,
@@ -461,195 +487,71 @@ void btsnd_hcic_accept_esco_conn(const RawAddress& bd_addr,
                                  uint16_t max_latency, uint16_t content_fmt,
                                  uint8_t retrans_effort,
                                  uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ACCEPT_ESCO;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ACCEPT_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ACCEPT_ESCO);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT32_TO_STREAM(pp, transmit_bandwidth);
-  UINT32_TO_STREAM(pp, receive_bandwidth);
-  UINT16_TO_STREAM(pp, max_latency);
-  UINT16_TO_STREAM(pp, content_fmt);
-  UINT8_TO_STREAM(pp, retrans_effort);
-  UINT16_TO_STREAM(pp, packet_types);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    AcceptEscoConnCmd::Build(bd_addr, transmit_bandwidth,
+                                             receive_bandwidth, max_latency,
+                                             content_fmt, retrans_effort,
+                                             packet_types));
 }
 
 void btsnd_hcic_reject_esco_conn(const RawAddress& bd_addr, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REJECT_ESCO;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REJECT_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REJECT_ESCO);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT8_TO_STREAM(pp, reason);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RejectEscoConnCmd::Build(bd_addr, reason));
 }
 
 void btsnd_hcic_hold_mode(uint16_t handle, uint16_t max_hold_period,
                           uint16_t min_hold_period) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_HOLD_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_HOLD_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_HOLD_MODE);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, max_hold_period);
-  UINT16_TO_STREAM(pp, min_hold_period);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    HoldModeCmd::Build(handle, max_hold_period,
+                                       min_hold_period));
 }
 
 void btsnd_hcic_sniff_mode(uint16_t handle, uint16_t max_sniff_period,
                            uint16_t min_sniff_period, uint16_t sniff_attempt,
                            uint16_t sniff_timeout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SNIFF_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SNIFF_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SNIFF_MODE);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, max_sniff_period);
-  UINT16_TO_STREAM(pp, min_sniff_period);
-  UINT16_TO_STREAM(pp, sniff_attempt);
-  UINT16_TO_STREAM(pp, sniff_timeout);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    SniffModeCmd::Build(handle, max_sniff_period,
+                                        min_sniff_period, sniff_attempt,
+                                        sniff_timeout));
 }
 
 void btsnd_hcic_exit_sniff_mode(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_EXIT_SNIFF_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ExitSniffModeCmd::Build(handle));
 }
 
 void btsnd_hcic_park_mode(uint16_t handle, uint16_t beacon_max_interval,
                           uint16_t beacon_min_interval) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_PARK_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_PARK_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_PARK_MODE);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, beacon_max_interval);
-  UINT16_TO_STREAM(pp, beacon_min_interval);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ParkModeCmd::Build(handle, beacon_max_interval,
+                                       beacon_min_interval));
 }
 
 void btsnd_hcic_exit_park_mode(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_EXIT_PARK_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, ExitParkModeCmd::Build(handle));
 }
 
 void btsnd_hcic_qos_setup(uint16_t handle, uint8_t flags, uint8_t service_type,
                           uint32_t token_rate, uint32_t peak, uint32_t latency,
                           uint32_t delay_var) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_QOS_SETUP;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_QOS_SETUP);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_QOS_SETUP);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, flags);
-  UINT8_TO_STREAM(pp, service_type);
-  UINT32_TO_STREAM(pp, token_rate);
-  UINT32_TO_STREAM(pp, peak);
-  UINT32_TO_STREAM(pp, latency);
-  UINT32_TO_STREAM(pp, delay_var);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    QosSetupCmd::Build(handle, flags, service_type, token_rate,
+                                       peak, latency, delay_var));
 }
 
 void btsnd_hcic_switch_role(const RawAddress& bd_addr, uint8_t role) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SWITCH_ROLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SWITCH_ROLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SWITCH_ROLE);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT8_TO_STREAM(pp, role);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    SwitchRoleCmd::Build(bd_addr, role));
 }
 
-void btsnd_hcic_write_policy_set(uint16_t handle, uint16_t settings) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_POLICY_SET;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_WRITE_POLICY_SETTINGS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_POLICY_SET);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, settings);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
-}
-
-void btsnd_hcic_write_def_policy_set(uint16_t settings) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_DEF_POLICY_SET;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_WRITE_DEF_POLICY_SETTINGS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_DEF_POLICY_SET);
-
-  UINT16_TO_STREAM(pp, settings);
+void btsnd_hcic_write_policy_set(uint16_t handle, uint16_t settings) {
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WritePolicySetCmd::Build(handle, settings));
+}
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+void btsnd_hcic_write_def_policy_set(uint16_t settings) {
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteDefPolicySetCmd::Build(settings));
 }
 
 void btsnd_hcic_set_event_filter(uint8_t filt_type, uint8_t filt_cond_type,
@@ -694,35 +596,13 @@ void btsnd_hcic_set_event_filter(uint8_t filt_type, uint8_t filt_cond_type,
 }
 
 void btsnd_hcic_write_pin_type(uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PIN_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, type);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, WritePinTypeCmd::Build(type));
 }
 
 void btsnd_hcic_delete_stored_key(const RawAddress& bd_addr,
                                   bool delete_all_flag) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_DELETE_STORED_KEY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_DELETE_STORED_LINK_KEY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_DELETE_STORED_KEY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT8_TO_STREAM(pp, delete_all_flag);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    DeleteStoredKeyCmd::Build(bd_addr, delete_all_flag));
 }
 
 void btsnd_hcic_change_name(BD_NAME name) {
@@ -746,93 +626,32 @@ void btsnd_hcic_change_name(BD_NAME name) {
 }
 
 void btsnd_hcic_read_name(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LOCAL_NAME);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, ReadNameCmd::Build());
 }
 
 void btsnd_hcic_write_page_tout(uint16_t timeout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM2;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PAGE_TOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM2);
-
-  UINT16_TO_STREAM(pp, timeout);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WritePageToutCmd::Build(timeout));
 }
 
 void btsnd_hcic_write_scan_enable(uint8_t flag) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_SCAN_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, flag);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteScanEnableCmd::Build(flag));
 }
 
 void btsnd_hcic_write_pagescan_cfg(uint16_t interval, uint16_t window) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PAGESCAN_CFG;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PAGESCAN_CFG);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PAGESCAN_CFG);
-
-  UINT16_TO_STREAM(pp, interval);
-  UINT16_TO_STREAM(pp, window);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WritePagescanCfgCmd::Build(interval, window));
 }
 
 void btsnd_hcic_write_inqscan_cfg(uint16_t interval, uint16_t window) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_INQSCAN_CFG;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_INQUIRYSCAN_CFG);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_INQSCAN_CFG);
-
-  UINT16_TO_STREAM(pp, interval);
-  UINT16_TO_STREAM(pp, window);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteInqscanCfgCmd::Build(interval, window));
 }
 
 void btsnd_hcic_write_auth_enable(uint8_t flag) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_AUTHENTICATION_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, flag);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteAuthEnableCmd::Build(flag));
 }
 
 void btsnd_hcic_write_dev_class(DEV_CLASS dev_class) {
@@ -851,50 +670,18 @@ void btsnd_hcic_write_dev_class(DEV_CLASS dev_class) {
 }
 
 void btsnd_hcic_write_voice_settings(uint16_t flags) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM2;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_VOICE_SETTINGS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM2);
-
-  UINT16_TO_STREAM(pp, flags);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteVoiceSettingsCmd::Build(flags));
 }
 
 void btsnd_hcic_write_auto_flush_tout(uint16_t handle, uint16_t tout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_AUTOMATIC_FLUSH_TIMEOUT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_AUTOMATIC_FLUSH_TIMEOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_AUTOMATIC_FLUSH_TIMEOUT);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, tout);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteAutoFlushToutCmd::Build(handle, tout));
 }
 
 void btsnd_hcic_read_tx_power(uint16_t handle, uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_TX_POWER;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_TRANSMIT_POWER_LEVEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_TX_POWER);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, type);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ReadTxPowerCmd::Build(handle, type));
 }
 
 void btsnd_hcic_host_num_xmitted_pkts(uint8_t num_handles, uint16_t* handle,
@@ -960,21 +747,9 @@ void btsnd_hcic_write_cur_iac_lap(uint8_t num_cur_iac, LAP* const iac_lap) {
 void btsnd_hcic_sniff_sub_rate(uint16_t handle, uint16_t max_lat,
                                uint16_t min_remote_lat,
                                uint16_t min_local_lat) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SNIFF_SUB_RATE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SNIFF_SUB_RATE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SNIFF_SUB_RATE);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT16_TO_STREAM(pp, max_lat);
-  UINT16_TO_STREAM(pp, min_remote_lat);
-  UINT16_TO_STREAM(pp, min_local_lat);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    SniffSubRateCmd::Build(handle, max_lat, min_remote_lat,
+                                           min_local_lat));
 }
 #endif /* BTM_SSR_INCLUDED */
 
@@ -996,21 +771,9 @@ void btsnd_hcic_write_ext_inquiry_response(void* buffer, uint8_t fec_req) {
 
 void btsnd_hcic_io_cap_req_reply(const RawAddress& bd_addr, uint8_t capability,
                                  uint8_t oob_present, uint8_t auth_req) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_IO_CAP_RESP;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_IO_CAPABILITY_REQUEST_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_IO_CAP_RESP);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT8_TO_STREAM(pp, capability);
-  UINT8_TO_STREAM(pp, oob_present);
-  UINT8_TO_STREAM(pp, auth_req);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    IoCapReqReplyCmd::Build(bd_addr, capability, oob_present,
+                                            auth_req));
 }
 
 void btsnd_hcic_enhanced_set_up_synchronous_connection(
@@ -1113,32 +876,12 @@ void btsnd_hcic_enhanced_accept_synchronous_connection(
 
 void btsnd_hcic_io_cap_req_neg_reply(const RawAddress& bd_addr,
                                      uint8_t err_code) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_IO_CAP_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_IO_CAP_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_IO_CAP_NEG_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT8_TO_STREAM(pp, err_code);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    IoCapReqNegReplyCmd::Build(bd_addr, err_code));
 }
 
 void btsnd_hcic_read_local_oob_data(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_R_LOCAL_OOB;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LOCAL_OOB_DATA);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_R_LOCAL_OOB);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, ReadLocalOobDataCmd::Build());
 }
 
 void btsnd_hcic_user_conf_reply(const RawAddress& bd_addr, bool is_yes) {
@@ -1164,114 +907,41 @@ void btsnd_hcic_user_conf_reply(const RawAddress& bd_addr, bool is_yes) {
 }
 
 void btsnd_hcic_user_passkey_reply(const RawAddress& bd_addr, uint32_t value) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_U_PKEY_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_USER_PASSKEY_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_U_PKEY_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT32_TO_STREAM(pp, value);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    UserPasskeyReplyCmd::Build(bd_addr, value));
 }
 
 void btsnd_hcic_user_passkey_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_U_PKEY_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_USER_PASSKEY_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_U_PKEY_NEG_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    UserPasskeyNegReplyCmd::Build(bd_addr));
 }
 
 void btsnd_hcic_rem_oob_reply(const RawAddress& bd_addr, const Octet16& c,
                               const Octet16& r) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REM_OOB_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REM_OOB_DATA_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REM_OOB_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  ARRAY16_TO_STREAM(pp, c.data());
-  ARRAY16_TO_STREAM(pp, r.data());
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RemOobReplyCmd::Build(bd_addr, c, r));
 }
 
 void btsnd_hcic_rem_oob_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REM_OOB_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REM_OOB_DATA_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REM_OOB_NEG_REPLY);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    RemOobNegReplyCmd::Build(bd_addr));
 }
 
 void btsnd_hcic_read_inq_tx_power(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_R_TX_POWER;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_INQ_TX_POWER_LEVEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_R_TX_POWER);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, ReadInqTxPowerCmd::Build());
 }
 
 void btsnd_hcic_send_keypress_notif(const RawAddress& bd_addr, uint8_t notif) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SEND_KEYPRESS_NOTIF;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SEND_KEYPRESS_NOTIF);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SEND_KEYPRESS_NOTIF);
-
-  BDADDR_TO_STREAM(pp, bd_addr);
-  UINT8_TO_STREAM(pp, notif);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    SendKeypressNotifCmd::Build(bd_addr, notif));
 }
 
 /**** end of Simple Pairing Commands ****/
 
 #if (L2CAP_NON_FLUSHABLE_PB_INCLUDED == TRUE)
 void btsnd_hcic_enhanced_flush(uint16_t handle, uint8_t packet_type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ENHANCED_FLUSH;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_ENHANCED_FLUSH);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ENHANCED_FLUSH);
-
-  UINT16_TO_STREAM(pp, handle);
-  UINT8_TO_STREAM(pp, packet_type);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    EnhancedFlushCmd::Build(handle, packet_type));
 }
 #endif
 
@@ -1280,33 +950,12 @@ void btsnd_hcic_enhanced_flush(uint16_t handle, uint8_t packet_type) {
  *************************/
 
 void btsnd_hcic_get_link_quality(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_GET_LINK_QUALITY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    GetLinkQualityCmd::Build(handle));
 }
 
 void btsnd_hcic_read_rssi(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RSSI);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, ReadRssiCmd::Build(handle));
 }
 
 static void read_encryption_key_size_complete(ReadEncKeySizeCb cb, uint8_t* return_parameters,
@@ -1334,91 +983,32 @@ void btsnd_hcic_read_encryption_key_size(uint16_t handle, ReadEncKeySizeCb cb) {
 }
 
 void btsnd_hcic_read_failed_contact_counter(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_FAILED_CONTACT_COUNTER);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ReadFailedContactCounterCmd::Build(handle));
 }
 
 void btsnd_hcic_read_automatic_flush_timeout(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_AUTOMATIC_FLUSH_TIMEOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
-
-  UINT16_TO_STREAM(pp, handle);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    ReadAutomaticFlushTimeoutCmd::Build(handle));
 }
 
 void btsnd_hcic_enable_test_mode(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ENABLE_DEV_UNDER_TEST_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, EnableTestModeCmd::Build());
 }
 
 void btsnd_hcic_write_inqscan_type(uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_INQSCAN_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, type);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteInqscanTypeCmd::Build(type));
 }
 
 void btsnd_hcic_write_inquiry_mode(uint8_t mode) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_INQUIRY_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, mode);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WriteInquiryModeCmd::Build(mode));
 }
 
 void btsnd_hcic_write_pagescan_type(uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PAGESCAN_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
-
-  UINT8_TO_STREAM(pp, type);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID,
+                    WritePagescanTypeCmd::Build(type));
 }
 
 /* Must have room to store BT_HDR + max VSC length + callback pointer */
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// A2DP PCM sample rate converter
+//
+
+#ifndef A2DP_RESAMPLER_H
+#define A2DP_RESAMPLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+// Polyphase sample rate converter for interleaved 16-bit PCM, for any rational
+// ratio between the source and the destination rates (e.g. 44.1 kHz to
+// 48 kHz uses 160 phases, 147 input samples apart).
+//
+// Each output sample is the dot product of one phase of a windowed sinc
+// low-pass filter with the most recent input samples. The dot products are
+// computed in single precision, with SSE2 or NEON when available.
+class A2dpResampler {
+ public:
+  enum Quality {
+    // 16 taps per phase, ~55 dB stopband
+    kQualityLow,
+    // 32 taps per phase, ~80 dB stopband
+    kQualityMedium,
+    // 64 taps per phase, ~100 dB stopband
+    kQualityHigh,
+  };
+
+  // Creates a converter from |src_rate| to |dst_rate| for |channel_count|
+  // interleaved channels (1 or 2).
+  // Returns nullptr if the parameters are not supported, e.g. when the
+  // reduced ratio needs too many filter phases.
+  static std::unique_ptr<A2dpResampler> create(uint32_t src_rate,
+                                               uint32_t dst_rate,
+                                               uint8_t channel_count,
+                                               Quality quality);
+
+  uint32_t srcRate() const { return src_rate_; }
+  uint32_t dstRate() const { return dst_rate_; }
+  uint8_t channelCount() const { return channel_count_; }
+  Quality quality() const { return quality_; }
+
+  // Gets the delay introduced by the filter, in source frames.
+  size_t delayFrames() const { return taps_per_phase_ / 2; }
+
+  // Gets the maximum number of frames that converting |src_frames| frames
+  // can produce.
+  size_t maxOutputFrames(size_t src_frames) const;
+
+  // Converts the |src_frames| frames of |p_src|, and writes the output to
+  // |p_dst|, which must hold at least maxOutputFrames(|src_frames|) frames.
+  // All the input is consumed, the samples still needed by the filter are
+  // kept for the next call.
+  // Returns the number of frames written to |p_dst|.
+  size_t resample(const int16_t* p_src, size_t src_frames, int16_t* p_dst,
+                  size_t dst_capacity_frames);
+
+  // Clears the filter history, e.g. when the audio stream restarts.
+  void reset();
+
+ private:
+  A2dpResampler(uint32_t src_rate, uint32_t dst_rate, uint8_t channel_count,
+                Quality quality, uint32_t interpolation, uint32_t decimation,
+                size_t taps_per_phase);
+  void initFilter();
+  // Converts the |block_frames| input frames appended to the history buffers
+  size_t processBlock(size_t block_frames, int16_t* p_dst,
+                      size_t dst_capacity_frames);
+
+  const uint32_t src_rate_;
+  const uint32_t dst_rate_;
+  const uint8_t channel_count_;
+  const Quality quality_;
+  // The reduced dst_rate / src_rate ratio: number of filter phases, and the
+  // phase increment per output frame.
+  const uint32_t interpolation_;
+  const uint32_t decimation_;
+  const size_t taps_per_phase_;
+
+  // Filter phases, each one in reverse order so that it multiplies the input
+  // samples in memory order.
+  std::vector<float> coefficients_;
+  // Per channel input samples, the first taps_per_phase_ - 1 ones being the
+  // history of the previous call.
+  std::vector<std::vector<float>> history_;
+  // Phase of the next output frame, and the position of its input frame
+  // within the current block.
+  uint32_t phase_;
+  size_t input_position_;
+};
+
+#endif  // A2DP_RESAMPLER_H
@@ -1443,6 +1443,25 @@ extern tBTM_STATUS BTM_SetPowerMode(uint8_t pm_id, const RawAddress& remote_bda,
 extern tBTM_STATUS BTM_ReadPowerMode(const RawAddress& remote_bda,
                                      tBTM_PM_MODE* p_mode);
 
+/*******************************************************************************
+ *
+ * Function         BTM_PmReadLinkStats
+ *
+ * Description      This returns the counters of the power mode changes of a
+ *                  specific ACL connection.
+ *
+ * Input Param      remote_bda - device address of desired ACL connection
+ *
+ * Output Param     p_stats - address where the counters are copied into
+ *                            (valid only if return code is BTM_SUCCESS)
+ *
+ * Returns          BTM_SUCCESS if successful,
+ *                  BTM_UNKNOWN_ADDR if bd addr is not active or bad
+ *
+ ******************************************************************************/
+extern tBTM_STATUS BTM_PmReadLinkStats(const RawAddress& remote_bda,
+                                       tBTM_PM_LINK_STATS* p_stats);
+
 /*******************************************************************************
  *
  * Function         BTM_SetSsrParams
@@ -1725,6 +1725,18 @@ typedef struct {
   tBTM_PM_MODE mode;
 } tBTM_PM_PWR_MD;
 
+/* Power mode activity of an ACL link since it was connected */
+typedef struct {
+  uint16_t to_active;     /* mode changes to active mode */
+  uint16_t to_hold;       /* mode changes to hold mode */
+  uint16_t to_sniff;      /* mode changes to sniff mode */
+  uint16_t to_park;       /* mode changes to park mode */
+  uint16_t cmds_sent;     /* HCI mode commands sent */
+  uint16_t cmds_failed;   /* HCI mode commands rejected by the controller */
+  uint16_t deferred;      /* low power requests held back after a wake up */
+  uint16_t flaps_avoided; /* held back requests cancelled by a wake up */
+} tBTM_PM_LINK_STATS;
+
 /*************************************
  *  Power Manager Callback Functions
  *************************************/
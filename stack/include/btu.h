@@ -31,6 +31,7 @@
 #include "bt_target.h"
 #include "common/message_loop_thread.h"
 #include "osi/include/alarm.h"
+#include "osi/include/future.h"
 
 #include <base/callback.h>
 #include <base/location.h>
@@ -67,6 +68,10 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
                                       const base::TimeDelta& delay);
 
 void BTU_StartUp(void);
+/* Same as BTU_StartUp(), but the core stack control blocks are initialized
+ * while the HCI layer is still starting up. The rest of the stack is only
+ * brought up once |hci_start_up_future| is ready. */
+void BTU_StartUpOverlapped(future_t* hci_start_up_future);
 void BTU_ShutDown(void);
 
 #endif
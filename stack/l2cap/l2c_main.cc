@@ -31,6 +31,7 @@
 #include "bt_common.h"
 #include "bt_target.h"
 #include "btu.h"
+#include "common/latency_tracer.h"
 #include "device/include/controller.h"
 #include "hci/include/btsnoop.h"
 #include "hcimsgs.h"
@@ -61,6 +62,8 @@ tL2C_CB l2cb;
  *
  ******************************************************************************/
 void l2c_rcv_acl_data(BT_HDR* p_msg) {
+  bluetooth::common::LatencyTracer::Stamp(
+      bluetooth::common::LatencyTracer::L2CAP_RX);
   uint8_t* p = (uint8_t*)(p_msg + 1) + p_msg->offset;
 
   /* Extract the handle */
@@ -26,6 +26,7 @@
 #include "bt_target.h"
 
 #include "bt_common.h"
+#include "common/latency_tracer.h"
 #include "common/time_util.h"
 #include "osi/include/osi.h"
 
@@ -281,6 +282,8 @@ void RFCOMM_DisconnectInd(uint16_t lcid, bool is_conf_needed) {
  *
  ******************************************************************************/
 void RFCOMM_BufDataInd(uint16_t lcid, BT_HDR* p_buf) {
+  bluetooth::common::LatencyTracer::Stamp(
+      bluetooth::common::LatencyTracer::RFCOMM_RX);
   tRFC_MCB* p_mcb = rfc_find_lcid_mcb(lcid);
 
   if (!p_mcb) {
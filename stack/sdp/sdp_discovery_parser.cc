@@ -0,0 +1,709 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  This file contains the parser of the attribute lists received in the SDP
+ *  discovery responses. Each continuation fragment is parsed as it arrives,
+ *  and the records and attributes are carved out of the discovery database
+ *  directly, the attributes of a record kept sorted by attribute ID.
+ *
+ ******************************************************************************/
+
+#include <string.h>
+
+#include "bt_common.h"
+#include "bt_target.h"
+#include "sdp_api.h"
+#include "sdpint.h"
+
+using bluetooth::Uuid;
+
+/* Parser states */
+#define SDP_DISC_PARSE_HDR 0   /* Parsing a data element header */
+#define SDP_DISC_PARSE_VALUE 1 /* Parsing a data element value */
+#define SDP_DISC_PARSE_DONE 2  /* The whole response was parsed */
+
+/* Where the bytes of a data element value go */
+#define SDP_DISC_SINK_ATTR_ID 0 /* Attribute ID in the attribute list */
+#define SDP_DISC_SINK_DECODE 1  /* Decoded into the attribute once complete */
+#define SDP_DISC_SINK_ARRAY 2   /* Copied into the attribute as they arrive */
+#define SDP_DISC_SINK_SKIP 3    /* Dropped */
+
+/* Kinds of data elements the parser can be inside of */
+#define SDP_DISC_LEVEL_LIST 0   /* List of attribute lists */
+#define SDP_DISC_LEVEL_RECORD 1 /* Attribute list, alternating IDs and values */
+#define SDP_DISC_LEVEL_VALUE 2  /* Data element sequence or alternative */
+#define SDP_DISC_LEVEL_PROTO 3  /* Protocol list following its attribute ID
+                                   in an additional protocol list */
+
+#define SDP_ADDITIONAL_LIST_MASK 0x80
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_hdr_len
+ *
+ * Description      Returns the size of a data element header, from its
+ *                  type descriptor.
+ *
+ ******************************************************************************/
+static uint8_t sdp_disc_parse_hdr_len(uint8_t type) {
+  switch (type & 7) {
+    case SIZE_IN_NEXT_BYTE:
+      return 2;
+    case SIZE_IN_NEXT_WORD:
+      return 3;
+    case SIZE_IN_NEXT_LONG:
+      return 5;
+    default:
+      return 1;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_value_len
+ *
+ * Description      Returns the length of a data element value, from its
+ *                  complete header.
+ *
+ ******************************************************************************/
+static uint32_t sdp_disc_parse_value_len(uint8_t* p_hdr) {
+  uint8_t type = *p_hdr++;
+  uint8_t u8;
+  uint16_t u16;
+  uint32_t u32;
+
+  switch (type & 7) {
+    case SIZE_ONE_BYTE:
+      return 1;
+    case SIZE_TWO_BYTES:
+      return 2;
+    case SIZE_FOUR_BYTES:
+      return 4;
+    case SIZE_EIGHT_BYTES:
+      return 8;
+    case SIZE_SIXTEEN_BYTES:
+      return 16;
+    case SIZE_IN_NEXT_BYTE:
+      BE_STREAM_TO_UINT8(u8, p_hdr);
+      return u8;
+    case SIZE_IN_NEXT_WORD:
+      BE_STREAM_TO_UINT16(u16, p_hdr);
+      return u16;
+    default:
+      BE_STREAM_TO_UINT32(u32, p_hdr);
+      return u32;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_push
+ *
+ * Description      Enters a data element sequence.
+ *
+ ******************************************************************************/
+static void sdp_disc_parse_push(tSDP_DISC_PARSER* p_parser, uint8_t kind,
+                                uint32_t end, tSDP_DISC_ATTR* p_attr,
+                                uint8_t nest_level) {
+  tSDP_DISC_PARSE_LEVEL* p_level = &p_parser->levels[p_parser->depth++];
+
+  p_level->end = end;
+  p_level->p_attr = p_attr;
+  p_level->p_last_attr = NULL;
+  p_level->num_elems = 0;
+  p_level->kind = kind;
+  p_level->nest_level = nest_level;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_pop
+ *
+ * Description      Leaves the data element sequences whose last element
+ *                  was parsed.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+static uint16_t sdp_disc_parse_pop(tSDP_DISC_PARSER* p_parser) {
+  while (p_parser->depth > 0) {
+    tSDP_DISC_PARSE_LEVEL* p_level = &p_parser->levels[p_parser->depth - 1];
+
+    if (p_level->kind == SDP_DISC_LEVEL_PROTO) {
+      /* Holds a single element, none if the sequence ends first */
+      if (p_level->num_elems == 0 && p_parser->offset < p_level->end)
+        return SDP_SUCCESS;
+    } else if (p_parser->offset < p_level->end) {
+      return SDP_SUCCESS;
+    }
+
+    if (p_level->kind == SDP_DISC_LEVEL_RECORD && (p_level->num_elems & 1)) {
+      SDP_TRACE_WARNING("SDP - No value for attribute 0x%04x in attr_rsp",
+                        p_parser->attr_id);
+      return SDP_DB_FULL;
+    }
+
+    p_parser->depth--;
+    if (p_parser->depth > 0)
+      p_parser->levels[p_parser->depth - 1].num_elems++;
+  }
+
+  p_parser->state = SDP_DISC_PARSE_DONE;
+  return SDP_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_link
+ *
+ * Description      Adds an attribute to the data element the parser is in,
+ *                  keeping the attributes of a record sorted. Servers send
+ *                  them in ascending order, so this is an append to the
+ *                  last attribute.
+ *
+ ******************************************************************************/
+static void sdp_disc_parse_link(tSDP_DISC_PARSER* p_parser,
+                                tSDP_DISC_ATTR* p_attr) {
+  tSDP_DISC_PARSE_LEVEL* p_level = &p_parser->levels[p_parser->depth - 1];
+  tSDP_DISC_ATTR* p_last = p_level->p_last_attr;
+
+  if (p_level->kind == SDP_DISC_LEVEL_RECORD && p_last != NULL &&
+      p_last->attr_id > p_attr->attr_id) {
+    tSDP_DISC_ATTR** pp_attr = &p_parser->p_rec->p_first_attr;
+
+    while ((*pp_attr)->attr_id <= p_attr->attr_id)
+      pp_attr = &(*pp_attr)->p_next_attr;
+
+    p_attr->p_next_attr = *pp_attr;
+    *pp_attr = p_attr;
+    return;
+  }
+
+  if (p_last != NULL)
+    p_last->p_next_attr = p_attr;
+  else if (p_level->kind == SDP_DISC_LEVEL_RECORD)
+    p_parser->p_rec->p_first_attr = p_attr;
+  else
+    p_level->p_attr->attr_value.v.p_sub_attr = p_attr;
+
+  p_level->p_last_attr = p_attr;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_value
+ *
+ * Description      Starts parsing the value of a data element.
+ *
+ ******************************************************************************/
+static uint16_t sdp_disc_parse_value_done(tSDP_DISC_PARSER* p_parser);
+
+static uint16_t sdp_disc_parse_value(tSDP_DISC_PARSER* p_parser, uint8_t sink,
+                                     tSDP_DISC_ATTR* p_attr, uint32_t len) {
+  p_parser->state = SDP_DISC_PARSE_VALUE;
+  p_parser->sink = sink;
+  p_parser->p_attr = p_attr;
+  p_parser->value_len = len;
+  p_parser->value_used = 0;
+
+  if (len == 0) return sdp_disc_parse_value_done(p_parser);
+  return SDP_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_record
+ *
+ * Description      Adds a record to the database for an attribute list.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+static uint16_t sdp_disc_parse_record(tSDP_DISC_PARSER* p_parser,
+                                      uint8_t type, uint32_t len) {
+  tSDP_DISCOVERY_DB* p_db = p_parser->p_db;
+  tSDP_DISC_REC* p_rec;
+
+  if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
+    SDP_TRACE_WARNING("SDP - Wrong type: 0x%02x in attr_rsp", type);
+    return SDP_DB_FULL;
+  }
+
+  /* See if there is enough space in the database */
+  if (p_db->mem_free < sizeof(tSDP_DISC_REC)) {
+    SDP_TRACE_WARNING("SDP - DB full add_record");
+    return SDP_DB_FULL;
+  }
+
+  p_rec = (tSDP_DISC_REC*)p_db->p_free_mem;
+  p_db->p_free_mem += sizeof(tSDP_DISC_REC);
+  p_db->mem_free -= sizeof(tSDP_DISC_REC);
+
+  p_rec->p_first_attr = NULL;
+  p_rec->p_next_rec = NULL;
+  p_rec->remote_bd_addr = p_parser->bd_addr;
+
+  /* Add the record to the end of chain */
+  if (p_parser->p_last_rec)
+    p_parser->p_last_rec->p_next_rec = p_rec;
+  else
+    p_db->p_first_rec = p_rec;
+  p_parser->p_last_rec = p_rec;
+  p_parser->p_rec = p_rec;
+
+  sdp_disc_parse_push(p_parser, SDP_DISC_LEVEL_RECORD, p_parser->offset + len,
+                      NULL, 0);
+  return sdp_disc_parse_pop(p_parser);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_attr
+ *
+ * Description      Allocates space for an attribute from the database, and
+ *                  starts parsing its value.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+static uint16_t sdp_disc_parse_attr(tSDP_DISC_PARSER* p_parser, uint8_t type,
+                                    uint32_t len, uint16_t attr_id,
+                                    uint8_t nest_level) {
+  tSDP_DISCOVERY_DB* p_db = p_parser->p_db;
+  tSDP_DISC_ATTR* p_attr;
+  uint32_t total_len;
+  uint16_t attr_type = (type >> 3) & 0x0f;
+  uint8_t is_additional_list = nest_level & SDP_ADDITIONAL_LIST_MASK;
+  uint8_t sink = SDP_DISC_SINK_DECODE;
+
+  nest_level &= ~(SDP_ADDITIONAL_LIST_MASK);
+
+  if (len > SDP_DISC_ATTR_LEN_MASK) {
+    SDP_TRACE_WARNING("SDP - attr too long: %d in attr_rsp", len);
+    return SDP_DB_FULL;
+  }
+
+  /* See if there is enough space in the database */
+  if (len > 4)
+    total_len = len - 4 + (uint16_t)sizeof(tSDP_DISC_ATTR);
+  else
+    total_len = sizeof(tSDP_DISC_ATTR);
+
+  /* Ensure it is a multiple of 4 */
+  total_len = (total_len + 3) & ~3;
+
+  if (p_db->mem_free < total_len) return SDP_DB_FULL;
+
+  p_attr = (tSDP_DISC_ATTR*)p_db->p_free_mem;
+  p_attr->attr_id = attr_id;
+  p_attr->attr_len_type = (uint16_t)len | (attr_type << 12);
+  p_attr->p_next_attr = NULL;
+
+  switch (attr_type) {
+    case UINT_DESC_TYPE:
+    case TWO_COMP_INT_DESC_TYPE:
+      if (len != 1 && len != 2 && len != 4) sink = SDP_DISC_SINK_ARRAY;
+      break;
+
+    case UUID_DESC_TYPE:
+      if (len != 2 && len != 4 && len != 16) {
+        SDP_TRACE_WARNING("SDP - bad len in UUID attr: %d", len);
+        return sdp_disc_parse_value(p_parser, SDP_DISC_SINK_SKIP, NULL, len);
+      }
+      break;
+
+    case BOOLEAN_DESC_TYPE:
+      if (len != 1) {
+        SDP_TRACE_WARNING("SDP - bad len in boolean attr: %d", len);
+        return sdp_disc_parse_value(p_parser, SDP_DISC_SINK_SKIP, NULL, len);
+      }
+      break;
+
+    case TEXT_STR_DESC_TYPE:
+    case URL_DESC_TYPE:
+      sink = SDP_DISC_SINK_ARRAY;
+      break;
+
+    case DATA_ELE_SEQ_DESC_TYPE:
+    case DATA_ELE_ALT_DESC_TYPE:
+      /* Only the attribute itself, the sub-attributes follow it */
+      p_db->p_free_mem += sizeof(tSDP_DISC_ATTR);
+      p_db->mem_free -= sizeof(tSDP_DISC_ATTR);
+
+      if (nest_level >= SDP_MAX_NEST_LEVELS) {
+        SDP_TRACE_ERROR("SDP - attr nesting too deep");
+        return sdp_disc_parse_value(p_parser, SDP_DISC_SINK_SKIP, NULL, len);
+      }
+      if (is_additional_list != 0 ||
+          attr_id == ATTR_ID_ADDITION_PROTO_DESC_LISTS)
+        nest_level |= SDP_ADDITIONAL_LIST_MASK;
+
+      p_attr->attr_value.v.p_sub_attr = NULL;
+      sdp_disc_parse_link(p_parser, p_attr);
+      sdp_disc_parse_push(p_parser, SDP_DISC_LEVEL_VALUE,
+                          p_parser->offset + len, p_attr,
+                          (uint8_t)(nest_level + 1));
+      return sdp_disc_parse_pop(p_parser);
+
+    default:
+      sink = SDP_DISC_SINK_SKIP;
+      break;
+  }
+
+  p_db->p_free_mem += total_len;
+  p_db->mem_free -= total_len;
+
+  p_parser->nest_level = nest_level | is_additional_list;
+  return sdp_disc_parse_value(p_parser, sink, p_attr, len);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_element
+ *
+ * Description      Handles a complete data element header, depending on the
+ *                  data element the parser is in.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+static uint16_t sdp_disc_parse_element(tSDP_DISC_PARSER* p_parser) {
+  uint8_t type = p_parser->hdr[0];
+  uint32_t len = sdp_disc_parse_value_len(p_parser->hdr);
+  tSDP_DISC_PARSE_LEVEL* p_level;
+
+  p_parser->hdr_len = 0;
+  p_parser->state = SDP_DISC_PARSE_HDR;
+
+  /* The null type has no value */
+  if ((type >> 3) == NULL_DESC_TYPE) len = 0;
+
+  if (p_parser->depth == 0) {
+    if (p_parser->mode == SDP_DISC_PARSE_RECORD)
+      return sdp_disc_parse_record(p_parser, type, len);
+
+    /* The contents is a sequence of attribute sequences */
+    if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
+      SDP_TRACE_WARNING("SDP - Wrong type: 0x%02x in attr_rsp", type);
+      return SDP_ILLEGAL_PARAMETER;
+    }
+    sdp_disc_parse_push(p_parser, SDP_DISC_LEVEL_LIST, p_parser->offset + len,
+                        NULL, 0);
+    return sdp_disc_parse_pop(p_parser);
+  }
+
+  p_level = &p_parser->levels[p_parser->depth - 1];
+  if (p_parser->offset > p_level->end ||
+      len > p_level->end - p_parser->offset) {
+    SDP_TRACE_WARNING("%s: Bad len in attr_rsp %d", __func__, len);
+    return SDP_DB_FULL;
+  }
+
+  switch (p_level->kind) {
+    case SDP_DISC_LEVEL_LIST:
+      return sdp_disc_parse_record(p_parser, type, len);
+
+    case SDP_DISC_LEVEL_RECORD:
+      if (p_level->num_elems & 1)
+        return sdp_disc_parse_attr(p_parser, type, len, p_parser->attr_id, 0);
+
+      /* First get the attribute ID */
+      if (((type >> 3) != UINT_DESC_TYPE) || (len != 2)) {
+        SDP_TRACE_WARNING("SDP - Bad type: 0x%02x or len: %d in attr_rsp",
+                          type, len);
+        return SDP_DB_FULL;
+      }
+      return sdp_disc_parse_value(p_parser, SDP_DISC_SINK_ATTR_ID, NULL, len);
+
+    case SDP_DISC_LEVEL_PROTO:
+      return sdp_disc_parse_attr(p_parser, type, len,
+                                 ATTR_ID_PROTOCOL_DESC_LIST,
+                                 p_level->nest_level);
+
+    default:
+      return sdp_disc_parse_attr(p_parser, type, len, 0, p_level->nest_level);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_decode
+ *
+ * Description      Stores a complete fixed size value into its attribute.
+ *
+ * Returns          true if the value is followed by a protocol list
+ *
+ ******************************************************************************/
+static bool sdp_disc_parse_decode(tSDP_DISC_PARSER* p_parser,
+                                  tSDP_DISC_ATTR* p_attr) {
+  uint8_t* p = p_parser->value;
+  uint16_t attr_type = SDP_DISC_ATTR_TYPE(p_attr->attr_len_type);
+  uint16_t attr_len = SDP_DISC_ATTR_LEN(p_attr->attr_len_type);
+  uint16_t id;
+
+  switch (attr_type) {
+    case UINT_DESC_TYPE:
+      if ((p_parser->nest_level & SDP_ADDITIONAL_LIST_MASK) && attr_len == 2) {
+        BE_STREAM_TO_UINT16(id, p);
+        if (id == ATTR_ID_PROTOCOL_DESC_LIST) return true;
+        p -= 2;
+      }
+      FALLTHROUGH_INTENDED; /* FALLTHROUGH */
+
+    case TWO_COMP_INT_DESC_TYPE:
+      switch (attr_len) {
+        case 1:
+          p_attr->attr_value.v.u8 = *p;
+          break;
+        case 2:
+          BE_STREAM_TO_UINT16(p_attr->attr_value.v.u16, p);
+          break;
+        default:
+          BE_STREAM_TO_UINT32(p_attr->attr_value.v.u32, p);
+          break;
+      }
+      break;
+
+    case UUID_DESC_TYPE:
+      switch (attr_len) {
+        case 2:
+          BE_STREAM_TO_UINT16(p_attr->attr_value.v.u16, p);
+          break;
+        case 4:
+          BE_STREAM_TO_UINT32(p_attr->attr_value.v.u32, p);
+          if (p_attr->attr_value.v.u32 < 0x10000) {
+            p_attr->attr_len_type = 2 | (attr_type << 12);
+            p_attr->attr_value.v.u16 = (uint16_t)p_attr->attr_value.v.u32;
+          }
+          break;
+        default: {
+          /* See if we can compress his UUID down to 16 or 32bit UUIDs */
+          Uuid uuid = Uuid::From128BitBE(p);
+          switch (uuid.GetShortestRepresentationSize()) {
+            case Uuid::kNumBytes16:
+              p_attr->attr_len_type = 2 | (attr_type << 12);
+              p_attr->attr_value.v.u16 = uuid.As16Bit();
+              break;
+            case Uuid::kNumBytes32:
+              p_attr->attr_len_type = 4 | (attr_type << 12);
+              p_attr->attr_value.v.u32 = uuid.As32Bit();
+              break;
+            default:
+              memcpy(p_attr->attr_value.v.array, p, Uuid::kNumBytes128);
+              break;
+          }
+          break;
+        }
+      }
+      break;
+
+    case BOOLEAN_DESC_TYPE:
+      p_attr->attr_value.v.u8 = *p;
+      break;
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_value_done
+ *
+ * Description      Handles a complete data element value.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+static uint16_t sdp_disc_parse_value_done(tSDP_DISC_PARSER* p_parser) {
+  tSDP_DISC_ATTR* p_attr = p_parser->p_attr;
+  uint8_t* p = p_parser->value;
+  uint8_t nest_level;
+
+  p_parser->state = SDP_DISC_PARSE_HDR;
+  p_parser->p_attr = NULL;
+
+  switch (p_parser->sink) {
+    case SDP_DISC_SINK_ATTR_ID:
+      BE_STREAM_TO_UINT16(p_parser->attr_id, p);
+      break;
+
+    case SDP_DISC_SINK_DECODE:
+      if (!sdp_disc_parse_decode(p_parser, p_attr)) break;
+
+      /* In an additional protocol list, the ID of the protocol list is
+       * followed by the list itself, saved as a sub-attribute */
+      nest_level = p_parser->nest_level & ~(SDP_ADDITIONAL_LIST_MASK);
+      if (nest_level >= SDP_MAX_NEST_LEVELS) {
+        SDP_TRACE_ERROR("SDP - attr nesting too deep");
+        p_attr = NULL;
+        break;
+      }
+      p_attr->attr_value.v.p_sub_attr = NULL;
+      sdp_disc_parse_link(p_parser, p_attr);
+      sdp_disc_parse_push(p_parser, SDP_DISC_LEVEL_PROTO,
+                          p_parser->levels[p_parser->depth - 1].end, p_attr,
+                          (uint8_t)(nest_level + 1));
+      return sdp_disc_parse_pop(p_parser);
+  }
+
+  if (p_attr != NULL) sdp_disc_parse_link(p_parser, p_attr);
+
+  p_parser->levels[p_parser->depth - 1].num_elems++;
+  return sdp_disc_parse_pop(p_parser);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_start
+ *
+ * Description      Prepares the parser for a new response, whose records are
+ *                  added after the ones already in the database.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_disc_parse_start(tSDP_DISC_PARSER* p_parser, tSDP_DISCOVERY_DB* p_db,
+                          const RawAddress& bd_addr, uint8_t mode) {
+  p_parser->p_db = p_db;
+  p_parser->bd_addr = bd_addr;
+  p_parser->p_rec = NULL;
+  p_parser->p_last_rec = p_db->p_first_rec;
+  if (p_parser->p_last_rec) {
+    while (p_parser->p_last_rec->p_next_rec)
+      p_parser->p_last_rec = p_parser->p_last_rec->p_next_rec;
+  }
+  p_parser->p_attr = NULL;
+  p_parser->offset = 0;
+  p_parser->rsp_len = 0;
+  p_parser->mode = mode;
+  p_parser->state = SDP_DISC_PARSE_HDR;
+  p_parser->hdr_len = 0;
+  p_parser->depth = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_data
+ *
+ * Description      Parses the next fragment of the response, and saves what
+ *                  it completes in the database. The fragments of a
+ *                  response add up to SDP_MAX_DISC_RSP_BYTE_COUNT bytes at
+ *                  most, so a peer can't keep a discovery going forever.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+uint16_t sdp_disc_parse_data(tSDP_DISC_PARSER* p_parser, uint8_t* p,
+                             uint16_t len) {
+  uint8_t* p_end = p + len;
+  uint16_t status = SDP_SUCCESS;
+
+  if (len > SDP_MAX_DISC_RSP_BYTE_COUNT - p_parser->rsp_len) {
+    SDP_TRACE_WARNING("SDP - response longer than %d bytes",
+                      SDP_MAX_DISC_RSP_BYTE_COUNT);
+    return SDP_INVALID_PDU_SIZE;
+  }
+  p_parser->rsp_len += len;
+#if (SDP_RAW_DATA_INCLUDED == TRUE)
+  tSDP_DISCOVERY_DB* p_db = p_parser->p_db;
+  /* The raw data holds the attribute lists, without the list around them */
+  uint8_t* p_raw = NULL;
+  if (p_parser->mode == SDP_DISC_PARSE_RECORD || p_parser->depth > 0) p_raw = p;
+#endif
+
+  while (p < p_end && status == SDP_SUCCESS) {
+    switch (p_parser->state) {
+      case SDP_DISC_PARSE_HDR:
+        p_parser->hdr[p_parser->hdr_len++] = *p++;
+        p_parser->offset++;
+        if (p_parser->hdr_len < sdp_disc_parse_hdr_len(p_parser->hdr[0]))
+          break;
+
+        status = sdp_disc_parse_element(p_parser);
+#if (SDP_RAW_DATA_INCLUDED == TRUE)
+        if (p_raw == NULL && p_parser->depth > 0) p_raw = p;
+#endif
+        break;
+
+      case SDP_DISC_PARSE_VALUE: {
+        uint32_t rem_len = p_parser->value_len - p_parser->value_used;
+        uint32_t cpy_len = (uint32_t)(p_end - p);
+        if (cpy_len > rem_len) cpy_len = rem_len;
+
+        if (p_parser->sink == SDP_DISC_SINK_ARRAY) {
+          memcpy(&p_parser->p_attr->attr_value.v.array[p_parser->value_used],
+                 p, cpy_len);
+        } else if (p_parser->sink != SDP_DISC_SINK_SKIP) {
+          memcpy(&p_parser->value[p_parser->value_used], p, cpy_len);
+        }
+        p += cpy_len;
+        p_parser->offset += cpy_len;
+        p_parser->value_used += cpy_len;
+
+        if (p_parser->value_used == p_parser->value_len)
+          status = sdp_disc_parse_value_done(p_parser);
+        break;
+      }
+
+      default:
+        /* Only the attribute list of a record is expected in a response
+         * to a service attribute request, ignore what follows it */
+        if (p_parser->mode == SDP_DISC_PARSE_RECORD) {
+          p = p_end;
+          break;
+        }
+        SDP_TRACE_WARNING("SDP - data after the attribute lists");
+        status = SDP_INVALID_CONT_STATE;
+        break;
+    }
+  }
+
+#if (SDP_RAW_DATA_INCLUDED == TRUE)
+  if (p_db->raw_data && p_raw != NULL) {
+    uint32_t cpy_len = (uint32_t)(p - p_raw);
+    if (cpy_len > p_db->raw_size - p_db->raw_used) {
+      SDP_TRACE_WARNING("raw data full, %d bytes dropped",
+                        cpy_len - (p_db->raw_size - p_db->raw_used));
+      cpy_len = p_db->raw_size - p_db->raw_used;
+    }
+    memcpy(&p_db->raw_data[p_db->raw_used], p_raw, cpy_len);
+    p_db->raw_used += cpy_len;
+  }
+#endif
+
+  return status;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_parse_end
+ *
+ * Description      Checks that the last fragment completed the response.
+ *
+ * Returns          SDP_SUCCESS, or the error to report
+ *
+ ******************************************************************************/
+uint16_t sdp_disc_parse_end(tSDP_DISC_PARSER* p_parser) {
+  if (p_parser->state == SDP_DISC_PARSE_DONE) return SDP_SUCCESS;
+
+  SDP_TRACE_WARNING("SDP - attr_rsp ended in the middle of a data element");
+  if (p_parser->mode == SDP_DISC_PARSE_RECORD) return SDP_DB_FULL;
+  return SDP_INVALID_CONT_STATE;
+}
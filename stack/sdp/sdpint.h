@@ -59,6 +59,9 @@
 #define MAX_ATTR_LEN 256
 #endif
 
+/* Max nesting of the attribute values saved in a discovery database */
+#define SDP_MAX_NEST_LEVELS 5
+
 /* Internal UUID sequence representation */
 typedef struct {
   uint16_t len;
@@ -121,6 +124,50 @@ typedef struct {
 } tSDP_CONT_INFO;
 #endif /* SDP_SERVER_ENABLED == TRUE */
 
+/* Parsing modes of the discovery responses */
+#define SDP_DISC_PARSE_LIST 0   /* List of attribute lists, one per record */
+#define SDP_DISC_PARSE_RECORD 1 /* Attribute list of a single record */
+
+/* Data element the discovery response parser is inside of: the list of
+ * attribute lists, the attribute list of a record, or an attribute value */
+typedef struct {
+  uint32_t end;                /* Response offset of the end of the element */
+  tSDP_DISC_ATTR* p_attr;      /* Attribute holding the element value */
+  tSDP_DISC_ATTR* p_last_attr; /* Last attribute added in the element */
+  uint16_t num_elems;          /* Number of data elements parsed in it */
+  uint8_t kind;
+  uint8_t nest_level; /* Nest level of the attributes it contains */
+} tSDP_DISC_PARSE_LEVEL;
+
+/* The list of attribute lists, an attribute list, and the nested values */
+#define SDP_DISC_PARSE_MAX_DEPTH (SDP_MAX_NEST_LEVELS + 2)
+
+/* Parser of the attribute lists of the discovery responses. The response
+ * is parsed as its continuation fragments arrive, and saved directly in the
+ * discovery database: only a data element header or a short value split
+ * between two fragments is buffered. */
+typedef struct {
+  tSDP_DISCOVERY_DB* p_db;
+  RawAddress bd_addr;
+  tSDP_DISC_REC* p_rec;      /* Record being parsed */
+  tSDP_DISC_REC* p_last_rec; /* Last record of the database */
+  tSDP_DISC_ATTR* p_attr;    /* Attribute the value is parsed into */
+  uint32_t offset;           /* Bytes of the response parsed */
+  uint32_t rsp_len;          /* Bytes of the response received */
+  uint32_t value_len;        /* Length of the value being parsed */
+  uint32_t value_used;       /* Bytes of the value already parsed */
+  uint16_t attr_id;          /* ID of the attribute to parse next */
+  uint8_t mode;
+  uint8_t state;
+  uint8_t sink;       /* Where the value bytes go */
+  uint8_t nest_level; /* Nest level of the value being parsed */
+  uint8_t hdr[5];     /* Data element header being parsed */
+  uint8_t hdr_len;
+  uint8_t value[16]; /* Value decoded once complete, e.g. a 128-bit UUID */
+  uint8_t depth;
+  tSDP_DISC_PARSE_LEVEL levels[SDP_DISC_PARSE_MAX_DEPTH];
+} tSDP_DISC_PARSER;
+
 /* Define the SDP Connection Control Block */
 typedef struct {
 #define SDP_STATE_IDLE 0
@@ -138,10 +185,11 @@ typedef struct {
   alarm_t* sdp_conn_timer;
   uint16_t rem_mtu_size;
   uint16_t connection_id;
-  uint16_t list_len; /* length of the response in the GKI buffer */
-  uint8_t* rsp_list; /* pointer to GKI buffer holding response */
+  uint16_t list_len; /* length of the server response in rsp_list */
+  uint8_t* rsp_list; /* server response sent in continuation fragments */
 
-  tSDP_DISCOVERY_DB* p_db; /* Database to save info into   */
+  tSDP_DISCOVERY_DB* p_db;     /* Database to save info into   */
+  tSDP_DISC_PARSER rsp_parser; /* Parser of the discovery responses */
   tSDP_DISC_CMPL_CB* p_cb; /* Callback for discovery done  */
   tSDP_DISC_CMPL_CB2*
       p_cb2; /* Callback for discovery done piggy back with the user data */
@@ -259,4 +307,13 @@ extern void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
 extern void sdp_disc_connected(tCONN_CB* p_ccb);
 extern void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
 
+/* Functions provided by sdp_discovery_parser.cc
+ */
+extern void sdp_disc_parse_start(tSDP_DISC_PARSER* p_parser,
+                                 tSDP_DISCOVERY_DB* p_db,
+                                 const RawAddress& bd_addr, uint8_t mode);
+extern uint16_t sdp_disc_parse_data(tSDP_DISC_PARSER* p_parser, uint8_t* p,
+                                    uint16_t len);
+extern uint16_t sdp_disc_parse_end(tSDP_DISC_PARSER* p_parser);
+
 #endif
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "stack/include/a2dp_resampler.h"
+
+namespace {
+
+constexpr double kAmplitude = 16384.0;  // -6 dBFS
+
+std::vector<int16_t> make_tone(uint32_t rate, double frequency,
+                               uint8_t channel_count, size_t frames) {
+  std::vector<int16_t> pcm(frames * channel_count);
+  for (size_t i = 0; i < frames; i++) {
+    double sample = kAmplitude * sin(2.0 * M_PI * frequency * i / rate);
+    for (uint8_t ch = 0; ch < channel_count; ch++) {
+      pcm[i * channel_count + ch] = static_cast<int16_t>(lround(sample));
+    }
+  }
+  return pcm;
+}
+
+std::vector<int16_t> convert(A2dpResampler* resampler,
+                             const std::vector<int16_t>& src,
+                             size_t chunk_frames) {
+  uint8_t channel_count = resampler->channelCount();
+  size_t src_frames = src.size() / channel_count;
+  std::vector<int16_t> dst;
+  for (size_t offset = 0; offset < src_frames; offset += chunk_frames) {
+    size_t frames = std::min(chunk_frames, src_frames - offset);
+    std::vector<int16_t> out(resampler->maxOutputFrames(frames) *
+                             channel_count);
+    size_t written =
+        resampler->resample(&src[offset * channel_count], frames, out.data(),
+                            resampler->maxOutputFrames(frames));
+    dst.insert(dst.end(), out.begin(), out.begin() + written * channel_count);
+  }
+  return dst;
+}
+
+// Fits a sine of |frequency| to the samples of |channel| past the filter
+// delay, and returns the power ratio of the sine to the residual (THD+N), in
+// dB.
+double signal_to_noise_db(const std::vector<int16_t>& pcm, uint32_t rate,
+                          double frequency, uint8_t channel_count,
+                          uint8_t channel, size_t skip_frames) {
+  // Least squares fit of a * sin + b * cos + c
+  double m[3][3] = {};
+  double v[3] = {};
+  size_t frames = pcm.size() / channel_count;
+  for (size_t i = skip_frames; i < frames; i++) {
+    double w = 2.0 * M_PI * frequency * i / rate;
+    double basis[3] = {sin(w), cos(w), 1.0};
+    double y = pcm[i * channel_count + channel];
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) m[r][c] += basis[r] * basis[c];
+      v[r] += basis[r] * y;
+    }
+  }
+  // Gaussian elimination
+  for (int p = 0; p < 3; p++) {
+    for (int r = p + 1; r < 3; r++) {
+      double f = m[r][p] / m[p][p];
+      for (int c = p; c < 3; c++) m[r][c] -= f * m[p][c];
+      v[r] -= f * v[p];
+    }
+  }
+  double x[3];
+  for (int r = 2; r >= 0; r--) {
+    x[r] = v[r];
+    for (int c = r + 1; c < 3; c++) x[r] -= m[r][c] * x[c];
+    x[r] /= m[r][r];
+  }
+
+  double signal = 0;
+  double noise = 0;
+  for (size_t i = skip_frames; i < frames; i++) {
+    double w = 2.0 * M_PI * frequency * i / rate;
+    double fit = x[0] * sin(w) + x[1] * cos(w) + x[2];
+    double error = pcm[i * channel_count + channel] - fit;
+    signal += (fit - x[2]) * (fit - x[2]);
+    noise += error * error;
+  }
+  return 10.0 * log10(signal / noise);
+}
+
+double rms_db(const std::vector<int16_t>& pcm, size_t skip_samples) {
+  double power = 0;
+  for (size_t i = skip_samples; i < pcm.size(); i++) power += pcm[i] * pcm[i];
+  power /= (pcm.size() - skip_samples);
+  return 10.0 * log10(power / (kAmplitude * kAmplitude / 2.0));
+}
+
+struct ConversionParams {
+  uint32_t src_rate;
+  uint32_t dst_rate;
+  uint8_t channel_count;
+  A2dpResampler::Quality quality;
+  double min_snr_db;
+};
+
+}  // namespace
+
+class A2dpResamplerQualityTest
+    : public ::testing::TestWithParam<ConversionParams> {};
+
+TEST_P(A2dpResamplerQualityTest, tone_signal_to_noise) {
+  const ConversionParams& params = GetParam();
+  auto resampler =
+      A2dpResampler::create(params.src_rate, params.dst_rate,
+                            params.channel_count, params.quality);
+  ASSERT_NE(resampler, nullptr);
+
+  const double kFrequency = 997.0;
+  size_t src_frames = params.src_rate / 2;
+  auto src = make_tone(params.src_rate, kFrequency, params.channel_count,
+                       src_frames);
+  // 20 ms chunks, as read by the encoders
+  auto dst = convert(resampler.get(), src, params.src_rate / 50);
+
+  size_t dst_frames = dst.size() / params.channel_count;
+  size_t expected_frames =
+      (uint64_t)src_frames * params.dst_rate / params.src_rate;
+  EXPECT_NEAR(dst_frames, expected_frames, 1);
+
+  // Skips the filter start up
+  size_t skip_frames = 2 * resampler->delayFrames() * params.dst_rate /
+                           params.src_rate +
+                       1;
+  for (uint8_t ch = 0; ch < params.channel_count; ch++) {
+    double snr = signal_to_noise_db(dst, params.dst_rate, kFrequency,
+                                    params.channel_count, ch, skip_frames);
+    EXPECT_GT(snr, params.min_snr_db)
+        << params.src_rate << " -> " << params.dst_rate << " channel " << +ch;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    Conversions, A2dpResamplerQualityTest,
+    ::testing::Values(
+        ConversionParams{44100, 48000, 2, A2dpResampler::kQualityLow, 55.0},
+        ConversionParams{44100, 48000, 2, A2dpResampler::kQualityMedium, 80.0},
+        ConversionParams{44100, 48000, 2, A2dpResampler::kQualityHigh, 85.0},
+        ConversionParams{48000, 44100, 2, A2dpResampler::kQualityHigh, 85.0},
+        ConversionParams{32000, 44100, 1, A2dpResampler::kQualityHigh, 85.0},
+        ConversionParams{16000, 48000, 2, A2dpResampler::kQualityMedium, 80.0},
+        ConversionParams{48000, 16000, 1, A2dpResampler::kQualityMedium,
+                         80.0}));
+
+TEST(A2dpResamplerTest, unsupported_parameters) {
+  EXPECT_EQ(A2dpResampler::create(0, 48000, 2, A2dpResampler::kQualityLow),
+            nullptr);
+  EXPECT_EQ(A2dpResampler::create(44100, 48000, 0, A2dpResampler::kQualityLow),
+            nullptr);
+  EXPECT_EQ(A2dpResampler::create(44100, 48000, 3, A2dpResampler::kQualityLow),
+            nullptr);
+  // 44101 phases
+  EXPECT_EQ(
+      A2dpResampler::create(44100, 44101, 2, A2dpResampler::kQualityLow),
+      nullptr);
+}
+
+TEST(A2dpResamplerTest, output_does_not_depend_on_chunking) {
+  auto src = make_tone(44100, 997.0, 2, 4410);
+  auto resampler =
+      A2dpResampler::create(44100, 48000, 2, A2dpResampler::kQualityMedium);
+  ASSERT_NE(resampler, nullptr);
+  auto whole = convert(resampler.get(), src, src.size() / 2);
+  resampler->reset();
+  auto chunked = convert(resampler.get(), src, 77);
+  EXPECT_EQ(whole, chunked);
+}
+
+TEST(A2dpResamplerTest, rejects_aliased_tones) {
+  // 23 kHz is above the Nyquist frequency of the 44.1 kHz output
+  auto src = make_tone(48000, 23000.0, 1, 24000);
+  auto resampler =
+      A2dpResampler::create(48000, 44100, 1, A2dpResampler::kQualityHigh);
+  ASSERT_NE(resampler, nullptr);
+  auto dst = convert(resampler.get(), src, 960);
+  EXPECT_LT(rms_db(dst, 2 * resampler->delayFrames()), -80.0);
+}
+
+TEST(A2dpResamplerTest, same_rate_passes_dc) {
+  std::vector<int16_t> src(2000, 1000);
+  auto resampler =
+      A2dpResampler::create(48000, 48000, 1, A2dpResampler::kQualityLow);
+  ASSERT_NE(resampler, nullptr);
+  auto dst = convert(resampler.get(), src, 480);
+  ASSERT_EQ(dst.size(), src.size());
+  for (size_t i = 2 * resampler->delayFrames(); i < dst.size(); i++) {
+    EXPECT_NEAR(dst[i], 1000, 1);
+  }
+}
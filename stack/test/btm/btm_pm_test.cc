@@ -0,0 +1,411 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <deque>
+#include <vector>
+
+#include "bt_target.h"
+#include "btm_api.h"
+#include "btm_int.h"
+#include "btm_int_types.h"
+#include "common/time_util.h"
+#include "device/include/interop.h"
+#include "hcidefs.h"
+#include "hcimsgs.h"
+#include "l2c_int.h"
+
+tBTM_CB btm_cb;
+
+namespace {
+
+constexpr int kNumLinks = 7;
+constexpr uint16_t kSniffMax = 800;
+constexpr uint16_t kSniffMin = 400;
+
+uint64_t now_ms;
+alarm_callback_t pm_timer_cb;
+uint64_t pm_timer_deadline_ms;
+
+// A controller answering the mode commands of the power manager: a command
+// status for every command, then a mode change event once the link switched
+// to the new mode
+class FakeController {
+ public:
+  struct Command {
+    uint16_t handle;
+    uint8_t mode;
+    uint16_t interval;
+  };
+
+  void Reset() {
+    pending_status_.clear();
+    pending_mode_change_.clear();
+    commands_sent_ = 0;
+    max_in_flight_ = 0;
+    reject_next_ = false;
+  }
+
+  void Send(uint16_t handle, uint8_t mode, uint16_t interval) {
+    for (const Command& cmd : pending_status_) {
+      // A link never gets a second command before the first one is answered
+      EXPECT_NE(cmd.handle, handle);
+    }
+    pending_status_.push_back({handle, mode, interval});
+    commands_sent_++;
+    max_in_flight_ =
+        std::max(max_in_flight_, static_cast<int>(pending_status_.size()));
+  }
+
+  // Answers the commands sent so far with command status events
+  void SendCommandStatus() {
+    while (!pending_status_.empty()) {
+      Command cmd = pending_status_.front();
+      pending_status_.pop_front();
+      if (reject_next_) {
+        reject_next_ = false;
+        btm_pm_proc_cmd_status(HCI_ERR_COMMAND_DISALLOWED, cmd.handle);
+        continue;
+      }
+      pending_mode_change_.push_back(cmd);
+      btm_pm_proc_cmd_status(HCI_SUCCESS, cmd.handle);
+    }
+  }
+
+  // Completes the mode changes of the links
+  void SendModeChanges() {
+    while (!pending_mode_change_.empty()) {
+      Command cmd = pending_mode_change_.front();
+      pending_mode_change_.pop_front();
+      btm_pm_proc_mode_change(HCI_SUCCESS, cmd.handle, cmd.mode, cmd.interval);
+    }
+  }
+
+  // Runs until the controller has nothing left to answer
+  void Settle() {
+    while (!pending_status_.empty() || !pending_mode_change_.empty()) {
+      SendCommandStatus();
+      SendModeChanges();
+    }
+  }
+
+  // The remote device wakes the link up by itself
+  void RemoteWake(uint16_t handle) {
+    btm_pm_proc_mode_change(HCI_SUCCESS, handle, HCI_MODE_ACTIVE, 0);
+  }
+
+  size_t pending_status() const { return pending_status_.size(); }
+  int commands_sent() const { return commands_sent_; }
+  int max_in_flight() const { return max_in_flight_; }
+  void RejectNext() { reject_next_ = true; }
+
+ private:
+  std::deque<Command> pending_status_;
+  std::deque<Command> pending_mode_change_;
+  int commands_sent_;
+  int max_in_flight_;
+  bool reject_next_;
+};
+
+FakeController controller;
+
+}  // namespace
+
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace bluetooth {
+namespace common {
+uint64_t time_get_os_boottime_ms() { return now_ms; }
+}  // namespace common
+}  // namespace bluetooth
+
+void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
+                        alarm_callback_t cb, void* data) {
+  pm_timer_cb = cb;
+  pm_timer_deadline_ms = now_ms + interval_ms;
+}
+void alarm_cancel(alarm_t* alarm) { pm_timer_cb = nullptr; }
+
+bool interop_match_addr(const interop_feature_t feature,
+                        const RawAddress* addr) {
+  return false;
+}
+uint8_t* BTM_ReadLocalFeatures(void) {
+  static uint8_t features[HCI_FEATURE_BYTES_PER_PAGE] = {0xff, 0xff, 0xff};
+  return features;
+}
+uint8_t btm_handle_to_acl_index(uint16_t hci_handle) {
+  uint8_t xx;
+  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++) {
+    if (btm_cb.acl_db[xx].in_use && btm_cb.acl_db[xx].hci_handle == hci_handle)
+      break;
+  }
+  return xx;
+}
+
+void btsnd_hcic_sniff_mode(uint16_t handle, uint16_t max_sniff_period,
+                           uint16_t min_sniff_period, uint16_t sniff_attempt,
+                           uint16_t sniff_timeout) {
+  controller.Send(handle, HCI_MODE_SNIFF, max_sniff_period);
+}
+void btsnd_hcic_exit_sniff_mode(uint16_t handle) {
+  controller.Send(handle, HCI_MODE_ACTIVE, 0);
+}
+void btsnd_hcic_park_mode(uint16_t handle, uint16_t beacon_max,
+                          uint16_t beacon_min) {
+  controller.Send(handle, HCI_MODE_PARK, beacon_max);
+}
+void btsnd_hcic_exit_park_mode(uint16_t handle) {
+  controller.Send(handle, HCI_MODE_ACTIVE, 0);
+}
+void btsnd_hcic_hold_mode(uint16_t handle, uint16_t max_hold_period,
+                          uint16_t min_hold_period) {
+  controller.Send(handle, HCI_MODE_HOLD, max_hold_period);
+}
+void btsnd_hcic_sniff_sub_rate(uint16_t handle, uint16_t max_lat,
+                               uint16_t min_remote_lat,
+                               uint16_t min_local_lat) {}
+
+tL2C_LCB* l2cu_find_lcb_by_bd_addr(const RawAddress& p_bd_addr,
+                                   tBT_TRANSPORT transport) {
+  return nullptr;
+}
+void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, tL2C_CCB* p_ccb, BT_HDR* p_buf) {
+}
+void btm_sco_disc_chk_pend_for_modechange(uint16_t hci_handle) {}
+tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) { return nullptr; }
+void btm_cont_rswitch(tACL_CONN* p, tBTM_SEC_DEV_REC* p_dev_rec,
+                      uint8_t hci_status) {}
+uint16_t BTM_GetNumAclLinks(void) { return 0; }
+tBTM_BLE_CONN_ST btm_ble_get_conn_st(void) { return BLE_CONN_IDLE; }
+bool fixed_queue_is_empty(fixed_queue_t* queue) { return true; }
+
+class BtmPmTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(&btm_cb, 0, sizeof(btm_cb));
+    now_ms = 100000;
+    pm_timer_cb = nullptr;
+    controller.Reset();
+    btm_pm_reset();
+
+    ASSERT_EQ(BTM_PmRegister(BTM_PM_REG_SET, &pm_id_, nullptr), BTM_SUCCESS);
+    for (int i = 0; i < kNumLinks; i++) Connect(i);
+  }
+
+  void Connect(int i) {
+    tACL_CONN* p = &btm_cb.acl_db[i];
+    p->in_use = true;
+    p->hci_handle = 0x40 + i;
+    p->transport = BT_TRANSPORT_BR_EDR;
+    p->remote_addr = Address(i);
+    btm_pm_sm_alloc(i);
+  }
+
+  static RawAddress Address(int i) {
+    RawAddress addr = RawAddress::kAny;
+    addr.address[5] = i + 1;
+    return addr;
+  }
+
+  // Lets the time pass, running the power manager timer when it is due
+  void Advance(uint64_t duration_ms) {
+    uint64_t end_ms = now_ms + duration_ms;
+    while (pm_timer_cb != nullptr && pm_timer_deadline_ms <= end_ms) {
+      now_ms = std::max(now_ms, pm_timer_deadline_ms);
+      alarm_callback_t cb = pm_timer_cb;
+      pm_timer_cb = nullptr;
+      cb(nullptr);
+    }
+    now_ms = end_ms;
+  }
+
+  tBTM_STATUS Sniff(int i) {
+    tBTM_PM_PWR_MD pm = {kSniffMax, kSniffMin, 4, 1, BTM_PM_MD_SNIFF};
+    return BTM_SetPowerMode(pm_id_, Address(i), &pm);
+  }
+
+  tBTM_STATUS Active(int i) {
+    tBTM_PM_PWR_MD pm = {0, 0, 0, 0, BTM_PM_MD_ACTIVE};
+    return BTM_SetPowerMode(pm_id_, Address(i), &pm);
+  }
+
+  tBTM_PM_MODE Mode(int i) {
+    tBTM_PM_MODE mode;
+    EXPECT_EQ(BTM_ReadPowerMode(Address(i), &mode), BTM_SUCCESS);
+    return mode;
+  }
+
+  tBTM_PM_LINK_STATS Stats(int i) {
+    tBTM_PM_LINK_STATS stats;
+    EXPECT_EQ(BTM_PmReadLinkStats(Address(i), &stats), BTM_SUCCESS);
+    return stats;
+  }
+
+  uint8_t pm_id_;
+};
+
+TEST_F(BtmPmTest, test_links_sent_to_sniff_together) {
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS);
+
+  for (int i = 0; i < kNumLinks; i++) EXPECT_EQ(Sniff(i), BTM_CMD_STARTED);
+  EXPECT_EQ(controller.max_in_flight(),
+            std::min(kNumLinks, BTM_PM_MAX_PEND_CMDS));
+
+  controller.Settle();
+  for (int i = 0; i < kNumLinks; i++) {
+    EXPECT_EQ(Mode(i), BTM_PM_MD_SNIFF);
+    EXPECT_EQ(Stats(i).to_sniff, 1);
+    EXPECT_EQ(Stats(i).cmds_sent, 1);
+  }
+  EXPECT_EQ(controller.commands_sent(), kNumLinks);
+}
+
+TEST_F(BtmPmTest, test_sniff_held_back_after_wake_up) {
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS);
+  Sniff(0);
+  controller.Settle();
+  controller.RemoteWake(0x40);
+  ASSERT_EQ(Mode(0), BTM_PM_MD_ACTIVE);
+
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS / 4);
+  EXPECT_EQ(Sniff(0), BTM_CMD_STORED);
+  EXPECT_EQ(controller.pending_status(), 0u);
+  EXPECT_EQ(Stats(0).deferred, 1);
+
+  // Sent once the link has been active long enough
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS);
+  EXPECT_EQ(controller.pending_status(), 1u);
+  controller.Settle();
+  EXPECT_EQ(Mode(0), BTM_PM_MD_SNIFF);
+  EXPECT_EQ(Stats(0).to_sniff, 2);
+  EXPECT_EQ(Stats(0).to_active, 1);
+}
+
+TEST_F(BtmPmTest, test_wake_up_cancels_held_back_sniff) {
+  EXPECT_EQ(Sniff(1), BTM_CMD_STORED);
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS / 2);
+  Active(1);
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS);
+
+  EXPECT_EQ(controller.commands_sent(), 0);
+  EXPECT_EQ(Mode(1), BTM_PM_MD_ACTIVE);
+  EXPECT_EQ(Stats(1).deferred, 1);
+  EXPECT_EQ(Stats(1).flaps_avoided, 1);
+}
+
+TEST_F(BtmPmTest, test_forced_sniff_not_held_back) {
+  tBTM_PM_PWR_MD pm = {kSniffMax, kSniffMin, 4, 1,
+                       BTM_PM_MD_SNIFF | BTM_PM_MD_FORCE};
+  EXPECT_EQ(BTM_SetPowerMode(pm_id_, Address(2), &pm), BTM_CMD_STARTED);
+  controller.Settle();
+  EXPECT_EQ(Mode(2), BTM_PM_MD_SNIFF);
+  EXPECT_EQ(Stats(2).deferred, 0);
+}
+
+TEST_F(BtmPmTest, test_rejected_command) {
+  Advance(BTM_PM_SNIFF_HOLDOFF_MS);
+  controller.RejectNext();
+  Sniff(3);
+  Sniff(4);
+  controller.Settle();
+
+  EXPECT_EQ(Mode(3), BTM_PM_MD_ACTIVE);
+  EXPECT_EQ(Stats(3).cmds_failed, 1);
+  EXPECT_EQ(Mode(4), BTM_PM_MD_SNIFF);
+
+  // The link takes new requests after the failure
+  EXPECT_EQ(Sniff(3), BTM_CMD_STARTED);
+  controller.Settle();
+  EXPECT_EQ(Mode(3), BTM_PM_MD_SNIFF);
+}
+
+TEST_F(BtmPmTest, test_stats_of_unknown_link) {
+  tBTM_PM_LINK_STATS stats;
+  EXPECT_EQ(BTM_PmReadLinkStats(Address(kNumLinks), &stats), BTM_UNKNOWN_ADDR);
+}
+
+// Seven links with the traffic of different profiles: the requests of the
+// profiles go to the power manager every 10 ms, while the controller answers
+// the commands in between
+TEST_F(BtmPmTest, test_mixed_profiles) {
+  enum { A2DP, HID_KEYBOARD, HID_MOUSE, HEADSET, WATCH, PAN, SPP };
+  const uint64_t kTickMs = 10;
+  const uint64_t kDurationMs = 30000;
+
+  for (uint64_t t = 0; t < kDurationMs; t += kTickMs) {
+    // Music: streaming for 10 s, then paused
+    if (t < 10000)
+      Active(A2DP);
+    else if (t % 1000 == 0)
+      Sniff(A2DP);
+
+    // Keystrokes every 150 ms in bursts of typing, sniff as soon as idle
+    bool typing = (t / 3000) % 2 == 0;
+    if (typing && t % 150 == 0)
+      Active(HID_KEYBOARD);
+    else if (t % 150 == 50)
+      Sniff(HID_KEYBOARD);
+
+    // The mouse wakes the link up by itself, every 700 ms
+    if (t % 700 == 0 && Mode(HID_MOUSE) == BTM_PM_MD_SNIFF)
+      controller.RemoteWake(0x40 + HID_MOUSE);
+    if (t % 100 == 20) Sniff(HID_MOUSE);
+
+    // Idle links, a notification on the watch every 5 s
+    if (t % 1000 == 0) {
+      Sniff(HEADSET);
+      Sniff(SPP);
+    }
+    if (t % 5000 == 0) Active(WATCH);
+    if (t % 5000 == 100) Sniff(WATCH);
+
+    // Network traffic every 2 s
+    if (t % 2000 == 0) Active(PAN);
+    if (t % 2000 == 500) Sniff(PAN);
+
+    controller.SendCommandStatus();
+    Advance(kTickMs / 2);
+    controller.SendModeChanges();
+    Advance(kTickMs / 2);
+  }
+  Advance(2 * BTM_PM_SNIFF_HOLDOFF_MS);
+  controller.Settle();
+
+  for (int i = 0; i < kNumLinks; i++) {
+    tBTM_PM_LINK_STATS stats = Stats(i);
+    EXPECT_EQ(Mode(i), BTM_PM_MD_SNIFF) << "link " << i;
+    EXPECT_EQ(stats.cmds_failed, 0);
+
+    // A link goes back to sniff at most once per hold off period
+    EXPECT_LE(stats.to_sniff, kDurationMs / BTM_PM_SNIFF_HOLDOFF_MS + 1)
+        << "link " << i;
+    EXPECT_LE(stats.to_active, stats.to_sniff);
+  }
+
+  // The keyboard and the mouse asked for sniff far more often than the link
+  // was allowed to flap
+  EXPECT_GT(Stats(HID_KEYBOARD).deferred, Stats(HID_KEYBOARD).to_sniff);
+  EXPECT_GT(Stats(HID_KEYBOARD).flaps_avoided, 0);
+  EXPECT_GT(Stats(HID_MOUSE).deferred, Stats(HID_MOUSE).to_sniff);
+
+  // The idle links went to sniff once and stayed there
+  EXPECT_EQ(Stats(HEADSET).to_sniff, 1);
+  EXPECT_EQ(Stats(SPP).to_sniff, 1);
+  EXPECT_EQ(Stats(HEADSET).to_active, 0);
+}
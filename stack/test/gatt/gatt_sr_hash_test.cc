@@ -0,0 +1,149 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/logging.h>
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <list>
+
+#include "stack/gatt/gatt_int.h"
+
+using bluetooth::Uuid;
+
+namespace {
+
+void add_attr(tGATT_SVC_DB& db, uint16_t handle, uint16_t type) {
+  db.attr_list.emplace_back();
+  tGATT_ATTR& attr = db.attr_list.back();
+  attr.handle = handle;
+  attr.uuid = Uuid::From16Bit(type);
+}
+
+tGATT_SVC_DB& add_service(std::list<tGATT_SVC_DB>& dbs,
+                          std::list<tGATT_SRV_LIST_ELEM>& srv_list,
+                          uint16_t s_hdl, uint16_t e_hdl, uint16_t type,
+                          uint16_t service) {
+  dbs.emplace_back();
+  tGATT_SVC_DB& db = dbs.back();
+  add_attr(db, s_hdl, type);
+  db.attr_list.back().p_value.reset(new tGATT_ATTR_VALUE);
+  db.attr_list.back().p_value->uuid = Uuid::From16Bit(service);
+
+  srv_list.emplace_back();
+  srv_list.back().p_db = &db;
+  srv_list.back().s_hdl = s_hdl;
+  srv_list.back().e_hdl = e_hdl;
+  return db;
+}
+
+void add_include(tGATT_SVC_DB& db, uint16_t handle, uint16_t s_hdl,
+                 uint16_t e_hdl, uint16_t service) {
+  add_attr(db, handle, GATT_UUID_INCLUDE_SERVICE);
+  db.attr_list.back().p_value.reset(new tGATT_ATTR_VALUE);
+  db.attr_list.back().p_value->incl_handle.s_handle = s_hdl;
+  db.attr_list.back().p_value->incl_handle.e_handle = e_hdl;
+  db.attr_list.back().p_value->incl_handle.service_type =
+      Uuid::From16Bit(service);
+}
+
+void add_char(tGATT_SVC_DB& db, uint16_t handle, tGATT_CHAR_PROP property,
+              uint16_t char_uuid) {
+  add_attr(db, handle, GATT_UUID_CHAR_DECLARE);
+  db.attr_list.back().p_value.reset(new tGATT_ATTR_VALUE);
+  db.attr_list.back().p_value->char_decl.property = property;
+  db.attr_list.back().p_value->char_decl.char_val_handle = handle + 1;
+
+  add_attr(db, handle + 1, char_uuid);
+}
+
+// GAP and GATT services, a Glucose service including a secondary Battery
+// service, with a reliable write characteristic and its Extended Properties
+void build_db(std::list<tGATT_SVC_DB>& dbs,
+              std::list<tGATT_SRV_LIST_ELEM>& srv_list) {
+  tGATT_SVC_DB& gap = add_service(dbs, srv_list, 0x0001, 0x0005,
+                                  GATT_UUID_PRI_SERVICE, 0x1800);
+  add_char(gap, 0x0002, GATT_CHAR_PROP_BIT_READ | GATT_CHAR_PROP_BIT_WRITE,
+           0x2A00);
+  add_char(gap, 0x0004, GATT_CHAR_PROP_BIT_READ, 0x2A01);
+
+  tGATT_SVC_DB& gatt = add_service(dbs, srv_list, 0x0006, 0x000D,
+                                   GATT_UUID_PRI_SERVICE, 0x1801);
+  add_char(gatt, 0x0007, GATT_CHAR_PROP_BIT_INDICATE, 0x2A05);
+  add_attr(gatt, 0x0009, GATT_UUID_CHAR_CLIENT_CONFIG);
+  add_char(gatt, 0x000A, GATT_CHAR_PROP_BIT_READ | GATT_CHAR_PROP_BIT_WRITE,
+           0x2B29);
+  add_char(gatt, 0x000C, GATT_CHAR_PROP_BIT_READ, 0x2B2A);
+
+  tGATT_SVC_DB& glucose = add_service(dbs, srv_list, 0x000E, 0x0013,
+                                      GATT_UUID_PRI_SERVICE, 0x1808);
+  add_include(glucose, 0x000F, 0x0014, 0x0016, 0x180F);
+  add_char(glucose, 0x0010,
+           GATT_CHAR_PROP_BIT_READ | GATT_CHAR_PROP_BIT_INDICATE |
+               GATT_CHAR_PROP_BIT_EXT_PROP,
+           0x2A18);
+  add_attr(glucose, 0x0012, GATT_UUID_CHAR_EXT_PROP);
+  add_attr(glucose, 0x0013, GATT_UUID_CHAR_CLIENT_CONFIG);
+
+  tGATT_SVC_DB& battery = add_service(dbs, srv_list, 0x0014, 0x0016,
+                                      GATT_UUID_SEC_SERVICE, 0x180F);
+  add_char(battery, 0x0015, GATT_CHAR_PROP_BIT_READ, 0x2A19);
+}
+
+}  // namespace
+
+TEST(GattSrHashTest, hash_of_example_database) {
+  std::list<tGATT_SVC_DB> dbs;
+  std::list<tGATT_SRV_LIST_ELEM> srv_list;
+  build_db(dbs, srv_list);
+
+  // Computed outside of the stack, with the OpenSSL AES-CMAC over the
+  // database laid out by hand: 6B3065E8A746C0B21E0E30DA8DD90352, sent with
+  // the least significant octet first
+  Octet16 expected{0x52, 0x03, 0xD9, 0x8D, 0xDA, 0x30, 0x0E, 0x1E,
+                   0xB2, 0xC0, 0x46, 0xA7, 0xE8, 0x65, 0x30, 0x6B};
+  EXPECT_EQ(gatts_calculate_database_hash(srv_list), expected);
+}
+
+TEST(GattSrHashTest, hash_changes_with_database) {
+  std::list<tGATT_SVC_DB> dbs;
+  std::list<tGATT_SRV_LIST_ELEM> srv_list;
+  build_db(dbs, srv_list);
+  Octet16 hash = gatts_calculate_database_hash(srv_list);
+
+  tGATT_SVC_DB& glucose = *std::next(dbs.begin(), 2);
+
+  // Characteristic values are not covered
+  glucose.attr_list[3].permission = GATT_PERM_READ;
+  EXPECT_EQ(gatts_calculate_database_hash(srv_list), hash);
+
+  // Descriptors are covered by handle and type
+  glucose.attr_list[4].handle = 0x0011;
+  Octet16 moved_descriptor_hash = gatts_calculate_database_hash(srv_list);
+  EXPECT_NE(moved_descriptor_hash, hash);
+
+  glucose.attr_list[3].uuid = Uuid::From16Bit(0x2A19);
+  EXPECT_NE(gatts_calculate_database_hash(srv_list), moved_descriptor_hash);
+}
+
+TEST(GattSrHashTest, hash_of_empty_database) {
+  std::list<tGATT_SRV_LIST_ELEM> srv_list;
+
+  // AES-CMAC of the empty message: 4387C14B46EF7E176DCEEFA862D72FF9
+  Octet16 expected{0xF9, 0x2F, 0xD7, 0x62, 0xA8, 0xEF, 0xCE, 0x6D,
+                   0x17, 0x7E, 0xEF, 0x46, 0x4B, 0xC1, 0x87, 0x43};
+  EXPECT_EQ(gatts_calculate_database_hash(srv_list), expected);
+}
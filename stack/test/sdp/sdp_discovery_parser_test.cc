@@ -0,0 +1,311 @@
+/******************************************************************************
+ *
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "stack/sdp/sdpint.h"
+
+tSDP_CB sdp_cb;
+
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+const RawAddress kPeer({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+Bytes Uint16(uint16_t value) {
+  return {(UINT_DESC_TYPE << 3) | SIZE_TWO_BYTES, (uint8_t)(value >> 8),
+          (uint8_t)value};
+}
+
+Bytes Uint8(uint8_t value) {
+  return {(UINT_DESC_TYPE << 3) | SIZE_ONE_BYTE, value};
+}
+
+Bytes Uuid16(uint16_t value) {
+  return {(UUID_DESC_TYPE << 3) | SIZE_TWO_BYTES, (uint8_t)(value >> 8),
+          (uint8_t)value};
+}
+
+Bytes Uuid128(const uint8_t* value) {
+  Bytes element = {(UUID_DESC_TYPE << 3) | SIZE_SIXTEEN_BYTES};
+  element.insert(element.end(), value, value + 16);
+  return element;
+}
+
+Bytes Text(const std::string& text) {
+  Bytes element = {(TEXT_STR_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE,
+                   (uint8_t)text.size()};
+  element.insert(element.end(), text.begin(), text.end());
+  return element;
+}
+
+Bytes Seq(const std::vector<Bytes>& elements) {
+  Bytes contents;
+  for (const Bytes& element : elements)
+    contents.insert(contents.end(), element.begin(), element.end());
+
+  Bytes seq = {(DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD,
+               (uint8_t)(contents.size() >> 8), (uint8_t)contents.size()};
+  seq.insert(seq.end(), contents.begin(), contents.end());
+  return seq;
+}
+
+// Attribute list of an OBEX service, the attributes in the given order
+Bytes ObexRecord(uint32_t handle, uint8_t channel, bool reversed = false) {
+  std::vector<Bytes> attrs = {
+      Uint16(ATTR_ID_SERVICE_RECORD_HDL),
+      {(UINT_DESC_TYPE << 3) | SIZE_FOUR_BYTES, (uint8_t)(handle >> 24),
+       (uint8_t)(handle >> 16), (uint8_t)(handle >> 8), (uint8_t)handle},
+      Uint16(ATTR_ID_SERVICE_CLASS_ID_LIST),
+      Seq({Uuid16(UUID_SERVCLASS_PBAP_PSE)}),
+      Uint16(ATTR_ID_PROTOCOL_DESC_LIST),
+      Seq({Seq({Uuid16(UUID_PROTOCOL_L2CAP)}),
+           Seq({Uuid16(UUID_PROTOCOL_RFCOMM), Uint8(channel)}),
+           Seq({Uuid16(UUID_PROTOCOL_OBEX)})}),
+      Uint16(ATTR_ID_SERVICE_NAME),
+      Text("OBEX Phonebook Access Server"),
+  };
+  if (reversed) {
+    for (size_t i = 0, j = attrs.size() - 2; i < j; i += 2, j -= 2) {
+      std::swap(attrs[i], attrs[j]);
+      std::swap(attrs[i + 1], attrs[j + 1]);
+    }
+  }
+  return Seq(attrs);
+}
+
+tSDP_DISC_ATTR* FindAttr(tSDP_DISC_REC* p_rec, uint16_t attr_id) {
+  for (tSDP_DISC_ATTR* p_attr = p_rec->p_first_attr; p_attr;
+       p_attr = p_attr->p_next_attr) {
+    if (p_attr->attr_id == attr_id) return p_attr;
+  }
+  return nullptr;
+}
+
+size_t CountRecords(tSDP_DISCOVERY_DB* p_db) {
+  size_t count = 0;
+  for (tSDP_DISC_REC* p_rec = p_db->p_first_rec; p_rec;
+       p_rec = p_rec->p_next_rec)
+    count++;
+  return count;
+}
+
+class SdpDiscoveryParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Init(sizeof(db_storage_)); }
+
+  void Init(size_t size) {
+    p_db_ = reinterpret_cast<tSDP_DISCOVERY_DB*>(db_storage_);
+    memset(db_storage_, 0, sizeof(db_storage_));
+    p_db_->mem_size = size - sizeof(tSDP_DISCOVERY_DB);
+    p_db_->mem_free = p_db_->mem_size;
+    p_db_->p_free_mem = (uint8_t*)(p_db_ + 1);
+  }
+
+  // Feeds |response| as fragments of at most |fragment_len| bytes
+  uint16_t Parse(uint8_t mode, Bytes response, size_t fragment_len) {
+    sdp_disc_parse_start(&parser_, p_db_, kPeer, mode);
+    for (size_t offset = 0; offset < response.size();
+         offset += fragment_len) {
+      size_t len = std::min(fragment_len, response.size() - offset);
+      uint16_t result =
+          sdp_disc_parse_data(&parser_, &response[offset], (uint16_t)len);
+      if (result != SDP_SUCCESS) return result;
+    }
+    return sdp_disc_parse_end(&parser_);
+  }
+
+  void ExpectObexRecord(tSDP_DISC_REC* p_rec, uint32_t handle,
+                        uint8_t channel) {
+    ASSERT_NE(p_rec, nullptr);
+    EXPECT_EQ(p_rec->remote_bd_addr, kPeer);
+
+    tSDP_DISC_ATTR* p_attr = FindAttr(p_rec, ATTR_ID_SERVICE_RECORD_HDL);
+    ASSERT_NE(p_attr, nullptr);
+    EXPECT_EQ(p_attr->attr_value.v.u32, handle);
+
+    p_attr = FindAttr(p_rec, ATTR_ID_PROTOCOL_DESC_LIST);
+    ASSERT_NE(p_attr, nullptr);
+    tSDP_DISC_ATTR* p_l2cap = p_attr->attr_value.v.p_sub_attr;
+    ASSERT_NE(p_l2cap, nullptr);
+    EXPECT_EQ(p_l2cap->attr_value.v.p_sub_attr->attr_value.v.u16,
+              UUID_PROTOCOL_L2CAP);
+    tSDP_DISC_ATTR* p_rfcomm = p_l2cap->p_next_attr;
+    ASSERT_NE(p_rfcomm, nullptr);
+    tSDP_DISC_ATTR* p_uuid = p_rfcomm->attr_value.v.p_sub_attr;
+    EXPECT_EQ(p_uuid->attr_value.v.u16, UUID_PROTOCOL_RFCOMM);
+    EXPECT_EQ(p_uuid->p_next_attr->attr_value.v.u8, channel);
+    tSDP_DISC_ATTR* p_obex = p_rfcomm->p_next_attr;
+    ASSERT_NE(p_obex, nullptr);
+    EXPECT_EQ(p_obex->p_next_attr, nullptr);
+
+    p_attr = FindAttr(p_rec, ATTR_ID_SERVICE_NAME);
+    ASSERT_NE(p_attr, nullptr);
+    std::string name = "OBEX Phonebook Access Server";
+    EXPECT_EQ(SDP_DISC_ATTR_LEN(p_attr->attr_len_type), name.size());
+    EXPECT_EQ(memcmp(p_attr->attr_value.v.array, name.data(), name.size()),
+              0);
+  }
+
+  alignas(tSDP_DISCOVERY_DB) uint8_t db_storage_[65536];
+  tSDP_DISCOVERY_DB* p_db_;
+  tSDP_DISC_PARSER parser_;
+};
+
+}  // namespace
+
+TEST_F(SdpDiscoveryParserTest, test_single_record) {
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_RECORD, ObexRecord(0x10001, 19), 672),
+            SDP_SUCCESS);
+
+  ASSERT_EQ(CountRecords(p_db_), 1u);
+  ExpectObexRecord(p_db_->p_first_rec, 0x10001, 19);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_split_at_every_byte) {
+  Bytes response = Seq({ObexRecord(0x10001, 19), ObexRecord(0x10002, 20)});
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_LIST, response, 1), SDP_SUCCESS);
+
+  ASSERT_EQ(CountRecords(p_db_), 2u);
+  ExpectObexRecord(p_db_->p_first_rec, 0x10001, 19);
+  ExpectObexRecord(p_db_->p_first_rec->p_next_rec, 0x10002, 20);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_many_records) {
+  std::vector<Bytes> records;
+  for (uint8_t i = 0; i < 64; i++) records.push_back(ObexRecord(i, i + 1));
+  Bytes response = Seq(records);
+  // More than the former reassembly buffer could hold
+  ASSERT_GT(response.size(), 4096u);
+
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_LIST, response, 48), SDP_SUCCESS);
+
+  ASSERT_EQ(CountRecords(p_db_), 64u);
+  tSDP_DISC_REC* p_rec = p_db_->p_first_rec;
+  for (uint8_t i = 0; i < 64; i++, p_rec = p_rec->p_next_rec)
+    ExpectObexRecord(p_rec, i, i + 1);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_records_appended_to_database) {
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_RECORD, ObexRecord(1, 1), 16), SDP_SUCCESS);
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_RECORD, ObexRecord(2, 2), 16), SDP_SUCCESS);
+
+  ASSERT_EQ(CountRecords(p_db_), 2u);
+  ExpectObexRecord(p_db_->p_first_rec, 1, 1);
+  ExpectObexRecord(p_db_->p_first_rec->p_next_rec, 2, 2);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_attributes_sorted) {
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_RECORD, ObexRecord(1, 1, true), 7),
+            SDP_SUCCESS);
+
+  uint16_t last_id = 0;
+  int count = 0;
+  for (tSDP_DISC_ATTR* p_attr = p_db_->p_first_rec->p_first_attr; p_attr;
+       p_attr = p_attr->p_next_attr, count++) {
+    EXPECT_GE(p_attr->attr_id, last_id);
+    last_id = p_attr->attr_id;
+  }
+  EXPECT_EQ(count, 4);
+  ExpectObexRecord(p_db_->p_first_rec, 1, 1);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_uuid128_compressed) {
+  uint8_t base_uuid[16] = {0x00, 0x00, 0x11, 0x2f, 0x00, 0x00, 0x10, 0x00,
+                           0x80, 0x00, 0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb};
+  uint8_t vendor_uuid[16] = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0,
+                             0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0};
+  Bytes record = Seq({Uint16(ATTR_ID_SERVICE_CLASS_ID_LIST),
+                      Seq({Uuid128(base_uuid), Uuid128(vendor_uuid)})});
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_RECORD, record, 5), SDP_SUCCESS);
+
+  tSDP_DISC_ATTR* p_attr =
+      FindAttr(p_db_->p_first_rec, ATTR_ID_SERVICE_CLASS_ID_LIST);
+  ASSERT_NE(p_attr, nullptr);
+  tSDP_DISC_ATTR* p_uuid = p_attr->attr_value.v.p_sub_attr;
+  EXPECT_EQ(SDP_DISC_ATTR_LEN(p_uuid->attr_len_type), 2);
+  EXPECT_EQ(p_uuid->attr_value.v.u16, UUID_SERVCLASS_PBAP_PSE);
+  p_uuid = p_uuid->p_next_attr;
+  EXPECT_EQ(SDP_DISC_ATTR_LEN(p_uuid->attr_len_type), 16);
+  EXPECT_EQ(memcmp(p_uuid->attr_value.v.array, vendor_uuid, 16), 0);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_truncated_response) {
+  Bytes response = Seq({ObexRecord(1, 1), ObexRecord(2, 2)});
+  response.resize(response.size() - 3);
+
+  EXPECT_EQ(Parse(SDP_DISC_PARSE_LIST, response, 32), SDP_INVALID_CONT_STATE);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_data_after_lists) {
+  Bytes response = Seq({ObexRecord(1, 1)});
+  response.push_back(0);
+
+  EXPECT_EQ(Parse(SDP_DISC_PARSE_LIST, response, 32), SDP_INVALID_CONT_STATE);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_element_longer_than_list) {
+  Bytes record = ObexRecord(1, 1);
+  // The service name claims a byte past the end of the record
+  record[record.size() - 29]++;
+
+  EXPECT_EQ(Parse(SDP_DISC_PARSE_RECORD, record, 32), SDP_DB_FULL);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_response_too_long) {
+  // Bytes past the attribute list of a record are ignored, yet counted
+  Bytes record = ObexRecord(1, 1);
+  record.resize(SDP_MAX_DISC_RSP_BYTE_COUNT + 1);
+
+  EXPECT_EQ(Parse(SDP_DISC_PARSE_RECORD, record, 672), SDP_INVALID_PDU_SIZE);
+}
+
+TEST_F(SdpDiscoveryParserTest, test_database_full) {
+  Init(sizeof(tSDP_DISCOVERY_DB) + 256);
+  std::vector<Bytes> records;
+  for (uint8_t i = 0; i < 8; i++) records.push_back(ObexRecord(i, i));
+
+  EXPECT_EQ(Parse(SDP_DISC_PARSE_LIST, Seq(records), 48), SDP_DB_FULL);
+  EXPECT_LE(p_db_->p_free_mem, (uint8_t*)(p_db_ + 1) + p_db_->mem_size);
+}
+
+#if (SDP_RAW_DATA_INCLUDED == TRUE)
+TEST_F(SdpDiscoveryParserTest, test_raw_data) {
+  uint8_t raw_data[1024];
+  p_db_->raw_data = raw_data;
+  p_db_->raw_size = sizeof(raw_data);
+  p_db_->raw_used = 0;
+
+  Bytes records = ObexRecord(1, 1);
+  Bytes more = ObexRecord(2, 2);
+  records.insert(records.end(), more.begin(), more.end());
+  ASSERT_EQ(Parse(SDP_DISC_PARSE_LIST, Seq({ObexRecord(1, 1), more}), 10),
+            SDP_SUCCESS);
+
+  // The attribute lists, without the list around them
+  ASSERT_EQ(p_db_->raw_used, records.size());
+  EXPECT_EQ(memcmp(raw_data, records.data(), records.size()), 0);
+}
+#endif
@@ -10,6 +10,9 @@
 known_benchmarks=(
   bluetooth_benchmark_thread_performance
   bluetooth_benchmark_timer_performance
+  bluetooth_benchmark_interop
+  bluetooth_benchmark_metrics_registry
+  bluetooth_benchmark_gatt_notify_batcher
 )
 
 usage() {
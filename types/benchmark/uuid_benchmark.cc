@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2020 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <bluetooth/uuid.h>
+
+using ::benchmark::State;
+using bluetooth::Uuid;
+
+namespace {
+
+// What std::hash<Uuid> did before: a std::string built from the 16 bytes
+struct StringUuidHash {
+  std::size_t operator()(const Uuid& key) const {
+    const auto& uuid_bytes = key.To128BitBE();
+    return std::hash<std::string>{}(std::string(
+        reinterpret_cast<const char*>(uuid_bytes.data()), uuid_bytes.size()));
+  }
+};
+
+// Attribute types of a typical GATT database, mostly 16 bit UUIDs
+std::vector<Uuid> MakeKeys() {
+  std::vector<Uuid> keys;
+  for (uint16_t uuid16 = 0x2a00; uuid16 < 0x2a30; uuid16++) {
+    keys.push_back(Uuid::From16Bit(uuid16));
+  }
+  keys.push_back(Uuid::FromString("6333651e-c481-4a3e-9169-7c902aad37bb"));
+  keys.push_back(Uuid::FromString("f0d4de7e-4a88-476c-9d9f-1937b0996cc0"));
+  keys.push_back(Uuid::FromString("38663f1a-e711-4cac-b641-326b56404837"));
+  keys.push_back(Uuid::FromString("00e4ca9e-ab14-41e4-8823-f9e70c7e91df"));
+  return keys;
+}
+
+template <typename Hash>
+void LookupBenchmark(State& state) {
+  std::vector<Uuid> keys = MakeKeys();
+  std::unordered_map<Uuid, int, Hash> map;
+  for (size_t i = 0; i < keys.size(); i++) map[keys[i]] = i;
+
+  size_t i = 0;
+  for (auto _ : state) {
+    auto it = map.find(keys[i]);
+    benchmark::DoNotOptimize(it);
+    if (++i == keys.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+static void BM_UuidMapLookup_StringHash(State& state) {
+  LookupBenchmark<StringUuidHash>(state);
+}
+BENCHMARK(BM_UuidMapLookup_StringHash);
+
+static void BM_UuidMapLookup(State& state) {
+  LookupBenchmark<std::hash<Uuid>>(state);
+}
+BENCHMARK(BM_UuidMapLookup);
+
+// Cost of the hearing aid UUID globals at static initialization
+static void BM_UuidInit_FromString(State& state) {
+  for (auto _ : state) {
+    Uuid uuids[] = {
+        Uuid::FromString("FDF0"),
+        Uuid::FromString("6333651e-c481-4a3e-9169-7c902aad37bb"),
+        Uuid::FromString("f0d4de7e-4a88-476c-9d9f-1937b0996cc0"),
+        Uuid::FromString("38663f1a-e711-4cac-b641-326b56404837"),
+        Uuid::FromString("00e4ca9e-ab14-41e4-8823-f9e70c7e91df"),
+        Uuid::FromString("2d410339-82b6-42aa-b34e-e2e01df8cc1a"),
+    };
+    benchmark::DoNotOptimize(uuids);
+  }
+}
+BENCHMARK(BM_UuidInit_FromString);
+
+static void BM_UuidInit_FromLiteral(State& state) {
+  for (auto _ : state) {
+    constexpr Uuid uuids[] = {
+        Uuid::FromLiteral("FDF0"),
+        Uuid::FromLiteral("6333651e-c481-4a3e-9169-7c902aad37bb"),
+        Uuid::FromLiteral("f0d4de7e-4a88-476c-9d9f-1937b0996cc0"),
+        Uuid::FromLiteral("38663f1a-e711-4cac-b641-326b56404837"),
+        Uuid::FromLiteral("00e4ca9e-ab14-41e4-8823-f9e70c7e91df"),
+        Uuid::FromLiteral("2d410339-82b6-42aa-b34e-e2e01df8cc1a"),
+    };
+    benchmark::DoNotOptimize(uuids);
+  }
+}
+BENCHMARK(BM_UuidInit_FromLiteral);
+
+// Attribute type check done for every attribute of a GATT database
+static void BM_UuidCompare16Bit(State& state) {
+  std::vector<Uuid> keys = MakeKeys();
+  size_t i = 0;
+  for (auto _ : state) {
+    bool match = keys[i] == Uuid::From16Bit(0x2a19);
+    benchmark::DoNotOptimize(match);
+    if (++i == keys.size()) i = 0;
+  }
+}
+BENCHMARK(BM_UuidCompare16Bit);
+
+BENCHMARK_MAIN();
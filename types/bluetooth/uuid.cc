@@ -18,9 +18,11 @@
 
 #include "uuid.h"
 
+#include <base/logging.h>
 #include <base/rand_util.h>
 #include <base/strings/stringprintf.h>
 #include <algorithm>
+#include <cstdlib>
 
 namespace bluetooth {
 
@@ -28,12 +30,12 @@ static_assert(sizeof(Uuid) == 16, "Uuid must be 16 bytes long!");
 
 using UUID128Bit = Uuid::UUID128Bit;
 
+constexpr UUID128Bit Uuid::kBaseUuid;
+
 const Uuid Uuid::kEmpty = Uuid::From128BitBE(UUID128Bit{{0x00}});
 
 namespace {
-constexpr Uuid kBase = Uuid::From128BitBE(
-    UUID128Bit{{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
-                0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb}});
+constexpr Uuid kBase = Uuid::From16Bit(0x0000);
 }  // namespace
 
 size_t Uuid::GetShortestRepresentationSize() const {
@@ -47,12 +49,6 @@ size_t Uuid::GetShortestRepresentationSize() const {
   return kNumBytes32;
 }
 
-bool Uuid::Is16Bit() const {
-  return GetShortestRepresentationSize() == kNumBytes16;
-}
-
-uint16_t Uuid::As16Bit() const { return (((uint16_t)uu[2]) << 8) + uu[3]; }
-
 uint32_t Uuid::As32Bit() const {
   return (((uint32_t)uu[0]) << 24) + (((uint32_t)uu[1]) << 16) +
          (((uint32_t)uu[2]) << 8) + uu[3];
@@ -102,24 +98,6 @@ Uuid Uuid::FromString(const std::string& uuid, bool* is_valid) {
   return ret;
 }
 
-Uuid Uuid::From16Bit(uint16_t uuid16) {
-  Uuid u = kBase;
-
-  u.uu[2] = (uint8_t)((0xFF00 & uuid16) >> 8);
-  u.uu[3] = (uint8_t)(0x00FF & uuid16);
-  return u;
-}
-
-Uuid Uuid::From32Bit(uint32_t uuid32) {
-  Uuid u = kBase;
-
-  u.uu[0] = (uint8_t)((0xFF000000 & uuid32) >> 24);
-  u.uu[1] = (uint8_t)((0x00FF0000 & uuid32) >> 16);
-  u.uu[2] = (uint8_t)((0x0000FF00 & uuid32) >> 8);
-  u.uu[3] = (uint8_t)(0x000000FF & uuid32);
-  return u;
-}
-
 Uuid Uuid::From128BitBE(const uint8_t* uuid) {
   UUID128Bit tmp;
   memcpy(tmp.data(), uuid, kNumBytes128);
@@ -144,8 +122,6 @@ const UUID128Bit Uuid::To128BitLE() const {
   return le;
 }
 
-const UUID128Bit& Uuid::To128BitBE() const { return uu; }
-
 Uuid Uuid::GetRandom() {
   Uuid uuid;
   base::RandBytes(uuid.uu.data(), uuid.uu.size());
@@ -159,9 +135,10 @@ bool Uuid::operator<(const Uuid& rhs) const {
                                       rhs.uu.end());
 }
 
-bool Uuid::operator==(const Uuid& rhs) const { return uu == rhs.uu; }
-
-bool Uuid::operator!=(const Uuid& rhs) const { return uu != rhs.uu; }
+void Uuid::InvalidLiteral() {
+  LOG(FATAL) << "Malformed UUID literal";
+  abort();
+}
 
 std::string Uuid::ToString() const {
   return base::StringPrintf(
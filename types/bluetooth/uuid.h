@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <array>
+#include <cstring>
 #include <string>
 
 namespace bluetooth {
@@ -54,11 +55,19 @@ class Uuid final {
   size_t GetShortestRepresentationSize() const;
 
   // Returns true if this UUID can be represented as 16 bit.
-  bool Is16Bit() const;
+  bool Is16Bit() const {
+    uint32_t word, base_word;
+    uint64_t tail, base_tail;
+    memcpy(&word, uu.data() + 4, sizeof(word));
+    memcpy(&base_word, kBaseUuid.data() + 4, sizeof(base_word));
+    memcpy(&tail, uu.data() + 8, sizeof(tail));
+    memcpy(&base_tail, kBaseUuid.data() + 8, sizeof(base_tail));
+    return uu[0] == 0 && uu[1] == 0 && word == base_word && tail == base_tail;
+  }
 
   // Returns 16 bit Little Endian representation of this UUID. Use
   // GetShortestRepresentationSize() or Is16Bit() before using this method.
-  uint16_t As16Bit() const;
+  uint16_t As16Bit() const { return (((uint16_t)uu[2]) << 8) + uu[3]; }
 
   // Returns 32 bit Little Endian representation of this UUID. Use
   // GetShortestRepresentationSize() before using this method.
@@ -70,11 +79,43 @@ class Uuid final {
   // successfull, false otherwise.
   static Uuid FromString(const std::string& uuid, bool* is_valid = nullptr);
 
+  // Converts string literal representing 128, 32, or 16 bit UUID, in the
+  // formats accepted by FromString(), to UUID. Evaluated at compile time when
+  // used in a constant expression, where a malformed literal fails to compile.
+  template <size_t N>
+  static constexpr Uuid FromLiteral(const char (&uuid)[N]) {
+    static_assert(N - 1 == kString128BitLen || N - 1 == 8 || N - 1 == 4,
+                  "UUID literal must have 36, 8 or 4 characters");
+    if (N - 1 == 4) return From16Bit(ParseHex(uuid, 0, 4));
+    if (N - 1 == 8) return From32Bit(ParseHex(uuid, 0, 8));
+
+    UUID128Bit uu{};
+    size_t pos = 0;
+    for (size_t i = 0; i < kNumBytes128; i++) {
+      if (pos == 8 || pos == 13 || pos == 18 || pos == 23) {
+        if (uuid[pos] != '-') InvalidLiteral();
+        pos++;
+      }
+      uu[i] = ParseHex(uuid, pos, 2);
+      pos += 2;
+    }
+    return Uuid(uu);
+  }
+
   // Converts 16bit Little Endian representation of UUID to UUID
-  static Uuid From16Bit(uint16_t uuid16bit);
+  static constexpr Uuid From16Bit(uint16_t uuid16bit) {
+    return From32Bit(uuid16bit);
+  }
 
   // Converts 32bit Little Endian representation of UUID to UUID
-  static Uuid From32Bit(uint32_t uuid32bit);
+  static constexpr Uuid From32Bit(uint32_t uuid32bit) {
+    UUID128Bit uu = kBaseUuid;
+    uu[0] = (uint8_t)((0xFF000000 & uuid32bit) >> 24);
+    uu[1] = (uint8_t)((0x00FF0000 & uuid32bit) >> 16);
+    uu[2] = (uint8_t)((0x0000FF00 & uuid32bit) >> 8);
+    uu[3] = (uint8_t)(0x000000FF & uuid32bit);
+    return Uuid(uu);
+  }
 
   // Converts 128 bit Big Endian array representing UUID to UUID.
   static constexpr Uuid From128BitBE(const UUID128Bit& uuid) {
@@ -97,7 +138,7 @@ class Uuid final {
   const UUID128Bit To128BitLE() const;
 
   // Returns 128 bit Big Endian representation of this UUID
-  const UUID128Bit& To128BitBE() const;
+  constexpr const UUID128Bit& To128BitBE() const { return uu; }
 
   // Returns string representing this UUID in
   // xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx format, lowercase.
@@ -107,12 +148,44 @@ class Uuid final {
   bool IsEmpty() const;
 
   bool operator<(const Uuid& rhs) const;
-  bool operator==(const Uuid& rhs) const;
-  bool operator!=(const Uuid& rhs) const;
+  // Compared as two 64 bit words, this is done for every attribute type and
+  // service class lookup
+  bool operator==(const Uuid& rhs) const {
+    uint64_t lhs_words[2], rhs_words[2];
+    memcpy(lhs_words, uu.data(), kNumBytes128);
+    memcpy(rhs_words, rhs.uu.data(), kNumBytes128);
+    return ((lhs_words[0] ^ rhs_words[0]) | (lhs_words[1] ^ rhs_words[1])) == 0;
+  }
+  bool operator!=(const Uuid& rhs) const { return !(*this == rhs); }
 
  private:
+  // Bluetooth Base UUID, 00000000-0000-1000-8000-00805F9B34FB
+  static constexpr UUID128Bit kBaseUuid = {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                            0x10, 0x00, 0x80, 0x00, 0x00, 0x80,
+                                            0x5f, 0x9b, 0x34, 0xfb}};
+
   constexpr Uuid(const UUID128Bit& val) : uu{val} {};
 
+  // Not constexpr, so that reaching it fails the compile time evaluation of a
+  // malformed literal. Aborts when reached at run time.
+  [[noreturn]] static void InvalidLiteral();
+
+  static constexpr uint8_t HexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    InvalidLiteral();
+  }
+
+  // Returns the value of |len| hex digits of |str| starting at |pos|
+  static constexpr uint32_t ParseHex(const char* str, size_t pos, size_t len) {
+    uint32_t value = 0;
+    for (size_t i = pos; i < pos + len; i++) {
+      value = (value << 4) | HexDigit(str[i]);
+    }
+    return value;
+  }
+
   // Network-byte-ordered ID (Big Endian).
   UUID128Bit uu;
 };
@@ -131,9 +204,13 @@ template <>
 struct hash<bluetooth::Uuid> {
   std::size_t operator()(const bluetooth::Uuid& key) const {
     const auto& uuid_bytes = key.To128BitBE();
-    std::hash<std::string> hash_fn;
-    return hash_fn(std::string(reinterpret_cast<const char*>(uuid_bytes.data()),
-                               uuid_bytes.size()));
+    uint64_t high, low;
+    memcpy(&high, uuid_bytes.data(), sizeof(high));
+    memcpy(&low, uuid_bytes.data() + sizeof(high), sizeof(low));
+    // UUIDs derived from the Base UUID only differ in the first four bytes,
+    // which stay in the low bits of the result on 32 bit platforms too
+    return std::hash<uint64_t>{}(high ^ (low + 0x9e3779b97f4a7c15ULL +
+                                         (high << 6) + (high >> 2)));
   }
 };
 
@@ -168,3 +168,32 @@ TEST(BtifStorageTest, test_string_to_uuid_invalid) {
   uuid = Uuid::FromString("12234567-89ab-cdef-abcd-ef01234567ZZ", &is_valid);
   EXPECT_FALSE(is_valid);
 }
+
+TEST(UuidTest, FromLiteral) {
+  constexpr Uuid uuid16 = Uuid::FromLiteral("1128");
+  EXPECT_EQ(uuid16, Uuid::From16Bit(0x1128));
+  constexpr Uuid uuid32 = Uuid::FromLiteral("12341128");
+  EXPECT_EQ(uuid32, Uuid::From32Bit(0x12341128));
+  constexpr Uuid uuid128 =
+      Uuid::FromLiteral("e39c6285-867f-4b1d-9db0-35fbd9aebf22");
+  EXPECT_EQ(uuid128,
+            Uuid::FromString("e39c6285-867f-4b1d-9db0-35fbd9aebf22"));
+  EXPECT_EQ(Uuid::FromLiteral("E39C6285-867F-4B1D-9DB0-35FBD9AEBF22"),
+            uuid128);
+}
+
+TEST(UuidTest, ShortFormsAreConstexpr) {
+  static_assert(Uuid::From16Bit(0x180f).To128BitBE()[3] == 0x0f, "");
+  static_assert(Uuid::From32Bit(0x12345678).To128BitBE()[0] == 0x12, "");
+  EXPECT_TRUE(Uuid::From16Bit(0x180f).Is16Bit());
+  EXPECT_FALSE(Uuid::From32Bit(0x12345678).Is16Bit());
+  EXPECT_FALSE(SEQUENTIAL.Is16Bit());
+}
+
+TEST(UuidTest, Hash) {
+  std::hash<Uuid> hash_fn;
+  EXPECT_EQ(hash_fn(Uuid::FromLiteral("180f")),
+            hash_fn(Uuid::From16Bit(0x180f)));
+  EXPECT_NE(hash_fn(Uuid::From16Bit(0x180f)), hash_fn(Uuid::From16Bit(0x180a)));
+  EXPECT_NE(hash_fn(ONES), hash_fn(SEQUENTIAL));
+}